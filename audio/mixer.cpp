@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -42,7 +43,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -98,7 +99,7 @@ public:
 	 *
 	 * @return volume
 	 */
-	byte getVolume();
+	byte getVolume() const;
 
 	/**
 	 * Sets the channel's balance setting.
@@ -112,7 +113,7 @@ public:
 	 *
 	 * @return balance
 	 */
-	int8 getBalance();
+	int8 getBalance() const;
 
 	/**
 	 * Sets the channel's left fader level.
@@ -126,7 +127,7 @@ public:
 	 *
 	 * @return The channel's left fader level.
 	 */
-	uint8 getFaderL();
+	uint8 getFaderL() const;
 
 	/**
 	 * Sets the channel's right fader level.
@@ -140,7 +141,7 @@ public:
 	 *
 	 * @return The channel's right fader level.
 	 */
-	uint8 getFaderR();
+	uint8 getFaderR() const;
 
 	/**
 	 * Set the channel's sample rate.
@@ -154,7 +155,7 @@ public:
 	 *
 	 * @return The current sample rate of the channel.
 	 */
-	uint32 getRate();
+	uint32 getRate() const;
 
 	/**
 	 * Reset the sample rate of the channel back to its
@@ -227,17 +228,31 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _rateQuality(kRateQualityFast), _soundTypeSettings(),
+	  _numSlots(0), _freeSlotsStart(0), _numFreeSlots(0), _channelPool(new Common::ObjectPool<Channel>()), _commandWrite(0), _commandRead(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		_channels[i] = nullptr;
+	if (ConfMan.get("resampler_quality").equalsIgnoreCase("high"))
+		_rateQuality = kRateQualityHigh;
+
+	for (int i = 0; i != kMaxChannelBlocks; i++)
+		_slotBlocks[i] = nullptr;
+
+	// Start out with the same amount of channels as the old fixed channel array
+	uint index;
+	allocSlot(index);
+	pushFreeSlot(index);
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		delete _channels[i];
+	for (uint i = 0; i != _activeSlots.size(); i++)
+		_channelPool->deleteChunk(getSlot(_activeSlots[i]).channel);
+
+	for (int i = 0; i != kMaxChannelBlocks; i++)
+		delete[] _slotBlocks[i];
+
+	delete _channelPool;
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -258,29 +273,223 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
-			index = i;
-			break;
-		}
+void MixerImpl::pushFreeSlot(uint index) {
+	_freeSlots[(_freeSlotsStart + _numFreeSlots) % kMaxChannels] = index;
+	_numFreeSlots++;
+}
+
+bool MixerImpl::allocSlot(uint &index) {
+	if (_numFreeSlots) {
+		index = _freeSlots[_freeSlotsStart];
+		_freeSlotsStart = (_freeSlotsStart + 1) % kMaxChannels;
+		_numFreeSlots--;
+		return true;
 	}
-	if (index == -1) {
+
+	const uint numSlots = _numSlots.load();
+	if (numSlots == kMaxChannels)
+		return false;
+
+	// Grow by another block. The slots must be fully set up before the new
+	// slot count is published to the lock-free queries.
+	ChannelSlot *block = new ChannelSlot[kChannelsPerBlock];
+	for (uint i = 0; i != kChannelsPerBlock; i++)
+		block[i].state.handle.store(kInvalidHandle);
+	_slotBlocks[numSlots / kChannelsPerBlock] = block;
+	_numSlots.store(numSlots + kChannelsPerBlock);
+
+	_activeSlots.reserve(numSlots + kChannelsPerBlock);
+	for (uint i = 1; i != kChannelsPerBlock; i++)
+		pushFreeSlot(numSlots + i);
+
+	index = numSlots;
+	return true;
+}
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	uint index;
+	if (!allocSlot(index)) {
 		warning("MixerImpl::out of mixer slots");
-		delete chan;
+		_channelPool->deleteChunk(chan);
 		return;
 	}
 
-	_channels[index] = chan;
+	ChannelSlot &slot = getSlot(index);
+	slot.channel = chan;
+	slot.activeIndex = _activeSlots.size();
+	_activeSlots.push_back(index);
 
+	// The handle is made of the slot index and the number of channels the
+	// slot had, skipping the invalid handle
 	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	chanHandle._val = index + (++slot.generation * kMaxChannels);
+	if (chanHandle._val == kInvalidHandle)
+		chanHandle._val = index + (++slot.generation * kMaxChannels);
 
 	chan->setHandle(chanHandle);
-	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	slot.state.nativeRate.store(chan->getRate());
+	publishChannelState(index);
+
+	_typeCounts[chan->getType()].fetchAdd(1);
+	_idCounts[(uint32)chan->getId() % kIdBuckets].fetchAdd(1);
+}
+
+void MixerImpl::removeActiveChannel(uint activeIndex) {
+	const uint index = _activeSlots[activeIndex];
+	ChannelSlot &slot = getSlot(index);
+	Channel *chan = slot.channel;
+
+	// Unpublish the slot first, so that no query can match it any more
+	slot.state.handle.store(kInvalidHandle);
+	_typeCounts[chan->getType()].fetchSub(1);
+	_idCounts[(uint32)chan->getId() % kIdBuckets].fetchSub(1);
+
+	_channelPool->deleteChunk(chan);
+	slot.channel = nullptr;
+
+	// Move the last active slot in place of the removed one
+	const uint last = _activeSlots.back();
+	_activeSlots[activeIndex] = last;
+	getSlot(last).activeIndex = activeIndex;
+	_activeSlots.pop_back();
+	pushFreeSlot(index);
+}
+
+void MixerImpl::removeChannel(uint index) {
+	ChannelSlot &slot = getSlot(index);
+	if (slot.channel)
+		removeActiveChannel(slot.activeIndex);
+}
+
+void MixerImpl::publishChannelState(uint index) {
+	ChannelSlot &slot = getSlot(index);
+	const Channel *chan = slot.channel;
+	ChannelState &state = slot.state;
+
+	state.id.store(chan->getId());
+	state.type.store(chan->getType());
+	state.volume.store(chan->getVolume());
+	state.balance.store(chan->getBalance());
+	state.faderL.store(chan->getFaderL());
+	state.faderR.store(chan->getFaderR());
+	state.rate.store(chan->getRate());
+	state.handle.store(chan->getHandle()._val);
+}
+
+MixerImpl::ChannelState *MixerImpl::findChannelState(SoundHandle handle) {
+	const uint index = handle._val % kMaxChannels;
+	if (handle._val == kInvalidHandle || index >= _numSlots.load())
+		return nullptr;
+
+	ChannelState &state = getSlot(index).state;
+	if (state.handle.load() != handle._val)
+		return nullptr;
+
+	return &state;
+}
+
+Channel *MixerImpl::findChannel(SoundHandle handle) {
+	// Only to be used with _mutex held
+	const uint index = handle._val % kMaxChannels;
+	if (handle._val == kInvalidHandle || index >= _numSlots.load())
+		return nullptr;
+
+	Channel *chan = getSlot(index).channel;
+	if (!chan || chan->getHandle()._val != handle._val)
+		return nullptr;
+
+	return chan;
+}
+
+void MixerImpl::queueCommand(ChannelCommand::Type type, uint32 target, uint32 value) {
+	for (;;) {
+		{
+			Common::StackLock lock(_commandMutex);
+
+			const uint32 write = _commandWrite.load();
+			if (write - _commandRead.load() < kCommandQueueSize) {
+				ChannelCommand &cmd = _commands[write % kCommandQueueSize];
+				cmd.type = type;
+				cmd.target = target;
+				cmd.value = value;
+				_commandWrite.store(write + 1);
+				return;
+			}
+		}
+
+		// The queue is full, which means the mixer callback is not running
+		// (e.g. audio is suspended). Drain it ourselves. This must not be
+		// done while holding _commandMutex, since the engine may already
+		// hold _mutex through mutex().
+		Common::StackLock lock(_mutex);
+		processCommands();
+	}
+}
+
+void MixerImpl::processCommands() {
+	// Only ever called with _mutex held, which makes this the single consumer
+	uint32 read = _commandRead.load();
+	const uint32 write = _commandWrite.load();
+
+	while (read != write) {
+		applyCommand(_commands[read % kCommandQueueSize]);
+		read++;
+	}
+
+	_commandRead.store(read);
+}
+
+void MixerImpl::applyCommand(const ChannelCommand &cmd) {
+	if (cmd.type == ChannelCommand::kUpdateTypeVolume) {
+		for (uint i = 0; i != _activeSlots.size(); ++i) {
+			Channel *chan = getSlot(_activeSlots[i]).channel;
+			if (chan->getType() == (SoundType)cmd.target)
+				chan->notifyGlobalVolChange();
+		}
+		return;
+	}
+
+	// Commands for channels which terminated in the meantime are dropped.
+	// The setter may have raced with the slot being reused and stored its
+	// value in the state of the new channel, so republish that one.
+	SoundHandle handle;
+	handle._val = cmd.target;
+	Channel *chan = findChannel(handle);
+	if (!chan) {
+		const uint index = cmd.target % kMaxChannels;
+		if (index < _numSlots.load() && getSlot(index).channel)
+			publishChannelState(index);
+		return;
+	}
+
+	switch (cmd.type) {
+	case ChannelCommand::kSetVolume:
+		chan->setVolume(cmd.value);
+		break;
+	case ChannelCommand::kSetBalance:
+		chan->setBalance((int8)(int32)cmd.value);
+		break;
+	case ChannelCommand::kSetFaderL:
+		chan->setFaderL(cmd.value);
+		break;
+	case ChannelCommand::kSetFaderR:
+		chan->setFaderR(cmd.value);
+		break;
+	case ChannelCommand::kSetRate:
+		chan->setRate(cmd.value);
+		break;
+	case ChannelCommand::kResetRate:
+		chan->resetRate();
+		break;
+	default:
+		break;
+	}
+
+	// The setters already stored the new value in the channel state, and
+	// later commands may have stored newer ones, so nothing is published
 }
 
 void MixerImpl::playStream(
@@ -302,9 +511,9 @@ void MixerImpl::playStream(
 	assert(_mixerReady);
 
 	// Prevent duplicate sounds
-	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+	if (id != -1 && _idCounts[(uint32)id % kIdBuckets].load() != 0) {
+		for (uint i = 0; i != _activeSlots.size(); i++)
+			if (getSlot(_activeSlots[i]).channel->getId() == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -322,7 +531,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new (*_channelPool) Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -338,6 +547,8 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	processCommands();
+
 	//  zero the buf
 	memset(buf, 0, len);
 
@@ -352,39 +563,45 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
-			}
+	for (uint i = 0; i < _activeSlots.size();) {
+		Channel *chan = getSlot(_activeSlots[i]).channel;
+		if (chan->isFinished()) {
+			removeActiveChannel(i);
+			continue;
+		}
+
+		if (!chan->isPaused()) {
+			tmp = chan->mix(buf, len);
+
+			if (tmp > res)
+				res = tmp;
 		}
+		i++;
+	}
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+	for (uint i = 0; i < _activeSlots.size();) {
+		if (!getSlot(_activeSlots[i]).channel->isPermanent())
+			removeActiveChannel(i);
+		else
+			i++;
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+	if (_idCounts[(uint32)id % kIdBuckets].load() == 0)
+		return;
+
+	for (uint i = 0; i < _activeSlots.size();) {
+		if (getSlot(_activeSlots[i]).channel->getId() == id)
+			removeActiveChannel(i);
+		else
+			i++;
 	}
 }
 
@@ -392,127 +609,116 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannel(handle))
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	removeChannel(handle._val % kMaxChannels);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
+	_soundTypeSettings[type].mute.store(mute);
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(ChannelCommand::kUpdateTypeVolume, type, 0);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	return _soundTypeSettings[type].mute;
+	return _soundTypeSettings[type].mute.load() != 0;
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setVolume(volume);
+	state->volume.store(volume);
+	queueCommand(ChannelCommand::kSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return state->volume.load();
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setBalance(balance);
+	state->balance.store(balance);
+	queueCommand(ChannelCommand::kSetBalance, handle._val, (uint32)(int32)balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return state->balance.load();
 }
 
 void MixerImpl::setChannelFaderL(SoundHandle handle, uint8 faderL) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setFaderL(faderL);
+	state->faderL.store(faderL);
+	queueCommand(ChannelCommand::kSetFaderL, handle._val, faderL);
 }
 
 uint8 MixerImpl::getChannelFaderL(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getFaderL();
+	return state->faderL.load();
 }
 
 void MixerImpl::setChannelFaderR(SoundHandle handle, uint8 faderR) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setFaderR(faderR);
+	state->faderR.store(faderR);
+	queueCommand(ChannelCommand::kSetFaderR, handle._val, faderR);
 }
 
 uint8 MixerImpl::getChannelFaderR(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getFaderR();
+	return state->faderR.load();
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setRate(rate);
+	state->rate.store(rate);
+	queueCommand(ChannelCommand::kSetRate, handle._val, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getRate();
+	return state->rate.load();
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->resetRate();
+	state->rate.store(state->nativeRate.load());
+	queueCommand(ChannelCommand::kResetRate, handle._val, 0);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -522,37 +728,35 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->loop();
+	chan->loop();
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
-	}
+	for (uint i = 0; i != _activeSlots.size(); i++)
+		getSlot(_activeSlots[i]).channel->pause(paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+	for (uint i = 0; i != _activeSlots.size(); i++) {
+		Channel *chan = getSlot(_activeSlots[i]).channel;
+		if (chan->getId() == id) {
+			chan->pause(paused);
 			return;
 		}
 	}
@@ -562,51 +766,48 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->pause(paused);
+	chan->pause(paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+	if (_idCounts[(uint32)id % kIdBuckets].load() == 0)
+		return false;
+
+	const uint numSlots = _numSlots.load();
+	for (uint i = 0; i != numSlots; i++) {
+		const ChannelState &state = getSlot(i).state;
+		if (state.handle.load() != kInvalidHandle && state.id.load() == id)
 			return true;
+	}
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	const ChannelState *state = findChannelState(handle);
+	if (state)
+		return state->id.load();
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannelState(handle) != nullptr;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
-			return true;
-	return false;
+	assert(0 <= (int)type && (int)type < ARRAYSIZE(_typeCounts));
+	return _typeCounts[type].load() != 0;
 }
 
 void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
@@ -618,19 +819,15 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
+	_soundTypeSettings[type].volume.store(volume);
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(ChannelCommand::kUpdateTypeVolume, type, 0);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 
-	return _soundTypeSettings[type].volume;
+	return _soundTypeSettings[type].volume.load();
 }
 
 
@@ -639,7 +836,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _faderL(255), _faderR(255), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
@@ -648,7 +845,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -660,7 +857,7 @@ void Channel::setVolume(const byte volume) {
 	updateChannelVolumes();
 }
 
-byte Channel::getVolume() {
+byte Channel::getVolume() const {
 	return _volume;
 }
 
@@ -669,7 +866,7 @@ void Channel::setBalance(const int8 balance) {
 	updateChannelVolumes();
 }
 
-int8 Channel::getBalance() {
+int8 Channel::getBalance() const {
 	return _balance;
 }
 
@@ -678,7 +875,7 @@ void Channel::setFaderL(uint8 faderL) {
 	updateChannelVolumes();
 }
 
-uint8 Channel::getFaderL() {
+uint8 Channel::getFaderL() const {
 	return _faderL;
 }
 
@@ -687,7 +884,7 @@ void Channel::setFaderR(uint8 faderR) {
 	updateChannelVolumes();
 }
 
-uint8 Channel::getFaderR() {
+uint8 Channel::getFaderR() const {
 	return _faderR;
 }
 
@@ -696,7 +893,7 @@ void Channel::setRate(uint32 rate) {
 		_converter->setInputRate(rate);
 }
 
-uint32 Channel::getRate() {
+uint32 Channel::getRate() const {
 	if (_converter)
 		return _converter->getInputRate();
 
@@ -23,8 +23,12 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/memorypool.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -58,26 +62,123 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		kChannelsPerBlock = 32,
+		kMaxChannelBlocks = 32,
+		kMaxChannels = kChannelsPerBlock * kMaxChannelBlocks,
+		kIdBuckets = 64
 	};
 
+	static const uint32 kInvalidHandle = 0xFFFFFFFF;
+
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
 	bool _mixerReady;
-	uint32 _handleSeed;
 
+	/** Resampling quality of the channels, from the "resampler_quality" setting */
+	RateConverterQuality _rateQuality;
+
+	/** Set by the engine, and read by the mixer callback when applying kUpdateTypeVolume. */
 	struct SoundTypeSettings {
-		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
+		SoundTypeSettings() : mute(0), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		Common::Atomic<uint32> mute;
+		Common::Atomic<int32> volume;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
+
+	/**
+	 * Copy of the state of a channel slot which engines can query without
+	 * taking _mutex. A slot is only valid while its handle matches the one
+	 * being queried. All channel fields are written before the handle is
+	 * published, and the handle is cleared before the channel is deleted.
+	 */
+	struct ChannelState {
+		Common::Atomic<uint32> handle;
+		Common::Atomic<int32> id;
+		Common::Atomic<uint32> type;
+		Common::Atomic<uint32> volume;
+		Common::Atomic<int32> balance;
+		Common::Atomic<uint32> faderL;
+		Common::Atomic<uint32> faderR;
+		Common::Atomic<uint32> rate;
+		Common::Atomic<uint32> nativeRate;
+	};
+
+	struct ChannelSlot {
+		ChannelSlot() : channel(nullptr), activeIndex(0), generation(0) {}
+
+		Channel *channel;
+		uint activeIndex;	///< The position of the slot in _activeSlots, while it has a channel
+		uint32 generation;	///< Counts the channels of the slot, to make up their handles
+		ChannelState state;
+	};
+
+	/**
+	 * The channel slots, allocated in blocks as more channels are needed.
+	 * Blocks never move or get freed while the mixer exists, so the
+	 * lock-free queries can index them directly. A slot index is only
+	 * valid if it is below _numSlots.
+	 */
+	ChannelSlot *_slotBlocks[kMaxChannelBlocks];
+	Common::Atomic<uint32> _numSlots;
+
+	/**
+	 * Unused slot indices, in a ring. Slots are reused in the order they
+	 * were freed, so that the handles of a slot, which repeat after
+	 * 2^32 / kMaxChannels channels, take as long as possible to come back.
+	 */
+	uint _freeSlots[kMaxChannels];
+	uint _freeSlotsStart;
+	uint _numFreeSlots;
+
+	/**
+	 * Slot indices of all live channels. Removing a channel moves the last
+	 * one in its place, so the order is not kept.
+	 */
+	Common::Array<uint> _activeSlots;
+
+	Common::ObjectPool<Channel> *_channelPool;
+
+	/** Live channel count per sound type. */
+	Common::Atomic<uint32> _typeCounts[4];
+
+	/** Live channel count per sound id hash, to reject isSoundIDActive() queries early. */
+	Common::Atomic<uint32> _idCounts[kIdBuckets];
+
+	/**
+	 * A channel parameter change requested by the engine. These are queued
+	 * in a single-producer/single-consumer ring and applied by whoever holds
+	 * _mutex next, which usually is the mixer callback.
+	 */
+	struct ChannelCommand {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kSetFaderL,
+			kSetFaderR,
+			kSetRate,
+			kResetRate,
+			kUpdateTypeVolume
+		};
+
+		Type type;
+		uint32 target;	///< The channel handle, or the sound type for kUpdateTypeVolume
+		uint32 value;
+	};
+
+	enum {
+		kCommandQueueSize = 256
+	};
+
+	/** Serializes the producers of the command ring. Never taken by the mixer callback. */
+	Common::Mutex _commandMutex;
+	ChannelCommand _commands[kCommandQueueSize];
+	Common::Atomic<uint32> _commandWrite;
+	Common::Atomic<uint32> _commandRead;
 
 
 public:
@@ -143,6 +244,20 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	ChannelSlot &getSlot(uint index) { return _slotBlocks[index / kChannelsPerBlock][index % kChannelsPerBlock]; }
+	Channel *findChannel(SoundHandle handle);
+	bool allocSlot(uint &index);
+	void removeChannel(uint index);
+	void removeActiveChannel(uint activeIndex);
+	void pushFreeSlot(uint index);
+	void publishChannelState(uint index);
+	ChannelState *findChannelState(SoundHandle handle);
+
+	void queueCommand(ChannelCommand::Type type, uint32 target, uint32 value);
+	void processCommands();
+	void applyCommand(const ChannelCommand &cmd);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
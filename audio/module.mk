@@ -133,5 +133,18 @@ MODULE_OBJS += \
 	soundfont/vab/vab.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -29,9 +29,17 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/hashmap.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/system.h"
 #include "common/util.h"
 
+#include <math.h>
+
 namespace Audio {
 
 /**
@@ -76,13 +84,58 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	enum {
+		kMixBufferFrames = 256
+	};
+
+	/** Resampled frames waiting to be mixed into the output */
+	st_sample_t _mixBuffer[kMixBufferFrames * (inStereo ? 2 : 1)];
+
+	/** The kernel which applies the volume and mixes into the output */
+	SampleMixer::MixFunc _mixFunc;
+
+	/** Whether to use the polyphase resampler when the rates differ */
+	const RateConverterQuality _quality;
+
+	/** Filter bank of the polyphase resampler, nullptr until first needed */
+	const FilterBank *_filterBank;
+
+	/** Rates the filter bank has been acquired for */
+	st_rate_t _filterInRate, _filterOutRate;
+
+	/** Filter phase of the next output frame */
+	uint _filterPhase;
+
+	/** Number of input frames to read before the next output frame */
+	uint _filterInput;
+
+	/**
+	 * The last kFilterTaps input samples of each channel, stored twice so
+	 * that they can always be read in one go starting at _historyPos.
+	 */
+	st_sample_t _history[inStereo ? 2 : 1][SampleMixer::kFilterTaps * 2];
+
+	/** Position of the oldest sample in the history */
+	uint _historyPos;
+
+	/** The kernel which applies the filter */
+	SampleMixer::FilterFunc _filterFunc;
+
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	int polyphaseConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+
+	void updateFilterBank();
+
+	static st_sample_t filterSample(int32 sum) {
+		sum = (sum + (1 << (FilterBank::kCoeffBits - 1))) >> FilterBank::kCoeffBits;
+		return (st_sample_t)CLIP<int32>(sum, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
 
 public:
-	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
-	virtual ~RateConverter_Impl() {}
+	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, RateConverterQuality quality);
+	virtual ~RateConverter_Impl() { FilterBank::release(_filterBank); }
 
 	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
 
@@ -97,48 +150,34 @@ public:
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
-	st_sample_t *outStart, *outEnd;
-
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	st_size_t numFrames = 0;
 
-	while (outBuffer < outEnd) {
+	while (numFrames < numSamples) {
 		// Check if we have to refill the buffer
 		if (_bufferSize == 0) {
 			_bufferPos = _buffer;
 			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 			if (_bufferSize <= 0)
-				return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				break;
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+		// Mix the data straight from the input buffer into the output buffer
+		const st_size_t frames = MIN<st_size_t>(numSamples - numFrames, _bufferSize / (inStereo ? 2 : 1));
+		if (frames == 0) {
+			// Drop an incomplete stereo frame
+			_bufferSize = 0;
+			continue;
+		}
 
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+		_mixFunc(outBuffer + numFrames * (outStereo ? 2 : 1), _bufferPos, frames, volL, volR);
 
-			outBuffer += 1;
-		}
+		_bufferPos += frames * (inStereo ? 2 : 1);
+		_bufferSize -= frames * (inStereo ? 2 : 1);
+		numFrames += frames;
 	}
 
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return numFrames;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -146,58 +185,54 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
-	st_sample_t *outStart, *outEnd;
-
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
-
-	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
-			}
+	st_size_t numFrames = 0;
+	bool endOfInput = false;
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_outPos--;
+	while (numFrames < numSamples && !endOfInput) {
+		// Gather a block of input frames, then mix it in one go
+		const st_size_t maxFrames = MIN<st_size_t>(numSamples - numFrames, kMixBufferFrames);
+		st_sample_t *mixPos = _mixBuffer;
+		st_size_t frames = 0;
 
-			if (_outPos >= 0) {
-				_bufferPos += (inStereo ? 2 : 1);
-			}
-		} while (_outPos >= 0);
+		while (frames < maxFrames) {
+			// Read enough input samples so that _outPos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
 
-		// Increment output position
-		_outPos += outPos_inc;
+				_bufferSize -= (inStereo ? 2 : 1);
+				_outPos--;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+				if (_outPos >= 0) {
+					_bufferPos += (inStereo ? 2 : 1);
+				}
+			} while (_outPos >= 0);
 
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
+			if (endOfInput)
+				break;
 
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+			*mixPos++ = *_bufferPos++;
+			if (inStereo)
+				*mixPos++ = *_bufferPos++;
 
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
+			// Increment output position
+			_outPos += outPos_inc;
+			frames++;
 		}
+
+		_mixFunc(outBuffer + numFrames * (outStereo ? 2 : 1), _mixBuffer, frames, volL, volR);
+		numFrames += frames;
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+
+	return numFrames;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -205,72 +240,145 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
-	st_sample_t *outStart, *outEnd;
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	st_size_t numFrames = 0;
+	bool endOfInput = false;
+
+	while (numFrames < numSamples && !endOfInput) {
+		// Interpolate a block of frames, then mix it in one go
+		const st_size_t maxFrames = MIN<st_size_t>(numSamples - numFrames, kMixBufferFrames);
+		st_sample_t *mixPos = _mixBuffer;
+		st_size_t frames = 0;
+
+		while (frames < maxFrames) {
+			// Read enough input samples so that _outPosFrac < 0
+			while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_inLastL = _inCurL;
+				_inCurL = *_bufferPos++;
+
+				if (inStereo) {
+					_inLastR = _inCurR;
+					_inCurR = *_bufferPos++;
+				}
+
+				_outPosFrac -= FRAC_ONE_LOW;
+			}
+
+			if (endOfInput)
+				break;
 
-	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPosFrac < 0
-		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+			// Loop as long as the _outPos trails behind, and as long as there is
+			// still space in the block.
+			while (_outPosFrac < (frac_t)FRAC_ONE_LOW && frames < maxFrames) {
+				// Interpolate
+				*mixPos++ = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				if (inStereo)
+					*mixPos++ = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				// Increment output position
+				_outPosFrac += outPos_inc;
+				frames++;
 			}
+		}
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_inLastL = _inCurL;
-			_inCurL = *_bufferPos++;
+		_mixFunc(outBuffer + numFrames * (outStereo ? 2 : 1), _mixBuffer, frames, volL, volR);
+		numFrames += frames;
+	}
 
-			if (inStereo) {
-				_inLastR = _inCurR;
-				_inCurR = *_bufferPos++;
-			}
+	return numFrames;
+}
 
-			_outPosFrac -= FRAC_ONE_LOW;
-		}
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void RateConverter_Impl<inStereo, outStereo, reverseStereo>::updateFilterBank() {
+	const FilterBank *bank = FilterBank::acquire(_inRate, _outRate);
 
-		// Loop as long as the _outPos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
-			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
+	// Keep the position between two input frames when the ratio changes
+	if (_filterBank)
+		_filterPhase = (uint)(((uint64)_filterPhase * bank->phases) / _filterBank->phases);
+
+	FilterBank::release(_filterBank);
+	_filterBank = bank;
+	_filterInRate = _inRate;
+	_filterOutRate = _outRate;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::polyphaseConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	if (!_filterBank || _filterInRate != _inRate || _filterOutRate != _outRate)
+		updateFilterBank();
+
+	const uint phases = _filterBank->phases;
+	const uint step = _filterBank->step;
+
+	st_size_t numFrames = 0;
+	bool endOfInput = false;
+
+	while (numFrames < numSamples && !endOfInput) {
+		// Filter a block of frames, then mix it in one go
+		const st_size_t maxFrames = MIN<st_size_t>(numSamples - numFrames, kMixBufferFrames);
+		st_sample_t *mixPos = _mixBuffer;
+		st_size_t frames = 0;
+
+		while (frames < maxFrames) {
+			// Feed the history with the input frames the next output frame needs
+			while (_filterInput) {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_history[0][_historyPos] = _history[0][_historyPos + SampleMixer::kFilterTaps] = *_bufferPos++;
+				if (inStereo)
+					_history[1][_historyPos] = _history[1][_historyPos + SampleMixer::kFilterTaps] = *_bufferPos++;
+
+				_historyPos = (_historyPos + 1) % SampleMixer::kFilterTaps;
+				_filterInput--;
 			}
 
-			// Increment output position
-			_outPosFrac += outPos_inc;
+			if (endOfInput)
+				break;
+
+			const int16 *coeffs = _filterBank->getCoeffs(_filterPhase);
+			*mixPos++ = filterSample(_filterFunc(_history[0] + _historyPos, coeffs));
+			if (inStereo)
+				*mixPos++ = filterSample(_filterFunc(_history[1] + _historyPos, coeffs));
+
+			// Advance to the next output frame
+			_filterPhase += step;
+			if (_filterPhase >= phases) {
+				_filterInput = _filterPhase / phases;
+				_filterPhase %= phases;
+			}
+			frames++;
 		}
+
+		_mixFunc(outBuffer + numFrames * (outStereo ? 2 : 1), _mixBuffer, frames, volL, volR);
+		numFrames += frames;
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+
+	return numFrames;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, RateConverterQuality quality) :
 	_inRate(inputRate),
 	_outRate(outputRate),
 	_outPos(1),
@@ -280,7 +388,19 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr),
+	_mixFunc(SampleMixer::getFuncs().get(inStereo, outStereo, reverseStereo)),
+	_quality(quality),
+	_filterBank(nullptr),
+	_filterInRate(0),
+	_filterOutRate(0),
+	_filterPhase(0),
+	// Center the first output frame on the first input frame
+	_filterInput(SampleMixer::kFilterTaps / 2 + 1),
+	_historyPos(0),
+	_filterFunc(SampleMixer::getFuncs().filter) {
+	memset(_history, 0, sizeof(_history));
+}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
@@ -288,6 +408,8 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 
 	if (_inRate == _outRate) {
 		return copyConvert(input, outBuffer, numSamples, volL, volR);
+	} else if (_quality == kRateQualityHigh) {
+		return polyphaseConvert(input, outBuffer, numSamples, volL, volR);
 	} else {
 		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
 			return simpleConvert(input, outBuffer, numSamples, volL, volR);
@@ -297,21 +419,210 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+const SampleMixer::Funcs SampleMixer::funcsGeneric = {
+	SampleMixer::mixGeneric<false, false, false>,
+	SampleMixer::mixGeneric<false, true, false>,
+	SampleMixer::mixGeneric<true, false, false>,
+	SampleMixer::mixGeneric<true, true, false>,
+	SampleMixer::mixGeneric<true, true, true>,
+	SampleMixer::filterGeneric
+};
+
+const SampleMixer::Funcs *SampleMixer::selectedFuncs = nullptr;
+
+const SampleMixer::Funcs &SampleMixer::getFuncs() {
+	// If no kernels have been selected yet, detect and select
+	if (!selectedFuncs) {
+		selectedFuncs = &funcsGeneric;
+		// The SIMD kernels rely on saturating signed additions
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) selectedFuncs = &funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) selectedFuncs = &funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) selectedFuncs = &funcsAVX2;
+#endif
+#endif
+	}
+
+	return *selectedFuncs;
+}
+
+#pragma mark -
+
+/**
+ * Keeps the filter banks shared by the converters, and a few unused ones
+ * for converters yet to come.
+ */
+class FilterBankCache : public Common::Singleton<FilterBankCache> {
+public:
+	const FilterBank *acquire(uint phases, uint step);
+	void release(const FilterBank *bank);
+
+private:
+	enum {
+		kMaxUnusedBanks = 8
+	};
+
+	friend class Common::Singleton<SingletonBaseType>;
+	FilterBankCache() : _unusedBanks(0) {}
+	~FilterBankCache();
+
+	static uint64 getKey(uint phases, uint step) { return ((uint64)step << 11) | phases; }
+
+	typedef Common::HashMap<uint64, FilterBank *> BankMap;
+
+	Common::Mutex _mutex;
+	BankMap _banks;
+	uint _unusedBanks;
+};
+
+FilterBankCache::~FilterBankCache() {
+	for (BankMap::iterator i = _banks.begin(); i != _banks.end(); ++i)
+		delete i->_value;
+}
+
+const FilterBank *FilterBankCache::acquire(uint phases, uint step) {
+	Common::StackLock lock(_mutex);
+
+	FilterBank *&bank = _banks.getOrCreateVal(getKey(phases, step));
+	if (!bank)
+		bank = new FilterBank(phases, step);
+	else if (bank->_refCount == 0)
+		_unusedBanks--;
+
+	bank->_refCount++;
+	return bank;
+}
+
+void FilterBankCache::release(const FilterBank *bank) {
+	Common::StackLock lock(_mutex);
+
+	FilterBank *&entry = _banks.getVal(getKey(bank->phases, bank->step));
+	assert(entry == bank && entry->_refCount > 0);
+	if (--entry->_refCount)
+		return;
+
+	if (++_unusedBanks <= kMaxUnusedBanks)
+		return;
+
+	// Too many unused banks, drop them all but the one just released
+	for (BankMap::iterator i = _banks.begin(); i != _banks.end(); ++i) {
+		if (i->_value->_refCount == 0 && i->_value != bank) {
+			delete i->_value;
+			_banks.erase(i);
+		}
+	}
+	_unusedBanks = 1;
+}
+
+/** Modified Bessel function of the first kind, for the Kaiser window */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50 && term > sum * 1e-12; k++) {
+		const double t = x / (2 * k);
+		term *= t * t;
+		sum += term;
+	}
+	return sum;
+}
+
+FilterBank::FilterBank(uint phases_, uint step_) : phases(phases_), step(step_), _refCount(0) {
+	const int taps = SampleMixer::kFilterTaps;
+
+	// Cut off a bit below the Nyquist frequency of the lower of the two
+	// rates, in cycles per input sample, and leave the rest of the way to
+	// the Kaiser window.
+	const double cutoff = 0.44 * (step > phases ? (double)phases / step : 1.0);
+	const double beta = 6.0;
+	const double windowScale = 1.0 / besselI0(beta);
+
+	_coeffs = new int16[phases * taps];
+
+	for (uint phase = 0; phase < phases; phase++) {
+		double coeffs[SampleMixer::kFilterTaps];
+		double sum = 0.0;
+
+		for (int i = 0; i < taps; i++) {
+			// Distance of the tap to the output sample, in input samples
+			const double d = i - taps / 2 + 1 - (double)phase / phases;
+			const double x = d / (taps / 2);
+			const double window = (x * x < 1.0) ? besselI0(beta * sqrt(1.0 - x * x)) * windowScale : 0.0;
+			const double sinc = (d == 0.0) ? 1.0 : sin(2.0 * M_PI * cutoff * d) / (2.0 * M_PI * cutoff * d);
+
+			coeffs[i] = 2.0 * cutoff * sinc * window;
+			sum += coeffs[i];
+		}
+
+		// Normalize each phase to unity gain, and put the rounding error on
+		// the largest coefficient
+		int16 *dst = _coeffs + phase * taps;
+		int total = 0, largest = 0;
+		for (int i = 0; i < taps; i++) {
+			dst[i] = (int16)floor(coeffs[i] / sum * (1 << kCoeffBits) + 0.5);
+			total += dst[i];
+			if (dst[i] > dst[largest])
+				largest = i;
+		}
+		dst[largest] += (1 << kCoeffBits) - total;
+	}
+}
+
+FilterBank::~FilterBank() {
+	delete[] _coeffs;
+}
+
+const FilterBank *FilterBank::acquire(st_rate_t inRate, st_rate_t outRate) {
+	const st_rate_t div = Common::gcd(inRate, outRate);
+	uint phases = outRate / div;
+	uint step = inRate / div;
+
+	if (phases > kMaxPhases) {
+		// Use the closest ratio with few enough phases, the difference in
+		// pitch is far below what anyone could hear
+		const double ratio = (double)inRate / outRate;
+		double bestError = 1.0;
+		for (uint p = 1; p <= kMaxPhases; p++) {
+			const uint s = (uint)floor(p * ratio + 0.5);
+			const double error = fabs((double)s / p - ratio);
+			if (s && error < bestError) {
+				bestError = error;
+				phases = p;
+				step = s;
+			}
+		}
+	}
+
+	return FilterBankCache::instance().acquire(phases, step);
+}
+
+void FilterBank::release(const FilterBank *bank) {
+	if (bank)
+		FilterBankCache::instance().release(bank);
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality) {
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
-				return new RateConverter_Impl<true, true, true>(inRate, outRate);
+				return new RateConverter_Impl<true, true, true>(inRate, outRate, quality);
 			else
-				return new RateConverter_Impl<true, true, false>(inRate, outRate);
+				return new RateConverter_Impl<true, true, false>(inRate, outRate, quality);
 		} else
-			return new RateConverter_Impl<true, false, false>(inRate, outRate);
+			return new RateConverter_Impl<true, false, false>(inRate, outRate, quality);
 	} else {
 		if (outStereo) {
-			return new RateConverter_Impl<false, true, false>(inRate, outRate);
+			return new RateConverter_Impl<false, true, false>(inRate, outRate, quality);
 		} else
-			return new RateConverter_Impl<false, false, false>(inRate, outRate);
+			return new RateConverter_Impl<false, false, false>(inRate, outRate, quality);
 	}
 }
 
 } // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::FilterBankCache);
+}
@@ -66,6 +66,17 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * The algorithms a RateConverter can use when the input and output rates
+ * differ.
+ */
+enum RateConverterQuality {
+	/** Nearest neighbour or linear interpolation, cheap but prone to aliasing. */
+	kRateQualityFast,
+	/** Polyphase windowed-sinc filtering, for a much cleaner upsampling. */
+	kRateQualityHigh
+};
+
 /**
  * Helper class that handles resampling an AudioStream between an input and output
  * sample rate. Its regular use case is upsampling from the native stream rate
@@ -104,7 +115,7 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality = kRateQualityFast);
 
 /** @} */
 } // End of namespace Audio
@@ -0,0 +1,120 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+/**
+ * Scale sixteen samples by their volumes and add them with saturation to
+ * the output. The unpack and pack instructions both work on the two 128-bit
+ * lanes separately, so the sample order is preserved.
+ */
+static FORCEINLINE void mixSamplesAVX2(st_sample_t *out, __m256i in, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(in, vol);
+	const __m256i hi = _mm256_mulhi_epi16(in, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+
+	const __m256i bias = _mm256_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), bias)), 8);
+
+	const __m256i res = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)out), _mm256_packs_epi32(p0, p1));
+	_mm256_storeu_si256((__m256i *)out, res);
+}
+
+template<bool reverseStereo>
+static void mixStereoToStereoAVX2(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = reverseStereo ? _mm256_set1_epi32((volL << 16) | volR) : _mm256_set1_epi32((volR << 16) | volL);
+
+	for (; numFrames >= 8; numFrames -= 8) {
+		__m256i samples = _mm256_loadu_si256((const __m256i *)in);
+		if (reverseStereo) {
+			samples = _mm256_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+			samples = _mm256_shufflehi_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+		mixSamplesAVX2(out, samples, vol);
+		in += 16;
+		out += 16;
+	}
+
+	SampleMixer::mixGeneric<true, true, reverseStereo>(out, in, numFrames, volL, volR);
+}
+
+static void mixMonoToStereoAVX2(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+
+	for (; numFrames >= 16; numFrames -= 16) {
+		const __m128i samples0 = _mm_loadu_si128((const __m128i *)in);
+		const __m128i samples1 = _mm_loadu_si128((const __m128i *)(in + 8));
+		const __m256i dup0 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(samples0, samples0)), _mm_unpackhi_epi16(samples0, samples0), 1);
+		const __m256i dup1 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(samples1, samples1)), _mm_unpackhi_epi16(samples1, samples1), 1);
+		mixSamplesAVX2(out, dup0, vol);
+		mixSamplesAVX2(out + 16, dup1, vol);
+		in += 16;
+		out += 32;
+	}
+
+	SampleMixer::mixGeneric<false, true, false>(out, in, numFrames, volL, volR);
+}
+
+static int32 filterAVX2(const st_sample_t *samples, const int16 *coeffs) {
+	__m256i sum = _mm256_setzero_si256();
+	for (int i = 0; i < SampleMixer::kFilterTaps; i += 16) {
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(samples + i));
+		const __m256i c = _mm256_loadu_si256((const __m256i *)(coeffs + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(s, c));
+	}
+
+	__m128i res = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	res = _mm_add_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(1, 0, 3, 2)));
+	res = _mm_add_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(res);
+}
+
+const SampleMixer::Funcs SampleMixer::funcsAVX2 = {
+	SampleMixer::mixGeneric<false, false, false>,
+	mixMonoToStereoAVX2,
+	SampleMixer::mixGeneric<true, false, false>,
+	mixStereoToStereoAVX2<false>,
+	mixStereoToStereoAVX2<true>,
+	filterAVX2
+};
+
+} // End of namespace Audio
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
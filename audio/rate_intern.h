@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * The kernels used by the rate converters.
+ *
+ * The mixing kernels apply the channel volumes to a block of resampled
+ * frames and add them, with clipping, to the mixer output buffer. The input
+ * frames use the channel layout of the source stream, the output frames the
+ * one of the mixer.
+ *
+ * The filter kernel computes one output sample of the polyphase resampler,
+ * the dot product of kFilterTaps input samples and filter coefficients.
+ *
+ * All variants produce exactly the same output as the generic one.
+ */
+class SampleMixer {
+public:
+	enum {
+		/** Number of filter coefficients of each phase of the polyphase resampler. */
+		kFilterTaps = 32
+	};
+
+	typedef void (*MixFunc)(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR);
+	typedef int32 (*FilterFunc)(const st_sample_t *samples, const int16 *coeffs);
+
+	struct Funcs {
+		MixFunc monoToMono;
+		MixFunc monoToStereo;
+		MixFunc stereoToMono;
+		MixFunc stereoToStereo;
+		MixFunc stereoToStereoReverse;
+		FilterFunc filter;
+
+		MixFunc get(bool inStereo, bool outStereo, bool reverseStereo) const {
+			if (inStereo) {
+				if (outStereo)
+					return reverseStereo ? stereoToStereoReverse : stereoToStereo;
+				return stereoToMono;
+			}
+			return outStereo ? monoToStereo : monoToMono;
+		}
+	};
+
+	/**
+	 * Return the kernels best suited for the CPU we are running on.
+	 * The selection is done on the first call.
+	 */
+	static const Funcs &getFuncs();
+
+	/** The kernels in use, nullptr until they have been selected. */
+	static const Funcs *selectedFuncs;
+
+	static const Funcs funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Funcs funcsAVX2;
+#endif
+
+	/** The generic kernel, also used by the SIMD variants for the remaining frames. */
+	template<bool inStereo, bool outStereo, bool reverseStereo>
+	static void mixGeneric(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+		for (; numFrames; numFrames--) {
+			st_sample_t inL, inR;
+			inL = *in++;
+			inR = (inStereo ? *in++ : inL);
+
+			st_sample_t outL, outR;
+			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+			if (outStereo) {
+				// Output left channel
+				clampedAdd(out[reverseStereo    ], outL);
+
+				// Output right channel
+				clampedAdd(out[reverseStereo ^ 1], outR);
+
+				out += 2;
+			} else {
+				// Output mono channel
+				clampedAdd(out[0], (outL + outR) / 2);
+
+				out += 1;
+			}
+		}
+	}
+
+	/** The generic filter kernel. */
+	static int32 filterGeneric(const st_sample_t *samples, const int16 *coeffs) {
+		int32 sum = 0;
+		for (int i = 0; i < kFilterTaps; i++)
+			sum += samples[i] * coeffs[i];
+		return sum;
+	}
+};
+
+/**
+ * The coefficients of a polyphase resampling filter.
+ *
+ * The output rate is phases / step times the input rate. Output sample n
+ * lies phase (n * step) % phases, counted in 1 / phases input samples, past
+ * input sample (n * step) / phases, and is computed with the coefficients
+ * of that phase. Each phase has SampleMixer::kFilterTaps coefficients in
+ * 1.15 fixed point, which add up to exactly 1.0.
+ *
+ * Banks are shared between all the converters using the same ratio, see
+ * acquire() and release().
+ */
+class FilterBank {
+public:
+	enum {
+		/** The largest number of phases in a bank, other ratios are approximated. */
+		kMaxPhases = 1024,
+		/** The number of fractional bits of the coefficients. */
+		kCoeffBits = 15
+	};
+
+	const uint phases;
+	const uint step;
+
+	/** Return the coefficients of the given phase. */
+	const int16 *getCoeffs(uint phase) const { return _coeffs + phase * SampleMixer::kFilterTaps; }
+
+	/**
+	 * Get the bank for converting from inRate to outRate, creating it if it
+	 * is not cached yet. Must be matched by a call to release().
+	 */
+	static const FilterBank *acquire(st_rate_t inRate, st_rate_t outRate);
+
+	/**
+	 * Give up a bank returned by acquire(). Unused banks are kept cached
+	 * for a while, since channels with the same rates come and go all the
+	 * time.
+	 */
+	static void release(const FilterBank *bank);
+
+	FilterBank(uint phases_, uint step_);
+	~FilterBank();
+
+private:
+	int16 *_coeffs;
+	uint _refCount;
+
+	friend class FilterBankCache;
+};
+
+} // End of namespace Audio
+
+#endif
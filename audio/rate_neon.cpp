@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+static inline int32x4_t scaleSamplesNEON(int16x4_t in, int16x4_t vol) {
+	// Divide by kMaxMixerVolume, truncating towards zero like the generic code
+	const int32x4_t p = vmull_s16(in, vol);
+	const int32x4_t bias = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24));
+	return vshrq_n_s32(vaddq_s32(p, bias), 8);
+}
+
+/**
+ * Scale eight samples by their volumes and add them with saturation to
+ * the output.
+ */
+static inline void mixSamplesNEON(st_sample_t *out, int16x8_t in, int16x8_t vol) {
+	const int32x4_t p0 = scaleSamplesNEON(vget_low_s16(in), vget_low_s16(vol));
+	const int32x4_t p1 = scaleSamplesNEON(vget_high_s16(in), vget_high_s16(vol));
+	const int16x8_t res = vqaddq_s16(vld1q_s16(out), vcombine_s16(vmovn_s32(p0), vmovn_s32(p1)));
+	vst1q_s16(out, res);
+}
+
+template<bool reverseStereo>
+static void mixStereoToStereoNEON(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const int16x8_t vol = vreinterpretq_s16_u32(vdupq_n_u32(reverseStereo ? ((volL << 16) | volR) : ((volR << 16) | volL)));
+
+	for (; numFrames >= 4; numFrames -= 4) {
+		int16x8_t samples = vld1q_s16(in);
+		if (reverseStereo)
+			samples = vrev32q_s16(samples);
+		mixSamplesNEON(out, samples, vol);
+		in += 8;
+		out += 8;
+	}
+
+	SampleMixer::mixGeneric<true, true, reverseStereo>(out, in, numFrames, volL, volR);
+}
+
+static void mixMonoToStereoNEON(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const int16x8_t vol = vreinterpretq_s16_u32(vdupq_n_u32((volR << 16) | volL));
+
+	for (; numFrames >= 8; numFrames -= 8) {
+		const int16x8_t samples = vld1q_s16(in);
+		const int16x8x2_t dup = vzipq_s16(samples, samples);
+		mixSamplesNEON(out, dup.val[0], vol);
+		mixSamplesNEON(out + 8, dup.val[1], vol);
+		in += 8;
+		out += 16;
+	}
+
+	SampleMixer::mixGeneric<false, true, false>(out, in, numFrames, volL, volR);
+}
+
+static int32 filterNEON(const st_sample_t *samples, const int16 *coeffs) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (int i = 0; i < SampleMixer::kFilterTaps; i += 8) {
+		const int16x8_t s = vld1q_s16(samples + i);
+		const int16x8_t c = vld1q_s16(coeffs + i);
+		sum = vmlal_s16(sum, vget_low_s16(s), vget_low_s16(c));
+		sum = vmlal_s16(sum, vget_high_s16(s), vget_high_s16(c));
+	}
+
+	int32x2_t res = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	res = vpadd_s32(res, res);
+	return vget_lane_s32(res, 0);
+}
+
+const SampleMixer::Funcs SampleMixer::funcsNEON = {
+	SampleMixer::mixGeneric<false, false, false>,
+	mixMonoToStereoNEON,
+	SampleMixer::mixGeneric<true, false, false>,
+	mixStereoToStereoNEON<false>,
+	mixStereoToStereoNEON<true>,
+	filterNEON
+};
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
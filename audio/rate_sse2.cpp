@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+/**
+ * Scale eight samples by their volumes and add them with saturation to
+ * the output. The division by kMaxMixerVolume truncates towards zero, just
+ * like the generic code does.
+ */
+static FORCEINLINE void mixSamplesSSE2(st_sample_t *out, __m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+
+	const __m128i res = _mm_adds_epi16(_mm_loadu_si128((const __m128i *)out), _mm_packs_epi32(p0, p1));
+	_mm_storeu_si128((__m128i *)out, res);
+}
+
+template<bool reverseStereo>
+static void mixStereoToStereoSSE2(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = reverseStereo ? _mm_set1_epi32((volL << 16) | volR) : _mm_set1_epi32((volR << 16) | volL);
+
+	for (; numFrames >= 4; numFrames -= 4) {
+		__m128i samples = _mm_loadu_si128((const __m128i *)in);
+		if (reverseStereo) {
+			samples = _mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+			samples = _mm_shufflehi_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+		mixSamplesSSE2(out, samples, vol);
+		in += 8;
+		out += 8;
+	}
+
+	SampleMixer::mixGeneric<true, true, reverseStereo>(out, in, numFrames, volL, volR);
+}
+
+static void mixMonoToStereoSSE2(st_sample_t *out, const st_sample_t *in, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = _mm_set1_epi32((volR << 16) | volL);
+
+	for (; numFrames >= 8; numFrames -= 8) {
+		const __m128i samples = _mm_loadu_si128((const __m128i *)in);
+		mixSamplesSSE2(out, _mm_unpacklo_epi16(samples, samples), vol);
+		mixSamplesSSE2(out + 8, _mm_unpackhi_epi16(samples, samples), vol);
+		in += 8;
+		out += 16;
+	}
+
+	SampleMixer::mixGeneric<false, true, false>(out, in, numFrames, volL, volR);
+}
+
+static int32 filterSSE2(const st_sample_t *samples, const int16 *coeffs) {
+	__m128i sum = _mm_setzero_si128();
+	for (int i = 0; i < SampleMixer::kFilterTaps; i += 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coeffs + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(s, c));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+const SampleMixer::Funcs SampleMixer::funcsSSE2 = {
+	SampleMixer::mixGeneric<false, false, false>,
+	mixMonoToStereoSSE2,
+	SampleMixer::mixGeneric<true, false, false>,
+	mixStereoToStereoSSE2<false>,
+	mixStereoToStereoSSE2<true>,
+	filterSSE2
+};
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -39,3 +39,7 @@ const char *AbstractFSNode::lastPathComponent(const Common::String &str, const c
 Common::SeekableReadStream *AbstractFSNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 	return nullptr;
 }
+
+bool AbstractFSNode::getFileStatus(int64 &size, int64 &modificationTime) const {
+	return false;
+}
@@ -192,6 +192,18 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStreamForAltStream(Common::AltStreamType altStreamType);
 
+	/**
+	 * Query the size and the last modification time of the file referred by
+	 * this node, without opening it. Backends which cannot do that cheaply
+	 * simply return false.
+	 *
+	 * @param size Set to the size of the file, in bytes.
+	 * @param modificationTime Set to the last modification time, in seconds.
+	 *                         The epoch is up to the backend.
+	 * @return true if successful, false otherwise.
+	 */
+	virtual bool getFileStatus(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
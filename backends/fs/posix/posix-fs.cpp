@@ -67,6 +67,17 @@ bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
 
+bool POSIXFilesystemNode::getFileStatus(int64 &size, int64 &modificationTime) const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	modificationTime = st.st_mtime;
+	return true;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -276,6 +287,13 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#ifdef HAS_MMAP
+	// Large files are mapped, so that they can be read in place
+	Common::SeekableReadStream *mapped = PosixMmapStream::makeFromPath(getPath());
+	if (mapped)
+		return mapped;
+#endif
+
 	return PosixIoStream::makeFromPath(getPath(), StdioStream::WriteMode_Read);
 }
 
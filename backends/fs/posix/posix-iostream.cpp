@@ -25,6 +25,12 @@
 
 #include <sys/stat.h>
 
+#ifdef HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 PosixIoStream::PosixIoStream(void *handle) :
 		StdioStream(handle) {
 }
@@ -44,3 +50,38 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+#ifdef HAS_MMAP
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	// Leave some address space for everything else on 32-bit systems
+	const uint64 maxMappedSize = (sizeof(void *) < 8) ? 256 * 1024 * 1024 : 0xFFFFFFFF;
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) ||
+	    st.st_size < kMinMappedSize || (uint64)st.st_size > maxMappedSize) {
+		close(fd);
+		return nullptr;
+	}
+
+	// The mapping stays valid once the file is closed
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMmapStream(mapping, st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(void *mapping, uint32 size) :
+		Common::MemoryReadStream((const byte *)mapping, size), _mapping(mapping) {
+}
+
+PosixMmapStream::~PosixMmapStream() {
+	munmap(_mapping, size());
+}
+#endif
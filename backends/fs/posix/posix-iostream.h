@@ -23,6 +23,7 @@
 #define BACKENDS_FS_POSIX_POSIXIOSTREAM_H
 
 #include "backends/fs/stdiostream.h"
+#include "common/memstream.h"
 
 /**
  * A file input / output stream using POSIX interfaces
@@ -39,4 +40,31 @@ public:
 	int64 size() const override;
 };
 
+#ifdef HAS_MMAP
+/**
+ * A read stream for a file mapped into memory, which gives direct access to
+ * the file data through getRangePointer().
+ */
+class PosixMmapStream final : public Common::MemoryReadStream {
+public:
+	enum {
+		/** Smaller files are read through stdio, mapping them does not pay off. */
+		kMinMappedSize = 256 * 1024
+	};
+
+	/**
+	 * Map the file at the given path. Return nullptr if it is not a regular
+	 * file, is too small or too large for being mapped, or mapping it fails.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	~PosixMmapStream() override;
+
+private:
+	PosixMmapStream(void *mapping, uint32 size);
+
+	void *_mapping;
+};
+#endif
+
 #endif
@@ -30,6 +30,7 @@
 #include "graphics/opengl/debug.h"
 
 #include "common/array.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
@@ -787,6 +788,10 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 	_overlay->updateGLTexture();
 
+	const Texture::UploadStats &uploadStats = Texture::getUploadStats();
+	debug(9, "OpenGL: Uploaded %u bytes of texture data in %u updates", (uint)uploadStats.bytes, uploadStats.uploads);
+	Texture::resetUploadStats();
+
 #if !USE_FORCED_GLES
 	if (_libretroPipeline) {
 		_libretroPipeline->beginScaling();
@@ -44,7 +44,7 @@ namespace OpenGL {
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyArea(), _dirtyRegion(32) {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -94,6 +94,61 @@ void Surface::addDirtyArea(const Common::Rect &r) {
 	} else {
 		_dirtyArea.extend(r);
 	}
+
+	if (_allDirty)
+		return;
+
+	const Common::Rect bounds(getWidth(), getHeight());
+	if (_dirtyRegion.getBounds() != bounds) {
+		_dirtyRegion.setBounds(bounds);
+		_dirtyRegion.addRect(_dirtyArea);
+	} else {
+		_dirtyRegion.addRect(r);
+	}
+}
+
+void Surface::getDirtyRects(Common::Array<Common::Rect> &rects) {
+	const Common::Rect dirtyArea = getDirtyArea();
+
+	rects.clear();
+	if (dirtyArea.isEmpty())
+		return;
+
+	if (!_allDirty) {
+		rects = _dirtyRegion.getRects();
+
+		// Without GL_UNPACK_ROW_LENGTH, whole lines are uploaded, so the
+		// rects are merged into bands of lines.
+		if (!OpenGLContext.unpackSubImageSupported && rects.size() > 1) {
+			Common::sort(rects.begin(), rects.end(), [](const Common::Rect &a, const Common::Rect &b) {
+				return a.top < b.top;
+			});
+
+			uint bands = 0;
+			for (uint i = 0; i < rects.size(); i++) {
+				Common::Rect band(0, rects[i].top, getWidth(), rects[i].bottom);
+				if (bands > 0 && band.top <= rects[bands - 1].bottom) {
+					rects[bands - 1].bottom = MAX(rects[bands - 1].bottom, band.bottom);
+				} else {
+					rects[bands++] = band;
+				}
+			}
+			rects.resize(bands);
+		}
+
+		// Each upload has a cost of its own, so only upload the parts
+		// separately when they are a good deal smaller.
+		uint parts = 0;
+		for (uint i = 0; i < rects.size(); i++)
+			parts += rects[i].width() * rects[i].height();
+
+		if (rects.size() > 1 && parts * 2 <= (uint)(dirtyArea.width() * dirtyArea.height()))
+			return;
+
+		rects.clear();
+	}
+
+	rects.push_back(dirtyArea);
 }
 
 Common::Rect Surface::getDirtyArea() const {
@@ -165,12 +220,22 @@ void TextureSurface::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	getDirtyRects(_uploadRects);
+	for (uint i = 0; i < _uploadRects.size(); i++)
+		uploadArea(_uploadRects[i]);
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
 void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
+	uploadArea(dirtyArea);
+
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
+}
+
+void TextureSurface::uploadArea(Common::Rect &dirtyArea) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
@@ -201,9 +266,6 @@ void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
 }
 
 FakeTextureSurface::FakeTextureSurface(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
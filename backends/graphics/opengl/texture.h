@@ -29,7 +29,9 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/blit.h"
+#include "graphics/dirtyregion.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 #include "common/rotationmode.h"
 
@@ -148,13 +150,21 @@ public:
 	 */
 	virtual const Texture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); _dirtyRegion.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
 	Common::Rect getDirtyArea() const;
+
+	/**
+	 * Get the areas of the surface to upload. These are the modified parts
+	 * of it when they are much smaller than the whole dirty area, which is
+	 * returned otherwise.
+	 */
+	void getDirtyRects(Common::Array<Common::Rect> &rects);
 private:
 	bool _allDirty;
 	Common::Rect _dirtyArea;
+	Graphics::DirtyRegion _dirtyRegion;
 };
 
 /**
@@ -202,7 +212,10 @@ protected:
 	void updateGLTexture(Common::Rect &dirtyArea);
 
 private:
+	void uploadArea(Common::Rect &area);
+
 	Texture _glTexture;
+	Common::Array<Common::Rect> _uploadRects;
 
 	Graphics::Surface _textureData;
 	Graphics::Surface _userPixelData;
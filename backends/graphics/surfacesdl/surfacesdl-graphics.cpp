@@ -33,6 +33,7 @@
 #include "common/frac.h"
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
+#include "common/taskscheduler.h"
 #endif
 #include "graphics/blit.h"
 #include "graphics/font.h"
@@ -191,10 +192,12 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
-	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0), _dirtyRegion(20),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0), _disableMouseKeyColor(false) {
 
+	_dirtyRegion.setMinRectHeight(4);
+
 	// allocate palette storage
 	_currentPalette = (SDL_Color *)calloc(256, sizeof(SDL_Color));
 	_overlayPalette = (SDL_Color *)calloc(256, sizeof(SDL_Color));
@@ -719,6 +722,10 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scaler = _scalerPlugin->createInstance(format);
 
+		// Let the worker threads scale parts of the larger rects
+		if (TaskMan.getNumWorkers())
+			_scaler->setBandHeight(16);
+
 		if (_mouseScaler != nullptr) {
 			delete _mouseScaler;
 			_mouseScaler = _scalerPlugin->createInstance(_cursorFormat);
@@ -1376,6 +1383,39 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_numPrevDirtyRects = _numDirtyRects;
 	}
 
+	// Coalesce overlapping and adjacent rects, so that no area is scaled and
+	// copied more than once. The tile size is a multiple of 5 lines and
+	// 2 pixels, so that the coalesced rects stay aligned for aspect ratio
+	// correction. The scalers need rects at least 4 lines high, so thinner
+	// ones are grown, and may overlap others.
+	if (!doRedraw && actualDirtyRects > 1) {
+		const Common::Rect bounds(width, height);
+		if (_dirtyRegion.getBounds() != bounds)
+			_dirtyRegion.setBounds(bounds);
+
+		for (int i = 0; i < actualDirtyRects; i++) {
+			const SDL_Rect &r = _dirtyRectList[i];
+			_dirtyRegion.addRect(Common::Rect(r.x, r.y, r.x + r.w, r.y + r.h));
+		}
+
+		const Common::Array<Common::Rect> &rects = _dirtyRegion.getRects();
+		if (rects.size() <= ARRAYSIZE(_dirtyRectList)) {
+			actualDirtyRects = rects.size();
+			for (int i = 0; i < actualDirtyRects; i++) {
+				int x = rects[i].left, y = rects[i].top, w = rects[i].width(), h = rects[i].height();
+#ifdef USE_ASPECT
+				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
+					makeRectStretchable(x, y, w, h, _videoMode.filtering);
+#endif
+				_dirtyRectList[i].x = x;
+				_dirtyRectList[i].y = y;
+				_dirtyRectList[i].w = w;
+				_dirtyRectList[i].h = h;
+			}
+		}
+		_dirtyRegion.clear();
+	}
+
 	// Only draw anything if necessary
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	bool doPresent = false;
@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -366,6 +367,8 @@ protected:
 	SDL_Rect _prevDirtyRectList[NUM_DIRTY_RECT];
 	int _numPrevDirtyRects;
 
+	Graphics::DirtyRegion _dirtyRegion;
+
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
 		int16 w, h;
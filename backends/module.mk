@@ -215,6 +215,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	tasks/sdl/sdl-tasks.o \
 	timer/sdl/sdl-timer.o
 
 ifndef USE_SDL3
@@ -341,6 +342,7 @@ MODULE_OBJS += \
 	fs/android/android-saf-fs.o \
 	graphics/android/android-graphics.o \
 	mutex/pthread/pthread-mutex.o \
+	tasks/pthread/pthread-tasks.o \
 	networking/basic/android/jni.o \
 	networking/basic/android/socket.o \
 	networking/basic/android/url.o
@@ -454,6 +456,12 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+
+ifdef POSIX
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o \
+	tasks/pthread/pthread-tasks.o
+endif
 endif
 
 ifdef MIYOO
@@ -67,6 +67,7 @@
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/tasks/pthread/pthread-tasks.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -905,6 +906,10 @@ Common::MutexInternal *OSystem_Android::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+Common::WorkerPoolInternal *OSystem_Android::createWorkerPool() {
+	return createPthreadWorkerPoolInternal();
+}
+
 void OSystem_Android::quit() {
 	ENTER();
 
@@ -254,6 +254,7 @@ public:
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	Common::MutexInternal *createMutex() override;
+	Common::WorkerPoolInternal *createWorkerPool() override;
 
 	void quit() override;
 
@@ -28,6 +28,7 @@
 
 #include "backends/platform/ds/osystem_ds.h"
 
+#include "common/archive.h"
 #include "common/config-manager.h"
 #include "common/translation.h"
 
@@ -83,6 +84,9 @@ void OSystem_DS::initBackend() {
 	ConfMan.setInt("autosave_period", 0);
 	ConfMan.setBool("FM_medium_quality", true);
 
+	// There is no memory to spare for keeping unused archive contents
+	Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(0);
+
 	_eventSource = new DSEventSource();
 	_eventManager = new DSEventManager(_eventSource);
 
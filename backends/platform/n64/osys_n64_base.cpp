@@ -32,6 +32,7 @@
 #include "backends/mutex/null/null-mutex.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
+#include "common/archive.h"
 #include "graphics/blit.h"
 
 typedef unsigned long long uint64;
@@ -166,6 +167,9 @@ void OSystem_N64::initBackend() {
 	ConfMan.setBool("FM_medium_quality", true);
 	ConfMan.set("gui_theme", "modern"); // In case of modern theme being present, use it.
 
+	// There is no memory to spare for keeping unused archive contents
+	Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(0);
+
 	FRAM_Init();
 
 	if (FRAM_Detect()) { // Use FlashRAM
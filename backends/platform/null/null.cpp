@@ -48,7 +48,12 @@ typedef void (*sighandler_t)(int);
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
+#ifdef POSIX
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/tasks/pthread/pthread-tasks.h"
+#else
 #include "backends/mutex/null/null-mutex.h"
+#endif
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -56,9 +61,9 @@ typedef void (*sighandler_t)(int);
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
+#include "backends/graphics/null/null-graphics.h"
 
 /*
  * Include header files needed for the getFilesystemFactory() method.
@@ -85,6 +90,9 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#ifdef POSIX
+	virtual Common::WorkerPoolInternal *createWorkerPool();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
@@ -119,6 +127,11 @@ OSystem_NULL::OSystem_NULL(bool silenceLogs) :
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// The tests don't initialize the backend, but may query the screen format
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -187,9 +200,20 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef POSIX
+	// The worker threads need real mutexes
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
 }
 
+#ifdef POSIX
+Common::WorkerPoolInternal *OSystem_NULL::createWorkerPool() {
+	return createPthreadWorkerPoolInternal();
+}
+#endif
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
 	timeval curTime;
@@ -23,6 +23,7 @@
 #define SDL_FUNCTION_POINTER_IS_VOID_POINTER
 
 #include "backends/platform/sdl/sdl.h"
+#include "common/archive.h"
 #include "common/config-manager.h"
 #include "gui/EventRecorder.h"
 #include "common/taskbar.h"
@@ -46,6 +47,7 @@
 #include "backends/events/default/default-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/tasks/sdl/sdl-tasks.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -377,6 +379,10 @@ void OSystem_SDL::initBackend() {
 
 	_audiocdManager = createAudioCDManager();
 
+	// Desktop systems can spare some memory to keep the contents of archives
+	// which are read again and again
+	Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(32 * 1024 * 1024);
+
 	// Setup a custom program icon.
 	_window->setupIcon();
 
@@ -840,6 +846,10 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::WorkerPoolInternal *OSystem_SDL::createWorkerPool() {
+	return createSdlWorkerPoolInternal();
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
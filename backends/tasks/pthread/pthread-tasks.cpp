@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "backends/tasks/pthread/pthread-tasks.h"
+
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * pthreads worker pool implementation
+ */
+class PthreadWorkerPoolInternal final : public Common::WorkerPoolInternal {
+public:
+	PthreadWorkerPoolInternal();
+	~PthreadWorkerPoolInternal() override;
+
+	uint getNumCPUs() override;
+	bool startThread(WorkerProc proc, void *param) override;
+	void joinThreads() override;
+
+	void lock() override { pthread_mutex_lock(&_mutex); }
+	void unlock() override { pthread_mutex_unlock(&_mutex); }
+	void wait() override { pthread_cond_wait(&_cond, &_mutex); }
+	void notifyOne() override { pthread_cond_signal(&_cond); }
+	void notifyAll() override { pthread_cond_broadcast(&_cond); }
+
+	uint64 getMicros() override;
+
+private:
+	struct Thread {
+		pthread_t thread;
+		WorkerProc proc;
+		void *param;
+	};
+
+	static void *threadProc(void *param);
+
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	Common::Array<Thread *> _threads;
+};
+
+
+PthreadWorkerPoolInternal::PthreadWorkerPoolInternal() {
+	if (pthread_mutex_init(&_mutex, nullptr) != 0)
+		warning("pthread_mutex_init() failed");
+	if (pthread_cond_init(&_cond, nullptr) != 0)
+		warning("pthread_cond_init() failed");
+}
+
+PthreadWorkerPoolInternal::~PthreadWorkerPoolInternal() {
+	joinThreads();
+	pthread_cond_destroy(&_cond);
+	pthread_mutex_destroy(&_mutex);
+}
+
+uint PthreadWorkerPoolInternal::getNumCPUs() {
+#ifdef _SC_NPROCESSORS_ONLN
+	const long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+	if (numCPUs > 0)
+		return numCPUs;
+#endif
+	return 1;
+}
+
+void *PthreadWorkerPoolInternal::threadProc(void *param) {
+	Thread *thread = (Thread *)param;
+	thread->proc(thread->param);
+	return nullptr;
+}
+
+bool PthreadWorkerPoolInternal::startThread(WorkerProc proc, void *param) {
+	Thread *thread = new Thread();
+	thread->proc = proc;
+	thread->param = param;
+
+	if (pthread_create(&thread->thread, nullptr, threadProc, thread) != 0) {
+		warning("pthread_create() failed");
+		delete thread;
+		return false;
+	}
+
+	_threads.push_back(thread);
+	return true;
+}
+
+void PthreadWorkerPoolInternal::joinThreads() {
+	for (uint i = 0; i < _threads.size(); i++) {
+		pthread_join(_threads[i]->thread, nullptr);
+		delete _threads[i];
+	}
+	_threads.clear();
+}
+
+uint64 PthreadWorkerPoolInternal::getMicros() {
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+}
+
+Common::WorkerPoolInternal *createPthreadWorkerPoolInternal() {
+	return new PthreadWorkerPoolInternal();
+}
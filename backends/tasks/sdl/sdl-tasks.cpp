@@ -0,0 +1,189 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/tasks/sdl/sdl-tasks.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * SDL worker pool implementation
+ */
+class SdlWorkerPoolInternal final : public Common::WorkerPoolInternal {
+public:
+	SdlWorkerPoolInternal();
+	~SdlWorkerPoolInternal() override;
+
+	uint getNumCPUs() override;
+	bool startThread(WorkerProc proc, void *param) override;
+	void joinThreads() override;
+
+	void lock() override;
+	void unlock() override;
+	void wait() override;
+	void notifyOne() override;
+	void notifyAll() override;
+
+	uint64 getMicros() override;
+
+private:
+	struct Thread {
+		SDL_Thread *thread;
+		WorkerProc proc;
+		void *param;
+	};
+
+	static int SDLCALL threadProc(void *param);
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_Mutex *_mutex;
+	SDL_Condition *_cond;
+#else
+	SDL_mutex *_mutex;
+	SDL_cond *_cond;
+#endif
+	Common::Array<Thread *> _threads;
+};
+
+
+SdlWorkerPoolInternal::SdlWorkerPoolInternal() {
+	_mutex = SDL_CreateMutex();
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	_cond = SDL_CreateCondition();
+#else
+	_cond = SDL_CreateCond();
+#endif
+}
+
+SdlWorkerPoolInternal::~SdlWorkerPoolInternal() {
+	joinThreads();
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_DestroyCondition(_cond);
+#else
+	SDL_DestroyCond(_cond);
+#endif
+	SDL_DestroyMutex(_mutex);
+}
+
+uint SdlWorkerPoolInternal::getNumCPUs() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	return MAX(SDL_GetNumLogicalCPUCores(), 1);
+#elif SDL_VERSION_ATLEAST(2, 0, 0)
+	return MAX(SDL_GetCPUCount(), 1);
+#else
+	// SDL 1.2 cannot tell, so do not start any workers by default
+	return 1;
+#endif
+}
+
+int SDLCALL SdlWorkerPoolInternal::threadProc(void *param) {
+	Thread *thread = (Thread *)param;
+	thread->proc(thread->param);
+	return 0;
+}
+
+bool SdlWorkerPoolInternal::startThread(WorkerProc proc, void *param) {
+	Thread *thread = new Thread();
+	thread->proc = proc;
+	thread->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	thread->thread = SDL_CreateThread(threadProc, "ScummVM worker", thread);
+#else
+	thread->thread = SDL_CreateThread(threadProc, thread);
+#endif
+	if (!thread->thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete thread;
+		return false;
+	}
+
+	_threads.push_back(thread);
+	return true;
+}
+
+void SdlWorkerPoolInternal::joinThreads() {
+	for (uint i = 0; i < _threads.size(); i++) {
+		SDL_WaitThread(_threads[i]->thread, nullptr);
+		delete _threads[i];
+	}
+	_threads.clear();
+}
+
+void SdlWorkerPoolInternal::lock() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_LockMutex(_mutex);
+#else
+	SDL_mutexP(_mutex);
+#endif
+}
+
+void SdlWorkerPoolInternal::unlock() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_UnlockMutex(_mutex);
+#else
+	SDL_mutexV(_mutex);
+#endif
+}
+
+void SdlWorkerPoolInternal::wait() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_WaitCondition(_cond, _mutex);
+#else
+	SDL_CondWait(_cond, _mutex);
+#endif
+}
+
+void SdlWorkerPoolInternal::notifyOne() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_SignalCondition(_cond);
+#else
+	SDL_CondSignal(_cond);
+#endif
+}
+
+void SdlWorkerPoolInternal::notifyAll() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_BroadcastCondition(_cond);
+#else
+	SDL_CondBroadcast(_cond);
+#endif
+}
+
+uint64 SdlWorkerPoolInternal::getMicros() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	return SDL_GetTicksNS() / 1000;
+#elif SDL_VERSION_ATLEAST(2, 0, 0)
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+#else
+	return (uint64)SDL_GetTicks() * 1000;
+#endif
+}
+
+Common::WorkerPoolInternal *createSdlWorkerPoolInternal() {
+	return new SdlWorkerPoolInternal();
+}
+
+#endif
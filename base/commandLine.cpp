@@ -177,6 +177,8 @@ static const char HELP_STRING4[] =
 	"  --enable-gs              Enable Roland GS mode for MIDI playback\n"
 	"  --output-channels=CHANNELS Select output channel count (e.g. 2 for stereo)\n"
 	"  --output-rate=RATE       Select output sample rate in Hz (e.g. 22050)\n"
+	"  --resampler-quality=QUALITY\n"
+	"                           Select the sample rate conversion quality (fast, high)\n"
 	"  --opl-driver=DRIVER      Select AdLib (OPL) emulator (db, mame"
 #ifndef DISABLE_NUKED_OPL
 																	 ", nuked"
@@ -325,6 +327,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("dump_midi", false);
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
+	ConfMan.registerDefault("resampler_quality", "fast");
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
@@ -773,6 +776,11 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_INT("output-rate")
 			END_OPTION
 
+			DO_LONG_OPTION("resampler-quality")
+				if (scumm_stricmp(option, "fast") && scumm_stricmp(option, "high"))
+					usage("Unrecognized resampler quality '%s'", option);
+			END_OPTION
+
 			DO_OPTION_BOOL('f', "fullscreen")
 			END_OPTION
 
@@ -2173,6 +2181,7 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 		"native-mt32",
 		"enable-gs",
 		"opl-driver",
+		"resampler-quality",
 		"talkspeed",
 		"render-mode",
 		"random-seed",
@@ -47,6 +47,7 @@
 #include "common/recorderfile.h"
 #endif
 #include "common/system.h"
+#include "common/taskscheduler.h"
 #include "common/textconsole.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
@@ -887,6 +888,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 			launcherDialog();
 		}
 	}
+	Common::TaskScheduler::destroy();
 #ifdef USE_SDL_NET
 	Networking::LocalWebserver::destroy();
 #endif
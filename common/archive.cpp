@@ -25,6 +25,7 @@
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
 #include "common/punycode.h"
 #include "common/debug.h"
 
@@ -230,6 +231,72 @@ void Archive::prepareMaps() const {
 	}
 }
 
+namespace {
+
+Mutex *g_archiveCacheMutex = nullptr; // Kept until exit, like the String memory pool mutex
+
+/**
+ * Guards the contents caches of all MemcachingCaseInsensitiveArchive, since
+ * the global budget lets any archive evict the contents of the others.
+ *
+ * The Mutex class can only be used once g_system is set and initialized, but
+ * archives may be used earlier than that. Hopefully there are no other
+ * threads in those early stages.
+ */
+class ArchiveCacheLock {
+public:
+	ArchiveCacheLock() : _mutex(nullptr) {
+		if (!g_system || !g_system->backendInitialized())
+			return;
+		if (!g_archiveCacheMutex)
+			g_archiveCacheMutex = new Mutex();
+		_mutex = g_archiveCacheMutex;
+		_mutex->lock();
+	}
+
+	~ArchiveCacheLock() {
+		if (_mutex)
+			_mutex->unlock();
+	}
+
+private:
+	Mutex *_mutex;
+};
+
+} // End of anonymous namespace
+
+MemcachingCaseInsensitiveArchive *MemcachingCaseInsensitiveArchive::_firstArchive = nullptr;
+uint32 MemcachingCaseInsensitiveArchive::_globalCacheLimit = MemcachingCaseInsensitiveArchive::kDefaultGlobalCacheLimit;
+uint64 MemcachingCaseInsensitiveArchive::_globalCachedBytes = 0;
+uint32 MemcachingCaseInsensitiveArchive::_useCounter = 0;
+uint32 MemcachingCaseInsensitiveArchive::_hits = 0;
+uint32 MemcachingCaseInsensitiveArchive::_misses = 0;
+uint32 MemcachingCaseInsensitiveArchive::_evictions = 0;
+
+MemcachingCaseInsensitiveArchive::MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize)
+	: _cachedBytes(0), _purgeSize(64), _maxStronglyCachedSize(maxStronglyCachedSize), _cacheLimit(kDefaultCacheLimit),
+	  _prevArchive(nullptr), _nextArchive(nullptr) {
+	ArchiveCacheLock lock;
+
+	_nextArchive = _firstArchive;
+	if (_firstArchive)
+		_firstArchive->_prevArchive = this;
+	_firstArchive = this;
+}
+
+MemcachingCaseInsensitiveArchive::~MemcachingCaseInsensitiveArchive() {
+	ArchiveCacheLock lock;
+
+	_globalCachedBytes -= _cachedBytes;
+
+	if (_prevArchive)
+		_prevArchive->_nextArchive = _nextArchive;
+	else
+		_firstArchive = _nextArchive;
+	if (_nextArchive)
+		_nextArchive->_prevArchive = _prevArchive;
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(const Path &path) const {
 	return createReadStreamForMemberImpl(path, false, Common::AltStreamType::Invalid);
 }
@@ -249,50 +316,176 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberI
 	cacheKey.path = translatePath(path);
 	cacheKey.altStreamType = isAltStream ? altStreamType : AltStreamType::Invalid;
 
-	bool isNew = false;
-	if (!_cache.contains(cacheKey)) {
-		SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
-		if (readResult._bypass)
-			return readResult._bypass;
-		_cache[cacheKey] = readResult;
-		isNew = true;
+	{
+		ArchiveCacheLock lock;
+
+		// Check whether the entry is still valid as WeakPtr might have expired.
+		CacheMap::iterator it = _cache.find(cacheKey);
+		if (it != _cache.end() && it->_value.contents.makeStrong()) {
+			_hits++;
+			return createStreamForEntry(cacheKey, it->_value);
+		}
+
+		_misses++;
 	}
 
-	SharedArchiveContents* entry = &_cache[cacheKey];
+	// The contents are read without the lock, so that the other archives
+	// can be used meanwhile
+	SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
+	if (readResult._bypass)
+		return readResult._bypass;
 
-	// Errors and missing files. Just return nullptr,
-	// no need to create stream.
-	if (entry->isFileMissing())
-		return nullptr;
+	ArchiveCacheLock lock;
 
-	// Check whether the entry is still valid as WeakPtr might have expired.
-	if (!entry->makeStrong()) {
-		// If it's expired, recreate the entry.
-		SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
-		if (readResult._bypass)
-			return readResult._bypass;
-		_cache[cacheKey] = readResult;
-		entry = &_cache[cacheKey];
-		isNew = true;
+	CacheMap::iterator it = _cache.find(cacheKey);
+	if (it == _cache.end()) {
+		if (_cache.size() >= _purgeSize) {
+			purgeExpired();
+			_purgeSize = MAX<uint32>(64, _cache.size() * 2);
+		}
+
+		_cache[cacheKey] = CacheEntry(readResult);
+		it = _cache.find(cacheKey);
+	} else if (!it->_value.contents.makeStrong()) {
+		it->_value.contents = readResult;
 	}
 
-	// It's possible that recreation failed in case of e.g. network
-	// share going offline.
-	if (entry->isFileMissing())
+	return createStreamForEntry(cacheKey, it->_value);
+}
+
+SeekableReadStream *MemcachingCaseInsensitiveArchive::createStreamForEntry(const CacheKey &key, CacheEntry &entry) const {
+	// Errors and missing files. Just return nullptr,
+	// no need to create stream. This includes recreation failing
+	// in case of e.g. network share going offline.
+	if (entry.contents.isFileMissing())
 		return nullptr;
 
 	// Now we have a valid contents reference. Make stream for it.
-	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->getContents(), entry->getSize());
+	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry.contents.getContents(), entry.contents.getSize());
 
-	// If the entry was just created and it's too big for strong caching,
-	// mark the copy in cache as weak
-	if (isNew && entry->getSize() > _maxStronglyCachedSize) {
-		entry->makeWeak();
-	}
+	// This may drop the entry, the stream keeps the contents alive
+	touchEntry(key, entry);
 
 	return memStream;
 }
 
+void MemcachingCaseInsensitiveArchive::touchEntry(const CacheKey &key, CacheEntry &entry) const {
+	const uint32 size = entry.contents.getSize();
+
+	// Small contents are always kept
+	if (size <= _maxStronglyCachedSize)
+		return;
+
+	// Contents which do not fit only live as long as their streams
+	if (size > _cacheLimit || size > _globalCacheLimit) {
+		entry.contents.makeWeak();
+		return;
+	}
+
+	entry.lastUse = ++_useCounter;
+
+	if (entry.inLRU) {
+		_lru.erase(entry.lru);
+	} else {
+		entry.inLRU = true;
+		_cachedBytes += size;
+		_globalCachedBytes += size;
+	}
+
+	_lru.push_front(key);
+	entry.lru = _lru.begin();
+
+	while (_cachedBytes > _cacheLimit)
+		evictOldest();
+	trimGlobalCache();
+}
+
+void MemcachingCaseInsensitiveArchive::evictOldest() const {
+	assert(!_lru.empty());
+
+	CacheMap::iterator it = _cache.find(_lru.back());
+	_lru.pop_back();
+	assert(it != _cache.end());
+
+	CacheEntry &entry = it->_value;
+	const uint32 size = entry.contents.getSize();
+	_cachedBytes -= size;
+	_globalCachedBytes -= size;
+	_evictions++;
+
+	entry.inLRU = false;
+	entry.contents.makeWeak();
+
+	// Forget about it unless streams still use the contents
+	if (entry.contents.isExpired())
+		_cache.erase(it);
+}
+
+void MemcachingCaseInsensitiveArchive::purgeExpired() const {
+	for (CacheMap::iterator it = _cache.begin(); it != _cache.end(); ++it) {
+		if (it->_value.contents.isExpired())
+			_cache.erase(it);
+	}
+}
+
+void MemcachingCaseInsensitiveArchive::trimGlobalCache() {
+	while (_globalCachedBytes > _globalCacheLimit) {
+		// Evict the least recently used contents of all archives
+		const MemcachingCaseInsensitiveArchive *oldest = nullptr;
+		uint32 oldestUse = 0;
+
+		for (const MemcachingCaseInsensitiveArchive *archive = _firstArchive; archive; archive = archive->_nextArchive) {
+			if (archive->_lru.empty())
+				continue;
+
+			// Compare the ages relative to the current use, in case the counter wrapped
+			const uint32 use = archive->_cache.getVal(archive->_lru.back()).lastUse;
+			if (!oldest || _useCounter - use > _useCounter - oldestUse) {
+				oldest = archive;
+				oldestUse = use;
+			}
+		}
+
+		if (!oldest)
+			break;
+
+		oldest->evictOldest();
+	}
+}
+
+void MemcachingCaseInsensitiveArchive::setCacheLimit(uint32 maxCachedBytes) {
+	ArchiveCacheLock lock;
+	_cacheLimit = maxCachedBytes;
+
+	while (_cachedBytes > _cacheLimit)
+		evictOldest();
+}
+
+void MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(uint32 maxCachedBytes) {
+	ArchiveCacheLock lock;
+	_globalCacheLimit = maxCachedBytes;
+	trimGlobalCache();
+}
+
+MemcachingCaseInsensitiveArchive::CacheStats MemcachingCaseInsensitiveArchive::getGlobalCacheStats() {
+	ArchiveCacheLock lock;
+
+	CacheStats stats;
+	stats.archives = 0;
+	stats.entries = 0;
+	stats.cachedBytes = _globalCachedBytes;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictions = _evictions;
+
+	for (const MemcachingCaseInsensitiveArchive *archive = _firstArchive; archive; archive = archive->_nextArchive) {
+		stats.archives++;
+		stats.entries += archive->_cache.size();
+	}
+
+	return stats;
+}
+
 SharedArchiveContents MemcachingCaseInsensitiveArchive::readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const {
 	return SharedArchiveContents();
 }
@@ -338,6 +531,78 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	if (_indexValid)
+		addToIndex(node);
+}
+
+void SearchSet::setUseIndex(bool useIndex) {
+	_useIndex = useIndex;
+	invalidateIndex();
+}
+
+void SearchSet::invalidateIndex() const {
+	_index.clear(true);
+	_indexValid = false;
+}
+
+void SearchSet::addToIndex(const Node &node) const {
+	// The other archives are asked for each lookup anyway
+	if (!node._arc->isMemberListComplete())
+		return;
+
+	ArchiveMemberList members;
+	node._arc->listMembers(members);
+
+	// The archive with the highest priority wins, and the first one added
+	// among archives of the same priority, as with the search through the list
+	for (const auto &member : members) {
+		const Path memberPath = member->getPathInArchive();
+		IndexMap::iterator i = _index.find(memberPath);
+		if (i == _index.end() || i->_value.priority < node._priority) {
+			IndexEntry &entry = _index[memberPath];
+			entry.arc = node._arc;
+			entry.priority = node._priority;
+		}
+	}
+}
+
+bool SearchSet::findInIndex(const Path &path, Archive *&arc) const {
+	if (!_useIndex)
+		return false;
+
+	if (!_indexValid) {
+		for (const auto &archive : _list)
+			addToIndex(archive);
+		_indexValid = true;
+	}
+
+	Archive *indexed = nullptr;
+	IndexMap::const_iterator i = _index.find(path);
+	if (i != _index.end()) {
+		// Archives other than FSDirectory may not take the Mac encoded
+		// name, and the member matching it exactly may be hidden by this one
+		if (!i->_key.equalsIgnoreCase(path)) {
+			_indexMisses++;
+			return false;
+		}
+		indexed = i->_value.arc;
+	}
+
+	// Archives with a higher priority which do not list all their members
+	// may provide the path, and win over the indexed one then
+	_indexHits++;
+	for (const auto &archive : _list) {
+		if (archive._arc == indexed)
+			break;
+
+		if (!archive._arc->isMemberListComplete() && archive._arc->hasFile(path)) {
+			arc = archive._arc;
+			return true;
+		}
+	}
+
+	arc = indexed;
+	return true;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -434,6 +699,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -457,6 +723,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -471,6 +738,7 @@ void SearchSet::setPriority(const String &name, int priority) {
 
 	Node node(*it);
 	_list.erase(it);
+	invalidateIndex();
 	node._priority = priority;
 	insert(node);
 }
@@ -479,6 +747,10 @@ bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
+	Archive *indexed;
+	if (findInIndex(path, indexed))
+		return indexed != nullptr;
+
 	for (const auto &archive : _list) {
 		if (archive._arc->hasFile(path))
 			return true;
@@ -559,6 +831,16 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
+	Archive *indexed;
+	if (findInIndex(path, indexed)) {
+		if (!indexed)
+			return ArchiveMemberPtr();
+		if (container) {
+			*container = indexed;
+		}
+		return indexed->getMember(path);
+	}
+
 	for (const auto &archive : _list) {
 		if (archive._arc->hasFile(path)) {
 			if (container) {
@@ -579,6 +861,10 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	Archive *indexed;
+	if (findInIndex(path, indexed))
+		return indexed ? indexed->createReadStreamForMember(path) : nullptr;
+
 	for (const auto &archive : _list) {
 		SeekableReadStream *stream = archive._arc->createReadStreamForMember(path);
 		if (stream)
@@ -621,6 +907,8 @@ SeekableReadStream *SearchSet::createReadStreamForMemberNext(const Path &path, c
 }
 
 SearchManager::SearchManager() {
+	// Engines look up many files through SearchMan, often in many archives
+	setUseIndex(true);
 	clear(); // Force a reset
 }
 
@@ -175,6 +175,13 @@ public:
 	 */
 	virtual int listMembers(ArchiveMemberList &list) const = 0;
 
+	/**
+	 * Return whether hasFile() only accepts the paths of the members added
+	 * by listMembers(), ignoring case. This lets SearchSet answer lookups
+	 * from its merged file index without asking the archive.
+	 */
+	virtual bool isMemberListComplete() const { return false; }
+
 	/**
 	 * Return an ArchiveMember representation of the given file.
 	 */
@@ -256,6 +263,11 @@ private:
 	SharedPtr<byte> getContents() const { return _strongRef; }
 	uint32 getSize() const { return _contentSize; }
 
+	/** Whether the contents are gone since no stream uses them anymore. */
+	bool isExpired() const {
+		return !_strongRef && _contentSize != 0 && !_missingFile && _weakRef.expired();
+	}
+
 	bool makeStrong() {
 		if (_strongRef || _contentSize == 0 || _missingFile)
 			return true;
@@ -283,10 +295,38 @@ private:
 
 /**
  * An archive that caches the resulting contents.
+ *
+ * Contents up to maxStronglyCachedSize bytes are kept as long as the archive
+ * exists. Larger contents are kept while streams use them, and afterwards
+ * within a byte budget per archive and a global one shared by all such
+ * archives, dropping the least recently used contents first. The caches
+ * of different archives may be used from different threads.
  */
 class MemcachingCaseInsensitiveArchive : public Archive {
 public:
-	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512) : _maxStronglyCachedSize(maxStronglyCachedSize) {}
+	enum {
+		/** Default number of bytes of unused contents an archive keeps. */
+		kDefaultCacheLimit = 8 * 1024 * 1024,
+		/**
+		 * Default number of bytes of unused contents kept by all archives
+		 * together. Backends short of memory lower it, and the ones with
+		 * memory to spare raise it, see setGlobalCacheLimit().
+		 */
+		kDefaultGlobalCacheLimit = 4 * 1024 * 1024
+	};
+
+	struct CacheStats {
+		uint32 archives;    ///< Number of archives
+		uint32 entries;     ///< Number of cached entries, including missing files
+		uint64 cachedBytes; ///< Bytes of contents kept within the budgets
+		uint32 hits;        ///< Streams created from cached contents
+		uint32 misses;      ///< Streams for which the contents had to be read
+		uint32 evictions;   ///< Contents dropped to stay within the budgets
+	};
+
+	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512);
+	~MemcachingCaseInsensitiveArchive();
+
 	SeekableReadStream *createReadStreamForMember(const Path &path) const;
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, Common::AltStreamType altStreamType) const;
 
@@ -297,6 +337,22 @@ public:
 	virtual SharedArchiveContents readContentsForPath(const Path &translatedPath) const = 0;
 	virtual SharedArchiveContents readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const;
 
+	/**
+	 * Set the number of bytes of contents this archive keeps once no stream
+	 * uses them anymore.
+	 */
+	void setCacheLimit(uint32 maxCachedBytes);
+
+	/**
+	 * Set the number of bytes of contents all archives together keep once
+	 * no stream uses them anymore.
+	 */
+	static void setGlobalCacheLimit(uint32 maxCachedBytes);
+	static uint32 getGlobalCacheLimit() { return _globalCacheLimit; }
+
+	/** Get the statistics of all archives together. */
+	static CacheStats getGlobalCacheStats();
+
 private:
 	struct CacheKey {
 		CacheKey();
@@ -305,6 +361,18 @@ private:
 		AltStreamType altStreamType;
 	};
 
+	typedef List<CacheKey> CacheKeyList;
+
+	struct CacheEntry {
+		SharedArchiveContents contents;
+		bool inLRU;                  ///< Whether the contents are kept within the budgets
+		CacheKeyList::iterator lru;  ///< Position in _lru if inLRU is set
+		uint32 lastUse;              ///< Value of _useCounter when last used
+
+		CacheEntry() : inLRU(false), lastUse(0) {}
+		CacheEntry(const SharedArchiveContents &c) : contents(c), inLRU(false), lastUse(0) {}
+	};
+
 	struct CacheKey_EqualTo {
 		bool operator()(const CacheKey &x, const CacheKey &y) const;
 	};
@@ -314,9 +382,37 @@ private:
 	};
 
 	SeekableReadStream *createReadStreamForMemberImpl(const Path &path, bool isAltStream, Common::AltStreamType altStreamType) const;
-
-	mutable HashMap<CacheKey, SharedArchiveContents, CacheKey_Hash, CacheKey_EqualTo> _cache;
+	/** Make a stream for the contents of an entry, with the cache lock held. */
+	SeekableReadStream *createStreamForEntry(const CacheKey &key, CacheEntry &entry) const;
+
+	/** Keep the contents of a used entry within the budgets, if possible. */
+	void touchEntry(const CacheKey &key, CacheEntry &entry) const;
+	/** Drop the least recently used contents of this archive. */
+	void evictOldest() const;
+	/** Remove the entries whose contents are gone. */
+	void purgeExpired() const;
+	/** Stay within the global budget. */
+	static void trimGlobalCache();
+
+	typedef HashMap<CacheKey, CacheEntry, CacheKey_Hash, CacheKey_EqualTo> CacheMap;
+	mutable CacheMap _cache;
+	mutable CacheKeyList _lru;   ///< Keys of the entries within the budgets, most recently used first
+	mutable uint64 _cachedBytes; ///< Bytes of the entries in _lru
+	mutable uint32 _purgeSize;   ///< Size of _cache above which expired entries get removed
 	uint32 _maxStronglyCachedSize;
+	uint32 _cacheLimit;
+
+	// All the archives, for the global budget and statistics
+	MemcachingCaseInsensitiveArchive *_prevArchive;
+	MemcachingCaseInsensitiveArchive *_nextArchive;
+	static MemcachingCaseInsensitiveArchive *_firstArchive;
+
+	static uint32 _globalCacheLimit;
+	static uint64 _globalCachedBytes;
+	static uint32 _useCounter;
+	static uint32 _hits;
+	static uint32 _misses;
+	static uint32 _evictions;
 };
 
 /**
@@ -347,8 +443,34 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	struct IndexEntry {
+		Archive *arc;
+		int priority;
+	};
+
+	// Like FSDirectory, the index also matches Mac encoded names
+	typedef HashMap<Path, IndexEntry, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> IndexMap;
+	mutable IndexMap _index;
+	mutable bool _indexValid;
+	bool _useIndex;
+	mutable uint32 _indexHits;
+	mutable uint32 _indexMisses;
+
+	/** Add the members of an archive with a complete member list to the merged index. */
+	void addToIndex(const Node &node) const;
+
+	/**
+	 * Look up the archive which provides @p path with the merged index,
+	 * building the index first if needed.
+	 *
+	 * @param arc Set to the archive, or nullptr if no archive provides it.
+	 * @return Whether the index could answer, otherwise all the archives
+	 *         have to be searched.
+	 */
+	bool findInIndex(const Path &path, Archive *&arc) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _ignoreClashes(false), _indexValid(false), _useIndex(false), _indexHits(0), _indexMisses(0) { }
 	virtual ~SearchSet() { clear(); }
 
 	char getPathSeparator() const override { return '/'; }
@@ -476,6 +598,45 @@ public:
 	 */
 	void setIgnoreClashes(bool ignoreClashes) { _ignoreClashes = ignoreClashes; }
 
+	/**
+	 * Enable or disable the merged file index.
+	 *
+	 * When enabled, hasFile(), getMember() and createReadStreamForMember()
+	 * look the path up in a map from the members of the archives whose
+	 * member list is complete (see Archive::isMemberListComplete()) to the
+	 * one listing them with the highest priority. Only the other archives,
+	 * which may accept more paths than they list, are asked in turn, and
+	 * only the ones with a higher priority than the indexed archive.
+	 *
+	 * The index is built from listMembers() on the first lookup, extended
+	 * when archives are added, and rebuilt after archives are removed or
+	 * reprioritized. It is enabled for SearchMan.
+	 *
+	 * The index does not notice when the contents of an archive change.
+	 * Call invalidateIndex() in that case. Like the archives, which cache
+	 * their contents on demand, it must not be used from several threads
+	 * at once.
+	 */
+	void setUseIndex(bool useIndex);
+
+	/**
+	 * Drop the merged file index, it gets rebuilt on the next lookup.
+	 */
+	void invalidateIndex() const;
+
+	/**
+	 * Number of lookups answered by the merged file index, including the
+	 * ones of paths which no archive provides.
+	 */
+	uint32 getIndexHits() const { return _indexHits; }
+
+	/**
+	 * Number of lookups which had to search all the archives although the
+	 * merged file index is enabled. This happens for names which only match
+	 * an indexed member once Mac encoded.
+	 */
+	uint32 getIndexMisses() const { return _indexMisses; }
+
 	bool getChildren(const Common::Path &path, Common::Array<Common::String> &list, ListMode mode = kListDirectoriesOnly, bool hidden = true) const override;
 };
 
@@ -0,0 +1,147 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic values
+ * @ingroup common
+ *
+ * @brief Minimal atomic value wrapper for data shared between threads.
+ *
+ * This is meant for the few places where a backend thread (audio callback,
+ * timer) and the engine thread exchange small values without taking a
+ * mutex. Only 32-bit integer types are supported.
+ *
+ * Loads have acquire semantics, stores have release semantics and
+ * read-modify-write operations are sequentially consistent. On compilers
+ * without atomic intrinsics, which only exist on single-threaded ports,
+ * the operations degrade to plain volatile accesses.
+ * @{
+ */
+
+template<typename T>
+class Atomic {
+public:
+	Atomic() : _value(T()) {}
+	explicit Atomic(T value) : _value(value) {}
+
+	/** Read the current value. */
+	T load() const {
+#if defined(__GNUC__) || defined(__clang__)
+		return __atomic_load_n(&_value, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+		return fromMSVC(_InterlockedCompareExchange(msvcPtr(), 0, 0));
+#else
+		return _value;
+#endif
+	}
+
+	/** Replace the current value. */
+	void store(T value) {
+#if defined(__GNUC__) || defined(__clang__)
+		__atomic_store_n(&_value, value, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+		_InterlockedExchange(msvcPtr(), toMSVC(value));
+#else
+		_value = value;
+#endif
+	}
+
+	/** Replace the current value and return the previous one. */
+	T exchange(T value) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __atomic_exchange_n(&_value, value, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+		return fromMSVC(_InterlockedExchange(msvcPtr(), toMSVC(value)));
+#else
+		T old = _value;
+		_value = value;
+		return old;
+#endif
+	}
+
+	/**
+	 * Replace the current value with @p desired if it equals @p expected.
+	 *
+	 * @return true if the value was replaced.
+	 */
+	bool compareExchange(T expected, T desired) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __atomic_compare_exchange_n(&_value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+		return _InterlockedCompareExchange(msvcPtr(), toMSVC(desired), toMSVC(expected)) == toMSVC(expected);
+#else
+		if (_value != expected)
+			return false;
+		_value = desired;
+		return true;
+#endif
+	}
+
+	/** Add @p delta to the current value and return the previous one. */
+	T fetchAdd(T delta) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __atomic_fetch_add(&_value, delta, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+		return fromMSVC(_InterlockedExchangeAdd(msvcPtr(), toMSVC(delta)));
+#else
+		T old = _value;
+		_value += delta;
+		return old;
+#endif
+	}
+
+	/** Subtract @p delta from the current value and return the previous one. */
+	T fetchSub(T delta) {
+		return fetchAdd(T(0) - delta);
+	}
+
+private:
+	// Prevent copying instances by accident
+	Atomic(const Atomic &);
+	Atomic &operator=(const Atomic &);
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	// MSVC only offers the 32-bit intrinsics on long, so the value is
+	// accessed as such and converted back.
+	volatile long *msvcPtr() const { return (volatile long *)&_value; }
+	static long toMSVC(T value) { return (long)value; }
+	static T fromMSVC(long value) { return (T)value; }
+#endif
+
+	volatile T _value;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -144,12 +144,19 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped,
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  *
+ * If a checkpoint interval is given, the decompressor state is saved every
+ * time that many bytes have been decompressed, which makes seeking back
+ * cheap at the cost of about 40 KB of memory per checkpoint. This is only
+ * supported when ZLIB is available, otherwise seeking back restarts the
+ * decompression from the start.
+ *
  * @param toBeWrapped	the stream to be wrapped (if it is in gzip-format)
  * @param knownSize	a supplied length of the uncompressed data (if not available directly)
+ * @param checkpointInterval	the number of decompressed bytes between checkpoints, 0 for none
  */
 SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped,
 		DisposeAfterUse::Flag disposeParent = DisposeAfterUse::YES, uint64 knownSize = 0,
-		const byte *dict = nullptr, uint dictLen = 0);
+		const byte *dict = nullptr, uint dictLen = 0, uint32 checkpointInterval = 0);
 
 /**
  * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
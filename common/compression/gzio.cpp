@@ -1373,10 +1373,11 @@ SeekableReadStream* wrapCompressedReadStream(Common::SeekableReadStream *parent,
 	return gzio;
 }
 
-SeekableReadStream* wrapDeflateReadStream(Common::SeekableReadStream *parent, DisposeAfterUse::Flag disposeParent, uint64 knownSize, const byte *dict, uint dictLen) {
+SeekableReadStream* wrapDeflateReadStream(Common::SeekableReadStream *parent, DisposeAfterUse::Flag disposeParent, uint64 knownSize, const byte *dict, uint dictLen, uint32 checkpointInterval) {
 	if (!parent)
 		return nullptr;
 
+	// Checkpoints are not supported, seeking back restarts the decompression
 	GzioReadStream *gzio = new GzioReadStream(parent, disposeParent, knownSize, GzioReadStream::Mode::ZLIB, dict, dictLen);
 	gzio->initialize_tables();
 
@@ -95,6 +95,9 @@ typedef Byte Bytef;
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/substream.h"
+#include "common/system.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -325,6 +328,8 @@ typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCa
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owns _stream, shared with the streamed members */
+	Common::SharedPtr<Common::Mutex> _streamMutex;	/* serializes the accesses to _stream, null without OSystem */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +464,9 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef.reset(stream);
+	if (g_system)
+		us->_streamMutex.reset(new Common::Mutex());
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -489,7 +497,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_ERRNO;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -516,7 +523,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -606,7 +612,7 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
+	// The zipfile stream is deleted along with the last streamed member
 	delete s;
 	return UNZ_OK;
 }
@@ -989,11 +995,22 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 
 	uint32 crc32_wait = s->cur_file_info.crc;
 
-	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
-	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
+	const uint32 dataOffset = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	byte *compressedBuffer = nullptr;
 	byte *uncompressedBuffer = nullptr;
 
+	// Inflate directly from the zipfile data if it is in memory
+	const byte *compressedData = nullptr;
+	if (s->cur_file_info.compression_method == Z_DEFLATED)
+		compressedData = s->_stream->getRangePointer(dataOffset, s->cur_file_info.compressed_size);
+
+	if (!compressedData) {
+		compressedBuffer = new byte[s->cur_file_info.compressed_size];
+		s->_stream->seek(dataOffset);
+		s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
+		compressedData = compressedBuffer;
+	}
+
 	switch (s->cur_file_info.compression_method) {
 	case 0: // Store
 		uncompressedBuffer = compressedBuffer;
@@ -1001,7 +1018,7 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	case Z_DEFLATED:
 		uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
 		assert(s->cur_file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
-		Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedBuffer, s->cur_file_info.compressed_size);
+		Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedData, s->cur_file_info.compressed_size);
 		delete[] compressedBuffer;
 		compressedBuffer = nullptr;
 		break;
@@ -1024,6 +1041,86 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
+namespace {
+
+/**
+ * The stored data of a streamed member, which keeps the zipfile stream
+ * alive so that the member may outlive its archive. The zipfile stream is
+ * shared with the archive and the other streamed members, which may be read
+ * on other threads, so it is locked while it is positioned and read.
+ */
+class ZipMemberReadStream : public Common::SafeSeekableSubReadStream {
+public:
+	ZipMemberReadStream(const Common::SharedPtr<Common::SeekableReadStream> &parentStream, const Common::SharedPtr<Common::Mutex> &mutex, uint32 begin, uint32 end) :
+			Common::SafeSeekableSubReadStream(parentStream.get(), begin, end, DisposeAfterUse::NO), _parentRef(parentStream), _mutex(mutex) {
+	}
+
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		if (!_mutex)
+			return Common::SafeSeekableSubReadStream::seek(offset, whence);
+
+		Common::StackLock lock(*_mutex);
+		return Common::SafeSeekableSubReadStream::seek(offset, whence);
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		if (!_mutex)
+			return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
+
+		Common::StackLock lock(*_mutex);
+		return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
+	}
+
+private:
+	Common::SharedPtr<Common::SeekableReadStream> _parentRef;
+	Common::SharedPtr<Common::Mutex> _mutex;
+};
+
+} // End of anonymous namespace
+
+/*
+  Open the current file in the zipfile for reading, without decompressing it
+  in advance. The stream reads from the zipfile stream, which it shares with
+  the archive. Unlike unzOpenCurrentFile, the CRC is not checked.
+*/
+static Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file) {
+	uInt iSizeVar;
+	unz_s *s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file == nullptr)
+		return nullptr;
+	s = (unz_s *)file;
+	if (!s->current_file_ok)
+		return nullptr;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
+		return nullptr;
+
+	const uint32 begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	const uint32 end = begin + s->cur_file_info.compressed_size;
+
+	// Other members may be read from the zipfile stream meanwhile
+	Common::SeekableReadStream *data = new ZipMemberReadStream(s->_streamRef, s->_streamMutex, begin, end);
+
+	switch (s->cur_file_info.compression_method) {
+	case 0: // Store
+		return data;
+	case Z_DEFLATED: {
+		// Keep up to 64 checkpoints, so that seeking back does not have to
+		// start over from the beginning of the member
+		const uint32 checkpointInterval = MAX<uint32>(s->cur_file_info.uncompressed_size / 64, 256 * 1024);
+		return Common::wrapDeflateReadStream(data, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size, nullptr, 0, checkpointInterval);
+	}
+	default:
+		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		delete data;
+		return nullptr;
+	}
+}
+
 
 namespace Common {
 
@@ -1034,9 +1131,13 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	Common::CRC32 _crc;
 #endif
 	bool _flattenTree;
+	uint32 _streamingThreshold;
+
+	/** Read a member, with the zipfile stream locked. */
+	Common::SharedArchiveContents readContentsForPathLocked(const Common::Path &path) const;
 
 public:
-	ZipArchive(unzFile zipFile, bool flattenTree);
+	ZipArchive(unzFile zipFile, bool flattenTree, uint32 streamingThreshold);
 
 
 	~ZipArchive();
@@ -1044,6 +1145,7 @@ public:
 	bool hasFile(const Path &path) const override;
 	bool isPathDirectory(const Path &path) const override;
 	int listMembers(ArchiveMemberList &list) const override;
+	bool isMemberListComplete() const override { return true; }
 	const ArchiveMemberPtr getMember(const Path &path) const override;
 	Common::SharedArchiveContents readContentsForPath(const Common::Path &translated) const override;
 	Common::Path translatePath(const Common::Path &path) const override {
@@ -1069,7 +1171,7 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : _zipFile(zipFile), _flattenTree(flattenTree) {
+ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree, uint32 streamingThreshold) : _zipFile(zipFile), _flattenTree(flattenTree), _streamingThreshold(streamingThreshold) {
 	assert(_zipFile);
 }
 
@@ -1112,8 +1214,30 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 }
 
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
+	// Streamed members may be reading from the zipfile stream on other threads
+	const Common::SharedPtr<Common::Mutex> &mutex = ((const unz_s *)_zipFile)->_streamMutex;
+	if (mutex)
+		mutex->lock();
+	Common::SharedArchiveContents contents = readContentsForPathLocked(path);
+	if (mutex)
+		mutex->unlock();
+	return contents;
+}
+
+Common::SharedArchiveContents ZipArchive::readContentsForPathLocked(const Common::Path &path) const {
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+	// Large members are not cached, but decompressed while being read
+	unz_file_info fi;
+	if (_streamingThreshold && unzGetCurrentFileInfo(_zipFile, &fi, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+	    fi.uncompressed_size > _streamingThreshold) {
+		Common::SeekableReadStream *stream = unzOpenCurrentFileStream(_zipFile);
+		if (!stream)
+			return Common::SharedArchiveContents();
+		return Common::SharedArchiveContents::bypass(stream);
+	}
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
@@ -1121,15 +1245,15 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path
 #endif
 }
 
-Archive *makeZipArchive(const Path &name, bool flattenTree) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree);
+Archive *makeZipArchive(const Path &name, bool flattenTree, uint32 streamingThreshold) {
+	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree, streamingThreshold);
 }
 
-Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
+Archive *makeZipArchive(const FSNode &node, bool flattenTree, uint32 streamingThreshold) {
+	return makeZipArchive(node.createReadStream(), flattenTree, streamingThreshold);
 }
 
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree, uint32 streamingThreshold) {
 	if (!stream)
 		return nullptr;
 	unzFile zipFile = unzOpen(stream, flattenTree);
@@ -1138,7 +1262,7 @@ Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile, flattenTree);
+	return new ZipArchive(zipFile, flattenTree, streamingThreshold);
 }
 
 } // End of namespace Common
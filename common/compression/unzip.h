@@ -39,21 +39,36 @@ class Archive;
 class FSNode;
 class SeekableReadStream;
 
+enum {
+	/**
+	 * Default size above which ZIP members are decompressed while they are
+	 * read, instead of being decompressed and cached as a whole when opened.
+	 */
+	kZipStreamingThreshold = 1024 * 1024
+};
+
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * Members larger than @p streamingThreshold bytes are decompressed while
+ * being read. Their streams keep the archive file open, so that they may
+ * outlive the archive like the other members. Pass 0 to always decompress
+ * members as a whole.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const Path &name, bool flattenTree = false);
+Archive *makeZipArchive(const Path &name, bool flattenTree = false, uint32 streamingThreshold = kZipStreamingThreshold);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * See above for @p streamingThreshold.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const FSNode &node, bool flattenTree = false);
+Archive *makeZipArchive(const FSNode &node, bool flattenTree = false, uint32 streamingThreshold = kZipStreamingThreshold);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
@@ -61,9 +76,11 @@ Archive *makeZipArchive(const FSNode &node, bool flattenTree = false);
  * This takes ownership of the stream,  in particular, it is deleted when the
  * ZipArchive is deleted.
  *
+ * See above for @p streamingThreshold.
+ *
  * May return 0 in case of a failure. In this case stream will still be deleted.
  */
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false);
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false, uint32 streamingThreshold = kZipStreamingThreshold);
 
 /** @} */
 
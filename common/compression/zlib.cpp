@@ -33,6 +33,7 @@
 
 #include "common/compression/deflate.h"
 
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -93,6 +94,10 @@ static bool _shownBackwardSeekingWarning = false;
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
  * Assumes the compressed data to be in gzip format.
+ *
+ * If a checkpoint interval is given, a copy of the decompressor state is
+ * kept each time that many bytes have been decompressed, so that seeks
+ * can resume from the closest checkpoint instead of the start of the data.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
@@ -100,6 +105,12 @@ protected:
 		BUFSIZE = 16384		// 1 << MAX_WBITS
 	};
 
+	struct Checkpoint {
+		uint32 pos;       ///< Position in the decompressed data
+		uint64 parentPos; ///< Position of the next compressed byte in the wrapped stream
+		z_stream stream;  ///< Copy of the decompressor state
+	};
+
 	byte	_buf[BUFSIZE];
 
 	DisposablePtr<SeekableReadStream> _wrapped;
@@ -110,9 +121,64 @@ protected:
 	uint32 _origSize;
 	bool _eos;
 
+	uint32 _checkpointInterval;
+	uint32 _nextCheckpoint;
+	Array<Checkpoint *> _checkpoints;
+
+	uint32 inflateBlock(byte *dataPtr, uint32 dataSize) {
+		_stream.next_out = dataPtr;
+		_stream.avail_out = dataSize;
+
+		// Keep going while we get no error
+		while (_zlibErr == Z_OK && _stream.avail_out) {
+			if (_stream.avail_in == 0 && !_wrapped->eos()) {
+				// If we are out of input data: Read more data, if available.
+				_stream.next_in = _buf;
+				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
+			}
+			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+		}
+
+		// Update the position counter
+		_pos += dataSize - _stream.avail_out;
+
+		if (_zlibErr == Z_STREAM_END && _stream.avail_out > 0)
+			_eos = true;
+
+		return dataSize - _stream.avail_out;
+	}
+
+	void addCheckpoint() {
+		Checkpoint *checkpoint = new Checkpoint();
+		if (inflateCopy(&checkpoint->stream, &_stream) != Z_OK) {
+			// Out of memory, go on without checkpoints
+			delete checkpoint;
+			_checkpointInterval = 0;
+			return;
+		}
+
+		checkpoint->pos = _pos;
+		checkpoint->parentPos = _wrapped->pos() - _stream.avail_in;
+		_checkpoints.push_back(checkpoint);
+		_nextCheckpoint = _pos + _checkpointInterval;
+	}
+
+	bool restoreCheckpoint(Checkpoint *checkpoint) {
+		inflateEnd(&_stream);
+		_zlibErr = inflateCopy(&_stream, &checkpoint->stream);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_wrapped->seek(checkpoint->parentPos, SEEK_SET);
+		_pos = checkpoint->pos;
+		return true;
+	}
+
 public:
 
-	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream() {
+	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream(), _checkpointInterval(0), _nextCheckpoint(0) {
 		assert(w != nullptr);
 
 		_parentPos = w->pos();
@@ -148,7 +214,8 @@ public:
 		_stream.avail_in = 0;
 	}
 
-	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize, const byte *dict, uint dictLen) : _wrapped(w, disposeParent), _stream() {
+	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize, const byte *dict, uint dictLen, uint32 checkpointInterval)
+		: _wrapped(w, disposeParent), _stream(), _checkpointInterval(checkpointInterval), _nextCheckpoint(checkpointInterval) {
 		assert(w != nullptr);
 
 		_parentPos = w->pos();
@@ -176,6 +243,10 @@ public:
 	}
 
 	~GZipReadStream() {
+		for (Checkpoint *checkpoint : _checkpoints) {
+			inflateEnd(&checkpoint->stream);
+			delete checkpoint;
+		}
 		inflateEnd(&_stream);
 	}
 
@@ -186,26 +257,26 @@ public:
 	}
 
 	uint32 read(void *dataPtr, uint32 dataSize) override {
-		_stream.next_out = (byte *)dataPtr;
-		_stream.avail_out = dataSize;
-
-		// Keep going while we get no error
-		while (_zlibErr == Z_OK && _stream.avail_out) {
-			if (_stream.avail_in == 0 && !_wrapped->eos()) {
-				// If we are out of input data: Read more data, if available.
-				_stream.next_in = _buf;
-				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
-			}
-			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+		if (!_checkpointInterval)
+			return inflateBlock((byte *)dataPtr, dataSize);
+
+		// Stop at the checkpoint positions to take a copy of the state
+		uint32 total = 0;
+		while (total < dataSize) {
+			if (_pos == _nextCheckpoint && _zlibErr == Z_OK)
+				addCheckpoint();
+
+			uint32 blockSize = dataSize - total;
+			if (_checkpointInterval && _pos < _nextCheckpoint)
+				blockSize = MIN(blockSize, _nextCheckpoint - _pos);
+
+			const uint32 decompressed = inflateBlock((byte *)dataPtr + total, blockSize);
+			total += decompressed;
+			if (decompressed < blockSize)
+				break;
 		}
 
-		// Update the position counter
-		_pos += dataSize - _stream.avail_out;
-
-		if (_zlibErr == Z_STREAM_END && _stream.avail_out > 0)
-			_eos = true;
-
-		return dataSize - _stream.avail_out;
+		return total;
 	}
 
 	bool eos() const override {
@@ -236,7 +307,20 @@ public:
 
 		assert(newPos >= 0);
 
-		if ((uint32)newPos < _pos) {
+		// Find the last checkpoint before the new position
+		Checkpoint *checkpoint = nullptr;
+		for (Checkpoint *cp : _checkpoints) {
+			if (cp->pos > (uint32)newPos)
+				break;
+			checkpoint = cp;
+		}
+
+		if (checkpoint && (checkpoint->pos > _pos || (uint32)newPos < _pos)) {
+			// Resume from there, rather than decompressing everything up to
+			// the new position
+			if (!restoreCheckpoint(checkpoint))
+				return false;
+		} else if ((uint32)newPos < _pos) {
 			// To search backward, we have to restart the whole decompression
 			// from the start of the file. A rather wasteful operation, best
 			// to avoid it. :/
@@ -408,7 +492,7 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, Di
 	return toBeWrapped;
 }
 
-SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, DisposeAfterUse::Flag disposeParent, uint64 knownSize, const byte *dict, uint dictLen) {
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, DisposeAfterUse::Flag disposeParent, uint64 knownSize, const byte *dict, uint dictLen, uint32 checkpointInterval) {
 	if (!toBeWrapped) {
 		return nullptr;
 	}
@@ -419,7 +503,7 @@ SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, Dispo
 		}
 		return nullptr;
 	}
-	return new GZipReadStream(toBeWrapped, disposeParent, knownSize, dict, dictLen);
+	return new GZipReadStream(toBeWrapped, disposeParent, knownSize, dict, dictLen, checkpointInterval);
 }
 
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
@@ -233,6 +233,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileStatus(int64 &size, int64 &modificationTime) const {
+	return _realNode && !_realNode->isDirectory() && _realNode->getFileStatus(size, modificationTime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -252,6 +252,19 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Query the size and the last modification time of the file referred by
+	 * this node, without opening it. This is meant for validating caches of
+	 * data computed from the file contents.
+	 *
+	 * @param size Set to the size of the file, in bytes.
+	 * @param modificationTime Set to the last modification time, in seconds.
+	 *                         The epoch depends on the backend.
+	 * @return True if successful, false if the backend does not support this
+	 *         or the node does not refer to an existing file.
+	 */
+	bool getFileStatus(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -433,6 +446,12 @@ public:
 	 */
 	int listMembers(ArchiveMemberList &list) const override;
 
+	/**
+	 * The cache is all there is, unless directories are listed as well,
+	 * which hasFile() does not accept.
+	 */
+	bool isMemberListComplete() const override { return !_includeDirectories; }
+
 	/**
 	 * Get an ArchiveMember representation of the specified file. A full match of relative
 	 * path and file name is needed for success.
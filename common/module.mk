@@ -38,6 +38,7 @@ MODULE_OBJS := \
 	str-enc.o \
 	encodings/singlebyte.o \
 	system.o \
+	taskscheduler.o \
 	textconsole.o \
 	text-to-speech.o \
 	tokenizer.o \
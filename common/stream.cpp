@@ -158,6 +158,13 @@ bool MemoryReadStream::seek(int64 offs, int whence) {
 	return true; // FIXME: STREAM REWRITE
 }
 
+const byte *MemoryReadStream::getRangePointer(int64 offset, uint32 size) const {
+	if (offset < 0 || offset > _size || size > _size - offset)
+		return nullptr;
+
+	return _ptrOrig.get() + offset;
+}
+
 #pragma mark -
 
 enum {
@@ -292,6 +299,13 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getRangePointer(int64 offset, uint32 size) const {
+	if (offset < 0 || offset > _end - _begin || size > _end - _begin - offset)
+		return nullptr;
+
+	return _parentStream->getRangePointer(_begin + offset, size);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
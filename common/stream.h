@@ -792,6 +792,22 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Get direct access to a range of the stream data, without copying it.
+	 *
+	 * Streams which hold their data in memory, or map it there, return a
+	 * pointer to the @p size bytes at @p offset. The data must not be modified,
+	 * and the pointer stays valid as long as the stream exists. The position
+	 * indicator is not changed.
+	 *
+	 * @param offset	Offset of the range from the start of the stream.
+	 * @param size		Size of the range in bytes.
+	 *
+	 * @return Pointer to the data, or nullptr if the stream does not support
+	 *         direct access or the range is out of bounds.
+	 */
+	virtual const byte *getRangePointer(int64 offset, uint32 size) const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
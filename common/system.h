@@ -55,6 +55,7 @@ class Store;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class WorkerPoolInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -1647,6 +1648,16 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Create the worker threads of a task scheduler, see Common::TaskScheduler.
+	 *
+	 * Backends which cannot run threads keep the default implementation,
+	 * and the tasks are then run synchronously.
+	 *
+	 * @return The newly created worker pool, or nullptr if threads are not supported.
+	 */
+	virtual Common::WorkerPoolInternal *createWorkerPool() { return nullptr; }
+
 	/** @} */
 
 
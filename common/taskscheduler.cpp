@@ -0,0 +1,398 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/taskscheduler.h"
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(TaskScheduler);
+
+enum {
+	/** The number of ranges of parallelFor() per thread, to balance uneven ranges. */
+	kRangesPerThread = 4
+};
+
+TaskScheduler::TaskScheduler() {
+	init(ConfMan.hasKey("worker_threads") ? ConfMan.getInt("worker_threads") : -1);
+}
+
+TaskScheduler::TaskScheduler(int numWorkers) {
+	init(numWorkers);
+}
+
+void TaskScheduler::init(int numWorkers) {
+	_pool = nullptr;
+	_nextQueue = 0;
+	_numWaiting = 0;
+	_quit = false;
+	_statsEnabled = false;
+
+	WorkerPoolInternal *pool = nullptr;
+	if (numWorkers != 0 && g_system)
+		pool = g_system->createWorkerPool();
+	if (!pool)
+		return;
+
+	if (numWorkers < 0)
+		numWorkers = (int)pool->getNumCPUs() - 1;
+	numWorkers = MIN<int>(numWorkers, kMaxWorkers);
+	if (numWorkers <= 0) {
+		delete pool;
+		return;
+	}
+
+	_pool = pool;
+	_workers.resize(numWorkers);
+	for (uint i = 0; i < _workers.size(); i++)
+		_workers[i].scheduler = this;
+
+	for (int i = 0; i < numWorkers; i++) {
+		if (!_pool->startThread(workerProc, &_workers[i])) {
+			warning("TaskScheduler: Could only start %d of %d worker threads", i, numWorkers);
+			_pool->lock();
+			_workers.resize(i);
+			_pool->unlock();
+			break;
+		}
+	}
+
+	if (_workers.empty()) {
+		delete _pool;
+		_pool = nullptr;
+	}
+}
+
+TaskScheduler::~TaskScheduler() {
+	if (_pool) {
+		// The workers only quit once all queues are empty
+		_pool->lock();
+		_quit = true;
+		_pool->notifyAll();
+		_pool->unlock();
+
+		_pool->joinThreads();
+		delete _pool;
+	}
+}
+
+void TaskScheduler::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+	TaskScheduler *scheduler = worker->scheduler;
+	WorkerPoolInternal *pool = scheduler->_pool;
+	const uint index = worker - scheduler->_workers.begin();
+
+	pool->lock();
+	for (;;) {
+		Task *task = scheduler->takeTask(index);
+		if (task) {
+			pool->unlock();
+			const uint64 micros = scheduler->runTask(task);
+			pool->lock();
+			scheduler->finishTask(task, micros);
+		} else if (scheduler->_quit) {
+			break;
+		} else {
+			pool->wait();
+		}
+	}
+	pool->unlock();
+}
+
+void TaskScheduler::queueTask(Task *task) {
+	List<Task *> &queue = _workers[_nextQueue].queue;
+	queue.push_back(task);
+	task->queue = _nextQueue;
+	task->queuePos = queue.reverse_begin();
+	_nextQueue = (_nextQueue + 1) % _workers.size();
+
+	// Threads waiting for their tasks to finish do not run this one, so
+	// make sure a worker wakes up
+	if (_numWaiting)
+		_pool->notifyAll();
+	else
+		_pool->notifyOne();
+}
+
+TaskScheduler::Task *TaskScheduler::takeTask(uint worker) {
+	// A worker takes the oldest task of its own queue, and steals the
+	// newest one of another queue, which is the least likely to be taken
+	// by its owner soon
+	if (worker < _workers.size() && !_workers[worker].queue.empty()) {
+		Task *task = _workers[worker].queue.front();
+		_workers[worker].queue.pop_front();
+		task->queue = -1;
+		return task;
+	}
+
+	for (uint i = 1; i <= _workers.size(); i++) {
+		List<Task *> &queue = _workers[(worker + i) % _workers.size()].queue;
+		if (!queue.empty()) {
+			Task *task = queue.back();
+			queue.pop_back();
+			task->queue = -1;
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+uint64 TaskScheduler::getMicros() const {
+	return _pool ? _pool->getMicros() : (uint64)g_system->getMillis() * 1000;
+}
+
+uint64 TaskScheduler::runTask(Task *task) {
+	uint64 start = 0;
+	const bool timed = _statsEnabled;
+	if (timed)
+		start = getMicros();
+
+	if (task->rangeProc)
+		task->rangeProc(task->param, task->begin, task->end);
+	else
+		task->proc(task->param);
+
+	// Make sure timed tasks are counted, even when they took no time
+	return timed ? MAX<uint64>(getMicros() - start, 1) : 0;
+}
+
+void TaskScheduler::runSync(Task *task) {
+	const uint64 micros = runTask(task);
+	if (micros) {
+		if (_pool)
+			_pool->lock();
+		addStats(task->name, micros);
+		if (_pool)
+			_pool->unlock();
+	}
+}
+
+void TaskScheduler::finishTask(Task *task, uint64 micros) {
+	if (micros)
+		addStats(task->name, micros);
+
+	if (--*task->counter == 0 && _numWaiting)
+		_pool->notifyAll();
+
+	releaseTask(task);
+}
+
+void TaskScheduler::releaseTask(Task *task) {
+	if (--task->refs == 0)
+		delete task;
+}
+
+bool TaskScheduler::unqueueTask(Task *task) {
+	if (task->queue < 0)
+		return false;
+
+	_workers[task->queue].queue.erase(task->queuePos);
+	task->queue = -1;
+	return true;
+}
+
+void TaskScheduler::waitFor(Task *tasks, uint numTasks, const uint *counter) {
+	if (!_pool)
+		return;
+
+	// Only the tasks waited for are run, other ones could take much longer
+	// or wait for this thread in turn. Tasks are never queued again, so
+	// each one only needs to be looked at once.
+	uint next = 0;
+	_pool->lock();
+	while (*counter) {
+		Task *task = nullptr;
+		while (!task && next < numTasks) {
+			if (unqueueTask(&tasks[next]))
+				task = &tasks[next];
+			next++;
+		}
+
+		if (task) {
+			_pool->unlock();
+			const uint64 micros = runTask(task);
+			_pool->lock();
+			finishTask(task, micros);
+		} else {
+			_numWaiting++;
+			_pool->wait();
+			_numWaiting--;
+		}
+	}
+	_pool->unlock();
+}
+
+TaskFuture TaskScheduler::submit(TaskProc proc, void *param, const char *name) {
+	Task *task = new Task();
+	task->proc = proc;
+	task->rangeProc = nullptr;
+	task->param = param;
+	task->begin = task->end = 0;
+	task->name = name;
+	task->pending = 1;
+	task->counter = &task->pending;
+	task->refs = 2;
+
+	if (!_pool) {
+		runSync(task);
+		delete task;
+		return TaskFuture();
+	}
+
+	_pool->lock();
+	queueTask(task);
+	_pool->unlock();
+
+	return TaskFuture(this, task);
+}
+
+void TaskScheduler::parallelFor(uint count, uint grain, RangeProc proc, void *param, const char *name) {
+	if (!count)
+		return;
+
+	const uint numRanges = MIN<uint>(count / MAX<uint>(grain, 1), (_workers.size() + 1) * kRangesPerThread);
+	if (!_pool || numRanges <= 1) {
+		Task task;
+		task.proc = nullptr;
+		task.rangeProc = proc;
+		task.param = param;
+		task.begin = 0;
+		task.end = count;
+		task.name = name;
+		runSync(&task);
+		return;
+	}
+
+	// The tasks stay referenced by us, so they are not deleted when finished
+	Task *tasks = new Task[numRanges];
+	uint pending = numRanges;
+	for (uint i = 0; i < numRanges; i++) {
+		tasks[i].proc = nullptr;
+		tasks[i].rangeProc = proc;
+		tasks[i].param = param;
+		tasks[i].begin = (uint64)count * i / numRanges;
+		tasks[i].end = (uint64)count * (i + 1) / numRanges;
+		tasks[i].name = name;
+		tasks[i].counter = &pending;
+		tasks[i].pending = 0;
+		tasks[i].refs = 2;
+	}
+
+	_pool->lock();
+	for (uint i = 0; i < numRanges; i++)
+		queueTask(&tasks[i]);
+	_pool->unlock();
+
+	waitFor(tasks, numRanges, &pending);
+	delete[] tasks;
+}
+
+void TaskScheduler::addStats(const char *name, uint64 micros) {
+	for (uint i = 0; i < _stats.size(); i++) {
+		if (_stats[i].name == name) {
+			_stats[i].count++;
+			_stats[i].totalMicros += micros;
+			_stats[i].maxMicros = MAX(_stats[i].maxMicros, micros);
+			return;
+		}
+	}
+
+	TaskStats stats;
+	stats.name = name;
+	stats.count = 1;
+	stats.totalMicros = micros;
+	stats.maxMicros = micros;
+	_stats.push_back(stats);
+}
+
+Array<TaskScheduler::TaskStats> TaskScheduler::getStats() {
+	if (_pool)
+		_pool->lock();
+	Array<TaskStats> stats = _stats;
+	if (_pool)
+		_pool->unlock();
+	return stats;
+}
+
+void TaskScheduler::resetStats() {
+	if (_pool)
+		_pool->lock();
+	_stats.clear();
+	if (_pool)
+		_pool->unlock();
+}
+
+
+TaskFuture::TaskFuture(TaskScheduler *scheduler, TaskScheduler::Task *task) : _scheduler(scheduler), _task(task) {
+}
+
+TaskFuture::TaskFuture(const TaskFuture &other) : _scheduler(other._scheduler), _task(other._task) {
+	if (_task) {
+		_scheduler->_pool->lock();
+		_task->refs++;
+		_scheduler->_pool->unlock();
+	}
+}
+
+TaskFuture &TaskFuture::operator=(const TaskFuture &other) {
+	if (other._task) {
+		other._scheduler->_pool->lock();
+		other._task->refs++;
+		other._scheduler->_pool->unlock();
+	}
+	if (_task) {
+		_scheduler->_pool->lock();
+		_scheduler->releaseTask(_task);
+		_scheduler->_pool->unlock();
+	}
+
+	_scheduler = other._scheduler;
+	_task = other._task;
+	return *this;
+}
+
+TaskFuture::~TaskFuture() {
+	if (_task) {
+		_scheduler->_pool->lock();
+		_scheduler->releaseTask(_task);
+		_scheduler->_pool->unlock();
+	}
+}
+
+bool TaskFuture::isReady() const {
+	if (!_task)
+		return true;
+
+	_scheduler->_pool->lock();
+	const bool ready = _task->pending == 0;
+	_scheduler->_pool->unlock();
+	return ready;
+}
+
+void TaskFuture::wait() const {
+	if (_task)
+		_scheduler->waitFor(_task, 1, &_task->pending);
+}
+
+} // End of namespace Common
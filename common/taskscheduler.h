@@ -0,0 +1,271 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_TASKSCHEDULER_H
+#define COMMON_TASKSCHEDULER_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_taskscheduler Task scheduler
+ * @ingroup common
+ *
+ * @brief API for running work on a pool of worker threads.
+ * @{
+ */
+
+/**
+ * The worker threads of a TaskScheduler, provided by the backend through
+ * OSystem::createWorkerPool().
+ *
+ * Besides starting the threads, it provides a single lock with a condition
+ * variable, which the scheduler uses to protect its queues and to put idle
+ * threads to sleep. The lock does not need to be recursive.
+ */
+class WorkerPoolInternal {
+public:
+	typedef void (*WorkerProc)(void *param);
+
+	virtual ~WorkerPoolInternal() {}
+
+	/** Return the number of processors the threads can run on. */
+	virtual uint getNumCPUs() = 0;
+
+	/**
+	 * Start a thread calling proc(param).
+	 *
+	 * @return Whether the thread could be started.
+	 */
+	virtual bool startThread(WorkerProc proc, void *param) = 0;
+
+	/** Wait for all started threads to return. */
+	virtual void joinThreads() = 0;
+
+	virtual void lock() = 0;
+	virtual void unlock() = 0;
+
+	/**
+	 * Unlock, sleep until notifyOne() or notifyAll() is called, and lock
+	 * again. The thread may also wake up without being notified.
+	 */
+	virtual void wait() = 0;
+	virtual void notifyOne() = 0;
+	virtual void notifyAll() = 0;
+
+	/** Return a monotonic time in microseconds, used for the task statistics. */
+	virtual uint64 getMicros() = 0;
+};
+
+class TaskFuture;
+
+/**
+ * Runs tasks on a pool of worker threads.
+ *
+ * Each worker has its own queue of tasks. Submitted tasks are spread over
+ * the queues, and a worker whose queue is empty steals the most recently
+ * queued task of another one. Threads waiting for tasks to finish take the
+ * ones they wait for off the queues and run them, so tasks may wait for
+ * other tasks.
+ *
+ * When the backend provides no worker threads, or none are wanted, tasks
+ * are run synchronously when they are submitted.
+ *
+ * The scheduler may be used from any thread, including the tasks it runs,
+ * but TaskMan has to be created on the main thread.
+ */
+class TaskScheduler : public Singleton<TaskScheduler> {
+public:
+	typedef void (*TaskProc)(void *param);
+	typedef void (*RangeProc)(void *param, uint begin, uint end);
+
+	enum {
+		/** The largest number of worker threads. */
+		kMaxWorkers = 16
+	};
+
+	/** The time spent in the tasks of a name, see setStatsEnabled(). */
+	struct TaskStats {
+		const char *name;
+		uint count;
+		uint64 totalMicros;
+		uint64 maxMicros;
+	};
+
+	/**
+	 * Create a scheduler with the number of workers given by the
+	 * "worker_threads" setting, or one less than the number of processors
+	 * if it is not set, since the thread submitting the tasks helps
+	 * running them.
+	 */
+	TaskScheduler();
+
+	/**
+	 * Create a scheduler with the given number of workers.
+	 *
+	 * @param numWorkers The number of worker threads, 0 to run the tasks
+	 *                   synchronously, or -1 for the default.
+	 */
+	explicit TaskScheduler(int numWorkers);
+	~TaskScheduler();
+
+	/** Return the number of worker threads, 0 if the tasks are run synchronously. */
+	uint getNumWorkers() const { return _workers.size(); }
+
+	/**
+	 * Run proc(param) on a worker thread.
+	 *
+	 * @param name A name for the statistics, which must stay valid as long
+	 *             as the scheduler. Tasks with the same name are counted
+	 *             together.
+	 * @return A future which can be used to wait for the task to finish.
+	 */
+	TaskFuture submit(TaskProc proc, void *param, const char *name = nullptr);
+
+	/**
+	 * Call proc(param, begin, end) for ranges covering [0, count), and wait
+	 * for all of them to finish. The ranges are run in parallel, and are at
+	 * least grain items large unless count is smaller.
+	 */
+	void parallelFor(uint count, uint grain, RangeProc proc, void *param, const char *name = nullptr);
+
+	/** Call func(begin, end) for ranges covering [0, count), see above. */
+	template<class T>
+	void parallelFor(uint count, uint grain, const T &func, const char *name = nullptr) {
+		parallelFor(count, grain, &callRange<T>, const_cast<T *>(&func), name);
+	}
+
+	/**
+	 * Enable or disable timing the tasks. The statistics are kept when
+	 * they are disabled.
+	 */
+	void setStatsEnabled(bool enabled) { _statsEnabled = enabled; }
+	bool isStatsEnabled() const { return _statsEnabled; }
+
+	/** Return the statistics of each task name, see submit(). */
+	Array<TaskStats> getStats();
+	void resetStats();
+
+private:
+	friend class TaskFuture;
+
+	struct Task {
+		TaskProc proc;
+		RangeProc rangeProc;
+		void *param;
+		uint begin, end;
+		const char *name;
+		/** Decremented when the task is finished, the task waited for is done at 0. */
+		uint *counter;
+		/** The number of unfinished tasks of a future. */
+		uint pending;
+		/** The number of references, from the queues and futures. */
+		uint refs;
+		/** The worker whose queue holds the task, or -1 once it was taken. */
+		int queue;
+		List<Task *>::iterator queuePos;
+	};
+
+	struct Worker {
+		TaskScheduler *scheduler;
+		List<Task *> queue;
+	};
+
+	template<class T>
+	static void callRange(void *param, uint begin, uint end) {
+		(*(const T *)param)(begin, end);
+	}
+
+	void init(int numWorkers);
+	static void workerProc(void *param);
+
+	/** Queue a task and wake up a thread to run it, with the lock held. */
+	void queueTask(Task *task);
+	/** Take a task from the queue of worker, then from the others, with the lock held. */
+	Task *takeTask(uint worker);
+	/** Take a task off its queue if it was not taken yet, with the lock held. */
+	bool unqueueTask(Task *task);
+	uint64 getMicros() const;
+	/** Run a task without the lock held, return the time it took if it was timed. */
+	uint64 runTask(Task *task);
+	/** Run a task on the calling thread, without queueing it. */
+	void runSync(Task *task);
+	/** Account for a finished task, with the lock held. */
+	void finishTask(Task *task, uint64 micros);
+	void releaseTask(Task *task);
+	/**
+	 * Run those of the tasks which are still queued, then wait until the
+	 * counter is 0.
+	 */
+	void waitFor(Task *tasks, uint numTasks, const uint *counter);
+	void addStats(const char *name, uint64 micros);
+
+	WorkerPoolInternal *_pool;
+	Array<Worker> _workers;
+	uint _nextQueue;
+	uint _numWaiting;
+	bool _quit;
+
+	bool _statsEnabled;
+	Array<TaskStats> _stats;
+};
+
+/**
+ * A handle to a task submitted to a TaskScheduler. It must not outlive
+ * the scheduler.
+ */
+class TaskFuture {
+public:
+	TaskFuture() : _scheduler(nullptr), _task(nullptr) {}
+	TaskFuture(const TaskFuture &other);
+	TaskFuture &operator=(const TaskFuture &other);
+	~TaskFuture();
+
+	/** Return whether the task is finished. */
+	bool isReady() const;
+
+	/**
+	 * Wait for the task to finish. It is run on the calling thread if no
+	 * worker has started it yet.
+	 */
+	void wait() const;
+
+private:
+	friend class TaskScheduler;
+
+	TaskFuture(TaskScheduler *scheduler, TaskScheduler::Task *task);
+
+	TaskScheduler *_scheduler;
+	TaskScheduler::Task *_task;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+/** Shortcut for accessing the task scheduler. */
+#define TaskMan     Common::TaskScheduler::instance()
+
+#endif
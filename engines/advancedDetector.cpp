@@ -21,6 +21,7 @@
 
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "common/algorithm.h"
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
@@ -28,6 +29,7 @@
 #include "common/md5.h"
 #include "common/config-manager.h"
 #include "common/punycode.h"
+#include "common/savefile.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/tokenizer.h"
@@ -253,8 +255,6 @@ bool AdvancedMetaEngineDetectionBase::cleanupPirated(ADDetectedGames &matched) c
 }
 
 DetectedGames AdvancedMetaEngineDetectionBase::detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
-	FileMap allFiles;
-
 	if (fslist.empty())
 		return DetectedGames();
 
@@ -262,8 +262,8 @@ DetectedGames AdvancedMetaEngineDetectionBase::detectGames(const Common::FSList
 	// the _directoryGlobsMap
 	preprocessDescriptions();
 
-	// Compose a hashmap of all files in fslist.
-	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+	// Get a hashmap of all files in fslist.
+	const FileMap &allFiles = getFileHashMap(fslist);
 
 	// Run the detector on this
 	ADDetectedGames matches = detectGame(fslist.begin()->getParent(), allFiles, Common::UNK_LANG, Common::kPlatformUnknown, "", skipADFlags, skipIncomplete);
@@ -415,6 +415,7 @@ Common::Error AdvancedMetaEngineDetectionBase::identifyGame(DetectedGame &game,
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.savePersistentCache();
 
 	if (!agdDesc.desc)
 		return Common::kNoGameDataFoundError;
@@ -470,12 +471,241 @@ void AdvancedMetaEngineDetectionBase::composeFileHashMap(FileMap &allFiles, cons
 	}
 }
 
+const AdvancedMetaEngineDetectionBase::FileMap &AdvancedMetaEngineDetectionBase::getFileHashMap(const Common::FSList &fslist) const {
+	const int depth = (_maxScanDepth == 0 ? 1 : _maxScanDepth);
+
+	// Identify the list by its files, then what gets scanned of it. When
+	// only the list itself is scanned, every engine ends up with the same map.
+	Common::String key = ADCacheMan.getFileListKey(fslist);
+	if (depth > 1) {
+		key += Common::String::format(":%d:%d", depth, (_flags & kADFlagMatchFullPaths) ? 1 : 0);
+
+		Common::StringArray globs;
+		for (const auto &glob : _globsMap)
+			globs.push_back(glob._key);
+		Common::sort(globs.begin(), globs.end());
+
+		for (const auto &glob : globs) {
+			key += ':';
+			key += glob;
+		}
+	}
+
+	FileMap *allFiles = ADCacheMan.getFileMap(key);
+	if (!allFiles) {
+		allFiles = new FileMap();
+		composeFileHashMap(*allFiles, fslist, depth);
+		ADCacheMan.addFileMap(key, allFiles);
+	}
+
+	return *allFiles;
+}
+
 /* Singleton Cache Storage for MD5 */
 
 namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+#define MD5_CACHE_FILENAME "scummvm-md5cache.dat"
+
+enum {
+	kMD5CacheVersion = 1,
+	/** Minimum time between two writes of the persistent cache, in milliseconds */
+	kMD5CacheSaveDelay = 5000
+};
+
+void AdvancedDetectorCacheManager::loadPersistentCache() {
+	// The savefile manager is not available yet when detecting from the
+	// command line
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	_persistentLoaded = true;
+
+	Common::ScopedPtr<Common::InSaveFile> file(saveFileMan->openRawFile(MD5_CACHE_FILENAME));
+	if (!file)
+		return;
+
+	if (file->readUint32BE() != MKTAG('M', 'D', '5', 'C') || file->readUint32LE() != kMD5CacheVersion) {
+		debugC(2, kDebugGlobalDetection, "Ignoring MD5 cache with unknown format");
+		return;
+	}
+
+	const uint32 lastRun = file->readUint32LE();
+	const uint32 count = file->readUint32LE();
+
+	for (uint32 i = 0; i < count; i++) {
+		const Common::String key = file->readString();
+		PersistentEntry entry;
+		entry.fileSize = file->readSint64LE();
+		entry.fileTime = file->readSint64LE();
+		entry.props.size = file->readSint64LE();
+		entry.props.md5prop = (MD5Properties)file->readUint32LE();
+		entry.props.md5 = file->readString();
+		entry.lastRun = file->readUint32LE();
+
+		if (file->eos() || file->err()) {
+			warning("Truncated MD5 cache, ignoring the remaining entries");
+			break;
+		}
+
+		// Entries added before the file could be loaded are more recent
+		if (!_persistentMap.contains(key))
+			_persistentMap.setVal(key, entry);
+	}
+
+	// Keep counting detection runs from where the previous session stopped
+	_persistentRun += lastRun;
+
+	debugC(2, kDebugGlobalDetection, "Loaded %u entries from the MD5 cache", _persistentMap.size());
+}
+
+bool AdvancedDetectorCacheManager::getPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, FileProperties &fileProps) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	PersistentHashMap::iterator i = _persistentMap.find(key);
+	if (i == _persistentMap.end())
+		return false;
+
+	if (i->_value.fileSize != fileSize || i->_value.fileTime != fileTime) {
+		// The file has changed since the MD5 was computed
+		_persistentMap.erase(i);
+		_persistentDirty = true;
+		return false;
+	}
+
+	// Not worth a write on its own, rescanning an unchanged library should
+	// not touch the cache file
+	i->_value.lastRun = _persistentRun;
+	fileProps = i->_value.props;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, const FileProperties &fileProps) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	PersistentEntry &entry = _persistentMap.getOrCreateVal(key);
+	entry.fileSize = fileSize;
+	entry.fileTime = fileTime;
+	entry.props = fileProps;
+	entry.lastRun = _persistentRun;
+	_persistentDirty = true;
+
+	if (_persistentMap.size() > kMaxPersistentEntries)
+		trimPersistentCache();
+}
+
+void AdvancedDetectorCacheManager::trimPersistentCache() {
+	// Drop the entries which have not been used for the most detection runs,
+	// leaving some room so that this does not happen for every new entry
+	const uint target = kMaxPersistentEntries * 3 / 4;
+
+	Common::Array<uint32> runs;
+	runs.reserve(_persistentMap.size());
+	for (const auto &entry : _persistentMap)
+		runs.push_back(entry._value.lastRun);
+	Common::sort(runs.begin(), runs.end());
+
+	const uint32 threshold = runs[runs.size() - target];
+	uint excess = _persistentMap.size() - target;
+
+	for (PersistentHashMap::iterator i = _persistentMap.begin(); i != _persistentMap.end() && excess; ++i) {
+		if (i->_value.lastRun < threshold) {
+			_persistentMap.erase(i);
+			excess--;
+		}
+	}
+	for (PersistentHashMap::iterator i = _persistentMap.begin(); i != _persistentMap.end() && excess; ++i) {
+		if (i->_value.lastRun == threshold) {
+			_persistentMap.erase(i);
+			excess--;
+		}
+	}
+}
+
+void AdvancedDetectorCacheManager::savePersistentCache(bool force) {
+	if (!_persistentDirty)
+		return;
+
+	const uint32 time = g_system->getMillis();
+	if (!force && _persistentSaveTime && time - _persistentSaveTime < kMD5CacheSaveDelay)
+		return;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	Common::ScopedPtr<Common::OutSaveFile> file(saveFileMan->openForSaving(MD5_CACHE_FILENAME, false));
+	if (!file) {
+		warning("Failed to open " MD5_CACHE_FILENAME " for writing");
+		return;
+	}
+
+	file->writeUint32BE(MKTAG('M', 'D', '5', 'C'));
+	file->writeUint32LE(kMD5CacheVersion);
+	file->writeUint32LE(_persistentRun);
+	file->writeUint32LE(_persistentMap.size());
+
+	for (const auto &entry : _persistentMap) {
+		file->writeString(entry._key);
+		file->writeByte(0);
+		file->writeSint64LE(entry._value.fileSize);
+		file->writeSint64LE(entry._value.fileTime);
+		file->writeSint64LE(entry._value.props.size);
+		file->writeUint32LE(entry._value.props.md5prop);
+		file->writeString(entry._value.props.md5);
+		file->writeByte(0);
+		file->writeUint32LE(entry._value.lastRun);
+	}
+
+	file->finalize();
+	if (file->err()) {
+		warning("Failed to write " MD5_CACHE_FILENAME);
+		return;
+	}
+
+	_persistentDirty = false;
+	_persistentSaveTime = time;
+}
+
+const Common::String &AdvancedDetectorCacheManager::getFileListKey(const Common::FSList &fslist) {
+	// Every engine of a detection run scans the same list
+	if (&fslist == _fileList && fslist.size() == _fileListSize)
+		return _fileListKey;
+
+	// 64-bit FNV-1a over the paths of the list
+	uint64 hash = 0xcbf29ce484222325ULL;
+	for (const auto &file : fslist) {
+		const Common::String path = file.getPath().toString('/');
+		// The terminating zero separates the paths
+		for (uint i = 0; i <= path.size(); i++)
+			hash = (hash ^ (byte)path.c_str()[i]) * 0x100000001b3ULL;
+	}
+
+	_fileList = &fslist;
+	_fileListSize = fslist.size();
+	_fileListKey = Common::String::format("%u:%08x%08x", _fileListSize, (uint32)(hash >> 32), (uint32)hash);
+	return _fileListKey;
+}
+
+void AdvancedDetectorCacheManager::clearPersistentCache() {
+	_persistentMap.clear(true);
+	_persistentDirty = false;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	// There is nothing left to load once the file is gone
+	_persistentLoaded = true;
+	if (saveFileMan->exists(MD5_CACHE_FILENAME) && !saveFileMan->removeSavefile(MD5_CACHE_FILENAME))
+		warning("Failed to remove " MD5_CACHE_FILENAME);
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -536,6 +766,59 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
+/**
+ * Build the key of the persistent MD5 cache for a file, from the full paths
+ * of all the files on disk its properties are computed from. Their combined
+ * size and latest modification time tell whether an entry is still valid.
+ */
+static bool getPersistentCacheKey(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname,
+								  Common::String &key, int64 &fileSize, int64 &fileTime) {
+	Common::Array<Common::Path> sources;
+
+	if (md5prop & kMD5Archive) {
+		// The file is inside an archive, the name is 'type:archive:file'
+		Common::StringTokenizer tok(fname.toString(), ":");
+		tok.nextToken();
+		sources.push_back(Common::Path(tok.nextToken()));
+	} else if (md5prop & (kMD5MacResFork | kMD5MacDataFork)) {
+		// The forks may come from any of the files MacResManager looks at
+		const Common::String appleDoubleName = "._" + fname.baseName();
+		sources.push_back(fname);
+		sources.push_back(fname.append(".rsrc"));
+		sources.push_back(fname.append(".bin"));
+		sources.push_back(fname.getParent().appendComponent(appleDoubleName));
+		sources.push_back(Common::Path("__MACOSX").join(fname.getParent()).appendComponent(appleDoubleName));
+	} else {
+		sources.push_back(fname);
+	}
+
+	key = md5PropToCachePrefix(md5prop);
+	fileSize = 0;
+	fileTime = 0;
+	bool found = false;
+
+	for (const Common::Path &source : sources) {
+		AdvancedMetaEngineBase::FileMap::const_iterator node = allFiles.find(source);
+		int64 size, time;
+
+		if (node == allFiles.end() || !node->_value.getFileStatus(size, time))
+			continue;
+
+		key += ':';
+		key += node->_value.getPath().toString('/');
+		fileSize += size;
+		fileTime = MAX(fileTime, time);
+		found = true;
+	}
+
+	key += ':';
+	key += fname.toString('/');
+	key += ':';
+	key += Common::String::format("%d", md5Bytes);
+
+	return found;
+}
+
 bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
@@ -549,7 +832,19 @@ bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles,
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+	// Then check the persistent cache, valid as long as the files are unchanged
+	Common::String persistentKey;
+	int64 fileSize, fileTime;
+	const bool persistent = getPersistentCacheKey(_md5Bytes, allFiles, md5prop, fname, persistentKey, fileSize, fileTime);
+
+	bool res = persistent && ADCacheMan.getPersistentMD5(persistentKey, fileSize, fileTime, fileProps);
+
+	if (!res) {
+		res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+
+		if (res && persistent)
+			ADCacheMan.setPersistentMD5(persistentKey, fileSize, fileTime, fileProps);
+	}
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
@@ -595,6 +595,17 @@ protected:
 	 */
 	void composeFileHashMap(FileMap &allFiles, const Common::FSList &fslist, int depth, const Common::Path &parentName = Common::Path()) const;
 
+	/**
+	 * Get a hashmap of all files in @p fslist, as composed by composeFileHashMap()
+	 * with the scan depth of this engine.
+	 *
+	 * The maps are kept by the AdvancedDetectorCacheManager until it is cleared,
+	 * and shared by all engines which scan the same subdirectories, so that
+	 * running the detection of every engine over a directory builds the map
+	 * only once in the common case.
+	 */
+	const FileMap &getFileHashMap(const Common::FSList &fslist) const;
+
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
@@ -738,6 +749,13 @@ private:
 
 /**
  * Singleton Cache Storage for Computed MD5s and Open Archives
+ *
+ * Besides the MD5s of the current detection run, which are forgotten by
+ * clear(), the MD5s are also kept in a persistent cache. It is stored in
+ * the savegame directory, and keyed by the full path of the file and the
+ * way the MD5 was computed. An entry is only used as long as the size and
+ * the modification time of the file are unchanged, so that detecting the
+ * games of an unchanged library again only costs a stat call per file.
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -761,6 +779,33 @@ public:
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
 
+	/**
+	 * Look up the properties of a file in the persistent cache.
+	 *
+	 * @param key       Full path of the file and how the MD5 is computed.
+	 * @param fileSize  Current size of the file on disk.
+	 * @param fileTime  Current modification time of the file on disk.
+	 * @param fileProps Set to the cached properties.
+	 * @return True if a valid entry was found, false otherwise.
+	 */
+	bool getPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, FileProperties &fileProps);
+
+	/**
+	 * Store the properties of a file in the persistent cache, replacing
+	 * any previous entry for it.
+	 */
+	void setPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, const FileProperties &fileProps);
+
+	/**
+	 * Write the persistent cache to disk if it has changed. Unless forced,
+	 * this happens at most every few seconds, so that adding many games in
+	 * a row does not rewrite the file each time.
+	 */
+	void savePersistentCache(bool force = false);
+
+	/** Forget all the entries of the persistent cache, on disk too. */
+	void clearPersistentCache();
+
 	void addArchive(const Common::FSNode &node, Common::Archive *archivePtr) {
 		if (!archivePtr)
 			return;
@@ -778,7 +823,34 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/** Same as AdvancedMetaEngineDetectionBase::FileMap. */
+	typedef Common::HashMap<Common::Path, Common::FSNode, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> FileMap;
+
+	/** Keep a file map composed during detection, taking ownership of it. */
+	void addFileMap(const Common::String &key, FileMap *fileMap) {
+		delete fileMapHashMap.getValOrDefault(key, nullptr);
+		fileMapHashMap.setVal(key, fileMap);
+	}
+
+	FileMap *getFileMap(const Common::String &key) const {
+		return fileMapHashMap.getValOrDefault(key, nullptr);
+	}
+
+	/**
+	 * Get a key identifying the files of @p fslist, for the file maps. It
+	 * is a hash of the paths, only computed again for another list or after
+	 * clear(), so the list must not change during a detection run.
+	 */
+	const Common::String &getFileListKey(const Common::FSList &fslist);
+
+	void clearFileMaps() {
+		for (auto &entry : fileMapHashMap) {
+			delete entry._value;
+		}
+		fileMapHashMap.clear(true);
+	}
+
+	AdvancedDetectorCacheManager() : _fileList(nullptr), _fileListSize(0), _persistentLoaded(false), _persistentDirty(false), _persistentRun(0), _persistentSaveTime(0) {
 		clear();
 	}
 
@@ -789,21 +861,58 @@ public:
 		archiveHashMap.clear(true);
 	}
 
+	/**
+	 * Forget the MD5s and file maps of the current detection run, and close
+	 * the archives. The persistent cache is kept.
+	 */
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
 		clearArchives();
+		clearFileMaps();
+		_fileList = nullptr;
+		_persistentRun++;
 	}
 
 private:
 	friend class Common::Singleton<AdvancedDetectorCacheManager>;
 
+	enum {
+		/** Maximum number of entries in the persistent cache */
+		kMaxPersistentEntries = 65536
+	};
+
+	struct PersistentEntry {
+		int64 fileSize;
+		int64 fileTime;
+		FileProperties props;
+		/** Detection run the entry was last used in, for evicting old entries */
+		uint32 lastRun;
+	};
+
+	void loadPersistentCache();
+	void trimPersistentCache();
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	typedef Common::HashMap<Common::Path, Common::Archive *, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> ArchiveHashMap;
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentHashMap;
+	typedef Common::HashMap<Common::String, FileMap *> FileMapHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+	FileMapHashMap fileMapHashMap;
+
+	/** The last list given to getFileListKey() in this detection run, and its key. */
+	const Common::FSList *_fileList;
+	uint _fileListSize;
+	Common::String _fileListKey;
+
+	PersistentHashMap _persistentMap;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+	uint32 _persistentRun;
+	uint32 _persistentSaveTime;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
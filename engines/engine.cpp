@@ -1200,6 +1200,7 @@ Common::ErrorCode Engine::updateAddOns(const MetaEngine *metaEngine) const {
 			ADCacheMan.clear();
 
 			DetectedGames detectedGames = detectionPlugin->get<MetaEngineDetection>().detectGames(files);
+			ADCacheMan.savePersistentCache();
 			DetectedGames detectedAddOns;
 			for (DetectedGame &game : detectedGames) {
 				if (game.isAddOn) {
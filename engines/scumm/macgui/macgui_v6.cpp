@@ -729,16 +729,7 @@ void MacV6Gui::updateThumbnail(MacDialogWindow *window, Common::Rect drawArea, i
 
 	Graphics::ColorQuantizer quantizer(245);
 
-	for (int y = yMin; y < yMax; y++) {
-		for (int x = 0; x < thumbnail->w; x++) {
-			uint32 color = thumbnail->getPixel(x, y);
-
-			byte r, g, b;
-			thumbnail->format.colorToRGB(color, r, g, b);
-
-			quantizer.addColor(r, g, b);
-		}
-	}
+	quantizer.addSurface(thumbnail->getSubArea(thumbnailRect));
 
 	Graphics::Palette *palette = quantizer.getPalette();
 	_system->getPaletteManager()->setPalette(*palette);
@@ -52,6 +52,13 @@ inline static void convertPaletteToMap(uint32 *dst, const byte *src, uint colors
 	}
 }
 
+/**
+ * Same as convertPaletteToMap(), but keeps the last few converted palettes
+ * around, so that blitting with the same palette again does not need to
+ * convert it every time.
+ */
+void convertPaletteToMapCached(uint32 *dst, const byte *src, uint colors, const Graphics::PixelFormat &format);
+
 /**
  * Blits a rectangle.
  * Cautions: 
@@ -321,6 +328,7 @@ private:
 
 	typedef void(*BlitFunc)(Args &, const TSpriteBlendMode &, const AlphaType &);
 	static BlitFunc blitFunc;
+	static void selectBlitFunc();
 
 	static void fillGeneric(Args &args, const TSpriteBlendMode &blendMode);
 	template<class T>
@@ -408,6 +416,34 @@ public:
 			  const TSpriteBlendMode blendMode,
 			  const AlphaType alphaType);
 
+	/** The parameters of blit() which may differ between the sprites of blitBatch(). */
+	struct Sprite {
+		const byte *src;
+		uint srcPitch;
+		int posX, posY;
+		uint width, height;
+		int scaleX, scaleY;
+		int scaleXsrcOff, scaleYsrcOff;
+		uint32 colorMod;
+		uint flipping;
+	};
+
+	/**
+	 * Same as calling blit() for each of the sprites in turn, but selects
+	 * the blitting function only once for all of them.
+	 * NOTE: Can only be used with BlendBlit::getSupportedPixelFormat format
+	 * @param dst a pointer to the destination buffer
+	 * @param dstPitch destination pitch
+	 * @param sprites the sprites to blit, in drawing order
+	 * @param count number of sprites
+	 * @param blendMode the blending mode to be used for all sprites
+	 * @param alphaType the alpha mixing mode to be used for all sprites
+	 */
+	static void blitBatch(byte *dst, const uint dstPitch,
+			  const Sprite *sprites, const uint count,
+			  const TSpriteBlendMode blendMode,
+			  const AlphaType alphaType);
+
 	/**
 	 * Optimized version of doFill to be used with alpha blended fills
 	 * NOTE: Can only be used with BlendBlit::getSupportedPixelFormat format
@@ -223,22 +223,44 @@ void BlendBlit::blit(byte *dst, const byte *src,
 	if (width == 0 || height == 0) return;
 
 	// If no function has been selected yet, detect and select
-	if (!blitFunc) {
-		// Get the correct blit function
-		blitFunc = blitGeneric;
+	if (!blitFunc)
+		selectBlitFunc();
+
+	Args args(dst, src, dstPitch, srcPitch, posX, posY, width, height, scaleX, scaleY, scaleXsrcOff, scaleYsrcOff, colorMod, flipping);
+	blitFunc(args, blendMode, alphaType);
+}
+
+void BlendBlit::blitBatch(byte *dst, const uint dstPitch,
+						  const Sprite *sprites, const uint count,
+						  const TSpriteBlendMode blendMode,
+						  const AlphaType alphaType) {
+	if (!blitFunc)
+		selectBlitFunc();
+
+	const BlitFunc func = blitFunc;
+	for (uint i = 0; i < count; i++) {
+		const Sprite &sprite = sprites[i];
+		if (sprite.width == 0 || sprite.height == 0)
+			continue;
+
+		Args args(dst, sprite.src, dstPitch, sprite.srcPitch, sprite.posX, sprite.posY, sprite.width, sprite.height,
+		          sprite.scaleX, sprite.scaleY, sprite.scaleXsrcOff, sprite.scaleYsrcOff, sprite.colorMod, sprite.flipping);
+		func(args, blendMode, alphaType);
+	}
+}
+
+void BlendBlit::selectBlitFunc() {
+	// Get the correct blit function
+	blitFunc = blitGeneric;
 #ifdef SCUMMVM_NEON
-		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) blitFunc = blitNEON;
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) blitFunc = blitNEON;
 #endif
 #ifdef SCUMMVM_SSE2
-		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) blitFunc = blitSSE2;
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) blitFunc = blitSSE2;
 #endif
 #ifdef SCUMMVM_AVX2
-		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) blitFunc = blitAVX2;
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) blitFunc = blitAVX2;
 #endif
-	}
-	
-	Args args(dst, src, dstPitch, srcPitch, posX, posY, width, height, scaleX, scaleY, scaleXsrcOff, scaleYsrcOff, colorMod, flipping);
-	blitFunc(args, blendMode, alphaType);
 }
 
 // Only fills 32bpp images
@@ -22,6 +22,7 @@
 #include "common/scummsys.h"
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-map.h"
 #include "graphics/pixelformat.h"
 
 #include <immintrin.h>
@@ -321,6 +322,66 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+template<typename DstColor, bool hasKey, bool hasMask>
+static void mapBlitRowAVX2(byte *dst, const byte *src, const byte *mask, uint w, const uint32 *map, uint32 key) {
+	const __m256i keyVec = _mm256_set1_epi32(key);
+
+	// Sixteen pixels at a time, from right to left
+	while (w >= 16) {
+		w -= 16;
+
+		const __m128i colors = _mm_loadu_si128((const __m128i *)(src + w));
+		const __m256i colorsLo = _mm256_cvtepu8_epi32(colors);
+		const __m256i colorsHi = _mm256_cvtepu8_epi32(_mm_srli_si128(colors, 8));
+		__m256i lo = _mm256_i32gather_epi32((const int *)map, colorsLo, 4);
+		__m256i hi = _mm256_i32gather_epi32((const int *)map, colorsHi, 4);
+
+		// The pixels keeping their destination color
+		__m256i keepLo = _mm256_setzero_si256(), keepHi = _mm256_setzero_si256();
+		if (hasKey) {
+			keepLo = _mm256_cmpeq_epi32(colorsLo, keyVec);
+			keepHi = _mm256_cmpeq_epi32(colorsHi, keyVec);
+		} else if (hasMask) {
+			const __m128i maskBytes = _mm_loadu_si128((const __m128i *)(mask + w));
+			keepLo = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(maskBytes), _mm256_setzero_si256());
+			keepHi = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(maskBytes, 8)), _mm256_setzero_si256());
+		}
+
+		if (sizeof(DstColor) == 4) {
+			__m256i *out = (__m256i *)(dst + w * 4);
+			if (hasKey || hasMask) {
+				lo = _mm256_blendv_epi8(lo, _mm256_loadu_si256(out), keepLo);
+				hi = _mm256_blendv_epi8(hi, _mm256_loadu_si256(out + 1), keepHi);
+			}
+			_mm256_storeu_si256(out, lo);
+			_mm256_storeu_si256(out + 1, hi);
+		} else {
+			// Truncate the map entries like the generic code before packing them
+			lo = _mm256_and_si256(lo, _mm256_set1_epi32(0xFFFF));
+			hi = _mm256_and_si256(hi, _mm256_set1_epi32(0xFFFF));
+			__m256i pixels = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+
+			__m256i *out = (__m256i *)(dst + w * 2);
+			if (hasKey || hasMask) {
+				const __m256i keep = _mm256_permute4x64_epi64(_mm256_packs_epi32(keepLo, keepHi), 0xD8);
+				pixels = _mm256_blendv_epi8(pixels, _mm256_loadu_si256(out), keep);
+			}
+			_mm256_storeu_si256(out, pixels);
+		}
+	}
+
+	MapBlitKernels::blitRowGeneric<DstColor, hasKey, hasMask>(dst, src, mask, w, map, key);
+}
+
+const MapBlitKernels::Funcs MapBlitKernels::funcsAVX2 = {
+	mapBlitRowAVX2<uint16, false, false>,
+	mapBlitRowAVX2<uint32, false, false>,
+	mapBlitRowAVX2<uint16, true, false>,
+	mapBlitRowAVX2<uint32, true, false>,
+	mapBlitRowAVX2<uint16, false, true>,
+	mapBlitRowAVX2<uint32, false, true>
+};
+
 } // End of namespace Graphics
 
 #if defined(__clang__)
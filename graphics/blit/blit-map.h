@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_BLIT_MAP_H
+#define GRAPHICS_BLIT_BLIT_MAP_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * The row kernels of crossBlitMap(), crossKeyBlitMap() and
+ * crossMaskBlitMap() for 16 and 32 bpp destinations, with SIMD variants
+ * looking up several palette entries at once.
+ *
+ * Rows are converted from right to left, reading each chunk of source
+ * pixels before writing the destination pixels, so that a CLUT8 surface
+ * can still be converted in place.
+ */
+class MapBlitKernels {
+public:
+	/**
+	 * Convert the first w pixels of a row. The mask is only used by the
+	 * mask kernels, the key only by the key kernels.
+	 */
+	typedef void (*RowFunc)(byte *dst, const byte *src, const byte *mask, uint w, const uint32 *map, uint32 key);
+
+	struct Funcs {
+		RowFunc blit16;
+		RowFunc blit32;
+		RowFunc keyBlit16;
+		RowFunc keyBlit32;
+		RowFunc maskBlit16;
+		RowFunc maskBlit32;
+
+		/** Return the kernel for a destination, or nullptr if there is none. */
+		RowFunc get(uint bytesPerPixel, bool hasKey, bool hasMask) const {
+			if (bytesPerPixel == 2)
+				return hasKey ? keyBlit16 : (hasMask ? maskBlit16 : blit16);
+			if (bytesPerPixel == 4)
+				return hasKey ? keyBlit32 : (hasMask ? maskBlit32 : blit32);
+			return nullptr;
+		}
+	};
+
+	/**
+	 * Return the kernels best suited for the CPU we are running on.
+	 * The selection is done on the first call.
+	 */
+	static const Funcs &getFuncs();
+
+	/** The kernels in use, nullptr until they have been selected. */
+	static const Funcs *selectedFuncs;
+
+	/** Convert pixel by pixel, used when no SIMD kernels are available. */
+	static const Funcs funcsNone;
+#ifdef SCUMMVM_NEON
+	static const Funcs funcsNEON;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Funcs funcsAVX2;
+#endif
+
+	/** The generic kernel, used by the SIMD variants for the remaining pixels. */
+	template<typename DstColor, bool hasKey, bool hasMask>
+	static void blitRowGeneric(byte *dst, const byte *src, const byte *mask, uint w, const uint32 *map, uint32 key) {
+		DstColor *out = (DstColor *)dst;
+		while (w-- > 0) {
+			const byte color = src[w];
+			if ((!hasKey || color != key) && (!hasMask || mask[w] != 0))
+				out[w] = map[color];
+		}
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -24,6 +24,7 @@
 #ifdef SCUMMVM_NEON
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-map.h"
 #include "graphics/pixelformat.h"
 
 #include <arm_neon.h>
@@ -376,6 +377,62 @@ void fastBlitNEON_XRGB1555_RGB565(byte *dst, const byte *src,
 	}
 }
 
+static inline uint32x4_t mapLookupNEON(const uint32 *map, const byte *colors) {
+	uint32x4_t result = vdupq_n_u32(map[colors[0]]);
+	result = vsetq_lane_u32(map[colors[1]], result, 1);
+	result = vsetq_lane_u32(map[colors[2]], result, 2);
+	return vsetq_lane_u32(map[colors[3]], result, 3);
+}
+
+template<typename DstColor, bool hasKey, bool hasMask>
+static void mapBlitRowNEON(byte *dst, const byte *src, const byte *mask, uint w, const uint32 *map, uint32 key) {
+	// Eight pixels at a time, from right to left
+	while (w >= 8) {
+		w -= 8;
+
+		const uint32x4_t lo = mapLookupNEON(map, src + w);
+		const uint32x4_t hi = mapLookupNEON(map, src + w + 4);
+
+		// The pixels keeping their destination color, without branching
+		uint8x8_t keep = vdup_n_u8(0);
+		if (hasKey && key <= 0xFF)
+			keep = vceq_u8(vld1_u8(src + w), vdup_n_u8(key));
+		else if (hasMask)
+			keep = vceq_u8(vld1_u8(mask + w), vdup_n_u8(0));
+		const uint16x8_t keep16 = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(keep)));
+
+		if (sizeof(DstColor) == 4) {
+			uint32 *out = (uint32 *)dst + w;
+			uint32x4_t pixelsLo = lo, pixelsHi = hi;
+			if (hasKey || hasMask) {
+				const uint32x4_t keepLo = vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(vget_low_u16(keep16))));
+				const uint32x4_t keepHi = vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(vget_high_u16(keep16))));
+				pixelsLo = vbslq_u32(keepLo, vld1q_u32(out), pixelsLo);
+				pixelsHi = vbslq_u32(keepHi, vld1q_u32(out + 4), pixelsHi);
+			}
+			vst1q_u32(out, pixelsLo);
+			vst1q_u32(out + 4, pixelsHi);
+		} else {
+			uint16 *out = (uint16 *)dst + w;
+			uint16x8_t pixels = vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+			if (hasKey || hasMask)
+				pixels = vbslq_u16(keep16, vld1q_u16(out), pixels);
+			vst1q_u16(out, pixels);
+		}
+	}
+
+	MapBlitKernels::blitRowGeneric<DstColor, hasKey, hasMask>(dst, src, mask, w, map, key);
+}
+
+const MapBlitKernels::Funcs MapBlitKernels::funcsNEON = {
+	mapBlitRowNEON<uint16, false, false>,
+	mapBlitRowNEON<uint32, false, false>,
+	mapBlitRowNEON<uint16, true, false>,
+	mapBlitRowNEON<uint32, true, false>,
+	mapBlitRowNEON<uint16, false, true>,
+	mapBlitRowNEON<uint32, false, true>
+};
+
 } // end of namespace Graphics
 
 #if !defined(__aarch64__) && !defined(__ARM_NEON)
@@ -20,8 +20,11 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-map.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/mutex.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -371,6 +374,102 @@ bool crossMaskBlit(byte *dst, const byte *src, const byte *mask,
 
 namespace {
 
+/** A palette converted by convertPaletteToMapCached(). */
+struct PaletteMapCacheEntry {
+	uint32 lastUse;          ///< 0 if the entry is unused
+	uint colors;
+	PixelFormat format;
+	byte palette[256 * 3];
+	uint32 map[256];
+};
+
+enum {
+	kPaletteMapCacheSize = 8
+};
+
+PaletteMapCacheEntry paletteMapCache[kPaletteMapCacheSize];
+uint32 paletteMapCacheUses = 0;
+Common::Mutex *paletteMapCacheMutex = nullptr;
+
+/**
+ * Locks the palette map cache, which may be used by blits on several threads.
+ *
+ * The Mutex class can only be used once g_system is set and initialized, but
+ * blits may happen earlier than that. Hopefully there are no other threads
+ * in those early stages.
+ */
+class PaletteMapCacheLock {
+public:
+	PaletteMapCacheLock() : _mutex(nullptr) {
+		if (!g_system || !g_system->backendInitialized())
+			return;
+		if (!paletteMapCacheMutex)
+			paletteMapCacheMutex = new Common::Mutex();
+		_mutex = paletteMapCacheMutex;
+		_mutex->lock();
+	}
+
+	~PaletteMapCacheLock() {
+		if (_mutex)
+			_mutex->unlock();
+	}
+
+private:
+	Common::Mutex *_mutex;
+};
+
+} // End of anonymous namespace
+
+void convertPaletteToMapCached(uint32 *dst, const byte *src, uint colors, const PixelFormat &format) {
+	assert(colors <= 256);
+
+	PaletteMapCacheLock lock;
+	PaletteMapCacheEntry *oldest = &paletteMapCache[0];
+	for (int i = 0; i < kPaletteMapCacheSize; i++) {
+		PaletteMapCacheEntry &entry = paletteMapCache[i];
+		if (entry.lastUse && entry.colors == colors && entry.format == format &&
+		    !memcmp(entry.palette, src, colors * 3)) {
+			entry.lastUse = ++paletteMapCacheUses;
+			memcpy(dst, entry.map, colors * sizeof(uint32));
+			return;
+		}
+
+		if (entry.lastUse < oldest->lastUse)
+			oldest = &entry;
+	}
+
+	// Replace the least recently used entry
+	oldest->lastUse = ++paletteMapCacheUses;
+	oldest->colors = colors;
+	oldest->format = format;
+	memcpy(oldest->palette, src, colors * 3);
+	convertPaletteToMap(oldest->map, src, colors, format);
+	memcpy(dst, oldest->map, colors * sizeof(uint32));
+}
+
+const MapBlitKernels::Funcs MapBlitKernels::funcsNone = {
+	nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+const MapBlitKernels::Funcs *MapBlitKernels::selectedFuncs = nullptr;
+
+const MapBlitKernels::Funcs &MapBlitKernels::getFuncs() {
+	// If no kernels have been selected yet, detect and select
+	if (!selectedFuncs) {
+		selectedFuncs = &funcsNone;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) selectedFuncs = &funcsNEON;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) selectedFuncs = &funcsAVX2;
+#endif
+	}
+
+	return *selectedFuncs;
+}
+
+namespace {
+
 template<typename DstColor, int DstSize, bool backward, bool hasKey, bool hasMask>
 inline void crossBlitMapLogic(byte *dst, const byte *src, const byte *mask, const uint w, const uint h,
 									const uint srcDelta, const uint dstDelta, const uint maskDelta, const uint32 *map, const uint32 key) {
@@ -422,6 +521,15 @@ inline bool crossBlitMapHelperLogic(byte *dst, const byte *src, const byte *mask
 	const uint dstDelta  = (dstPitch  - w * bytesPerPixel);
 	const uint maskDelta = hasMask ? (maskPitch - w) : 0;
 
+	// Use the row kernels when there are any, going from the bottom row
+	// to the top one for the same reason as below.
+	const MapBlitKernels::RowFunc blitRow = MapBlitKernels::getFuncs().get(bytesPerPixel, hasKey, hasMask);
+	if (blitRow) {
+		for (uint y = h; y-- > 0; )
+			blitRow(dst + y * dstPitch, src + y * srcPitch, hasMask ? mask + y * maskPitch : nullptr, w, map, key);
+		return true;
+	}
+
 	if (bytesPerPixel == 1) {
 		crossBlitMapLogic<uint8, 1, false, hasKey, hasMask>(dst, src, mask, w, h, srcDelta, dstDelta, maskDelta, map, key);
 	} else if (bytesPerPixel == 2) {
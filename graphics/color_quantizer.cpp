@@ -19,10 +19,12 @@
  *
  */
 
+#include "common/endian.h"
 #include "common/stack.h"
 
 #include "graphics/color_quantizer.h"
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Graphics {
 
@@ -97,6 +99,16 @@ private:
 		_nodePool.push(node);
 	}
 
+	void releaseNodeRecursively(OctreeNode *node) {
+		if (!node)
+			return;
+
+		for (int i = 0; i < 8; i++)
+			releaseNodeRecursively(node->child[i]);
+
+		releaseNode(node);
+	}
+
 	void deleteNodeRecursively(OctreeNode *node) {
 		if (!node)
 			return;
@@ -107,7 +119,7 @@ private:
 		delete node;
 	}
 
-	void insert(OctreeNode **node, byte r, byte g, byte b, uint level) {
+	void insert(OctreeNode **node, byte r, byte g, byte b, uint32 count, uint level) {
 		if (*node == nullptr) {
 			*node = allocateNode(level);
 			if (level != _leafLevel) {
@@ -123,10 +135,10 @@ private:
 		// regular node. But I saw no mention of this in the article.
 
 		if ((*node)->isLeaf) {
-			(*node)->numPixels++;
-			(*node)->sumRed += r;
-			(*node)->sumGreen += g;
-			(*node)->sumBlue += b;
+			(*node)->numPixels += count;
+			(*node)->sumRed += r * count;
+			(*node)->sumGreen += g * count;
+			(*node)->sumBlue += b * count;
 		} else {
 			byte bit = (0x80 >> level);
 			byte rbit = (r & bit) >> (5 - level);
@@ -134,7 +146,7 @@ private:
 			byte bbit = (b & bit) >> (7 - level);
 			int idx = rbit | gbit | bbit;
 
-			insert(&((*node)->child[idx]), r, g, b, level + 1);
+			insert(&((*node)->child[idx]), r, g, b, count, level + 1);
 		}
 
 		// Usually one reduction would be enough, but it's possible
@@ -233,15 +245,30 @@ public:
 		deleteNodeRecursively(_root);
 	}
 
-	void insert(byte r, byte g, byte b) {
-		insert(&_root, r, g, b, 0);
+	/**
+	 * Add a color count times. This gives the same tree as adding it
+	 * count times in a row, since only new leaves cause reductions.
+	 */
+	void insert(byte r, byte g, byte b, uint32 count) {
+		insert(&_root, r, g, b, count, 0);
+	}
+
+	/** Remove all colors, keeping the nodes around for reuse. */
+	void clear() {
+		releaseNodeRecursively(_root);
+		_root = nullptr;
+		_numLeaves = 0;
+
+		for (uint i = 0; i < kOctreeDepth - 1; i++)
+			_reduceList[i] = nullptr;
 	}
 
 	Palette *getPalette() {
 		_palette = new Graphics::Palette(_maxLeaves);
 		_colorIndex = 0;
 
-		getPalette(_root);
+		if (_root)
+			getPalette(_root);
 
 		return _palette;
 	}
@@ -256,7 +283,80 @@ ColorQuantizer::~ColorQuantizer() {
 }
 
 void ColorQuantizer::addColor(byte r, byte g, byte b) {
-	_octree->insert(r, g, b);
+	_octree->insert(r, g, b, 1);
+}
+
+void ColorQuantizer::addColors(const byte *colors, uint count) {
+	// Runs of the same color are added at once
+	uint i = 0;
+	while (i < count) {
+		const byte *color = colors + i * 3;
+		uint32 run = 1;
+		while (i + run < count && !memcmp(color, colors + (i + run) * 3, 3))
+			run++;
+
+		_octree->insert(color[0], color[1], color[2], run);
+		i += run;
+	}
+}
+
+void ColorQuantizer::addSurface(const Surface &surface, const byte *palette) {
+	const PixelFormat &format = surface.format;
+	assert(!format.isCLUT8() || palette);
+
+	for (int y = 0; y < surface.h; y++) {
+		const byte *src = (const byte *)surface.getBasePtr(0, y);
+		uint32 runColor = 0;
+		uint32 run = 0;
+
+		for (int x = 0; x < surface.w; x++) {
+			uint32 color;
+			switch (format.bytesPerPixel) {
+			case 1:
+				color = src[x];
+				break;
+			case 2:
+				color = ((const uint16 *)src)[x];
+				break;
+			case 3:
+				color = READ_UINT24(src + x * 3);
+				break;
+			default:
+				color = ((const uint32 *)src)[x];
+				break;
+			}
+
+			if (run && color == runColor) {
+				run++;
+				continue;
+			}
+
+			if (run)
+				addPixels(format, palette, runColor, run);
+			runColor = color;
+			run = 1;
+		}
+
+		if (run)
+			addPixels(format, palette, runColor, run);
+	}
+}
+
+void ColorQuantizer::addPixels(const PixelFormat &format, const byte *palette, uint32 color, uint32 count) {
+	byte r, g, b;
+	if (format.isCLUT8()) {
+		r = palette[color * 3 + 0];
+		g = palette[color * 3 + 1];
+		b = palette[color * 3 + 2];
+	} else {
+		format.colorToRGB(color, r, g, b);
+	}
+
+	_octree->insert(r, g, b, count);
+}
+
+void ColorQuantizer::reset() {
+	_octree->clear();
 }
 
 Graphics::Palette *ColorQuantizer::getPalette() {
@@ -22,10 +22,14 @@
 #ifndef GRAPHICS_COLOR_QUANTIZER_H
 #define GRAPHICS_COLOR_QUANTIZER_H
 
+#include "common/scummsys.h"
+
 namespace Graphics {
 
 class Octree;
 class Palette;
+struct PixelFormat;
+struct Surface;
 
 /**
  * @brief Class for selecting a good palette from a large number of colors.
@@ -33,12 +37,18 @@ class Palette;
  * Colors are added one by one, after which a palette with at most maxColors
  * entries can be retrieved. The caller is responsible for freeing the palette
  * afterwards.
+ *
+ * More colors can still be added after retrieving a palette, and the
+ * quantizer can be reset to be used for another image without allocating
+ * its tree again.
  */
 
 class ColorQuantizer {
 private:
 	Octree *_octree = nullptr;
 
+	void addPixels(const PixelFormat &format, const byte *palette, uint32 color, uint32 count);
+
 public:
 	/**
 	 * @brief Construct a new ColorQuantizer object
@@ -57,6 +67,30 @@ public:
 	 */
 	void addColor(byte r, byte g, byte b);
 
+	/**
+	 * @brief Add several colors to the quantizer
+	 *
+	 * @param colors   the colors, in interleaved RGB format
+	 * @param count    the number of colors
+	 */
+	void addColors(const byte *colors, uint count);
+
+	/**
+	 * @brief Add all pixels of a surface to the quantizer
+	 *
+	 * This gives the same palette as adding the pixels one by one with
+	 * addColor(), but adds runs of the same color at once.
+	 *
+	 * @param surface   the surface
+	 * @param palette   the palette of the surface, if it is CLUT8
+	 */
+	void addSurface(const Surface &surface, const byte *palette = nullptr);
+
+	/**
+	 * @brief Remove all colors added so far
+	 */
+	void reset();
+
 	/**
 	 * @brief Retrieve the resulting palette from the quantizer.
 	 *
@@ -0,0 +1,158 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/dirtyregion.h"
+
+#include "common/util.h"
+
+namespace Graphics {
+
+DirtyRegion::DirtyRegion(int tileSize) : _tileSize(tileSize), _minRectHeight(1), _tilesPerRow(0), _tileRows(0),
+		_numDirtyTiles(0), _firstDirtyRow(0), _lastDirtyRow(-1), _rectsValid(true) {
+	assert(tileSize > 0);
+}
+
+void DirtyRegion::setBounds(const Common::Rect &bounds) {
+	_bounds = bounds;
+	_tilesPerRow = (bounds.width() + _tileSize - 1) / _tileSize;
+	_tileRows = (bounds.height() + _tileSize - 1) / _tileSize;
+
+	_tiles.clear();
+	_tiles.resize(_tilesPerRow * _tileRows);
+	_numDirtyTiles = 0;
+	_firstDirtyRow = _tileRows;
+	_lastDirtyRow = -1;
+
+	_rects.clear();
+	_rectsValid = true;
+}
+
+void DirtyRegion::addRect(const Common::Rect &r) {
+	Common::Rect rect = r;
+	rect.clip(_bounds);
+	if (rect.isEmpty())
+		return;
+
+	const int firstColumn = (rect.left - _bounds.left) / _tileSize;
+	const int lastColumn = (rect.right - 1 - _bounds.left) / _tileSize;
+	const int firstRow = (rect.top - _bounds.top) / _tileSize;
+	const int lastRow = (rect.bottom - 1 - _bounds.top) / _tileSize;
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		const int16 tileTop = _bounds.top + row * _tileSize;
+		const int16 top = MAX<int16>(rect.top, tileTop);
+		const int16 bottom = MIN<int16>(rect.bottom, tileTop + _tileSize);
+
+		Common::Rect *tile = &_tiles[row * _tilesPerRow + firstColumn];
+		for (int column = firstColumn; column <= lastColumn; column++, tile++) {
+			const int16 tileLeft = _bounds.left + column * _tileSize;
+			const Common::Rect part(MAX<int16>(rect.left, tileLeft), top,
+			                        MIN<int16>(rect.right, tileLeft + _tileSize), bottom);
+
+			if (tile->isEmpty()) {
+				*tile = part;
+				_numDirtyTiles++;
+			} else {
+				tile->extend(part);
+			}
+		}
+	}
+
+	_firstDirtyRow = MIN(_firstDirtyRow, firstRow);
+	_lastDirtyRow = MAX(_lastDirtyRow, lastRow);
+	_rectsValid = false;
+}
+
+void DirtyRegion::clear() {
+	if (_numDirtyTiles) {
+		for (int i = _firstDirtyRow * _tilesPerRow; i < (_lastDirtyRow + 1) * _tilesPerRow; i++) {
+			_tiles[i] = Common::Rect();
+		}
+	}
+
+	_numDirtyTiles = 0;
+	_firstDirtyRow = _tileRows;
+	_lastDirtyRow = -1;
+
+	_rects.clear();
+	_rectsValid = true;
+}
+
+const Common::Array<Common::Rect> &DirtyRegion::getRects() {
+	if (_rectsValid)
+		return _rects;
+
+	_rects.clear();
+	_prevRuns.clear();
+
+	for (int row = _firstDirtyRow; row <= _lastDirtyRow; row++) {
+		const Common::Rect *tiles = &_tiles[row * _tilesPerRow];
+		uint prevRun = 0;
+
+		_runs.clear();
+		for (int column = 0; column < _tilesPerRow; column++) {
+			if (tiles[column].isEmpty())
+				continue;
+
+			// Join the modified tiles next to each other
+			Run run;
+			run.left = column;
+			Common::Rect box = tiles[column];
+			while (column + 1 < _tilesPerRow && !tiles[column + 1].isEmpty()) {
+				column++;
+				box.extend(tiles[column]);
+			}
+			run.right = column + 1;
+
+			// and the run with one spanning the same tiles in the row above.
+			// Both rows' runs are ordered, so this only needs a single pass.
+			while (prevRun < _prevRuns.size() && _prevRuns[prevRun].left < run.left)
+				prevRun++;
+
+			if (prevRun < _prevRuns.size() && _prevRuns[prevRun].left == run.left && _prevRuns[prevRun].right == run.right) {
+				run.rect = _prevRuns[prevRun].rect;
+				_rects[run.rect].extend(box);
+			} else {
+				run.rect = _rects.size();
+				_rects.push_back(box);
+			}
+
+			_runs.push_back(run);
+		}
+
+		_runs.swap(_prevRuns);
+	}
+
+	// Parts of rectangles at the edges of tiles may be thinner than
+	// the rectangles added
+	for (uint i = 0; i < _rects.size(); i++) {
+		Common::Rect &r = _rects[i];
+		if (r.height() < _minRectHeight) {
+			r.bottom = MIN<int>(r.top + _minRectHeight, _bounds.bottom);
+			r.top = MAX<int>(r.bottom - _minRectHeight, _bounds.top);
+		}
+	}
+
+	_rectsValid = true;
+	return _rects;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTYREGION_H
+#define GRAPHICS_DIRTYREGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirtyregion Dirty region
+ * @ingroup graphics
+ *
+ * @brief DirtyRegion class for tracking the modified areas of a surface.
+ *
+ * @{
+ */
+
+/**
+ * Keeps track of the modified areas of a surface, and coalesces them into
+ * a few rectangles which do not overlap, unless they are made higher with
+ * setMinRectHeight().
+ *
+ * The area is split into square tiles, each of which remembers the bounding
+ * box of the parts of the added rectangles within it. Adding a rectangle
+ * takes time linear in the number of tiles it touches, and coalescing takes
+ * time linear in the number of tiles, however many rectangles were added.
+ * The resulting rectangles are at most as large as the dirty tiles they
+ * cover.
+ */
+class DirtyRegion {
+public:
+	DirtyRegion(int tileSize = 16);
+
+	/**
+	 * Set the area to track. Added rectangles are clipped to it.
+	 * This also clears the region.
+	 */
+	void setBounds(const Common::Rect &bounds);
+
+	/** Get the area being tracked. */
+	const Common::Rect &getBounds() const { return _bounds; }
+
+	/**
+	 * Make the rectangles returned by getRects() at least this many rows
+	 * high, as far as the bounds allow, for users which cannot process
+	 * thinner ones. Rectangles grown this way may overlap others.
+	 */
+	void setMinRectHeight(int height) { _minRectHeight = height; _rectsValid = false; }
+
+	/** Mark a rectangle as modified. */
+	void addRect(const Common::Rect &r);
+
+	/** Mark nothing as modified. */
+	void clear();
+
+	/** Return true if nothing is marked as modified. */
+	bool isEmpty() const { return _numDirtyTiles == 0; }
+
+	/**
+	 * Get rectangles which cover all the modified areas and do not overlap,
+	 * ordered from top to bottom and left to right.
+	 */
+	const Common::Array<Common::Rect> &getRects();
+
+private:
+	struct Run {
+		int left, right; ///< Tile columns of the run, right being exclusive
+		uint rect;       ///< Index of the rectangle in _rects containing the run
+	};
+
+	int _tileSize;
+	int _minRectHeight;
+	int _tilesPerRow;
+	int _tileRows;
+	Common::Rect _bounds;
+
+	/** Bounding box of the modified parts of each tile, empty if there are none. */
+	Common::Array<Common::Rect> _tiles;
+	uint _numDirtyTiles;
+	/** Tile rows which may contain modified tiles. */
+	int _firstDirtyRow, _lastDirtyRow;
+
+	Common::Array<Common::Rect> _rects;
+	bool _rectsValid;
+	Common::Array<Run> _runs, _prevRuns;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
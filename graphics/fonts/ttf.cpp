@@ -994,7 +994,7 @@ Font *loadTTFFontFromArchive(const Common::String &filename, int size, TTFSizeMo
 		return nullptr;
 	}
 
-	// HACK: We currently assume that ZipArchive always loads the whole file into memory, so we can delete the archive here.
+	// Members of a ZipArchive may outlive it, so we can delete the archive here.
 	delete archive;
 	return font;
 }
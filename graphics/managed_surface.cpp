@@ -379,7 +379,7 @@ void ManagedSurface::simpleBlitFromInner(const Surface &src, const Common::Rect
 		assert(!format.isCLUT8());
 
 		uint32 map[256];
-		convertPaletteToMap(map, srcPalette->data(), srcPalette->size(), format);
+		convertPaletteToMapCached(map, srcPalette->data(), srcPalette->size(), format);
 
 		if (transparentColorSet) {
 			crossKeyBlitMap(dstPtr, srcPtr, pitch, src.pitch, srcRectC.width(), srcRectC.height(),
@@ -452,7 +452,7 @@ void ManagedSurface::maskBlitFromInner(const Surface &src, const Surface &mask,
 		assert(!format.isCLUT8());
 
 		uint32 map[256];
-		convertPaletteToMap(map, srcPalette->data(), srcPalette->size(), format);
+		convertPaletteToMapCached(map, srcPalette->data(), srcPalette->size(), format);
 		crossMaskBlitMap(dstPtr, srcPtr, maskPtr, pitch, src.pitch, mask.pitch, srcRectC.width(), srcRectC.height(),
 			format.bytesPerPixel, map);
 	} else {
@@ -958,9 +958,6 @@ void ManagedSurface::blendBlitFrom(const ManagedSurface &src, const Common::Rect
 void ManagedSurface::blendBlitFromInner(const Surface &src, const Common::Rect &srcRect,
 		const Common::Rect &destRect, const int flipping, const uint colorMod,
 		const TSpriteBlendMode blend, const AlphaType alphaType) {
-	Common::Rect srcRectC = srcRect;
-	Common::Rect destRectC = destRect;
-
 	if (!isBlendBlitPixelFormatSupported(src.format, format)) {
 		warning("ManagedSurface::blendBlitFrom only accepts RGBA32!");
 		return;
@@ -969,6 +966,31 @@ void ManagedSurface::blendBlitFromInner(const Surface &src, const Common::Rect &
 	// Alpha is zero
 	if ((colorMod & MS_ARGB(255, 0, 0, 0)) == 0) return;
 
+	BlendBlit::Sprite sprite;
+	Common::Rect destRectC;
+	if (clipBlendBlit(src, srcRect, destRect, flipping, colorMod, sprite, destRectC)) {
+		BlendBlit::blit(
+			(byte *)getBasePtr(0, 0),
+			sprite.src,
+			pitch, sprite.srcPitch,
+			sprite.posX, sprite.posY,
+			sprite.width, sprite.height,
+			sprite.scaleX, sprite.scaleY,
+			sprite.scaleXsrcOff, sprite.scaleYsrcOff,
+			sprite.colorMod, sprite.flipping,
+			blend, alphaType);
+
+		// Mark the affected area
+		addDirtyRect(destRectC);
+	}
+}
+
+bool ManagedSurface::clipBlendBlit(const Surface &src, const Common::Rect &srcRect,
+		const Common::Rect &destRect, const int flipping, const uint colorMod,
+		BlendBlit::Sprite &sprite, Common::Rect &destRectC) const {
+	Common::Rect srcRectC = srcRect;
+	destRectC = destRect;
+
 	const int scaleX = BlendBlit::getScaleFactor(srcRectC.width(), destRectC.width());
 	const int scaleY = BlendBlit::getScaleFactor(srcRectC.height(), destRectC.height());
 	int scaleXoff = 0, scaleYoff = 0;
@@ -986,12 +1008,12 @@ void ManagedSurface::blendBlitFromInner(const Surface &src, const Common::Rect &
 	}
 
 	if (destRectC.right > w) {
-		srcRectC.right -= (destRectC.right - src.w) * scaleX / BlendBlit::SCALE_THRESHOLD;
+		srcRectC.right -= (destRectC.right - w) * scaleX / BlendBlit::SCALE_THRESHOLD;
 		destRectC.right = w;
 	}
 
 	if (destRectC.bottom > h) {
-		srcRectC.bottom -= (destRectC.bottom - src.h) * scaleY / BlendBlit::SCALE_THRESHOLD;
+		srcRectC.bottom -= (destRectC.bottom - h) * scaleY / BlendBlit::SCALE_THRESHOLD;
 		destRectC.bottom = h;
 	}
 
@@ -1009,21 +1031,133 @@ void ManagedSurface::blendBlitFromInner(const Surface &src, const Common::Rect &
 		scaleYoff = (BlendBlit::SCALE_THRESHOLD - (scaleYoff + destRectC.height() * scaleY)) % BlendBlit::SCALE_THRESHOLD;
 	}
 
-	if (!destRectC.isEmpty() && !srcRectC.isEmpty()) {
-		BlendBlit::blit(
-			(byte *)getBasePtr(0, 0),
-			(const byte *)src.getBasePtr(srcRectC.left, srcRectC.top),
-			pitch, src.pitch,
-			destRectC.left, destRectC.top,
-			destRectC.width(), destRectC.height(),
-			scaleX, scaleY,
-			scaleXoff, scaleYoff,
-			colorMod, flipping,
-			blend, alphaType);
+	if (destRectC.isEmpty() || srcRectC.isEmpty())
+		return false;
 
-		// Mark the affected area
-		addDirtyRect(destRectC);
+	sprite.src = (const byte *)src.getBasePtr(srcRectC.left, srcRectC.top);
+	sprite.srcPitch = src.pitch;
+	sprite.posX = destRectC.left;
+	sprite.posY = destRectC.top;
+	sprite.width = destRectC.width();
+	sprite.height = destRectC.height();
+	sprite.scaleX = scaleX;
+	sprite.scaleY = scaleY;
+	sprite.scaleXsrcOff = scaleXoff;
+	sprite.scaleYsrcOff = scaleYoff;
+	sprite.colorMod = colorMod;
+	sprite.flipping = flipping;
+	return true;
+}
+
+BlendBlitSprite::BlendBlitSprite(const ManagedSurface &s, const Common::Rect &sr, const Common::Rect &dr,
+		const int f, const uint c, const TSpriteBlendMode b, const AlphaType a) :
+	src(&s.rawSurface()), srcRect(sr), destRect(dr), flipping(f), colorMod(c), blend(b), alphaType(a) {
+}
+
+void ManagedSurface::blendBlitBatch(const BlendBlitSprite *sprites, uint count) {
+	// How many batches back a sprite may be moved to
+	const int kMaxBatchLookback = 16;
+
+	struct Batch {
+		const BlendBlitSprite *first;
+		Common::Rect bounds;
+		uint end;               ///< Number of sprites, then their end in the sorted order
+	};
+
+	if (!isBlendBlitPixelFormatSupported(format, format)) {
+		warning("ManagedSurface::blendBlitBatch only accepts RGBA32!");
+		return;
+	}
+
+	// Gather the sprites into batches. A sprite may join an earlier batch
+	// with the same source and modes if it does not overlap any of the
+	// batches after that one, since it will now be drawn before them.
+	Common::Array<Batch> batches;
+	Common::Array<uint> batchOf;
+	batchOf.resize(count);
+
+	for (uint i = 0; i < count; i++) {
+		const BlendBlitSprite &sprite = sprites[i];
+		const int last = (int)batches.size() - 1;
+		int batch = -1;
+
+		for (int b = last; b >= 0 && b > last - kMaxBatchLookback; b--) {
+			const BlendBlitSprite &first = *batches[b].first;
+			if (first.src == sprite.src && first.blend == sprite.blend && first.alphaType == sprite.alphaType) {
+				batch = b;
+				break;
+			}
+			if (batches[b].bounds.intersects(sprite.destRect))
+				break;
+		}
+
+		if (batch < 0) {
+			Batch newBatch;
+			newBatch.first = &sprite;
+			newBatch.bounds = sprite.destRect;
+			newBatch.end = 0;
+			batches.push_back(newBatch);
+			batch = batches.size() - 1;
+		} else {
+			batches[batch].bounds.extend(sprite.destRect);
+		}
+
+		batchOf[i] = batch;
+		batches[batch].end++;
+	}
+
+	// Sort the sprites by batch, keeping their order within each batch
+	uint start = 0;
+	for (uint b = 0; b < batches.size(); b++) {
+		const uint size = batches[b].end;
+		batches[b].end = start;
+		start += size;
 	}
+
+	Common::Array<const BlendBlitSprite *> order;
+	order.resize(count);
+	for (uint i = 0; i < count; i++)
+		order[batches[batchOf[i]].end++] = &sprites[i];
+
+	Common::Array<BlendBlit::Sprite> blits;
+	Common::Array<Common::Rect> dirtyRects;
+	blits.reserve(count);
+	dirtyRects.reserve(count);
+
+	uint next = 0;
+	for (uint b = 0; b < batches.size(); b++) {
+		const BlendBlitSprite &first = *batches[b].first;
+		const uint end = batches[b].end;
+
+		blits.clear();
+		if (!isBlendBlitPixelFormatSupported(first.src->format, format)) {
+			warning("ManagedSurface::blendBlitBatch only accepts RGBA32!");
+			next = end;
+			continue;
+		}
+
+		for (; next < end; next++) {
+			const BlendBlitSprite &sprite = *order[next];
+
+			// Alpha is zero
+			if ((sprite.colorMod & MS_ARGB(255, 0, 0, 0)) == 0)
+				continue;
+
+			BlendBlit::Sprite blit;
+			Common::Rect destRectC;
+			if (clipBlendBlit(*sprite.src, sprite.srcRect, sprite.destRect, sprite.flipping, sprite.colorMod, blit, destRectC)) {
+				blits.push_back(blit);
+				dirtyRects.push_back(destRectC);
+			}
+		}
+
+		if (!blits.empty())
+			BlendBlit::blitBatch((byte *)getBasePtr(0, 0), pitch, &blits[0], blits.size(), first.blend, first.alphaType);
+	}
+
+	// Mark the affected area
+	for (uint i = 0; i < dirtyRects.size(); i++)
+		addDirtyRect(dirtyRects[i]);
 }
 
 Common::Rect ManagedSurface::blendBlitTo(ManagedSurface &target,
@@ -25,6 +25,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/transform_struct.h"
+#include "common/array.h"
 #include "common/types.h"
 #include "graphics/blit.h"
 
@@ -44,6 +45,32 @@ class Palette;
  * @{
  */
 
+class ManagedSurface;
+
+/**
+ * A sprite to draw with ManagedSurface::blendBlitBatch(), with the same
+ * parameters as ManagedSurface::blendBlitFrom().
+ */
+struct BlendBlitSprite {
+	const Surface *src;         ///< Source surface
+	Common::Rect srcRect;       ///< Subsection of the source surface to draw
+	Common::Rect destRect;      ///< Destination area, may be sized differently than srcRect
+	int flipping;               ///< Flipping flags (use Graphics::FLIP_FLAGS)
+	uint colorMod;              ///< What color to multiply by (0xffffffff does nothing)
+	TSpriteBlendMode blend;     ///< The blending mode to use
+	AlphaType alphaType;        ///< What alpha mode to use
+
+	BlendBlitSprite() : src(nullptr), flipping(FLIP_NONE), colorMod(MS_ARGB(255, 255, 255, 255)),
+		blend(BLEND_NORMAL), alphaType(ALPHA_FULL) {}
+	BlendBlitSprite(const Surface &s, const Common::Rect &sr, const Common::Rect &dr,
+			const int f = FLIP_NONE, const uint c = MS_ARGB(255, 255, 255, 255),
+			const TSpriteBlendMode b = BLEND_NORMAL, const AlphaType a = ALPHA_FULL) :
+		src(&s), srcRect(sr), destRect(dr), flipping(f), colorMod(c), blend(b), alphaType(a) {}
+	BlendBlitSprite(const ManagedSurface &s, const Common::Rect &sr, const Common::Rect &dr,
+			const int f = FLIP_NONE, const uint c = MS_ARGB(255, 255, 255, 255),
+			const TSpriteBlendMode b = BLEND_NORMAL, const AlphaType a = ALPHA_FULL);
+};
+
 /**
  * A derived graphics surface, which supports automatically managing the allocated
  * surface data block and introduces several new blitting methods.
@@ -119,6 +146,15 @@ protected:
 		const Common::Rect &destRect, const int flipping, const uint colorMod,
 		const TSpriteBlendMode blend, const AlphaType alphaType);
 
+	/**
+	 * Clip a sprite for blending onto this surface, and work out the
+	 * parameters to pass to BlendBlit for it.
+	 * @return false if nothing of it is visible.
+	 */
+	bool clipBlendBlit(const Surface &src, const Common::Rect &srcRect,
+		const Common::Rect &destRect, const int flipping, const uint colorMod,
+		BlendBlit::Sprite &sprite, Common::Rect &clippedDestRect) const;
+
 public:
 	/**
 	 * Clip the given source bounds so the passed destBounds will be entirely on-screen.
@@ -736,6 +772,31 @@ public:
 		const TSpriteBlendMode blend = BLEND_NORMAL,
 		const AlphaType alphaType = ALPHA_FULL);
 
+	/**
+	 * Draw many sprites onto this surface, using alpha blending. This
+	 * gives the same result as calling blendBlitFrom() for each of them
+	 * in turn, but checks the pixel format and selects the blitting
+	 * function once per batch of sprites sharing the same source surface,
+	 * blending mode and alpha type, instead of once per sprite.
+	 *
+	 * Sprites are gathered into batches out of order only where this does
+	 * not change the result, i.e. when they do not overlap the sprites
+	 * they are moved past.
+	 *
+	 * @param sprites	The sprites to draw, from the back to the front.
+	 * @param count		Number of sprites.
+	 */
+	void blendBlitBatch(const BlendBlitSprite *sprites, uint count);
+
+	/**
+	 * Draw many sprites onto this surface, using alpha blending.
+	 * @see blendBlitBatch(const BlendBlitSprite *, uint)
+	 */
+	void blendBlitBatch(const Common::Array<BlendBlitSprite> &sprites) {
+		if (!sprites.empty())
+			blendBlitBatch(&sprites[0], sprites.size());
+	}
+
 	/**
 	 * @brief Renders this surface onto target
 	 * @param target renders this surface onto this one
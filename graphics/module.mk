@@ -9,6 +9,7 @@ MODULE_OBJS := \
 	blit/blit-scale.o \
 	color_quantizer.o \
 	cursorman.o \
+	dirtyregion.o \
 	font.o \
 	fontman.o \
 	fonts/amigafont.o \
@@ -96,9 +97,23 @@ MODULE_OBJS += \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/zspan_avx2.o
+endif
 endif
 
 ifdef USE_ASPECT
@@ -148,15 +163,18 @@ endif
 
 ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	blit/blit-neon.o
+	blit/blit-neon.o \
+	yuv_to_rgb_neon.o
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	blit/blit-sse2.o \
+	yuv_to_rgb_sse2.o
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
-	blit/blit-avx2.o
+	blit/blit-avx2.o \
+	yuv_to_rgb_avx2.o
 endif
 
 # Include common rules
@@ -33,6 +33,8 @@
 
 namespace OpenGL {
 
+Texture::UploadStats Texture::_uploadStats = { 0, 0 };
+
 Texture::Texture(GLenum glIntFormat, GLenum glFormat, GLenum glType, bool autoCreate)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
@@ -253,12 +255,10 @@ void Texture::updateArea(const Common::Rect &area, const Graphics::Surface &src)
 	}
 
 	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
+	// Where GL_UNPACK_ROW_LENGTH is available, the pitch of the surface can
+	// be specified and only the area itself is uploaded. OpenGL ES 1.0 and
+	// 2.0 do not support it though. Thus, we are left with the following
+	// options there:
 	//
 	// 1) (As we do right now) Simply always update the whole texture lines of
 	//    rect changed. This is simplest to implement. In case performance is
@@ -271,8 +271,20 @@ void Texture::updateArea(const Common::Rect &area, const Graphics::Surface &src)
 	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
 	//    graphics manager did but it is much slower! Thus, we do not use it.
 	GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	if (OpenGLContext.unpackSubImageSupported && area.width() != src.w) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / src.format.bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                       _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+
+		_uploadStats.bytes += area.width() * area.height() * src.format.bytesPerPixel;
+	} else {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
+		                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+		_uploadStats.bytes += src.w * area.height() * src.format.bytesPerPixel;
+	}
+	_uploadStats.uploads++;
 }
 
 } // End of namespace OpenGL
@@ -129,6 +129,17 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Amount of texture data uploaded with updateArea(), for all textures.
+	 */
+	struct UploadStats {
+		uint uploads;   ///< Number of uploads
+		uint64 bytes;   ///< Number of bytes uploaded
+	};
+
+	static const UploadStats &getUploadStats() { return _uploadStats; }
+	static void resetUploadStats() { _uploadStats.uploads = 0; _uploadStats.bytes = 0; }
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -191,6 +202,8 @@ protected:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	static UploadStats _uploadStats;
 };
 
 } // End of namespace OpenGL
@@ -18,6 +18,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "common/algorithm.h"
+#include "common/util.h"
+
 #include "graphics/palette.h"
 
 namespace Graphics {
@@ -206,10 +209,107 @@ bool PaletteLookup::setPalette(const byte *palette, uint len)  {
 	_paletteSize = len;
 	_palette.set(palette, 0, len);
 	_colorHash.clear();
+	_tree.clear();
 
 	return true;
 }
 
+void PaletteLookup::buildTree(uint first, uint last) {
+	if (last - first <= kTreeBucketSize)
+		return;
+
+	// Split the range on the component with the largest spread
+	byte minColor[3] = { 255, 255, 255 };
+	byte maxColor[3] = { 0, 0, 0 };
+	for (uint i = first; i < last; i++) {
+		for (int c = 0; c < 3; c++) {
+			minColor[c] = MIN(minColor[c], _tree[i].color[c]);
+			maxColor[c] = MAX(maxColor[c], _tree[i].color[c]);
+		}
+	}
+
+	byte axis = 0;
+	for (byte c = 1; c < 3; c++) {
+		if (maxColor[c] - minColor[c] > maxColor[axis] - minColor[axis])
+			axis = c;
+	}
+
+	Common::sort(_tree.begin() + first, _tree.begin() + last, [axis](const TreeNode &a, const TreeNode &b) {
+		return a.color[axis] < b.color[axis] || (a.color[axis] == b.color[axis] && a.index < b.index);
+	});
+
+	const uint middle = (first + last) / 2;
+	_tree[middle].axis = axis;
+	buildTree(first, middle);
+	buildTree(middle + 1, last);
+}
+
+template<ColorDistanceMethod method>
+inline void PaletteLookup::compareEntry(const TreeNode &node, const byte *color, uint32 &bestDist, uint &bestColor) {
+	// The same distances as Palette::findBestColor(), ties going to the
+	// lowest palette index like there
+	const int r = node.color[0] - color[0];
+	const int g = node.color[1] - color[1];
+	const int b = node.color[2] - color[2];
+	uint32 dist;
+	if (method == kColorDistanceEuclidean) {
+		dist = r * r + g * g + b * b;
+	} else if (method == kColorDistanceNaive) {
+		dist = 3 * r * r + 5 * g * g + 2 * b * b;
+	} else {
+		const int rmean = (node.color[0] + color[0]) / 2;
+		dist = (((512 + rmean) * r * r) >> 8) + 4 * g * g + (((767 - rmean) * b * b) >> 8);
+	}
+
+	if (dist < bestDist || (dist == bestDist && node.index < bestColor)) {
+		bestDist = dist;
+		bestColor = node.index;
+	}
+}
+
+template<ColorDistanceMethod method>
+void PaletteLookup::searchTree(uint first, uint last, const byte *color, uint32 *offsets, uint32 minDist, uint32 &bestDist, uint &bestColor) const {
+	// Small ranges are compared entry by entry
+	if (last - first <= kTreeBucketSize) {
+		for (uint i = first; i < last; i++)
+			compareEntry<method>(_tree[i], color, bestDist, bestColor);
+		return;
+	}
+
+	const uint middle = (first + last) / 2;
+	const TreeNode &node = _tree[middle];
+	compareEntry<method>(node, color, bestDist, bestColor);
+
+	// Search the side of the split the color is on first. The other side
+	// is only searched if its smallest possible distance to the color is
+	// not larger than the best one so far. That distance is tracked per
+	// component, with the smallest weight each one has in the distance.
+	static const uint32 weights[3][3] = {
+		{ 1, 1, 1 },  // kColorDistanceEuclidean
+		{ 3, 5, 2 },  // kColorDistanceNaive
+		{ 2, 4, 2 }   // kColorDistanceRedmean
+	};
+	const byte axis = node.axis;
+	const int delta = color[axis] - node.color[axis];
+	const uint32 offset = weights[method][axis] * (uint32)(delta * delta);
+
+	if (delta < 0)
+		searchTree<method>(first, middle, color, offsets, minDist, bestDist, bestColor);
+	else
+		searchTree<method>(middle + 1, last, color, offsets, minDist, bestDist, bestColor);
+
+	const uint32 oldOffset = offsets[axis];
+	const uint32 farDist = minDist - oldOffset + offset;
+	if (farDist <= bestDist) {
+		offsets[axis] = offset;
+		if (delta < 0)
+			searchTree<method>(middle + 1, last, color, offsets, farDist, bestDist, bestColor);
+		else
+			searchTree<method>(first, middle, color, offsets, farDist, bestDist, bestColor);
+		offsets[axis] = oldOffset;
+	}
+}
+
 byte PaletteLookup::findBestColor(byte cr, byte cg, byte cb, ColorDistanceMethod method) {
 	if (_paletteSize == 0) {
 		warning("PaletteLookup::findBestColor(): Palette was not set");
@@ -221,7 +321,39 @@ byte PaletteLookup::findBestColor(byte cr, byte cg, byte cb, ColorDistanceMethod
 	if (_colorHash.contains(color))
 		return _colorHash[color];
 
-	uint bestColor = _palette.findBestColor(cr, cg, cb, method);
+	if (_tree.empty()) {
+		const byte *data = _palette.data();
+		_tree.resize(_palette.size());
+		for (uint i = 0; i < _tree.size(); i++) {
+			TreeNode &node = _tree[i];
+			node.color[0] = data[i * 3 + 0];
+			node.color[1] = data[i * 3 + 1];
+			node.color[2] = data[i * 3 + 2];
+			node.axis = 0;
+			node.index = i;
+		}
+		buildTree(0, _tree.size());
+	}
+
+	const byte rgb[3] = { cr, cg, cb };
+	uint32 offsets[3] = { 0, 0, 0 };
+	uint32 bestDist = 0xFFFFFFFF;
+	uint bestColor = 0;
+
+	switch (method) {
+	case kColorDistanceEuclidean:
+		searchTree<kColorDistanceEuclidean>(0, _tree.size(), rgb, offsets, 0, bestDist, bestColor);
+		break;
+	case kColorDistanceNaive:
+		searchTree<kColorDistanceNaive>(0, _tree.size(), rgb, offsets, 0, bestDist, bestColor);
+		break;
+	case kColorDistanceRedmean:
+		searchTree<kColorDistanceRedmean>(0, _tree.size(), rgb, offsets, 0, bestDist, bestColor);
+		break;
+	default:
+		break;
+	}
+
 	_colorHash[color] = bestColor;
 
 	return bestColor;
@@ -22,6 +22,7 @@
 #ifndef GRAPHICS_PALETTE_H
 #define GRAPHICS_PALETTE_H
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/types.h"
 
@@ -212,6 +213,10 @@ public:
 	 * @brief This method returns closest color from the palette
 	 *        and it uses cache for faster lookups
 	 *
+	 * Instead of comparing the color with every palette entry, a k-d tree
+	 * of the palette is searched, which gives the same result as
+	 * Palette::findBestColor().
+	 *
 	 * @param method           the method used to determine the closest color
 	 *
 	 * @return the palette index
@@ -231,9 +236,33 @@ public:
 	uint32 *createMap(const byte *srcPalette, uint len, ColorDistanceMethod method = kColorDistanceRedmean);
 
 private:
+	/**
+	 * A palette entry in the k-d tree. The tree is stored in a sorted
+	 * array, with the root of each range in the middle of it, down to
+	 * small ranges which are searched entry by entry.
+	 */
+	struct TreeNode {
+		byte color[3];
+		byte axis;       ///< The component the range is split on
+		uint16 index;
+	};
+
+	enum {
+		kTreeBucketSize = 8      ///< Ranges of up to this many entries are not split
+	};
+
+	void buildTree(uint first, uint last);
+
+	template<ColorDistanceMethod method>
+	static void compareEntry(const TreeNode &node, const byte *color, uint32 &bestDist, uint &bestColor);
+
+	template<ColorDistanceMethod method>
+	void searchTree(uint first, uint last, const byte *color, uint32 *offsets, uint32 minDist, uint32 &bestDist, uint &bestColor) const;
+
 	Palette _palette;
 	uint _paletteSize;
 	Common::HashMap<int, byte> _colorHash;
+	Common::Array<TreeNode> _tree;
 };
 
 } //  // end of namespace Graphics
@@ -33,6 +33,7 @@ public:
 	~HQScaler();
 	uint increaseFactor() override;
 	uint decreaseFactor() override;
+	bool canScaleInBands() const override { return true; }
 protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) override;
@@ -20,6 +20,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/taskscheduler.h"
+
 namespace {
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -52,6 +54,18 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
+	} else if (_bandHeight && height >= 2 * _bandHeight && canScaleInBands()) {
+		// The bands only share the source, so they do not depend on each other
+		// and can be scaled by the worker threads
+		const int numBands = height / _bandHeight;
+		TaskMan.parallelFor(numBands, 1, [&](uint begin, uint end) {
+			for (uint band = begin; band < end; band++) {
+				const int top = band * height / numBands;
+				const int bottom = (band + 1) * height / numBands;
+				scaleIntern(srcPtr + top * srcPitch, srcPitch, dstPtr + top * _factor * dstPitch, dstPitch,
+				            width, bottom - top, x, y + top);
+			}
+		}, "Scaler::scale");
 	} else {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
@@ -27,7 +27,12 @@
 
 class Scaler {
 public:
-	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
+	enum {
+		/** The smallest number of source rows of a band, see setBandHeight(). */
+		kMinBandHeight = 4
+	};
+
+	Scaler(const Graphics::PixelFormat &format) : _format(format), _bandHeight(0) {}
 	virtual ~Scaler() {}
 
 	/**
@@ -94,6 +99,30 @@ public:
 		assert(0);
 	}
 
+	/**
+	 * Whether the scaler gives the same output when a rect is scaled in
+	 * horizontal bands, each reading the extraPixels() rows around it, as
+	 * when it is scaled in one piece, and whether the bands can be scaled
+	 * at the same time. Scalers opt in by overriding this.
+	 */
+	virtual bool canScaleInBands() const { return false; }
+
+	/**
+	 * Set the number of source rows of the horizontal bands a rect is split
+	 * into by scale(), if the scaler canScaleInBands(). The rows are spread
+	 * evenly over the bands, so a band may be up to twice as high. The
+	 * bands are scaled in parallel by TaskMan.
+	 *
+	 * @param height The height of a band, at least kMinBandHeight, or 0 to
+	 *               always scale a rect in one piece (the default).
+	 */
+	void setBandHeight(int height) {
+		assert(height == 0 || height >= kMinBandHeight);
+		_bandHeight = height;
+	}
+
+	int getBandHeight() const { return _bandHeight; }
+
 protected:
 	/**
 	 * @see scale
@@ -103,6 +132,9 @@ protected:
 
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	int _bandHeight;
 };
 
 /**
@@ -122,6 +154,13 @@ public:
 
 	virtual uint setFactor(uint factor) final;
 
+	/**
+	 * The old source and the buffered output are updated for the whole
+	 * rect after scaling it, so a band would see the changes of the ones
+	 * scaled before it.
+	 */
+	virtual bool canScaleInBands() const final { return false; }
+
 protected:
 
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
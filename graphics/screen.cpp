@@ -76,25 +76,26 @@ void Screen::makeAllDirty() {
 }
 
 void Screen::mergeDirtyRects() {
-	Common::List<Common::Rect>::iterator rOuter, rInner;
+	if (_dirtyRects.size() < 2)
+		return;
 
-	// Process the dirty rect list to find any rects to merge
-	for (rOuter = _dirtyRects.begin(); rOuter != _dirtyRects.end(); ++rOuter) {
-		rInner = rOuter;
-		while (++rInner != _dirtyRects.end()) {
+	// Track the whole screen, as well as any rects added outside of it
+	Common::Rect bounds = getBounds();
+	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
+	for (const auto &r : _dirtyRects)
+		bounds.extend(r);
 
-			if ((*rOuter).intersects(*rInner)) {
-				// These two rectangles overlap, so merge them
-				unionRectangle(*rOuter, *rOuter, *rInner);
+	if (_dirtyRegion.getBounds() != bounds)
+		_dirtyRegion.setBounds(bounds);
 
-				// remove the inner rect from the list
-				_dirtyRects.erase(rInner);
+	for (const auto &r : _dirtyRects)
+		_dirtyRegion.addRect(r);
 
-				// move back to beginning of list
-				rInner = rOuter;
-			}
-		}
-	}
+	_dirtyRects.clear();
+	for (const auto &r : _dirtyRegion.getRects())
+		_dirtyRects.push_back(r);
+
+	_dirtyRegion.clear();
 }
 
 bool Screen::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
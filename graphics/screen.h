@@ -22,6 +22,7 @@
 #ifndef GRAPHICS_SCREEN_H
 #define GRAPHICS_SCREEN_H
 
+#include "graphics/dirtyregion.h"
 #include "graphics/managed_surface.h"
 #include "graphics/palette.h"
 #include "graphics/pixelformat.h"
@@ -51,9 +52,15 @@ protected:
 	 * List of affected areas of the screen
 	 */
 	Common::List<Common::Rect> _dirtyRects;
+
+	/**
+	 * Used for merging the dirty areas
+	 */
+	DirtyRegion _dirtyRegion;
 protected:
 	/**
-	 * Merges together overlapping dirty areas of the screen
+	 * Merges together overlapping and adjacent dirty areas of the screen,
+	 * leaving dirty areas which do not overlap
 	 */
 	void mergeDirtyRects();
 
@@ -599,7 +599,7 @@ void Surface::convertToInPlace(const PixelFormat &dstFormat, const byte *palette
 		uint32 map[256];
 		assert(palette);
 
-		convertPaletteToMap(map, palette, paletteCount, dstFormat);
+		convertPaletteToMapCached(map, palette, paletteCount, dstFormat);
 		crossBlitMap((byte *)pixels, (const byte *)pixels, w * dstFormat.bytesPerPixel, pitch, w, h, dstFormat.bytesPerPixel, map);
 	} else {
 		crossBlit((byte *)pixels, (const byte *)pixels, w * dstFormat.bytesPerPixel, pitch, w, h, dstFormat, format);
@@ -660,7 +660,7 @@ Graphics::Surface *Surface::convertTo(const PixelFormat &dstFormat, const byte *
 		assert(srcPalette);
 		uint32 map[256];
 
-		convertPaletteToMap(map, srcPalette, srcPaletteCount, dstFormat);
+		convertPaletteToMapCached(map, srcPalette, srcPaletteCount, dstFormat);
 		crossBlitMap(dst, src, surface->pitch, pitch, w, h, dstFormat.bytesPerPixel, map);
 	} else {
 		// Converting from high color to high color
@@ -359,6 +359,10 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[1].initialize(drawCallMemorySize);
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
+
+	// Draw calls are executed once for each dirty rect they touch, so
+	// prefer fewer and larger rects
+	_dirtyRegion = Graphics::DirtyRegion(32);
 }
 
 void GLContext::deinit() {
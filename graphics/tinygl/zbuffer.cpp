@@ -49,6 +49,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 		_sbuf = (byte *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(byte));
 	else
 		_sbuf = nullptr;
+	_spanTexels = (uint32 *)gl_malloc(_pbufWidth * sizeof(uint32));
 
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
@@ -63,6 +64,7 @@ FrameBuffer::~FrameBuffer() {
 	gl_free(_zbuf);
 	if (_sbuf)
 		gl_free(_sbuf);
+	gl_free(_spanTexels);
 }
 
 Buffer *FrameBuffer::genOffscreenBuffer() {
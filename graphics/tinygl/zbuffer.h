@@ -77,6 +77,7 @@ static const int DRAW_FLAT = 1;
 static const int DRAW_SMOOTH = 2;
 
 struct GLTextureEnv; // defined in zdirtyrect.h
+struct SpanArgs; // defined in zspan.h
 
 struct Buffer {
 	byte *pbuf;
@@ -432,7 +433,7 @@ private:
 	}
 
 	template <bool kEnableAlphaTest, bool kBlendingEnabled, bool kDepthWrite, bool kFogMode>
-	FORCEINLINE void writePixel(int pixel, byte aSrc, byte rSrc, byte gSrc, byte bSrc, float z, uint fog, byte fog_r, byte fog_g, byte fog_b) {
+	FORCEINLINE void writePixel(int pixel, byte aSrc, byte rSrc, byte gSrc, byte bSrc, uint z, uint fog, byte fog_r, byte fog_g, byte fog_b) {
 		if (kEnableAlphaTest) {
 			if (!checkAlphaTest(aSrc))
 				return;
@@ -763,6 +764,12 @@ private:
 	template <bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode, bool kDepthWrite>
 	void fillTriangleTextureMapping(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
 
+	/**
+	 * Fill in the state shared by the spans of a triangle, and return
+	 * whether the span kernels can draw them.
+	 */
+	bool setupSpan(SpanArgs &span, bool depthTest, bool depthWrite, bool blending);
+
 public:
 
 	void fillTriangleTextureMappingPerspectiveSmooth(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
@@ -817,6 +824,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	uint32 *_spanTexels;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -121,17 +121,21 @@ void GLContext::disposeDrawCallLists() {
 	_drawCallsQueue.clear();
 }
 
-static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
+static inline void _appendDirtyRectangle(const DrawCall &call, Graphics::DirtyRegion &region, Common::List<DirtyRectangle> *debugRectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
-	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
-		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
+	region.addRect(dirty_region);
+	if (debugRectangles && (debugRectangles->empty() || dirty_region != debugRectangles->back().rectangle))
+		debugRectangles->push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
 void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas) {
 	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<DirtyRectangle>::iterator RectangleIterator;
 
-	Common::List<DirtyRectangle> rectangles;
+	Common::List<DirtyRectangle> debugRectangles;
+	Common::List<DirtyRectangle> *debugRectanglesPtr = _debugRectsEnabled ? &debugRectangles : nullptr;
+
+	if (_dirtyRegion.getBounds() != renderRect)
+		_dirtyRegion.setBounds(renderRect);
 
 	DrawCallIterator itFrame = _drawCallsQueue.begin();
 	DrawCallIterator endFrame = _drawCallsQueue.end();
@@ -145,72 +149,33 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 			const DrawCall &previousCall = **itPrevFrame;
 
 			if (previousCall != currentCall) {
-				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
-				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
+				_appendDirtyRectangle(previousCall, _dirtyRegion, debugRectanglesPtr, 255, 255, 255);
+				_appendDirtyRectangle(currentCall, _dirtyRegion, debugRectanglesPtr, 255, 0, 0);
 			}
 	}
 
 	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
-		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
+		_appendDirtyRectangle(**itPrevFrame, _dirtyRegion, debugRectanglesPtr, 255, 255, 255);
 	}
 
 	for ( ; itFrame != endFrame; ++itFrame) {
-		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
-	}
-
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
-	for (auto &rect : rectangles) {
-		rect.rectangle.right++;
-		rect.rectangle.bottom++;
-	}
-
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
-				}
-			}
-		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
-		}
+		_appendDirtyRectangle(**itFrame, _dirtyRegion, debugRectanglesPtr, 255, 0, 0);
 	}
 
-	for (auto &rect : rectangles) {
-		rect.rectangle.clip(renderRect);
-	}
+	// Coalesce the dirty rects into ones which do not overlap, as the draw
+	// calls are executed once for each of them.
+	const Common::Array<Common::Rect> &rectangles = _dirtyRegion.getRects();
 
 	if (!rectangles.empty()) {
 		for (auto &rect : rectangles) {
-			dirtyAreas.push_back(rect.rectangle);
+			dirtyAreas.push_back(rect);
 		}
 
 		// Execute draw calls.
 		for (auto &drawCall : _drawCallsQueue) {
 			Common::Rect drawCallRegion = drawCall->getDirtyRegion();
 			for (auto &rect : rectangles) {
-				Common::Rect dirtyRegion = rect.rectangle;
+				Common::Rect dirtyRegion = rect;
 				if (dirtyRegion.intersects(drawCallRegion)) {
 					drawCall->execute(true, &dirtyRegion);
 				}
@@ -219,22 +184,27 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 
 		if (_debugRectsEnabled) {
 			// Draw debug rectangles.
-			// Note: white rectangles are rectangle that contained other rectangles
-			// blue rectangles are rectangle merged from other rectangles
-			// red rectangles are original dirty rects
+			// Note: white rectangles are the dirty rects of the previous frame
+			// red rectangles are the dirty rects of the current frame
+			// blue rectangles are the coalesced rects which were redrawn
 
 			fb->enableBlending(false);
 			fb->enableAlphaTest(false);
 
-			for (auto &rect : rectangles) {
+			for (auto &rect : debugRectangles) {
 				debugDrawRectangle(rect.rectangle, rect.r, rect.g, rect.b);
 			}
+			for (auto &rect : rectangles) {
+				debugDrawRectangle(rect, 0, 0, 255);
+			}
 
 			fb->enableBlending(blending_enabled);
 			fb->enableAlphaTest(alpha_test_enabled);
 		}
 	}
 
+	_dirtyRegion.clear();
+
 	// Dispose not necessary draw calls.
 	for (auto &p : _previousFrameDrawCallsQueue) {
 		delete p;
@@ -34,6 +34,7 @@
 #include "common/list.h"
 #include "common/scummsys.h"
 
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/tinygl/gl.h"
@@ -472,6 +473,9 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Dirty rectangles of the frame
+	Graphics::DirtyRegion _dirtyRegion;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -0,0 +1,61 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+const SpanKernels::Funcs SpanKernels::funcsNone = {
+	nullptr
+};
+
+const SpanKernels::Funcs SpanKernels::funcsGeneric = {
+	SpanKernels::drawGeneric
+};
+
+const SpanKernels::Funcs *SpanKernels::selectedFuncs = nullptr;
+
+const SpanKernels::Funcs &SpanKernels::getFuncs() {
+	// If no kernels have been selected yet, detect and select
+	if (!selectedFuncs) {
+		// Without a system, as in some tests, the CPU features are unknown
+		if (!g_system)
+			return funcsNone;
+
+		// The generic kernel is no faster than drawing pixel by pixel
+		selectedFuncs = &funcsNone;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) selectedFuncs = &funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) selectedFuncs = &funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) selectedFuncs = &funcsAVX2;
+#endif
+	}
+
+	return *selectedFuncs;
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "graphics/tinygl/zbuffer.h"
+
+namespace TinyGL {
+
+/**
+ * A horizontal run of pixels of a triangle, drawn into a 32bpp color buffer
+ * with the depth test, and optionally texture modulation and
+ * SRC_ALPHA / ONE_MINUS_SRC_ALPHA blending.
+ */
+struct SpanArgs {
+	uint32 *pixels;        ///< First pixel of the span in the color buffer
+	uint *depth;           ///< First pixel of the span in the depth buffer
+	/**
+	 * Texels of the span as A << 24 | R << 16 | G << 8 | B, or nullptr
+	 * if it is not textured. Only the texels of the pixels passing the
+	 * depth test need to be set.
+	 */
+	const uint32 *texels;
+	int count;             ///< Number of pixels
+
+	uint z, r, g, b, a;    ///< Interpolated values at the first pixel
+	int dzdx, drdx, dgdx, dbdx, dadx;
+
+	int depthFunc;         ///< TGL_LESS, TGL_LEQUAL or TGL_ALWAYS
+	bool depthWrite;
+	bool blending;
+
+	/** Layout of the color buffer, alphaMask is 0 if it has no alpha. */
+	byte aShift, rShift, gShift, bShift;
+	uint32 alphaMask;
+
+	/** Drop the first n pixels of the span. */
+	void skip(int n) {
+		pixels += n;
+		depth += n;
+		if (texels)
+			texels += n;
+		count -= n;
+		z += (uint)n * dzdx;
+		r += (uint)n * drdx;
+		g += (uint)n * dgdx;
+		b += (uint)n * dbdx;
+		a += (uint)n * dadx;
+	}
+
+	/** Whether a pixel with the given depth buffer value passes the depth test. */
+	bool testDepth(uint zDst, uint zSrc) const {
+		switch (depthFunc) {
+		case TGL_LESS:
+			return zDst < zSrc;
+		case TGL_LEQUAL:
+			return zDst <= zSrc;
+		default:
+			return true;
+		}
+	}
+};
+
+/**
+ * The span drawing kernels, with SIMD variants processing four or eight
+ * pixels at once. They produce exactly the same results as
+ * FrameBuffer::putPixelNoTexture() and FrameBuffer::putPixelTexture().
+ */
+class SpanKernels {
+public:
+	typedef void (*DrawFunc)(const SpanArgs &args);
+
+	struct Funcs {
+		/** Draw a span, or nullptr to draw pixel by pixel. */
+		DrawFunc draw;
+	};
+
+	/**
+	 * Return the kernels best suited for the CPU we are running on.
+	 * The selection is done on the first call.
+	 */
+	static const Funcs &getFuncs();
+
+	/** The kernels in use, nullptr until they have been selected. */
+	static const Funcs *selectedFuncs;
+
+	/** Draw pixel by pixel, used when no SIMD kernels are available. */
+	static const Funcs funcsNone;
+	static const Funcs funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Funcs funcsAVX2;
+#endif
+
+	/** The generic kernel, also used by the SIMD variants for the remaining pixels. */
+	static void drawGeneric(const SpanArgs &args) {
+		if (args.texels) {
+			if (args.blending)
+				drawGeneric<true, true>(args);
+			else
+				drawGeneric<true, false>(args);
+		} else {
+			if (args.blending)
+				drawGeneric<false, true>(args);
+			else
+				drawGeneric<false, false>(args);
+		}
+	}
+
+	template<bool kTextured, bool kBlending>
+	static void drawGeneric(const SpanArgs &args) {
+		uint z = args.z, r = args.r, g = args.g, b = args.b, a = args.a;
+
+		for (int i = 0; i < args.count; i++) {
+			if (args.testDepth(args.depth[i], z)) {
+				if (args.depthWrite)
+					args.depth[i] = z;
+
+				byte cA, cR, cG, cB;
+				if (kTextured) {
+					const uint32 texel = args.texels[i];
+					cA = fpMul(sat16to8(a), texel >> 24);
+					cR = fpMul(sat16to8(r), (texel >> 16) & 0xFF);
+					cG = fpMul(sat16to8(g), (texel >> 8) & 0xFF);
+					cB = fpMul(sat16to8(b), texel & 0xFF);
+				} else {
+					cA = a >> (ZB_POINT_ALPHA_BITS - 8);
+					cR = r >> (ZB_POINT_RED_BITS - 8);
+					cG = g >> (ZB_POINT_GREEN_BITS - 8);
+					cB = b >> (ZB_POINT_BLUE_BITS - 8);
+				}
+
+				if (kBlending) {
+					const uint32 dst = args.pixels[i];
+					const uint finalR = ((cR * cA) >> 8) + ((((dst >> args.rShift) & 0xFF) * (255 - cA)) >> 8);
+					const uint finalG = ((cG * cA) >> 8) + ((((dst >> args.gShift) & 0xFF) * (255 - cA)) >> 8);
+					const uint finalB = ((cB * cA) >> 8) + ((((dst >> args.bShift) & 0xFF) * (255 - cA)) >> 8);
+					args.pixels[i] = args.alphaMask | (MIN<uint>(finalR, 255) << args.rShift) |
+					                 (MIN<uint>(finalG, 255) << args.gShift) | (MIN<uint>(finalB, 255) << args.bShift);
+				} else {
+					args.pixels[i] = (((uint32)cA << args.aShift) & args.alphaMask) | ((uint32)cR << args.rShift) |
+					                 ((uint32)cG << args.gShift) | ((uint32)cB << args.bShift);
+				}
+			}
+
+			z += args.dzdx;
+			r += args.drdx;
+			g += args.dgdx;
+			b += args.dbdx;
+			a += args.dadx;
+		}
+	}
+
+	/** Round a 16 bit color component to 8 bits, saturating. */
+	static inline byte sat16to8(uint32 x) {
+		x = (x + 128) >> 8;
+		return (byte)(x | -!!(x >> 8));
+	}
+
+	/** Multiply two 8 bit color components, (a * b) / 255 rounded. */
+	static inline byte fpMul(byte a, byte b) {
+		const uint32 r = a * b;
+		return (byte)((r + (r >> 8) + 127) >> 8);
+	}
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+/** The values of an interpolant at eight consecutive pixels. */
+static FORCEINLINE __m256i rampAVX2(uint v, int d) {
+	return _mm256_set_epi32(v + 7 * (uint)d, v + 6 * (uint)d, v + 5 * (uint)d, v + 4 * (uint)d,
+	                        v + 3 * (uint)d, v + 2 * (uint)d, v + (uint)d, v);
+}
+
+/** The change of an interpolant over eight pixels. */
+static FORCEINLINE __m256i stepAVX2(int d) {
+	return _mm256_set1_epi32(8 * (uint)d);
+}
+
+/** Select the lanes of a where mask is set, and those of b elsewhere. */
+static FORCEINLINE __m256i selectAVX2(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+}
+
+/** Saturate components which are known to be below 2^24 to 255. */
+static FORCEINLINE __m256i sat8AVX2(__m256i x) {
+	return _mm256_and_si256(_mm256_or_si256(x, _mm256_cmpgt_epi32(x, _mm256_set1_epi32(255))), _mm256_set1_epi32(0xFF));
+}
+
+/** SpanKernels::sat16to8() on eight components. */
+static FORCEINLINE __m256i sat16to8AVX2(__m256i c) {
+	return sat8AVX2(_mm256_srli_epi32(_mm256_add_epi32(c, _mm256_set1_epi32(128)), 8));
+}
+
+/** SpanKernels::fpMul() on eight pairs of 8 bit components. */
+static FORCEINLINE __m256i fpMulAVX2(__m256i a, __m256i b) {
+	const __m256i r = _mm256_mullo_epi16(a, b);
+	return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(r, _mm256_srli_epi32(r, 8)), _mm256_set1_epi32(127)), 8);
+}
+
+/** Blend eight 8 bit components with SRC_ALPHA / ONE_MINUS_SRC_ALPHA. */
+static FORCEINLINE __m256i blendAVX2(__m256i src, __m256i dst, __m256i srcA) {
+	const __m256i s = _mm256_srli_epi32(_mm256_mullo_epi16(src, srcA), 8);
+	const __m256i d = _mm256_srli_epi32(_mm256_mullo_epi16(dst, _mm256_sub_epi32(_mm256_set1_epi32(255), srcA)), 8);
+	return sat8AVX2(_mm256_add_epi32(s, d));
+}
+
+template<bool kTextured, bool kBlending, int kDepthFunc>
+static void drawAVX2(const SpanArgs &args) {
+	const __m256i mask8 = _mm256_set1_epi32(0xFF);
+	const __m256i sign = _mm256_set1_epi32((int)0x80000000);
+	const __m128i aShift = _mm_cvtsi32_si128(args.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(args.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(args.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(args.bShift);
+	const __m256i alphaMask = _mm256_set1_epi32(args.alphaMask);
+
+	__m256i z = rampAVX2(args.z, args.dzdx), r = rampAVX2(args.r, args.drdx), g = rampAVX2(args.g, args.dgdx);
+	__m256i b = rampAVX2(args.b, args.dbdx), a = rampAVX2(args.a, args.dadx);
+	const __m256i dz = stepAVX2(args.dzdx), dr = stepAVX2(args.drdx), dg = stepAVX2(args.dgdx);
+	const __m256i db = stepAVX2(args.dbdx), da = stepAVX2(args.dadx);
+
+	int i = 0;
+	for (; i + 8 <= args.count; i += 8) {
+		__m256i *depth = (__m256i *)(args.depth + i);
+		const __m256i zDst = _mm256_loadu_si256(depth);
+
+		// AVX2 only compares signed integers
+		__m256i pass;
+		if (kDepthFunc == TGL_LESS)
+			pass = _mm256_cmpgt_epi32(_mm256_xor_si256(z, sign), _mm256_xor_si256(zDst, sign));
+		else if (kDepthFunc == TGL_LEQUAL)
+			pass = _mm256_xor_si256(_mm256_cmpgt_epi32(_mm256_xor_si256(zDst, sign), _mm256_xor_si256(z, sign)), _mm256_set1_epi32(-1));
+		else
+			pass = _mm256_set1_epi32(-1);
+
+		if (_mm256_movemask_epi8(pass)) {
+			if (args.depthWrite)
+				_mm256_storeu_si256(depth, selectAVX2(pass, z, zDst));
+
+			__m256i cA, cR, cG, cB;
+			if (kTextured) {
+				const __m256i texel = _mm256_loadu_si256((const __m256i *)(args.texels + i));
+				cA = fpMulAVX2(sat16to8AVX2(a), _mm256_srli_epi32(texel, 24));
+				cR = fpMulAVX2(sat16to8AVX2(r), _mm256_and_si256(_mm256_srli_epi32(texel, 16), mask8));
+				cG = fpMulAVX2(sat16to8AVX2(g), _mm256_and_si256(_mm256_srli_epi32(texel, 8), mask8));
+				cB = fpMulAVX2(sat16to8AVX2(b), _mm256_and_si256(texel, mask8));
+			} else {
+				cA = _mm256_and_si256(_mm256_srli_epi32(a, ZB_POINT_ALPHA_BITS - 8), mask8);
+				cR = _mm256_and_si256(_mm256_srli_epi32(r, ZB_POINT_RED_BITS - 8), mask8);
+				cG = _mm256_and_si256(_mm256_srli_epi32(g, ZB_POINT_GREEN_BITS - 8), mask8);
+				cB = _mm256_and_si256(_mm256_srli_epi32(b, ZB_POINT_BLUE_BITS - 8), mask8);
+			}
+
+			__m256i *pixels = (__m256i *)(args.pixels + i);
+			const __m256i dst = _mm256_loadu_si256(pixels);
+			__m256i color;
+			if (kBlending) {
+				cR = blendAVX2(cR, _mm256_and_si256(_mm256_srl_epi32(dst, rShift), mask8), cA);
+				cG = blendAVX2(cG, _mm256_and_si256(_mm256_srl_epi32(dst, gShift), mask8), cA);
+				cB = blendAVX2(cB, _mm256_and_si256(_mm256_srl_epi32(dst, bShift), mask8), cA);
+				color = alphaMask;
+			} else {
+				color = _mm256_and_si256(_mm256_sll_epi32(cA, aShift), alphaMask);
+			}
+			color = _mm256_or_si256(color, _mm256_sll_epi32(cR, rShift));
+			color = _mm256_or_si256(color, _mm256_sll_epi32(cG, gShift));
+			color = _mm256_or_si256(color, _mm256_sll_epi32(cB, bShift));
+			_mm256_storeu_si256(pixels, selectAVX2(pass, color, dst));
+		}
+
+		z = _mm256_add_epi32(z, dz);
+		r = _mm256_add_epi32(r, dr);
+		g = _mm256_add_epi32(g, dg);
+		b = _mm256_add_epi32(b, db);
+		a = _mm256_add_epi32(a, da);
+	}
+
+	if (i < args.count) {
+		SpanArgs tail = args;
+		tail.skip(i);
+		SpanKernels::drawGeneric<kTextured, kBlending>(tail);
+	}
+}
+
+template<bool kTextured, bool kBlending>
+static void drawAVX2(const SpanArgs &args) {
+	switch (args.depthFunc) {
+	case TGL_LESS:
+		drawAVX2<kTextured, kBlending, TGL_LESS>(args);
+		break;
+	case TGL_LEQUAL:
+		drawAVX2<kTextured, kBlending, TGL_LEQUAL>(args);
+		break;
+	default:
+		drawAVX2<kTextured, kBlending, TGL_ALWAYS>(args);
+		break;
+	}
+}
+
+static void drawAVX2(const SpanArgs &args) {
+	if (args.texels) {
+		if (args.blending)
+			drawAVX2<true, true>(args);
+		else
+			drawAVX2<true, false>(args);
+	} else {
+		if (args.blending)
+			drawAVX2<false, true>(args);
+		else
+			drawAVX2<false, false>(args);
+	}
+}
+
+const SpanKernels::Funcs SpanKernels::funcsAVX2 = {
+	drawAVX2
+};
+
+} // end of namespace TinyGL
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,189 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace TinyGL {
+
+/** The values of an interpolant at four consecutive pixels. */
+static inline uint32x4_t rampNEON(uint v, int d) {
+	const uint32 values[4] = { v, v + (uint)d, v + 2 * (uint)d, v + 3 * (uint)d };
+	return vld1q_u32(values);
+}
+
+/** SpanKernels::sat16to8() on four components. */
+static inline uint32x4_t sat16to8NEON(uint32x4_t c) {
+	return vminq_u32(vshrq_n_u32(vaddq_u32(c, vdupq_n_u32(128)), 8), vdupq_n_u32(255));
+}
+
+/** SpanKernels::fpMul() on four pairs of 8 bit components. */
+static inline uint32x4_t fpMulNEON(uint32x4_t a, uint32x4_t b) {
+	const uint32x4_t r = vmulq_u32(a, b);
+	return vshrq_n_u32(vaddq_u32(vaddq_u32(r, vshrq_n_u32(r, 8)), vdupq_n_u32(127)), 8);
+}
+
+/** Blend four 8 bit components with SRC_ALPHA / ONE_MINUS_SRC_ALPHA. */
+static inline uint32x4_t blendNEON(uint32x4_t src, uint32x4_t dst, uint32x4_t srcA) {
+	const uint32x4_t s = vshrq_n_u32(vmulq_u32(src, srcA), 8);
+	const uint32x4_t d = vshrq_n_u32(vmulq_u32(dst, vsubq_u32(vdupq_n_u32(255), srcA)), 8);
+	return vminq_u32(vaddq_u32(s, d), vdupq_n_u32(255));
+}
+
+template<bool kTextured, bool kBlending, int kDepthFunc>
+static void drawNEON(const SpanArgs &args) {
+	const uint32x4_t mask8 = vdupq_n_u32(0xFF);
+	// Shifting by a negative amount shifts to the right
+	const int32x4_t aShift = vdupq_n_s32(args.aShift);
+	const int32x4_t rShift = vdupq_n_s32(args.rShift), rShiftBack = vdupq_n_s32(-args.rShift);
+	const int32x4_t gShift = vdupq_n_s32(args.gShift), gShiftBack = vdupq_n_s32(-args.gShift);
+	const int32x4_t bShift = vdupq_n_s32(args.bShift), bShiftBack = vdupq_n_s32(-args.bShift);
+	const uint32x4_t alphaMask = vdupq_n_u32(args.alphaMask);
+
+	uint32x4_t z = rampNEON(args.z, args.dzdx), r = rampNEON(args.r, args.drdx), g = rampNEON(args.g, args.dgdx);
+	uint32x4_t b = rampNEON(args.b, args.dbdx), a = rampNEON(args.a, args.dadx);
+	const uint32x4_t dz = vdupq_n_u32(4 * (uint)args.dzdx), dr = vdupq_n_u32(4 * (uint)args.drdx), dg = vdupq_n_u32(4 * (uint)args.dgdx);
+	const uint32x4_t db = vdupq_n_u32(4 * (uint)args.dbdx), da = vdupq_n_u32(4 * (uint)args.dadx);
+
+	int i = 0;
+	for (; i + 4 <= args.count; i += 4) {
+		uint32 *depth = args.depth + i;
+		const uint32x4_t zDst = vld1q_u32(depth);
+
+		uint32x4_t pass;
+		if (kDepthFunc == TGL_LESS)
+			pass = vcltq_u32(zDst, z);
+		else if (kDepthFunc == TGL_LEQUAL)
+			pass = vcleq_u32(zDst, z);
+		else
+			pass = vdupq_n_u32(0xFFFFFFFF);
+
+		if (vgetq_lane_u32(pass, 0) | vgetq_lane_u32(pass, 1) | vgetq_lane_u32(pass, 2) | vgetq_lane_u32(pass, 3)) {
+			if (args.depthWrite)
+				vst1q_u32(depth, vbslq_u32(pass, z, zDst));
+
+			uint32x4_t cA, cR, cG, cB;
+			if (kTextured) {
+				const uint32x4_t texel = vld1q_u32(args.texels + i);
+				cA = fpMulNEON(sat16to8NEON(a), vshrq_n_u32(texel, 24));
+				cR = fpMulNEON(sat16to8NEON(r), vandq_u32(vshrq_n_u32(texel, 16), mask8));
+				cG = fpMulNEON(sat16to8NEON(g), vandq_u32(vshrq_n_u32(texel, 8), mask8));
+				cB = fpMulNEON(sat16to8NEON(b), vandq_u32(texel, mask8));
+			} else {
+				cA = vandq_u32(vshrq_n_u32(a, ZB_POINT_ALPHA_BITS - 8), mask8);
+				cR = vandq_u32(vshrq_n_u32(r, ZB_POINT_RED_BITS - 8), mask8);
+				cG = vandq_u32(vshrq_n_u32(g, ZB_POINT_GREEN_BITS - 8), mask8);
+				cB = vandq_u32(vshrq_n_u32(b, ZB_POINT_BLUE_BITS - 8), mask8);
+			}
+
+			uint32 *pixels = args.pixels + i;
+			const uint32x4_t dst = vld1q_u32(pixels);
+			uint32x4_t color;
+			if (kBlending) {
+				cR = blendNEON(cR, vandq_u32(vshlq_u32(dst, rShiftBack), mask8), cA);
+				cG = blendNEON(cG, vandq_u32(vshlq_u32(dst, gShiftBack), mask8), cA);
+				cB = blendNEON(cB, vandq_u32(vshlq_u32(dst, bShiftBack), mask8), cA);
+				color = alphaMask;
+			} else {
+				color = vandq_u32(vshlq_u32(cA, aShift), alphaMask);
+			}
+			color = vorrq_u32(color, vshlq_u32(cR, rShift));
+			color = vorrq_u32(color, vshlq_u32(cG, gShift));
+			color = vorrq_u32(color, vshlq_u32(cB, bShift));
+			vst1q_u32(pixels, vbslq_u32(pass, color, dst));
+		}
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	if (i < args.count) {
+		SpanArgs tail = args;
+		tail.skip(i);
+		SpanKernels::drawGeneric<kTextured, kBlending>(tail);
+	}
+}
+
+template<bool kTextured, bool kBlending>
+static void drawNEON(const SpanArgs &args) {
+	switch (args.depthFunc) {
+	case TGL_LESS:
+		drawNEON<kTextured, kBlending, TGL_LESS>(args);
+		break;
+	case TGL_LEQUAL:
+		drawNEON<kTextured, kBlending, TGL_LEQUAL>(args);
+		break;
+	default:
+		drawNEON<kTextured, kBlending, TGL_ALWAYS>(args);
+		break;
+	}
+}
+
+static void drawNEON(const SpanArgs &args) {
+	if (args.texels) {
+		if (args.blending)
+			drawNEON<true, true>(args);
+		else
+			drawNEON<true, false>(args);
+	} else {
+		if (args.blending)
+			drawNEON<false, true>(args);
+		else
+			drawNEON<false, false>(args);
+	}
+}
+
+const SpanKernels::Funcs SpanKernels::funcsNEON = {
+	drawNEON
+};
+
+} // end of namespace TinyGL
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,200 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace TinyGL {
+
+/** The values of an interpolant at four consecutive pixels. */
+static FORCEINLINE __m128i rampSSE2(uint v, int d) {
+	return _mm_set_epi32(v + 3 * (uint)d, v + 2 * (uint)d, v + (uint)d, v);
+}
+
+/** The change of an interpolant over four pixels. */
+static FORCEINLINE __m128i stepSSE2(int d) {
+	return _mm_set1_epi32(4 * (uint)d);
+}
+
+/** Select the lanes of a where mask is set, and those of b elsewhere. */
+static FORCEINLINE __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/** Saturate components which are known to be below 2^24 to 255. */
+static FORCEINLINE __m128i sat8SSE2(__m128i x) {
+	return _mm_and_si128(_mm_or_si128(x, _mm_cmpgt_epi32(x, _mm_set1_epi32(255))), _mm_set1_epi32(0xFF));
+}
+
+/** SpanKernels::sat16to8() on four components. */
+static FORCEINLINE __m128i sat16to8SSE2(__m128i c) {
+	return sat8SSE2(_mm_srli_epi32(_mm_add_epi32(c, _mm_set1_epi32(128)), 8));
+}
+
+/** SpanKernels::fpMul() on four pairs of 8 bit components. */
+static FORCEINLINE __m128i fpMulSSE2(__m128i a, __m128i b) {
+	const __m128i r = _mm_mullo_epi16(a, b);
+	return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, _mm_srli_epi32(r, 8)), _mm_set1_epi32(127)), 8);
+}
+
+/** Blend four 8 bit components with SRC_ALPHA / ONE_MINUS_SRC_ALPHA. */
+static FORCEINLINE __m128i blendSSE2(__m128i src, __m128i dst, __m128i srcA) {
+	const __m128i s = _mm_srli_epi32(_mm_mullo_epi16(src, srcA), 8);
+	const __m128i d = _mm_srli_epi32(_mm_mullo_epi16(dst, _mm_sub_epi32(_mm_set1_epi32(255), srcA)), 8);
+	return sat8SSE2(_mm_add_epi32(s, d));
+}
+
+template<bool kTextured, bool kBlending, int kDepthFunc>
+static void drawSSE2(const SpanArgs &args) {
+	const __m128i mask8 = _mm_set1_epi32(0xFF);
+	const __m128i sign = _mm_set1_epi32((int)0x80000000);
+	const __m128i aShift = _mm_cvtsi32_si128(args.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(args.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(args.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(args.bShift);
+	const __m128i alphaMask = _mm_set1_epi32(args.alphaMask);
+
+	__m128i z = rampSSE2(args.z, args.dzdx), r = rampSSE2(args.r, args.drdx), g = rampSSE2(args.g, args.dgdx);
+	__m128i b = rampSSE2(args.b, args.dbdx), a = rampSSE2(args.a, args.dadx);
+	const __m128i dz = stepSSE2(args.dzdx), dr = stepSSE2(args.drdx), dg = stepSSE2(args.dgdx);
+	const __m128i db = stepSSE2(args.dbdx), da = stepSSE2(args.dadx);
+
+	int i = 0;
+	for (; i + 4 <= args.count; i += 4) {
+		__m128i *depth = (__m128i *)(args.depth + i);
+		const __m128i zDst = _mm_loadu_si128(depth);
+
+		// SSE2 only compares signed integers
+		__m128i pass;
+		if (kDepthFunc == TGL_LESS)
+			pass = _mm_cmplt_epi32(_mm_xor_si128(zDst, sign), _mm_xor_si128(z, sign));
+		else if (kDepthFunc == TGL_LEQUAL)
+			pass = _mm_xor_si128(_mm_cmpgt_epi32(_mm_xor_si128(zDst, sign), _mm_xor_si128(z, sign)), _mm_set1_epi32(-1));
+		else
+			pass = _mm_set1_epi32(-1);
+
+		if (_mm_movemask_epi8(pass)) {
+			if (args.depthWrite)
+				_mm_storeu_si128(depth, selectSSE2(pass, z, zDst));
+
+			__m128i cA, cR, cG, cB;
+			if (kTextured) {
+				const __m128i texel = _mm_loadu_si128((const __m128i *)(args.texels + i));
+				cA = fpMulSSE2(sat16to8SSE2(a), _mm_srli_epi32(texel, 24));
+				cR = fpMulSSE2(sat16to8SSE2(r), _mm_and_si128(_mm_srli_epi32(texel, 16), mask8));
+				cG = fpMulSSE2(sat16to8SSE2(g), _mm_and_si128(_mm_srli_epi32(texel, 8), mask8));
+				cB = fpMulSSE2(sat16to8SSE2(b), _mm_and_si128(texel, mask8));
+			} else {
+				cA = _mm_and_si128(_mm_srli_epi32(a, ZB_POINT_ALPHA_BITS - 8), mask8);
+				cR = _mm_and_si128(_mm_srli_epi32(r, ZB_POINT_RED_BITS - 8), mask8);
+				cG = _mm_and_si128(_mm_srli_epi32(g, ZB_POINT_GREEN_BITS - 8), mask8);
+				cB = _mm_and_si128(_mm_srli_epi32(b, ZB_POINT_BLUE_BITS - 8), mask8);
+			}
+
+			__m128i *pixels = (__m128i *)(args.pixels + i);
+			const __m128i dst = _mm_loadu_si128(pixels);
+			__m128i color;
+			if (kBlending) {
+				cR = blendSSE2(cR, _mm_and_si128(_mm_srl_epi32(dst, rShift), mask8), cA);
+				cG = blendSSE2(cG, _mm_and_si128(_mm_srl_epi32(dst, gShift), mask8), cA);
+				cB = blendSSE2(cB, _mm_and_si128(_mm_srl_epi32(dst, bShift), mask8), cA);
+				color = alphaMask;
+			} else {
+				color = _mm_and_si128(_mm_sll_epi32(cA, aShift), alphaMask);
+			}
+			color = _mm_or_si128(color, _mm_sll_epi32(cR, rShift));
+			color = _mm_or_si128(color, _mm_sll_epi32(cG, gShift));
+			color = _mm_or_si128(color, _mm_sll_epi32(cB, bShift));
+			_mm_storeu_si128(pixels, selectSSE2(pass, color, dst));
+		}
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	if (i < args.count) {
+		SpanArgs tail = args;
+		tail.skip(i);
+		SpanKernels::drawGeneric<kTextured, kBlending>(tail);
+	}
+}
+
+template<bool kTextured, bool kBlending>
+static void drawSSE2(const SpanArgs &args) {
+	switch (args.depthFunc) {
+	case TGL_LESS:
+		drawSSE2<kTextured, kBlending, TGL_LESS>(args);
+		break;
+	case TGL_LEQUAL:
+		drawSSE2<kTextured, kBlending, TGL_LEQUAL>(args);
+		break;
+	default:
+		drawSSE2<kTextured, kBlending, TGL_ALWAYS>(args);
+		break;
+	}
+}
+
+static void drawSSE2(const SpanArgs &args) {
+	if (args.texels) {
+		if (args.blending)
+			drawSSE2<true, true>(args);
+		else
+			drawSSE2<true, false>(args);
+	} else {
+		if (args.blending)
+			drawSSE2<false, true>(args);
+		else
+			drawSSE2<false, false>(args);
+	}
+}
+
+const SpanKernels::Funcs SpanKernels::funcsSSE2 = {
+	drawSSE2
+};
+
+} // end of namespace TinyGL
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -29,6 +29,7 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -201,6 +202,41 @@ end:
 	z += dzdx;
 }
 
+// drop the pixels of a span starting at x which are outside of the clipping rectangle
+static void clipSpan(SpanArgs &span, int x, const Common::Rect &clip) {
+	if (x < clip.left) {
+		const int skip = MIN(clip.left - x, span.count);
+		span.skip(skip);
+		x += skip;
+	}
+	span.count = MIN(span.count, clip.right - x);
+}
+
+bool FrameBuffer::setupSpan(SpanArgs &span, bool depthTest, bool depthWrite, bool blending) {
+	if (!SpanKernels::getFuncs().draw)
+		return false;
+
+	if (_pbufBpp != 4 || _pbufFormat.rLoss || _pbufFormat.gLoss || _pbufFormat.bLoss ||
+	    (_pbufFormat.aLoss != 0 && _pbufFormat.aLoss != 8))
+		return false;
+
+	span.depthFunc = depthTest ? _depthFunc : TGL_ALWAYS;
+	if (span.depthFunc != TGL_LESS && span.depthFunc != TGL_LEQUAL && span.depthFunc != TGL_ALWAYS)
+		return false;
+
+	if (blending && (_sourceBlendingFactor != TGL_SRC_ALPHA || _destinationBlendingFactor != TGL_ONE_MINUS_SRC_ALPHA))
+		return false;
+
+	span.depthWrite = depthWrite;
+	span.blending = blending;
+	span.aShift = _pbufFormat.aShift;
+	span.rShift = _pbufFormat.rShift;
+	span.gShift = _pbufFormat.gShift;
+	span.bShift = _pbufFormat.bShift;
+	span.alphaMask = _pbufFormat.aLoss ? 0 : 0xFF << _pbufFormat.aShift;
+	return true;
+}
+
 template <FrameBuffer::ColorMode kColorMode, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode,
           bool kDepthWrite, bool kFogMode, bool kAlphaTestEnabled, bool kEnableScissor,
           bool kBlendingEnabled, bool kStencilEnabled, bool kStippleEnabled, bool kDepthTestEnabled>
@@ -251,6 +287,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	// nothing to draw if the triangle lies outside of the clipping rectangle
+	if (kEnableScissor) {
+		if (p2->y < _clipRectangle.top || p0->y >= _clipRectangle.bottom)
+			return;
+		int minX = MIN(p0->x, MIN(p1->x, p2->x));
+		int maxX = MAX(p0->x, MAX(p1->x, p2->x));
+		if (maxX + 1 < _clipRectangle.left || minX - 1 >= _clipRectangle.right)
+			return;
+	}
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -369,6 +415,19 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// the span kernels draw the common cases of 32bpp buffers with the depth test and blending
+	SpanKernels::DrawFunc drawSpan = nullptr;
+	SpanArgs span;
+	if (kColorMode == ColorMode::Default && kInterpZ && !kFogMode && !kAlphaTestEnabled && !kStencilEnabled && !kStippleEnabled &&
+	    setupSpan(span, kDepthTestEnabled, kDepthWrite, kBlendingEnabled)) {
+		drawSpan = SpanKernels::getFuncs().draw;
+		span.dzdx = dzdx;
+		span.drdx = drdx;
+		span.dgdx = dgdx;
+		span.dbdx = dbdx;
+		span.dadx = dadx;
+	}
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -479,8 +538,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
+			// the remaining lines are all below the clipping rectangle
+			if (kEnableScissor && y >= _clipRectangle.bottom)
+				return;
+
 			int x = x1;
-			if (kColorMode == ColorMode::NoInterpolation) {
+			if (kEnableScissor && y < _clipRectangle.top) {
+				// only step the edges until the clipping rectangle is reached
+			} else if (kColorMode == ColorMode::NoInterpolation) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -518,6 +583,70 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					n -= 1;
 					x += 1;
 				}
+			} else if (drawSpan) {
+				span.pixels = (uint32 *)_pbuf + pp1 + x1;
+				span.depth = pz1 + x1;
+				span.texels = nullptr;
+				span.count = (x2 >> 16) - x1 + 1;
+				span.z = z1;
+				span.r = r1;
+				span.g = g1;
+				span.b = b1;
+				span.a = a1;
+
+				if (!(kInterpST || kInterpSTZ)) {
+					if (kEnableScissor && span.count > 0)
+						clipSpan(span, x1, _clipRectangle);
+					if (span.count > 0)
+						drawSpan(span);
+				} else {
+					// fetch the texels of the pixels which are going to be drawn first,
+					// with the same perspective correction as below
+					int first = 0, last = (x2 >> 16) - x1;
+					if (kEnableScissor) {
+						first = MAX(first, _clipRectangle.left - x1);
+						last = MIN(last, _clipRectangle.right - 1 - x1);
+					}
+					assert(last < _pbufWidth);
+
+					float sz = sz1, tz = tz1, fz = (float)z1, zinv = (float)(1.0 / fz);
+					uint z = z1;
+					for (int i = 0; i <= last;) {
+						float ss, tt;
+						ss = sz * zinv;
+						tt = tz * zinv;
+						int s = (int)ss;
+						int t = (int)tt;
+						const int dsdx = (int)((dszdx - ss * fdzdx) * zinv);
+						const int dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+						fz += fndzdx;
+						zinv = (float)(1.0 / fz);
+						sz += ndszdx;
+						tz += ndtzdx;
+
+						// the pixels after the last full block all use the same values
+						const int blockEnd = last + 1 - i >= NB_INTERP ? i + NB_INTERP : last + 1;
+						for (; i < blockEnd; i++) {
+							if (i >= first && span.testDepth(span.depth[i], z)) {
+								uint8 c_a, c_r, c_g, c_b;
+								texture->getARGBAt(_wrapS, _wrapT, s, t, c_a, c_r, c_g, c_b);
+								_spanTexels[i] = (c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+							} else {
+								_spanTexels[i] = 0;
+							}
+							z += dzdx;
+							s += dsdx;
+							t += dtdx;
+						}
+					}
+
+					if (first <= last) {
+						span.texels = _spanTexels;
+						span.count = last + 1;
+						span.skip(first);
+						drawSpan(span);
+					}
+				}
 			} else if (!(kInterpST || kInterpSTZ)) {
 				uint *pz;
 				byte *ps = nullptr;
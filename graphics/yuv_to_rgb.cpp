@@ -82,8 +82,12 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+#include "common/taskscheduler.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -198,6 +202,165 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+const YUVToRGBKernels::Funcs YUVToRGBKernels::funcsNone = {
+	nullptr,
+	nullptr,
+	nullptr,
+	nullptr
+};
+
+const YUVToRGBKernels::Funcs YUVToRGBKernels::funcsGeneric = {
+	YUVToRGBKernels::convertRowGeneric<uint16, false>,
+	YUVToRGBKernels::convertRowGeneric<uint32, false>,
+	YUVToRGBKernels::convertRowGeneric<uint16, true>,
+	YUVToRGBKernels::convertRowGeneric<uint32, true>
+};
+
+const YUVToRGBKernels::Funcs *YUVToRGBKernels::selectedFuncs = nullptr;
+
+const YUVToRGBKernels::Funcs &YUVToRGBKernels::getFuncs() {
+	// If no kernels have been selected yet, detect and select
+	if (!selectedFuncs) {
+		// The generic kernel is no faster than the lookup tables
+		selectedFuncs = &funcsNone;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) selectedFuncs = &funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) selectedFuncs = &funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) selectedFuncs = &funcsAVX2;
+#endif
+	}
+
+	return *selectedFuncs;
+}
+
+namespace {
+
+enum ChromaLayout {
+	kChroma444,
+	kChroma422,
+	kChroma420,
+	kChroma410
+};
+
+enum {
+	/** Number of pixels of a YUV410 row whose chroma is interpolated at once. */
+	kChroma410Chunk = 256,
+	/** Least number of rows converted by a worker thread. */
+	kRowsPerTask = 32
+};
+
+/**
+ * A conversion done with the row kernels. Each row is converted on its own,
+ * so bands of rows can be converted independently, see convertRows().
+ */
+struct YUVToRGBJob {
+	YUVToRGBKernels::RowFunc convertRow;
+	YUVToRGBRowParams params;
+	ChromaLayout layout;
+
+	byte *dst;
+	int dstPitch;
+	int bytesPerPixel;
+	const byte *ySrc;
+	const byte *uSrc;
+	const byte *vSrc;
+	int yWidth;
+	int yPitch;
+	int uvPitch;
+};
+
+/**
+ * Interpolate count pixels of a YUV410 chroma row, the same way as
+ * convertYUV410ToRGB() does, but vertically first.
+ */
+void interpolateChroma410(byte *dst, const byte *src, int uvPitch, int yDiff, int count) {
+	const int quads = count >> 2;
+
+	int column[kChroma410Chunk / 4 + 1];
+	for (int x = 0; x <= quads; x++)
+		column[x] = src[x] * (4 - yDiff) + src[x + uvPitch] * yDiff;
+
+	// column[x] * (4 - xDiff) + column[x + 1] * xDiff, for xDiff = 0 .. 3
+	for (int x = 0; x < quads; x++) {
+		const int left = column[x] * 4;
+		const int step = column[x + 1] - column[x];
+		dst[0] = left >> 4;
+		dst[1] = (left + step) >> 4;
+		dst[2] = (left + step * 2) >> 4;
+		dst[3] = (left + step * 3) >> 4;
+		dst += 4;
+	}
+}
+
+/** Convert the rows [firstRow, lastRow) of a job. */
+void convertRows(const YUVToRGBJob &job, int firstRow, int lastRow) {
+	static const int chromaRowShifts[] = { 0, 0, 1, 2 };
+	const int chromaRowShift = chromaRowShifts[job.layout];
+
+	for (int y = firstRow; y < lastRow; y++) {
+		byte *dstPtr = job.dst + y * job.dstPitch;
+		const byte *ySrc = job.ySrc + y * job.yPitch;
+		const byte *uSrc = job.uSrc + (y >> chromaRowShift) * job.uvPitch;
+		const byte *vSrc = job.vSrc + (y >> chromaRowShift) * job.uvPitch;
+
+		if (job.layout != kChroma410) {
+			job.convertRow(dstPtr, ySrc, uSrc, vSrc, job.yWidth, job.params);
+			continue;
+		}
+
+		// Scale the chroma up to the full resolution first
+		byte uRow[kChroma410Chunk], vRow[kChroma410Chunk];
+		for (int x = 0; x < job.yWidth; x += kChroma410Chunk) {
+			const int count = MIN<int>(kChroma410Chunk, job.yWidth - x);
+			interpolateChroma410(uRow, uSrc + (x >> 2), job.uvPitch, y & 3, count);
+			interpolateChroma410(vRow, vSrc + (x >> 2), job.uvPitch, y & 3, count);
+			job.convertRow(dstPtr + x * job.bytesPerPixel, ySrc + x, uRow, vRow, count, job.params);
+		}
+	}
+}
+
+/** Convert an image with the row kernels, return false if there are none. */
+bool convertWithKernels(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, ChromaLayout layout, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const bool halfChroma = (layout == kChroma422 || layout == kChroma420);
+	const YUVToRGBKernels::RowFunc convertRow = YUVToRGBKernels::getFuncs().get(dst->format.bytesPerPixel, halfChroma);
+	if (!convertRow)
+		return false;
+
+	const Graphics::PixelFormat &format = dst->format;
+
+	YUVToRGBJob job;
+	job.convertRow = convertRow;
+	job.params.ituScale = (scale == YUVToRGBManager::kScaleITU);
+	job.params.rLoss = format.rLoss;
+	job.params.gLoss = format.gLoss;
+	job.params.bLoss = format.bLoss;
+	job.params.rShift = format.rShift;
+	job.params.gShift = format.gShift;
+	job.params.bShift = format.bShift;
+	job.params.alphaMask = (0xFF >> format.aLoss) << format.aShift;
+	job.layout = layout;
+	job.dst = (byte *)dst->getPixels();
+	job.dstPitch = dst->pitch;
+	job.bytesPerPixel = format.bytesPerPixel;
+	job.ySrc = ySrc;
+	job.uSrc = uSrc;
+	job.vSrc = vSrc;
+	job.yWidth = yWidth;
+	job.yPitch = yPitch;
+	job.uvPitch = uvPitch;
+
+	TaskMan.parallelFor(yHeight, kRowsPerTask, [&job](uint begin, uint end) {
+		convertRows(job, begin, end);
+	}, "YUVToRGB");
+	return true;
+}
+
+} // End of anonymous namespace
+
 #define PUT_PIXEL(s, d) \
 	L = &clipTable[(s)]; \
 	*((PixelInt *)(d)) = ((L[cr_r] << r_shift) | (L[crb_g] << g_shift) | (L[cb_b] << b_shift) | a_mask)
@@ -244,6 +407,9 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	if (convertWithKernels(dst, scale, kChroma444, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch))
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -301,6 +467,9 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
 
+	if (convertWithKernels(dst, scale, kChroma422, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch))
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -362,6 +531,9 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	if (convertWithKernels(dst, scale, kChroma420, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch))
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -522,6 +694,9 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	if (convertWithKernels(dst, scale, kChroma410, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch))
+		return;
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+/** Load sixteen chroma samples, or eight used for two pixels each, as 16 bit values. */
+template<bool kHalfChroma>
+static FORCEINLINE __m256i loadChromaAVX2(const byte *src) {
+	if (kHalfChroma) {
+		const __m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(c, c)), _mm_unpackhi_epi16(c, c), 1);
+	}
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+}
+
+/** YUVToRGBKernels::chromaTerm() on sixteen samples. */
+static FORCEINLINE __m256i chromaTermAVX2(__m256i c, int coeff) {
+	const __m256i d = _mm256_sub_epi16(c, _mm256_set1_epi16(128));
+	// (abs(d) << 8) * coeff >> 16 >> 7 is abs(d) * coeff >> 15
+	const __m256i t = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_abs_epi16(d), 8), _mm256_set1_epi16(coeff)), 7);
+	return _mm256_sign_epi16(t, d);
+}
+
+/** YUVToRGBKernels::clampComponent() on sixteen components, followed by the loss of the destination. */
+template<bool kITU>
+static FORCEINLINE __m256i componentAVX2(__m256i v, __m128i loss) {
+	if (kITU) {
+		v = _mm256_min_epi16(_mm256_max_epi16(_mm256_sub_epi16(v, _mm256_set1_epi16(16)), _mm256_setzero_si256()), _mm256_set1_epi16(219));
+		v = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(v, _mm256_set1_epi16(255)), _mm256_set1_epi16((int16)YUVToRGBKernels::kITUScale)), 7);
+	} else {
+		v = _mm256_min_epi16(_mm256_max_epi16(v, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+	}
+	return _mm256_srl_epi16(v, loss);
+}
+
+/** Pack eight components of each color into 32 bit pixels. */
+static FORCEINLINE __m256i pack32AVX2(__m128i r, __m128i g, __m128i b, __m128i rShift, __m128i gShift, __m128i bShift, __m256i alpha) {
+	return _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(r), rShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(g), gShift)),
+	                       _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(b), bShift), alpha));
+}
+
+template<typename PixelInt, bool kHalfChroma, bool kITU>
+static void convertAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m256i u = loadChromaAVX2<kHalfChroma>(uSrc + (kHalfChroma ? x >> 1 : x));
+		const __m256i v = loadChromaAVX2<kHalfChroma>(vSrc + (kHalfChroma ? x >> 1 : x));
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+
+		const __m256i crb_g = _mm256_add_epi16(chromaTermAVX2(v, YUVToRGBKernels::kCrToG), chromaTermAVX2(u, YUVToRGBKernels::kCbToG));
+		const __m256i r = componentAVX2<kITU>(_mm256_add_epi16(y, chromaTermAVX2(v, YUVToRGBKernels::kCrToR)), rLoss);
+		const __m256i g = componentAVX2<kITU>(_mm256_sub_epi16(y, crb_g), gLoss);
+		const __m256i b = componentAVX2<kITU>(_mm256_add_epi16(y, chromaTermAVX2(u, YUVToRGBKernels::kCbToB)), bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			const __m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift)),
+			                                       _mm256_or_si256(_mm256_sll_epi16(b, bShift), _mm256_set1_epi16((int16)params.alphaMask)));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), pixels);
+		} else {
+			const __m256i alpha = _mm256_set1_epi32(params.alphaMask);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4),
+			                    pack32AVX2(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), rShift, gShift, bShift, alpha));
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32),
+			                    pack32AVX2(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1), rShift, gShift, bShift, alpha));
+		}
+	}
+
+	const int c = kHalfChroma ? x >> 1 : x;
+	YUVToRGBKernels::convertRowGeneric<PixelInt, kHalfChroma>(dst + x * sizeof(PixelInt), ySrc + x, uSrc + c, vSrc + c, width - x, params);
+}
+
+template<typename PixelInt, bool kHalfChroma>
+static void convertRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	if (params.ituScale)
+		convertAVX2<PixelInt, kHalfChroma, true>(dst, ySrc, uSrc, vSrc, width, params);
+	else
+		convertAVX2<PixelInt, kHalfChroma, false>(dst, ySrc, uSrc, vSrc, width, params);
+}
+
+const YUVToRGBKernels::Funcs YUVToRGBKernels::funcsAVX2 = {
+	convertRowAVX2<uint16, false>,
+	convertRowAVX2<uint32, false>,
+	convertRowAVX2<uint16, true>,
+	convertRowAVX2<uint32, true>
+};
+
+} // End of namespace Graphics
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/util.h"
+
+namespace Graphics {
+
+/** The layout of the destination pixels and the luminance scale used by the row kernels. */
+struct YUVToRGBRowParams {
+	bool ituScale;           ///< Luminance values range from [16, 235] instead of [0, 255]
+	byte rLoss, gLoss, bLoss;
+	byte rShift, gShift, bShift;
+	uint32 alphaMask;        ///< Set in every pixel
+};
+
+/**
+ * The kernels converting a row of YUV pixels to RGB, with SIMD variants
+ * computing the conversion arithmetically instead of with the lookup
+ * tables of YUVToRGBManager.
+ *
+ * The fixed point coefficients below are chosen so that all variants
+ * produce exactly the same output as the lookup tables.
+ */
+class YUVToRGBKernels {
+public:
+	enum {
+		/** The chroma coefficients, in 1.15 fixed point. */
+		kCrToR = 45919,          ///< 0.419 / 0.299
+		kCrToG = 23383,          ///< 0.299 / 0.419
+		kCbToG = 11286,          ///< 0.114 / 0.331
+		kCbToB = 58111,          ///< 0.587 / 0.331
+		/** Multiplier for dividing by 219, in 0.23 fixed point. */
+		kITUScale = 38305
+	};
+
+	/**
+	 * Convert width pixels. With half chroma, each chroma sample is
+	 * used for two consecutive pixels.
+	 */
+	typedef void (*RowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params);
+
+	struct Funcs {
+		RowFunc convert444To16;
+		RowFunc convert444To32;
+		RowFunc convert422To16;
+		RowFunc convert422To32;
+
+		RowFunc get(int bytesPerPixel, bool halfChroma) const {
+			if (bytesPerPixel == 2)
+				return halfChroma ? convert422To16 : convert444To16;
+			return halfChroma ? convert422To32 : convert444To32;
+		}
+	};
+
+	/**
+	 * Return the kernels best suited for the CPU we are running on.
+	 * The selection is done on the first call.
+	 */
+	static const Funcs &getFuncs();
+
+	/** The kernels in use, nullptr until they have been selected. */
+	static const Funcs *selectedFuncs;
+
+	/** Use the lookup tables, used when no SIMD kernels are available. */
+	static const Funcs funcsNone;
+	static const Funcs funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Funcs funcsAVX2;
+#endif
+
+	/** The generic kernel, also used by the SIMD variants for the remaining pixels. */
+	template<typename PixelInt, bool kHalfChroma>
+	static void convertRowGeneric(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+		PixelInt *out = (PixelInt *)dst;
+
+		for (int x = 0; x < width; x++) {
+			const int c = kHalfChroma ? x >> 1 : x;
+			const int y = ySrc[x];
+
+			const uint r = clampComponent(y + chromaTerm(vSrc[c], kCrToR), params.ituScale);
+			const uint g = clampComponent(y - chromaTerm(vSrc[c], kCrToG) - chromaTerm(uSrc[c], kCbToG), params.ituScale);
+			const uint b = clampComponent(y + chromaTerm(uSrc[c], kCbToB), params.ituScale);
+
+			out[x] = ((r >> params.rLoss) << params.rShift) | ((g >> params.gLoss) << params.gShift) |
+			         ((b >> params.bLoss) << params.bShift) | params.alphaMask;
+		}
+	}
+
+	/** The chroma sample c - 128 multiplied by coeff, truncated towards zero. */
+	static inline int chromaTerm(byte c, uint coeff) {
+		const int d = c - 128;
+		const int t = (ABS(d) * coeff) >> 15;
+		return d < 0 ? -t : t;
+	}
+
+	/** Clamp a color component to the luminance range, and scale it to [0, 255]. */
+	static inline uint clampComponent(int v, bool ituScale) {
+		if (ituScale)
+			return (CLIP(v - 16, 0, 219) * 255 * (uint)kITUScale) >> 23;
+		return CLIP(v, 0, 255);
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Graphics {
+
+/** YUVToRGBKernels::chromaTerm() on eight samples. */
+static inline int16x8_t chromaTermNEON(uint8x8_t c, uint16 coeff) {
+	const int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(c, vdup_n_u8(128)));
+	const uint16x8_t magnitude = vreinterpretq_u16_s16(vabsq_s16(d));
+	const int16x8_t t = vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(magnitude), coeff), 15),
+	                                                       vshrn_n_u32(vmull_n_u16(vget_high_u16(magnitude), coeff), 15)));
+	return vbslq_s16(vcltq_s16(d, vdupq_n_s16(0)), vnegq_s16(t), t);
+}
+
+/** YUVToRGBKernels::clampComponent() on eight components, followed by the loss of the destination. */
+template<bool kITU>
+static inline uint16x8_t componentNEON(int16x8_t v, int16x8_t negLoss) {
+	uint16x8_t c;
+	if (kITU) {
+		v = vminq_s16(vmaxq_s16(vsubq_s16(v, vdupq_n_s16(16)), vdupq_n_s16(0)), vdupq_n_s16(219));
+		c = vmulq_n_u16(vreinterpretq_u16_s16(v), 255);
+		c = vshrq_n_u16(vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(c), YUVToRGBKernels::kITUScale), 16),
+		                             vshrn_n_u32(vmull_n_u16(vget_high_u16(c), YUVToRGBKernels::kITUScale), 16)), 7);
+	} else {
+		c = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(v, vdupq_n_s16(0)), vdupq_n_s16(255)));
+	}
+	return vshlq_u16(c, negLoss);
+}
+
+/** Convert eight pixels, with one chroma sample each. */
+template<typename PixelInt, bool kITU>
+static inline void convert8NEON(byte *dst, uint8x8_t y8, uint8x8_t u, uint8x8_t v, const YUVToRGBRowParams &params) {
+	const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(y8));
+
+	const int16x8_t crb_g = vaddq_s16(chromaTermNEON(v, YUVToRGBKernels::kCrToG), chromaTermNEON(u, YUVToRGBKernels::kCbToG));
+	const uint16x8_t r = componentNEON<kITU>(vaddq_s16(y, chromaTermNEON(v, YUVToRGBKernels::kCrToR)), vdupq_n_s16(-params.rLoss));
+	const uint16x8_t g = componentNEON<kITU>(vsubq_s16(y, crb_g), vdupq_n_s16(-params.gLoss));
+	const uint16x8_t b = componentNEON<kITU>(vaddq_s16(y, chromaTermNEON(u, YUVToRGBKernels::kCbToB)), vdupq_n_s16(-params.bLoss));
+
+	if (sizeof(PixelInt) == 2) {
+		const uint16x8_t pixels = vorrq_u16(vorrq_u16(vshlq_u16(r, vdupq_n_s16(params.rShift)), vshlq_u16(g, vdupq_n_s16(params.gShift))),
+		                                    vorrq_u16(vshlq_u16(b, vdupq_n_s16(params.bShift)), vdupq_n_u16((uint16)params.alphaMask)));
+		vst1q_u16((uint16 *)dst, pixels);
+	} else {
+		const int32x4_t rShift = vdupq_n_s32(params.rShift);
+		const int32x4_t gShift = vdupq_n_s32(params.gShift);
+		const int32x4_t bShift = vdupq_n_s32(params.bShift);
+		const uint32x4_t alpha = vdupq_n_u32(params.alphaMask);
+		const uint32x4_t lo = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(g)), gShift)),
+		                                vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(b)), bShift), alpha));
+		const uint32x4_t hi = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(g)), gShift)),
+		                                vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(b)), bShift), alpha));
+		vst1q_u32((uint32 *)dst, lo);
+		vst1q_u32((uint32 *)dst + 4, hi);
+	}
+}
+
+template<typename PixelInt, bool kHalfChroma, bool kITU>
+static void convertNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		uint8x8_t u0, u1, v0, v1;
+		if (kHalfChroma) {
+			const uint8x8x2_t u = vzip_u8(vld1_u8(uSrc + (x >> 1)), vld1_u8(uSrc + (x >> 1)));
+			const uint8x8x2_t v = vzip_u8(vld1_u8(vSrc + (x >> 1)), vld1_u8(vSrc + (x >> 1)));
+			u0 = u.val[0];
+			u1 = u.val[1];
+			v0 = v.val[0];
+			v1 = v.val[1];
+		} else {
+			u0 = vld1_u8(uSrc + x);
+			u1 = vld1_u8(uSrc + x + 8);
+			v0 = vld1_u8(vSrc + x);
+			v1 = vld1_u8(vSrc + x + 8);
+		}
+
+		convert8NEON<PixelInt, kITU>(dst + x * sizeof(PixelInt), vld1_u8(ySrc + x), u0, v0, params);
+		convert8NEON<PixelInt, kITU>(dst + (x + 8) * sizeof(PixelInt), vld1_u8(ySrc + x + 8), u1, v1, params);
+	}
+
+	const int c = kHalfChroma ? x >> 1 : x;
+	YUVToRGBKernels::convertRowGeneric<PixelInt, kHalfChroma>(dst + x * sizeof(PixelInt), ySrc + x, uSrc + c, vSrc + c, width - x, params);
+}
+
+template<typename PixelInt, bool kHalfChroma>
+static void convertRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	if (params.ituScale)
+		convertNEON<PixelInt, kHalfChroma, true>(dst, ySrc, uSrc, vSrc, width, params);
+	else
+		convertNEON<PixelInt, kHalfChroma, false>(dst, ySrc, uSrc, vSrc, width, params);
+}
+
+const YUVToRGBKernels::Funcs YUVToRGBKernels::funcsNEON = {
+	convertRowNEON<uint16, false>,
+	convertRowNEON<uint32, false>,
+	convertRowNEON<uint16, true>,
+	convertRowNEON<uint32, true>
+};
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+/** Load eight chroma samples, or four used for two pixels each, as 16 bit values. */
+template<bool kHalfChroma>
+static FORCEINLINE __m128i loadChromaSSE2(const byte *src) {
+	if (kHalfChroma) {
+		uint32 samples;
+		memcpy(&samples, src, 4);
+		const __m128i c = _mm_unpacklo_epi8(_mm_cvtsi32_si128(samples), _mm_setzero_si128());
+		return _mm_unpacklo_epi16(c, c);
+	}
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+/** YUVToRGBKernels::chromaTerm() on eight samples. */
+static FORCEINLINE __m128i chromaTermSSE2(__m128i c, int coeff) {
+	const __m128i d = _mm_sub_epi16(c, _mm_set1_epi16(128));
+	const __m128i sign = _mm_srai_epi16(d, 15);
+	const __m128i magnitude = _mm_sub_epi16(_mm_xor_si128(d, sign), sign);
+	// (magnitude << 8) * coeff >> 16 >> 7 is magnitude * coeff >> 15
+	const __m128i t = _mm_srli_epi16(_mm_mulhi_epu16(_mm_slli_epi16(magnitude, 8), _mm_set1_epi16(coeff)), 7);
+	return _mm_sub_epi16(_mm_xor_si128(t, sign), sign);
+}
+
+/** YUVToRGBKernels::clampComponent() on eight components, followed by the loss of the destination. */
+template<bool kITU>
+static FORCEINLINE __m128i componentSSE2(__m128i v, __m128i loss) {
+	if (kITU) {
+		v = _mm_min_epi16(_mm_max_epi16(_mm_sub_epi16(v, _mm_set1_epi16(16)), _mm_setzero_si128()), _mm_set1_epi16(219));
+		v = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(v, _mm_set1_epi16(255)), _mm_set1_epi16((int16)YUVToRGBKernels::kITUScale)), 7);
+	} else {
+		v = _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(255));
+	}
+	return _mm_srl_epi16(v, loss);
+}
+
+template<typename PixelInt, bool kHalfChroma, bool kITU>
+static void convertSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m128i u = loadChromaSSE2<kHalfChroma>(uSrc + (kHalfChroma ? x >> 1 : x));
+		const __m128i v = loadChromaSSE2<kHalfChroma>(vSrc + (kHalfChroma ? x >> 1 : x));
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), _mm_setzero_si128());
+
+		const __m128i crb_g = _mm_add_epi16(chromaTermSSE2(v, YUVToRGBKernels::kCrToG), chromaTermSSE2(u, YUVToRGBKernels::kCbToG));
+		const __m128i r = componentSSE2<kITU>(_mm_add_epi16(y, chromaTermSSE2(v, YUVToRGBKernels::kCrToR)), rLoss);
+		const __m128i g = componentSSE2<kITU>(_mm_sub_epi16(y, crb_g), gLoss);
+		const __m128i b = componentSSE2<kITU>(_mm_add_epi16(y, chromaTermSSE2(u, YUVToRGBKernels::kCbToB)), bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			const __m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift)),
+			                                    _mm_or_si128(_mm_sll_epi16(b, bShift), _mm_set1_epi16((int16)params.alphaMask)));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+		} else {
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i alpha = _mm_set1_epi32(params.alphaMask);
+			const __m128i lo = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift)),
+			                                _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift), alpha));
+			const __m128i hi = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift)),
+			                                _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift), alpha));
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	const int c = kHalfChroma ? x >> 1 : x;
+	YUVToRGBKernels::convertRowGeneric<PixelInt, kHalfChroma>(dst + x * sizeof(PixelInt), ySrc + x, uSrc + c, vSrc + c, width - x, params);
+}
+
+template<typename PixelInt, bool kHalfChroma>
+static void convertRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	if (params.ituScale)
+		convertSSE2<PixelInt, kHalfChroma, true>(dst, ySrc, uSrc, vSrc, width, params);
+	else
+		convertSSE2<PixelInt, kHalfChroma, false>(dst, ySrc, uSrc, vSrc, width, params);
+}
+
+const YUVToRGBKernels::Funcs YUVToRGBKernels::funcsSSE2 = {
+	convertRowSSE2<uint16, false>,
+	convertRowSSE2<uint32, false>,
+	convertRowSSE2<uint16, true>,
+	convertRowSSE2<uint32, true>
+};
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -34,8 +34,11 @@
 #include "common/stream.h"
 #endif
 
+#include "engines/advancedDetector.h"
 #include "engines/engine.h"
 
+#include "image/codecs/bufferpool.h"
+
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	#include "gui/console.h"
@@ -76,6 +79,9 @@ Debugger::Debugger() {
 	registerCmd("clear",			WRAP_METHOD(Debugger, cmdClearLog));
 	registerCmd("cls",			WRAP_METHOD(Debugger, cmdClearLog)); // alias
 	registerCmd("exec",				WRAP_METHOD(Debugger, cmdExecFile));
+	registerCmd("archive_cache",	WRAP_METHOD(Debugger, cmdArchiveCache));
+	registerCmd("codec_pool",		WRAP_METHOD(Debugger, cmdCodecPool));
+	registerCmd("detection_cache",	WRAP_METHOD(Debugger, cmdDetectionCache));
 
 	registerCmd("debuglevel",		WRAP_METHOD(Debugger, cmdDebugLevel));
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
@@ -757,6 +763,56 @@ bool Debugger::cmdMd5Mac(int argc, const char **argv) {
 }
 #endif
 
+bool Debugger::cmdArchiveCache(int argc, const char **argv) {
+	typedef Common::MemcachingCaseInsensitiveArchive CachingArchive;
+
+	if (argc > 2) {
+		debugPrintf("Usage: %s [<limit in KB>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2)
+		CachingArchive::setGlobalCacheLimit(atoi(argv[1]) * 1024);
+
+	const CachingArchive::CacheStats stats = CachingArchive::getGlobalCacheStats();
+	debugPrintf("Archive contents cache: %u archives, %u entries\n", stats.archives, stats.entries);
+	debugPrintf("Cached contents: %u KB, limit %u KB\n", (uint)(stats.cachedBytes / 1024), CachingArchive::getGlobalCacheLimit() / 1024);
+	debugPrintf("Hits: %u, misses: %u, evictions: %u\n", stats.hits, stats.misses, stats.evictions);
+	return true;
+}
+
+bool Debugger::cmdCodecPool(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [reset | <limit in KB>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset"))
+			CodecBufferPoolMan.resetStats();
+		else
+			CodecBufferPoolMan.setCacheLimit(atoi(argv[1]) * 1024);
+	}
+
+	const Image::CodecBufferPool::Stats stats = CodecBufferPoolMan.getStats();
+	debugPrintf("Codec buffer pool: %u buffers in use (%u KB), %u cached (%u KB), limit %u KB\n",
+		stats.buffersInUse, (uint)(stats.bytesInUse / 1024), stats.buffersCached, (uint)(stats.bytesCached / 1024), CodecBufferPoolMan.getCacheLimit() / 1024);
+	debugPrintf("Requests: %u, heap allocations: %u, heap frees: %u\n", stats.requests, stats.heapAllocations, stats.heapFrees);
+	return true;
+}
+
+bool Debugger::cmdDetectionCache(int argc, const char **argv) {
+	if (argc != 2 || strcmp(argv[1], "clear")) {
+		debugPrintf("Usage: %s clear\n", argv[0]);
+		debugPrintf("Forgets the file properties kept between game detections\n");
+		return true;
+	}
+
+	ADCacheMan.clearPersistentCache();
+	debugPrintf("Detection cache cleared\n");
+	return true;
+}
+
 bool Debugger::cmdDebugLevel(int argc, const char **argv) {
 	if (argc == 1) { // print level
 		debugPrintf("Debugging is currently %s (set at level %d)\n", (gDebugLevel >= 0) ? "enabled" : "disabled", gDebugLevel);
@@ -277,6 +277,9 @@ protected:
 	bool cmdDebugFlagDisable(int argc, const char **argv);
 	bool cmdClearLog(int argc, const char **argv);
 	bool cmdExecFile(int argc, const char **argv);
+	bool cmdArchiveCache(int argc, const char **argv);
+	bool cmdCodecPool(int argc, const char **argv);
+	bool cmdDetectionCache(int argc, const char **argv);
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
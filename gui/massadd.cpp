@@ -157,6 +157,8 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 		close();
 	} else if (cmd == kCancelCmd) {
 		// User cancelled, so we don't do anything and just leave.
+		// The MD5s computed so far are still worth keeping, though.
+		ADCacheMan.savePersistentCache(true);
 		_games.clear();
 		close();
 	} else if (cmd == kListSelectionChangedCmd) {
@@ -277,6 +279,9 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		// Keep the computed MD5s for the next scan
+		ADCacheMan.savePersistentCache(true);
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
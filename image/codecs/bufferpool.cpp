@@ -0,0 +1,195 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "image/codecs/bufferpool.h"
+
+#include "common/intrinsics.h"
+#include "common/textconsole.h"
+#include "graphics/surface.h"
+
+namespace Common {
+DECLARE_SINGLETON(Image::CodecBufferPool);
+}
+
+namespace Image {
+
+namespace {
+
+/**
+ * Stored in front of each buffer. Padded to 16 bytes, so that the buffers
+ * keep the alignment of malloc().
+ */
+struct BufferHeader {
+	uint32 sizeClass;
+	uint32 size;
+	uint32 padding[2];
+};
+
+} // End of anonymous namespace
+
+CodecBufferPool::CodecBufferPool() : _cacheLimit(16 * 1024 * 1024) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+CodecBufferPool::~CodecBufferPool() {
+	purge();
+}
+
+uint32 CodecBufferPool::getSizeClass(uint32 size, uint32 &classSize) {
+	if (size <= kMinClassSize) {
+		classSize = kMinClassSize;
+		return 0;
+	}
+
+	if (size > kMaxClassSize) {
+		classSize = size;
+		return kUnpooled;
+	}
+
+	// Four classes per power of two, so that less than a fifth of a
+	// buffer is wasted
+	const int shift = Common::intLog2(size - 1) - 2;
+	const uint32 steps = ((size - 1) >> shift) + 1;
+	classSize = steps << shift;
+	return (shift - (Common::intLog2(kMinClassSize) - 2)) * 4 + steps - 4;
+}
+
+void *CodecBufferPool::allocate(uint32 size) {
+	uint32 classSize;
+	const uint32 sizeClass = getSizeClass(size, classSize);
+	BufferHeader *header = nullptr;
+
+	{
+		Common::StackLock lock(_mutex);
+		_stats.requests++;
+		_stats.buffersInUse++;
+		_stats.bytesInUse += classSize;
+
+		if (sizeClass != kUnpooled && !_freeBuffers[sizeClass].empty()) {
+			header = (BufferHeader *)_freeBuffers[sizeClass].back();
+			_freeBuffers[sizeClass].pop_back();
+			_stats.buffersCached--;
+			_stats.bytesCached -= classSize;
+		} else {
+			_stats.heapAllocations++;
+		}
+	}
+
+	if (!header) {
+		header = (BufferHeader *)malloc(sizeof(BufferHeader) + classSize);
+		if (!header)
+			error("CodecBufferPool::allocate(): Out of memory allocating %u bytes", size);
+		header->sizeClass = sizeClass;
+		header->size = classSize;
+	}
+
+	return header + 1;
+}
+
+void CodecBufferPool::release(void *buffer) {
+	if (!buffer)
+		return;
+
+	BufferHeader *header = (BufferHeader *)buffer - 1;
+
+	{
+		Common::StackLock lock(_mutex);
+		_stats.buffersInUse--;
+		_stats.bytesInUse -= header->size;
+
+		if (header->sizeClass != kUnpooled && _stats.bytesCached + header->size <= _cacheLimit) {
+			_freeBuffers[header->sizeClass].push_back(header);
+			_stats.buffersCached++;
+			_stats.bytesCached += header->size;
+			return;
+		}
+
+		_stats.heapFrees++;
+	}
+
+	free(header);
+}
+
+void CodecBufferPool::createSurface(Graphics::Surface &surface, int16 width, int16 height, const Graphics::PixelFormat &format) {
+	assert(width >= 0 && height >= 0);
+
+	// Cleared like Surface::create(), since the codecs draw their first
+	// frames on top of it
+	const uint32 size = width * height * format.bytesPerPixel;
+	void *pixels = nullptr;
+	if (size) {
+		pixels = allocate(size);
+		memset(pixels, 0, size);
+	}
+
+	surface.init(width, height, width * format.bytesPerPixel, pixels, format);
+}
+
+void CodecBufferPool::freeSurface(Graphics::Surface &surface) {
+	release(surface.getPixels());
+	surface.init(0, 0, 0, nullptr, Graphics::PixelFormat());
+}
+
+void CodecBufferPool::purge() {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < kNumClasses; i++) {
+		for (uint j = 0; j < _freeBuffers[i].size(); j++)
+			free(_freeBuffers[i][j]);
+		_stats.heapFrees += _freeBuffers[i].size();
+		_freeBuffers[i].clear();
+	}
+
+	_stats.buffersCached = 0;
+	_stats.bytesCached = 0;
+}
+
+void CodecBufferPool::setCacheLimit(uint32 bytes) {
+	Common::StackLock lock(_mutex);
+	_cacheLimit = bytes;
+
+	// Drop the largest buffers first, they are the least likely to be
+	// asked for again
+	for (int i = kNumClasses - 1; i >= 0 && _stats.bytesCached > _cacheLimit; i--) {
+		while (!_freeBuffers[i].empty() && _stats.bytesCached > _cacheLimit) {
+			BufferHeader *header = (BufferHeader *)_freeBuffers[i].back();
+			_freeBuffers[i].pop_back();
+			_stats.buffersCached--;
+			_stats.bytesCached -= header->size;
+			_stats.heapFrees++;
+			free(header);
+		}
+	}
+}
+
+CodecBufferPool::Stats CodecBufferPool::getStats() {
+	Common::StackLock lock(_mutex);
+	return _stats;
+}
+
+void CodecBufferPool::resetStats() {
+	Common::StackLock lock(_mutex);
+	_stats.requests = 0;
+	_stats.heapAllocations = 0;
+	_stats.heapFrees = 0;
+}
+
+} // End of namespace Image
@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IMAGE_CODECS_BUFFERPOOL_H
+#define IMAGE_CODECS_BUFFERPOOL_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+
+namespace Graphics {
+struct PixelFormat;
+struct Surface;
+}
+
+namespace Image {
+
+/**
+ * A pool of frame and scratch buffers shared by the codecs, so that
+ * playing videos one after the other, or decoders allocating a buffer for
+ * each frame, reuse the same memory instead of going through the heap.
+ *
+ * Buffers are grouped in size classes, four per power of two, and
+ * released buffers are kept for the next request of their class within
+ * a byte budget. The pool may be used from any thread.
+ */
+class CodecBufferPool : public Common::Singleton<CodecBufferPool> {
+public:
+	/** The allocation counters, see getStats(). */
+	struct Stats {
+		uint32 requests;        ///< Buffers asked for
+		uint32 heapAllocations; ///< Requests which had to allocate memory
+		uint32 heapFrees;       ///< Released buffers given back to the heap
+		uint32 buffersInUse;
+		uint32 buffersCached;
+		uint64 bytesInUse;
+		uint64 bytesCached;
+	};
+
+	CodecBufferPool();
+	~CodecBufferPool();
+
+	/**
+	 * Return a buffer of at least size bytes, aligned like malloc().
+	 * The contents are undefined.
+	 */
+	void *allocate(uint32 size);
+
+	/** Give back a buffer returned by allocate(). Does nothing for nullptr. */
+	void release(void *buffer);
+
+	/**
+	 * Like Graphics::Surface::create(), but take the pixels from the pool.
+	 * The surface has to be freed with freeSurface().
+	 */
+	void createSurface(Graphics::Surface &surface, int16 width, int16 height, const Graphics::PixelFormat &format);
+
+	/** Like Graphics::Surface::free(), for surfaces made by createSurface(). */
+	void freeSurface(Graphics::Surface &surface);
+
+	/** Give all the cached buffers back to the heap. */
+	void purge();
+
+	/**
+	 * Set the number of bytes the cached buffers may use. Buffers released
+	 * above the limit are given back to the heap.
+	 */
+	void setCacheLimit(uint32 bytes);
+	uint32 getCacheLimit() const { return _cacheLimit; }
+
+	Stats getStats();
+
+	/** Reset the request, allocation and free counters. */
+	void resetStats();
+
+private:
+	enum {
+		kMinClassSize = 4096,
+		kMaxClassSize = 64 * 1024 * 1024,
+		kNumClasses = 4 * 14 + 1,
+
+		/** Buffers above kMaxClassSize are not cached. */
+		kUnpooled = 0xFFFFFFFF
+	};
+
+	static uint32 getSizeClass(uint32 size, uint32 &classSize);
+
+	Common::Array<void *> _freeBuffers[kNumClasses];
+	Common::Mutex _mutex;
+	uint32 _cacheLimit;
+	Stats _stats;
+};
+
+} // End of namespace Image
+
+/** Shortcut for accessing the codec buffer pool. */
+#define CodecBufferPoolMan Image::CodecBufferPool::instance()
+
+#endif
@@ -20,6 +20,7 @@
  */
 
 #include "image/codecs/cinepak.h"
+#include "image/codecs/bufferpool.h"
 #include "image/codecs/cinepak_tables.h"
 #include "image/codecs/dither.h"
 
@@ -310,7 +311,7 @@ CinepakDecoder::CinepakDecoder(int bitsPerPixel) : Codec(), _bitsPerPixel(bitsPe
 
 CinepakDecoder::~CinepakDecoder() {
 	if (_curFrame.surface) {
-		_curFrame.surface->free();
+		CodecBufferPoolMan.freeSurface(*_curFrame.surface);
 		delete _curFrame.surface;
 	}
 
@@ -349,7 +350,7 @@ const Graphics::Surface *CinepakDecoder::decodeFrame(Common::SeekableReadStream
 
 	if (!_curFrame.surface) {
 		_curFrame.surface = new Graphics::Surface();
-		_curFrame.surface->create(_curFrame.width, _curFrame.height, _pixelFormat);
+		CodecBufferPoolMan.createSurface(*_curFrame.surface, _curFrame.width, _curFrame.height, _pixelFormat);
 	}
 
 	_y = 0;
@@ -0,0 +1,299 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/endian.h"
+#include "common/system.h"
+#include "common/util.h"
+
+#include "image/codecs/dsp.h"
+
+namespace Image {
+
+// SVQ1 half-pel motion compensation, four pixels at a time
+
+static void putPixels8Generic(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++) {
+		*((uint32 *)block) = READ_UINT32(pixels);
+		*((uint32 *)(block + 4)) = READ_UINT32(pixels + 4);
+		pixels += lineSize;
+		block += lineSize;
+	}
+}
+
+static inline uint32 rndAvg32(uint32 a, uint32 b) {
+	return (a | b) - (((a ^ b) & ~0x01010101) >> 1);
+}
+
+static void putPixels8L2Generic(byte *dst, const byte *src1, const byte *src2, int stride, int h) {
+	for (int i = 0; i < h; i++) {
+		uint32 a = READ_UINT32(&src1[stride * i]);
+		uint32 b = READ_UINT32(&src2[stride * i]);
+		*((uint32 *)&dst[stride * i]) = rndAvg32(a, b);
+		a = READ_UINT32(&src1[stride * i + 4]);
+		b = READ_UINT32(&src2[stride * i + 4]);
+		*((uint32 *)&dst[stride * i + 4]) = rndAvg32(a, b);
+	}
+}
+
+static void putPixels8X2Generic(byte *block, const byte *pixels, int lineSize, int h) {
+	putPixels8L2Generic(block, pixels, pixels + 1, lineSize, h);
+}
+
+static void putPixels8Y2Generic(byte *block, const byte *pixels, int lineSize, int h) {
+	putPixels8L2Generic(block, pixels, pixels + lineSize, lineSize, h);
+}
+
+static void putPixels8XY2Generic(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int j = 0; j < 2; j++) {
+		uint32 a = READ_UINT32(pixels);
+		uint32 b = READ_UINT32(pixels + 1);
+		uint32 l0 = (a & 0x03030303UL) + (b & 0x03030303UL) + 0x02020202UL;
+		uint32 h0 = ((a & 0xFCFCFCFCUL) >> 2) + ((b & 0xFCFCFCFCUL) >> 2);
+
+		pixels += lineSize;
+
+		for (int i = 0; i < h; i += 2) {
+			a = READ_UINT32(pixels);
+			b = READ_UINT32(pixels + 1);
+			uint32 l1 = (a & 0x03030303UL) + (b & 0x03030303UL);
+			uint32 h1 = ((a & 0xFCFCFCFCUL) >> 2) + ((b & 0xFCFCFCFCUL) >> 2);
+			*((uint32 *)block) = h0 + h1 + (((l0 + l1) >> 2) & 0x0F0F0F0FUL);
+			pixels += lineSize;
+			block += lineSize;
+			a = READ_UINT32(pixels);
+			b = READ_UINT32(pixels + 1);
+			l0 = (a & 0x03030303UL) + (b & 0x03030303UL) + 0x02020202UL;
+			h0 = ((a & 0xFCFCFCFCUL) >> 2) + ((b & 0xFCFCFCFCUL) >> 2);
+			*((uint32 *)block) = h0 + h1 + (((l0 + l1) >> 2) & 0x0F0F0F0FUL);
+			pixels += lineSize;
+			block += lineSize;
+		}
+
+		pixels += 4 - lineSize * (h + 1);
+		block += 4 - lineSize * h;
+	}
+}
+
+template<void (*putPixels8)(byte *, const byte *, int, int)>
+static void putPixels16Generic(byte *block, const byte *pixels, int lineSize, int h) {
+	putPixels8(block, pixels, lineSize, h);
+	putPixels8(block + 8, pixels + 8, lineSize, h);
+}
+
+// Indeo motion compensation
+
+template<bool kAdd>
+static void mc8x8Generic(int16 *buf, uint32 dpitch, const int16 *refBuf, uint32 pitch, int mcType) {
+	const int16 *wptr = refBuf + pitch;
+
+	for (int i = 0; i < 8; i++, buf += dpitch, refBuf += pitch, wptr += pitch) {
+		for (int j = 0; j < 8; j++) {
+			int value;
+			switch (mcType) {
+			case CodecDSP::kHalfPelNone:
+				value = refBuf[j];
+				break;
+			case CodecDSP::kHalfPelX:
+				value = (refBuf[j] + refBuf[j + 1]) >> 1;
+				break;
+			case CodecDSP::kHalfPelY:
+				value = (refBuf[j] + wptr[j]) >> 1;
+				break;
+			case CodecDSP::kHalfPelXY:
+				value = (refBuf[j] + refBuf[j + 1] + wptr[j] + wptr[j + 1]) >> 2;
+				break;
+			default:
+				return;
+			}
+
+			if (kAdd)
+				buf[j] += value;
+			else
+				buf[j] = value;
+		}
+	}
+}
+
+template<bool kAdd>
+static void mcAvg8x8Generic(int16 *buf, const int16 *refBuf, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2) {
+	int16 tmp[8 * 8];
+
+	mc8x8Generic<false>(tmp, 8, refBuf, pitch, mcType);
+	mc8x8Generic<true>(tmp, 8, refBuf2, pitch, mcType2);
+	for (int i = 0; i < 8; i++, buf += pitch) {
+		for (int j = 0; j < 8; j++) {
+			if (kAdd)
+				buf[j] += tmp[i * 8 + j] >> 1;
+			else
+				buf[j] = tmp[i * 8 + j] >> 1;
+		}
+	}
+}
+
+// Indeo inverse transforms
+
+/** The inverse 8-point slant transform, with s and d in natural order. */
+static inline void inverseSlant8(int32 *d, const int32 *s) {
+	const int32 s1 = s[0], s4 = s[1], s8 = s[2], s5 = s[3];
+	const int32 s2 = s[4], s6 = s[5], s3 = s[6], s7 = s[7];
+	int32 t, t1, t2, t3, t4, t5, t6, t7, t8;
+
+	// Reflection a,b = 1/2, 7/8
+	t4 = s5 + ((s4 * 4 - s5 + 4) >> 3);
+	t5 = s4 + ((-s4 - s5 * 4 + 4) >> 3);
+
+	t1 = s1 + t5; t5 = s1 - t5;
+	t2 = s2 + s6; t6 = s2 - s6;
+	t7 = s7 + s3; t3 = s7 - s3;
+	t8 = t4 - s8; t4 = t4 + s8;
+
+	t = t1 - t2; t1 = t1 + t2; t2 = t;
+	t = ((t4 + t3 * 2 + 2) >> 2) + t4; t3 = ((t4 * 2 - t3 + 2) >> 2) - t3; t4 = t;
+	t = t5 - t6; t5 = t5 + t6; t6 = t;
+	t = ((t8 + t7 * 2 + 2) >> 2) + t8; t7 = ((t8 * 2 - t7 + 2) >> 2) - t7; t8 = t;
+
+	d[0] = t1 + t4; d[3] = t1 - t4;
+	d[1] = t2 + t3; d[2] = t2 - t3;
+	d[4] = t5 + t8; d[7] = t5 - t8;
+	d[5] = t6 + t7; d[6] = t6 - t7;
+}
+
+/** The inverse 8-point Haar transform, with s and d in natural order. */
+static inline void inverseHaar8(int32 *d, const int32 *s) {
+	int32 t, t1, t2, t3, t4, t5, t6, t7, t8;
+
+	t1 = s[0] << 1; t5 = s[1] << 1;
+	t = (t1 - t5) >> 1;   t1 = (t1 + t5) >> 1;   t5 = t;
+	t3 = (t1 - s[2]) >> 1; t1 = (t1 + s[2]) >> 1;
+	t7 = (t5 - s[3]) >> 1; t5 = (t5 + s[3]) >> 1;
+	t2 = (t1 - s[4]) >> 1; t1 = (t1 + s[4]) >> 1;
+	t4 = (t3 - s[5]) >> 1; t3 = (t3 + s[5]) >> 1;
+	t6 = (t5 - s[6]) >> 1; t5 = (t5 + s[6]) >> 1;
+	t8 = (t7 - s[7]) >> 1; t7 = (t7 + s[7]) >> 1;
+
+	d[0] = t1; d[1] = t2; d[2] = t3; d[3] = t4;
+	d[4] = t5; d[5] = t6; d[6] = t7; d[7] = t8;
+}
+
+static void inverseSlant8x8Generic(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	int32 tmp[64], s[8], d[8];
+
+	for (int i = 0; i < 8; i++) {
+		if (flags[i]) {
+			for (int k = 0; k < 8; k++)
+				s[k] = in[k * 8 + i];
+			inverseSlant8(d, s);
+			for (int k = 0; k < 8; k++)
+				tmp[k * 8 + i] = d[k];
+		} else {
+			for (int k = 0; k < 8; k++)
+				tmp[k * 8 + i] = 0;
+		}
+	}
+
+	const int32 *src = tmp;
+	for (int i = 0; i < 8; i++, src += 8, out += pitch) {
+		if (!src[0] && !src[1] && !src[2] && !src[3] && !src[4] && !src[5] && !src[6] && !src[7]) {
+			memset(out, 0, 8 * sizeof(out[0]));
+		} else {
+			inverseSlant8(d, src);
+			for (int k = 0; k < 8; k++)
+				out[k] = (d[k] + 1) >> 1;
+		}
+	}
+}
+
+static void inverseHaar8x8Generic(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	int32 tmp[64], s[8], d[8];
+
+	for (int i = 0; i < 8; i++) {
+		if (flags[i]) {
+			// pre-scaling of the first four columns
+			const int shift = !(i & 4);
+			for (int k = 0; k < 8; k++)
+				s[k] = (k < 4) ? in[k * 8 + i] << shift : in[k * 8 + i];
+			inverseHaar8(d, s);
+			for (int k = 0; k < 8; k++)
+				tmp[k * 8 + i] = d[k];
+		} else {
+			for (int k = 0; k < 8; k++)
+				tmp[k * 8 + i] = 0;
+		}
+	}
+
+	const int32 *src = tmp;
+	for (int i = 0; i < 8; i++, src += 8, out += pitch) {
+		if (!src[0] && !src[1] && !src[2] && !src[3] && !src[4] && !src[5] && !src[6] && !src[7]) {
+			memset(out, 0, 8 * sizeof(out[0]));
+		} else {
+			inverseHaar8(d, src);
+			for (int k = 0; k < 8; k++)
+				out[k] = d[k];
+		}
+	}
+}
+
+static void clipRowGeneric(byte *dst, const int16 *src, uint32 width) {
+	for (uint32 x = 0; x < width; x++)
+		dst[x] = CLIP<int>(src[x] + 128, 0, 255);
+}
+
+const CodecDSP::Funcs CodecDSP::funcsGeneric = {
+	{
+		putPixels8Generic,
+		putPixels8X2Generic,
+		putPixels8Y2Generic,
+		putPixels8XY2Generic
+	},
+	{
+		putPixels16Generic<putPixels8Generic>,
+		putPixels16Generic<putPixels8X2Generic>,
+		putPixels16Generic<putPixels8Y2Generic>,
+		putPixels16Generic<putPixels8XY2Generic>
+	},
+	mc8x8Generic<false>,
+	mc8x8Generic<true>,
+	mcAvg8x8Generic<false>,
+	mcAvg8x8Generic<true>,
+	inverseSlant8x8Generic,
+	inverseHaar8x8Generic,
+	clipRowGeneric
+};
+
+const CodecDSP::Funcs *CodecDSP::selectedFuncs = nullptr;
+
+const CodecDSP::Funcs &CodecDSP::getFuncs() {
+	if (!selectedFuncs) {
+		selectedFuncs = &funcsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			selectedFuncs = &funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			selectedFuncs = &funcsSSE2;
+#endif
+	}
+
+	return *selectedFuncs;
+}
+
+} // End of namespace Image
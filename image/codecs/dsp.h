@@ -0,0 +1,99 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IMAGE_CODECS_DSP_H
+#define IMAGE_CODECS_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Image {
+
+/**
+ * Block kernels shared by the video codecs, with SIMD variants selected
+ * at runtime.
+ *
+ * All variants produce exactly the same output as the generic ones, which
+ * are the loops the codecs used before.
+ */
+class CodecDSP {
+public:
+	/** The half-pel positions of motion compensation. */
+	enum HalfPel {
+		kHalfPelNone = 0,
+		kHalfPelX    = 1,
+		kHalfPelY    = 2,
+		kHalfPelXY   = 3
+	};
+
+	struct Funcs {
+		/**
+		 * Copy an 8 pixel wide block at a half-pel position, rounding the
+		 * averages up, like SVQ1. The height must be even.
+		 */
+		void (*putPixels8[4])(byte *dst, const byte *src, int pitch, int h);
+		/** Copy a 16 pixel wide block at a half-pel position, see putPixels8. */
+		void (*putPixels16[4])(byte *dst, const byte *src, int pitch, int h);
+
+		/**
+		 * Write an 8x8 block of 16 bit samples at a half-pel position,
+		 * rounding the averages down, like Indeo 4 and 5.
+		 */
+		void (*mcPut8x8)(int16 *dst, uint32 dstPitch, const int16 *ref, uint32 pitch, int mcType);
+		/** Add an 8x8 block of 16 bit samples at a half-pel position, see mcPut8x8. */
+		void (*mcAdd8x8)(int16 *dst, uint32 dstPitch, const int16 *ref, uint32 pitch, int mcType);
+		/** Write the average of two 8x8 blocks of 16 bit samples at half-pel positions. */
+		void (*mcAvgPut8x8)(int16 *dst, const int16 *ref1, const int16 *ref2, uint32 pitch, int mcType1, int mcType2);
+		/** Add the average of two 8x8 blocks of 16 bit samples at half-pel positions. */
+		void (*mcAvgAdd8x8)(int16 *dst, const int16 *ref1, const int16 *ref2, uint32 pitch, int mcType1, int mcType2);
+
+		/**
+		 * The two dimensional inverse slant transform of Indeo 4 and 5, on
+		 * 8x8 blocks. The columns whose flag is 0 are empty.
+		 */
+		void (*inverseSlant8x8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+		/** The two dimensional inverse Haar transform of Indeo 4, on 8x8 blocks. */
+		void (*inverseHaar8x8)(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags);
+
+		/** Convert signed samples to pixels, adding 128 and clipping to [0, 255]. */
+		void (*clipRow)(byte *dst, const int16 *src, uint32 width);
+	};
+
+	/**
+	 * Return the kernels best suited for the CPU we are running on.
+	 * The selection is done on the first call.
+	 */
+	static const Funcs &getFuncs();
+
+	/** The kernels in use, nullptr until they have been selected. */
+	static const Funcs *selectedFuncs;
+
+	static const Funcs funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs funcsSSE2;
+#endif
+};
+
+} // End of namespace Image
+
+#endif
@@ -0,0 +1,335 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "common/util.h"
+
+#include "image/codecs/dsp.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Image {
+
+// SVQ1 half-pel motion compensation
+
+template<int kType>
+static void putPixels8NEON(byte *dst, const byte *src, int pitch, int h) {
+	uint8x8_t prev = vdup_n_u8(0), prevRight = vdup_n_u8(0);
+	if (kType == CodecDSP::kHalfPelXY) {
+		prev = vld1_u8(src);
+		prevRight = vld1_u8(src + 1);
+	}
+
+	for (int i = 0; i < h; i++, dst += pitch, src += pitch) {
+		const uint8x8_t cur = vld1_u8(src);
+		uint8x8_t result;
+
+		switch (kType) {
+		case CodecDSP::kHalfPelNone:
+			result = cur;
+			break;
+		case CodecDSP::kHalfPelX:
+			result = vrhadd_u8(cur, vld1_u8(src + 1));
+			break;
+		case CodecDSP::kHalfPelY:
+			result = vrhadd_u8(cur, vld1_u8(src + pitch));
+			break;
+		default: {
+			const uint8x8_t next = vld1_u8(src + pitch);
+			const uint8x8_t nextRight = vld1_u8(src + pitch + 1);
+			result = vrshrn_n_u16(vaddq_u16(vaddl_u8(prev, prevRight), vaddl_u8(next, nextRight)), 2);
+			prev = next;
+			prevRight = nextRight;
+			break;
+		}
+		}
+
+		vst1_u8(dst, result);
+	}
+}
+
+template<int kType>
+static void putPixels16NEON(byte *dst, const byte *src, int pitch, int h) {
+	putPixels8NEON<kType>(dst, src, pitch, h);
+	putPixels8NEON<kType>(dst + 8, src + 8, pitch, h);
+}
+
+// Indeo motion compensation
+
+/** Interpolate row i of a block. */
+static inline int16x8_t mcRowNEON(const int16 *ref, uint32 pitch, int mcType) {
+	const int16x8_t cur = vld1q_s16(ref);
+
+	switch (mcType) {
+	case CodecDSP::kHalfPelX:
+		return vhaddq_s16(cur, vld1q_s16(ref + 1));
+	case CodecDSP::kHalfPelY:
+		return vhaddq_s16(cur, vld1q_s16(ref + pitch));
+	case CodecDSP::kHalfPelXY: {
+		const int16x8_t right = vld1q_s16(ref + 1);
+		const int16x8_t next = vld1q_s16(ref + pitch);
+		const int16x8_t nextRight = vld1q_s16(ref + pitch + 1);
+		const int32x4_t lo = vaddq_s32(vaddl_s16(vget_low_s16(cur), vget_low_s16(right)), vaddl_s16(vget_low_s16(next), vget_low_s16(nextRight)));
+		const int32x4_t hi = vaddq_s32(vaddl_s16(vget_high_s16(cur), vget_high_s16(right)), vaddl_s16(vget_high_s16(next), vget_high_s16(nextRight)));
+		return vcombine_s16(vshrn_n_s32(lo, 2), vshrn_n_s32(hi, 2));
+	}
+	default:
+		return cur;
+	}
+}
+
+template<bool kAdd>
+static void mc8x8NEON(int16 *buf, uint32 dpitch, const int16 *refBuf, uint32 pitch, int mcType) {
+	if (mcType < CodecDSP::kHalfPelNone || mcType > CodecDSP::kHalfPelXY)
+		return;
+
+	for (int i = 0; i < 8; i++, buf += dpitch, refBuf += pitch) {
+		int16x8_t value = mcRowNEON(refBuf, pitch, mcType);
+		if (kAdd)
+			value = vaddq_s16(vld1q_s16(buf), value);
+		vst1q_s16(buf, value);
+	}
+}
+
+template<bool kAdd>
+static void mcAvg8x8NEON(int16 *buf, const int16 *refBuf, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2) {
+	if (mcType < CodecDSP::kHalfPelNone || mcType > CodecDSP::kHalfPelXY ||
+			mcType2 < CodecDSP::kHalfPelNone || mcType2 > CodecDSP::kHalfPelXY) {
+		const CodecDSP::Funcs &generic = CodecDSP::funcsGeneric;
+		(kAdd ? generic.mcAvgAdd8x8 : generic.mcAvgPut8x8)(buf, refBuf, refBuf2, pitch, mcType, mcType2);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++, buf += pitch, refBuf += pitch, refBuf2 += pitch) {
+		int16x8_t value = vshrq_n_s16(vaddq_s16(mcRowNEON(refBuf, pitch, mcType), mcRowNEON(refBuf2, pitch, mcType2)), 1);
+		if (kAdd)
+			value = vaddq_s16(vld1q_s16(buf), value);
+		vst1q_s16(buf, value);
+	}
+}
+
+// Indeo inverse transforms, on four columns or rows at once
+
+static inline void transposeNEON(int32x4_t *d0, int32x4_t *d1, int32x4_t *d2, int32x4_t *d3, int32x4_t s0, int32x4_t s1, int32x4_t s2, int32x4_t s3) {
+	const int32x4x2_t t0 = vtrnq_s32(s0, s1);
+	const int32x4x2_t t1 = vtrnq_s32(s2, s3);
+	*d0 = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+	*d1 = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+	*d2 = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+	*d3 = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+/** ((a + b * 2 + 2) >> 2) + a and ((a * 2 - b + 2) >> 2) - b. */
+static inline void reflectNEON(int32x4_t *a, int32x4_t *b) {
+	const int32x4_t two = vdupq_n_s32(2);
+	const int32x4_t t = vaddq_s32(vshrq_n_s32(vaddq_s32(vaddq_s32(*a, vshlq_n_s32(*b, 1)), two), 2), *a);
+	*b = vsubq_s32(vshrq_n_s32(vaddq_s32(vsubq_s32(vshlq_n_s32(*a, 1), *b), two), 2), *b);
+	*a = t;
+}
+
+static inline void inverseSlant8NEON(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t four = vdupq_n_s32(4);
+	const int32x4_t s1 = s[0], s4 = s[1], s8 = s[2], s5 = s[3];
+	const int32x4_t s2 = s[4], s6 = s[5], s3 = s[6], s7 = s[7];
+	int32x4_t t1, t2, t3, t4, t5, t6, t7, t8;
+
+	t4 = vaddq_s32(s5, vshrq_n_s32(vaddq_s32(vsubq_s32(vshlq_n_s32(s4, 2), s5), four), 3));
+	t5 = vaddq_s32(s4, vshrq_n_s32(vsubq_s32(vsubq_s32(four, s4), vshlq_n_s32(s5, 2)), 3));
+
+	t1 = vaddq_s32(s1, t5); t5 = vsubq_s32(s1, t5);
+	t2 = vaddq_s32(s2, s6); t6 = vsubq_s32(s2, s6);
+	t7 = vaddq_s32(s7, s3); t3 = vsubq_s32(s7, s3);
+	t8 = vsubq_s32(t4, s8); t4 = vaddq_s32(t4, s8);
+
+	const int32x4_t t12 = vsubq_s32(t1, t2); t1 = vaddq_s32(t1, t2); t2 = t12;
+	reflectNEON(&t4, &t3);
+	const int32x4_t t56 = vsubq_s32(t5, t6); t5 = vaddq_s32(t5, t6); t6 = t56;
+	reflectNEON(&t8, &t7);
+
+	d[0] = vaddq_s32(t1, t4); d[3] = vsubq_s32(t1, t4);
+	d[1] = vaddq_s32(t2, t3); d[2] = vsubq_s32(t2, t3);
+	d[4] = vaddq_s32(t5, t8); d[7] = vsubq_s32(t5, t8);
+	d[5] = vaddq_s32(t6, t7); d[6] = vsubq_s32(t6, t7);
+}
+
+/** (a + b) >> 1 and (a - b) >> 1. */
+static inline void haarButterflyNEON(int32x4_t *a, int32x4_t *b, int32x4_t s) {
+	*b = vshrq_n_s32(vsubq_s32(*a, s), 1);
+	*a = vshrq_n_s32(vaddq_s32(*a, s), 1);
+}
+
+static inline void inverseHaar8NEON(int32x4_t *d, const int32x4_t *s) {
+	int32x4_t t1 = vshlq_n_s32(s[0], 1), t5 = vshlq_n_s32(s[1], 1);
+	int32x4_t t2, t3, t4, t6, t7, t8;
+
+	const int32x4_t t = vshrq_n_s32(vsubq_s32(t1, t5), 1);
+	t1 = vshrq_n_s32(vaddq_s32(t1, t5), 1);
+	t5 = t;
+	haarButterflyNEON(&t1, &t3, s[2]);
+	haarButterflyNEON(&t5, &t7, s[3]);
+	haarButterflyNEON(&t1, &t2, s[4]);
+	haarButterflyNEON(&t3, &t4, s[5]);
+	haarButterflyNEON(&t5, &t6, s[6]);
+	haarButterflyNEON(&t7, &t8, s[7]);
+
+	d[0] = t1; d[1] = t2; d[2] = t3; d[3] = t4;
+	d[4] = t5; d[5] = t6; d[6] = t7; d[7] = t8;
+}
+
+/**
+ * A two dimensional transform of an 8x8 block. The vectors of rows hold
+ * four values, rows[2 * i + h] being columns [4 * h, 4 * h + 4) of row i.
+ */
+template<bool kSlant>
+static inline void inverseTransform8x8NEON(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	int32x4_t rows[16], cols[16], src[8], dst[8];
+
+	// The columns, with the empty ones cleared
+	for (int h = 0; h < 2; h++) {
+		const uint32 nonEmpty[4] = {
+			flags[4 * h + 0] ? 0xFFFFFFFFU : 0, flags[4 * h + 1] ? 0xFFFFFFFFU : 0,
+			flags[4 * h + 2] ? 0xFFFFFFFFU : 0, flags[4 * h + 3] ? 0xFFFFFFFFU : 0
+		};
+		const int32x4_t mask = vreinterpretq_s32_u32(vld1q_u32(nonEmpty));
+
+		for (int k = 0; k < 8; k++)
+			src[k] = vld1q_s32(in + 8 * k + 4 * h);
+
+		if (kSlant) {
+			inverseSlant8NEON(dst, src);
+		} else {
+			// The first four columns are pre-scaled
+			if (h == 0) {
+				for (int k = 0; k < 4; k++)
+					src[k] = vshlq_n_s32(src[k], 1);
+			}
+			inverseHaar8NEON(dst, src);
+		}
+
+		for (int k = 0; k < 8; k++)
+			rows[2 * k + h] = vandq_s32(dst[k], mask);
+	}
+
+	// cols[2 * j + h] are rows [4 * h, 4 * h + 4) of column j
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeNEON(&cols[2 * (4 * q + 0) + h], &cols[2 * (4 * q + 1) + h], &cols[2 * (4 * q + 2) + h], &cols[2 * (4 * q + 3) + h],
+			              rows[2 * (4 * h + 0) + q], rows[2 * (4 * h + 1) + q], rows[2 * (4 * h + 2) + q], rows[2 * (4 * h + 3) + q]);
+		}
+	}
+
+	// The rows. Rows of zeroes stay zeroes, so they need no special case.
+	for (int h = 0; h < 2; h++) {
+		for (int j = 0; j < 8; j++)
+			src[j] = cols[2 * j + h];
+
+		if (kSlant) {
+			inverseSlant8NEON(dst, src);
+			for (int j = 0; j < 8; j++)
+				dst[j] = vshrq_n_s32(vaddq_s32(dst[j], vdupq_n_s32(1)), 1);
+		} else {
+			inverseHaar8NEON(dst, src);
+		}
+
+		for (int j = 0; j < 8; j++)
+			cols[2 * j + h] = dst[j];
+	}
+
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeNEON(&rows[2 * (4 * h + 0) + q], &rows[2 * (4 * h + 1) + q], &rows[2 * (4 * h + 2) + q], &rows[2 * (4 * h + 3) + q],
+			              cols[2 * (4 * q + 0) + h], cols[2 * (4 * q + 1) + h], cols[2 * (4 * q + 2) + h], cols[2 * (4 * q + 3) + h]);
+		}
+	}
+
+	// The narrowing moves keep the low 16 bits, like the conversion to int16
+	for (int i = 0; i < 8; i++, out += pitch)
+		vst1q_s16(out, vcombine_s16(vmovn_s32(rows[2 * i]), vmovn_s32(rows[2 * i + 1])));
+}
+
+static void inverseSlant8x8NEON(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	inverseTransform8x8NEON<true>(in, out, pitch, flags);
+}
+
+static void inverseHaar8x8NEON(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	inverseTransform8x8NEON<false>(in, out, pitch, flags);
+}
+
+static void clipRowNEON(byte *dst, const int16 *src, uint32 width) {
+	const int16x8_t bias = vdupq_n_s16(128);
+
+	uint32 x = 0;
+	for (; x + 8 <= width; x += 8)
+		vst1_u8(dst + x, vqmovun_s16(vqaddq_s16(vld1q_s16(src + x), bias)));
+
+	for (; x < width; x++)
+		dst[x] = CLIP<int>(src[x] + 128, 0, 255);
+}
+
+const CodecDSP::Funcs CodecDSP::funcsNEON = {
+	{
+		putPixels8NEON<kHalfPelNone>,
+		putPixels8NEON<kHalfPelX>,
+		putPixels8NEON<kHalfPelY>,
+		putPixels8NEON<kHalfPelXY>
+	},
+	{
+		putPixels16NEON<kHalfPelNone>,
+		putPixels16NEON<kHalfPelX>,
+		putPixels16NEON<kHalfPelY>,
+		putPixels16NEON<kHalfPelXY>
+	},
+	mc8x8NEON<false>,
+	mc8x8NEON<true>,
+	mcAvg8x8NEON<false>,
+	mcAvg8x8NEON<true>,
+	inverseSlant8x8NEON,
+	inverseHaar8x8NEON,
+	clipRowNEON
+};
+
+} // End of namespace Image
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,376 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+#include "image/codecs/dsp.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Image {
+
+// SVQ1 half-pel motion compensation
+
+template<int kWidth>
+static FORCEINLINE __m128i loadPixelsSSE2(const byte *src) {
+	if (kWidth == 8)
+		return _mm_loadl_epi64((const __m128i *)src);
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+template<int kWidth>
+static FORCEINLINE void storePixelsSSE2(byte *dst, __m128i pixels) {
+	if (kWidth == 8)
+		_mm_storel_epi64((__m128i *)dst, pixels);
+	else
+		_mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+/** (a + b + c + d + 2) >> 2 on the low eight pixels. */
+static FORCEINLINE __m128i avg4LoSSE2(__m128i a, __m128i b, __m128i c, __m128i d) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+	                                  _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+template<int kWidth, int kType>
+static void putPixelsSSE2(byte *dst, const byte *src, int pitch, int h) {
+	__m128i prev = _mm_setzero_si128(), prevRight = _mm_setzero_si128();
+	if (kType == CodecDSP::kHalfPelXY) {
+		prev = loadPixelsSSE2<kWidth>(src);
+		prevRight = loadPixelsSSE2<kWidth>(src + 1);
+	}
+
+	for (int i = 0; i < h; i++, dst += pitch, src += pitch) {
+		const __m128i cur = loadPixelsSSE2<kWidth>(src);
+		__m128i result;
+
+		switch (kType) {
+		case CodecDSP::kHalfPelNone:
+			result = cur;
+			break;
+		case CodecDSP::kHalfPelX:
+			result = _mm_avg_epu8(cur, loadPixelsSSE2<kWidth>(src + 1));
+			break;
+		case CodecDSP::kHalfPelY:
+			result = _mm_avg_epu8(cur, loadPixelsSSE2<kWidth>(src + pitch));
+			break;
+		default: {
+			const __m128i next = loadPixelsSSE2<kWidth>(src + pitch);
+			const __m128i nextRight = loadPixelsSSE2<kWidth>(src + pitch + 1);
+			result = avg4LoSSE2(prev, prevRight, next, nextRight);
+			if (kWidth == 16)
+				result = _mm_packus_epi16(result, avg4LoSSE2(_mm_unpackhi_epi64(prev, prev), _mm_unpackhi_epi64(prevRight, prevRight),
+				                                             _mm_unpackhi_epi64(next, next), _mm_unpackhi_epi64(nextRight, nextRight)));
+			else
+				result = _mm_packus_epi16(result, result);
+			prev = next;
+			prevRight = nextRight;
+			break;
+		}
+		}
+
+		storePixelsSSE2<kWidth>(dst, result);
+	}
+}
+
+// Indeo motion compensation
+
+/** (a + b) >> 1, without overflowing. */
+static FORCEINLINE __m128i avg2SSE2(__m128i a, __m128i b) {
+	const __m128i carry = _mm_and_si128(_mm_and_si128(a, b), _mm_set1_epi16(1));
+	return _mm_add_epi16(_mm_add_epi16(_mm_srai_epi16(a, 1), _mm_srai_epi16(b, 1)), carry);
+}
+
+static FORCEINLINE __m128i widenLoSSE2(__m128i a) {
+	return _mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16);
+}
+
+static FORCEINLINE __m128i widenHiSSE2(__m128i a) {
+	return _mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16);
+}
+
+/** (a + b + c + d) >> 2, computed with 32 bits. */
+static FORCEINLINE __m128i avg4SSE2(__m128i a, __m128i b, __m128i c, __m128i d) {
+	const __m128i lo = _mm_add_epi32(_mm_add_epi32(widenLoSSE2(a), widenLoSSE2(b)), _mm_add_epi32(widenLoSSE2(c), widenLoSSE2(d)));
+	const __m128i hi = _mm_add_epi32(_mm_add_epi32(widenHiSSE2(a), widenHiSSE2(b)), _mm_add_epi32(widenHiSSE2(c), widenHiSSE2(d)));
+	return _mm_packs_epi32(_mm_srai_epi32(lo, 2), _mm_srai_epi32(hi, 2));
+}
+
+/** Interpolate row i of a block. */
+static FORCEINLINE __m128i mcRowSSE2(const int16 *ref, uint32 pitch, int mcType) {
+	const __m128i cur = _mm_loadu_si128((const __m128i *)ref);
+
+	switch (mcType) {
+	case CodecDSP::kHalfPelX:
+		return avg2SSE2(cur, _mm_loadu_si128((const __m128i *)(ref + 1)));
+	case CodecDSP::kHalfPelY:
+		return avg2SSE2(cur, _mm_loadu_si128((const __m128i *)(ref + pitch)));
+	case CodecDSP::kHalfPelXY:
+		return avg4SSE2(cur, _mm_loadu_si128((const __m128i *)(ref + 1)),
+		                _mm_loadu_si128((const __m128i *)(ref + pitch)), _mm_loadu_si128((const __m128i *)(ref + pitch + 1)));
+	default:
+		return cur;
+	}
+}
+
+template<bool kAdd>
+static void mc8x8SSE2(int16 *buf, uint32 dpitch, const int16 *refBuf, uint32 pitch, int mcType) {
+	if (mcType < CodecDSP::kHalfPelNone || mcType > CodecDSP::kHalfPelXY)
+		return;
+
+	for (int i = 0; i < 8; i++, buf += dpitch, refBuf += pitch) {
+		__m128i value = mcRowSSE2(refBuf, pitch, mcType);
+		if (kAdd)
+			value = _mm_add_epi16(_mm_loadu_si128((const __m128i *)buf), value);
+		_mm_storeu_si128((__m128i *)buf, value);
+	}
+}
+
+template<bool kAdd>
+static void mcAvg8x8SSE2(int16 *buf, const int16 *refBuf, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2) {
+	if (mcType < CodecDSP::kHalfPelNone || mcType > CodecDSP::kHalfPelXY ||
+			mcType2 < CodecDSP::kHalfPelNone || mcType2 > CodecDSP::kHalfPelXY) {
+		const CodecDSP::Funcs &generic = CodecDSP::funcsGeneric;
+		(kAdd ? generic.mcAvgAdd8x8 : generic.mcAvgPut8x8)(buf, refBuf, refBuf2, pitch, mcType, mcType2);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++, buf += pitch, refBuf += pitch, refBuf2 += pitch) {
+		__m128i value = _mm_srai_epi16(_mm_add_epi16(mcRowSSE2(refBuf, pitch, mcType), mcRowSSE2(refBuf2, pitch, mcType2)), 1);
+		if (kAdd)
+			value = _mm_add_epi16(_mm_loadu_si128((const __m128i *)buf), value);
+		_mm_storeu_si128((__m128i *)buf, value);
+	}
+}
+
+// Indeo inverse transforms, on four columns or rows at once
+
+static FORCEINLINE void transposeSSE2(__m128i *d0, __m128i *d1, __m128i *d2, __m128i *d3, __m128i s0, __m128i s1, __m128i s2, __m128i s3) {
+	const __m128i t0 = _mm_unpacklo_epi32(s0, s1);
+	const __m128i t1 = _mm_unpacklo_epi32(s2, s3);
+	const __m128i t2 = _mm_unpackhi_epi32(s0, s1);
+	const __m128i t3 = _mm_unpackhi_epi32(s2, s3);
+	*d0 = _mm_unpacklo_epi64(t0, t1);
+	*d1 = _mm_unpackhi_epi64(t0, t1);
+	*d2 = _mm_unpacklo_epi64(t2, t3);
+	*d3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/** ((a + b * 2 + 2) >> 2) + a and ((a * 2 - b + 2) >> 2) - b. */
+static FORCEINLINE void reflectSSE2(__m128i *a, __m128i *b) {
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128i t = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(*a, _mm_slli_epi32(*b, 1)), two), 2), *a);
+	*b = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(*a, 1), *b), two), 2), *b);
+	*a = t;
+}
+
+static FORCEINLINE void inverseSlant8SSE2(__m128i *d, const __m128i *s) {
+	const __m128i four = _mm_set1_epi32(4);
+	const __m128i s1 = s[0], s4 = s[1], s8 = s[2], s5 = s[3];
+	const __m128i s2 = s[4], s6 = s[5], s3 = s[6], s7 = s[7];
+	__m128i t1, t2, t3, t4, t5, t6, t7, t8;
+
+	t4 = _mm_add_epi32(s5, _mm_srai_epi32(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(s4, 2), s5), four), 3));
+	t5 = _mm_add_epi32(s4, _mm_srai_epi32(_mm_sub_epi32(_mm_sub_epi32(four, s4), _mm_slli_epi32(s5, 2)), 3));
+
+	t1 = _mm_add_epi32(s1, t5); t5 = _mm_sub_epi32(s1, t5);
+	t2 = _mm_add_epi32(s2, s6); t6 = _mm_sub_epi32(s2, s6);
+	t7 = _mm_add_epi32(s7, s3); t3 = _mm_sub_epi32(s7, s3);
+	t8 = _mm_sub_epi32(t4, s8); t4 = _mm_add_epi32(t4, s8);
+
+	const __m128i t12 = _mm_sub_epi32(t1, t2); t1 = _mm_add_epi32(t1, t2); t2 = t12;
+	reflectSSE2(&t4, &t3);
+	const __m128i t56 = _mm_sub_epi32(t5, t6); t5 = _mm_add_epi32(t5, t6); t6 = t56;
+	reflectSSE2(&t8, &t7);
+
+	d[0] = _mm_add_epi32(t1, t4); d[3] = _mm_sub_epi32(t1, t4);
+	d[1] = _mm_add_epi32(t2, t3); d[2] = _mm_sub_epi32(t2, t3);
+	d[4] = _mm_add_epi32(t5, t8); d[7] = _mm_sub_epi32(t5, t8);
+	d[5] = _mm_add_epi32(t6, t7); d[6] = _mm_sub_epi32(t6, t7);
+}
+
+/** (a + b) >> 1 and (a - b) >> 1. */
+static FORCEINLINE void haarButterflySSE2(__m128i *a, __m128i *b, __m128i s) {
+	*b = _mm_srai_epi32(_mm_sub_epi32(*a, s), 1);
+	*a = _mm_srai_epi32(_mm_add_epi32(*a, s), 1);
+}
+
+static FORCEINLINE void inverseHaar8SSE2(__m128i *d, const __m128i *s) {
+	__m128i t1 = _mm_slli_epi32(s[0], 1), t5 = _mm_slli_epi32(s[1], 1);
+	__m128i t2, t3, t4, t6, t7, t8;
+
+	const __m128i t = _mm_srai_epi32(_mm_sub_epi32(t1, t5), 1);
+	t1 = _mm_srai_epi32(_mm_add_epi32(t1, t5), 1);
+	t5 = t;
+	haarButterflySSE2(&t1, &t3, s[2]);
+	haarButterflySSE2(&t5, &t7, s[3]);
+	haarButterflySSE2(&t1, &t2, s[4]);
+	haarButterflySSE2(&t3, &t4, s[5]);
+	haarButterflySSE2(&t5, &t6, s[6]);
+	haarButterflySSE2(&t7, &t8, s[7]);
+
+	d[0] = t1; d[1] = t2; d[2] = t3; d[3] = t4;
+	d[4] = t5; d[5] = t6; d[6] = t7; d[7] = t8;
+}
+
+/**
+ * A two dimensional transform of an 8x8 block. The vectors of rows hold
+ * four values, rows[2 * i + h] being columns [4 * h, 4 * h + 4) of row i.
+ */
+template<bool kSlant>
+static FORCEINLINE void inverseTransform8x8SSE2(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	__m128i rows[16], cols[16], src[8], dst[8];
+
+	// The columns, with the empty ones cleared
+	for (int h = 0; h < 2; h++) {
+		uint32 columnFlags;
+		memcpy(&columnFlags, flags + 4 * h, 4);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i flagBytes = _mm_cvtsi32_si128(columnFlags);
+		const __m128i empty = _mm_cmpeq_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(flagBytes, zero), zero), zero);
+
+		for (int k = 0; k < 8; k++)
+			src[k] = _mm_loadu_si128((const __m128i *)(in + 8 * k + 4 * h));
+
+		if (kSlant) {
+			inverseSlant8SSE2(dst, src);
+		} else {
+			// The first four columns are pre-scaled
+			if (h == 0) {
+				for (int k = 0; k < 4; k++)
+					src[k] = _mm_slli_epi32(src[k], 1);
+			}
+			inverseHaar8SSE2(dst, src);
+		}
+
+		for (int k = 0; k < 8; k++)
+			rows[2 * k + h] = _mm_andnot_si128(empty, dst[k]);
+	}
+
+	// cols[2 * j + h] are rows [4 * h, 4 * h + 4) of column j
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeSSE2(&cols[2 * (4 * q + 0) + h], &cols[2 * (4 * q + 1) + h], &cols[2 * (4 * q + 2) + h], &cols[2 * (4 * q + 3) + h],
+			              rows[2 * (4 * h + 0) + q], rows[2 * (4 * h + 1) + q], rows[2 * (4 * h + 2) + q], rows[2 * (4 * h + 3) + q]);
+		}
+	}
+
+	// The rows. Rows of zeroes stay zeroes, so they need no special case.
+	for (int h = 0; h < 2; h++) {
+		for (int j = 0; j < 8; j++)
+			src[j] = cols[2 * j + h];
+
+		if (kSlant) {
+			inverseSlant8SSE2(dst, src);
+			for (int j = 0; j < 8; j++)
+				dst[j] = _mm_srai_epi32(_mm_add_epi32(dst[j], _mm_set1_epi32(1)), 1);
+		} else {
+			inverseHaar8SSE2(dst, src);
+		}
+
+		for (int j = 0; j < 8; j++)
+			cols[2 * j + h] = dst[j];
+	}
+
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeSSE2(&rows[2 * (4 * h + 0) + q], &rows[2 * (4 * h + 1) + q], &rows[2 * (4 * h + 2) + q], &rows[2 * (4 * h + 3) + q],
+			              cols[2 * (4 * q + 0) + h], cols[2 * (4 * q + 1) + h], cols[2 * (4 * q + 2) + h], cols[2 * (4 * q + 3) + h]);
+		}
+	}
+
+	// Keep the low 16 bits, like the conversion to int16
+	for (int i = 0; i < 8; i++, out += pitch) {
+		const __m128i lo = _mm_srai_epi32(_mm_slli_epi32(rows[2 * i], 16), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_slli_epi32(rows[2 * i + 1], 16), 16);
+		_mm_storeu_si128((__m128i *)out, _mm_packs_epi32(lo, hi));
+	}
+}
+
+static void inverseSlant8x8SSE2(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	inverseTransform8x8SSE2<true>(in, out, pitch, flags);
+}
+
+static void inverseHaar8x8SSE2(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	inverseTransform8x8SSE2<false>(in, out, pitch, flags);
+}
+
+static void clipRowSSE2(byte *dst, const int16 *src, uint32 width) {
+	const __m128i bias = _mm_set1_epi16(128);
+
+	uint32 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m128i lo = _mm_adds_epi16(_mm_loadu_si128((const __m128i *)(src + x)), bias);
+		const __m128i hi = _mm_adds_epi16(_mm_loadu_si128((const __m128i *)(src + x + 8)), bias);
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(lo, hi));
+	}
+
+	for (; x < width; x++)
+		dst[x] = CLIP<int>(src[x] + 128, 0, 255);
+}
+
+const CodecDSP::Funcs CodecDSP::funcsSSE2 = {
+	{
+		putPixelsSSE2<8, kHalfPelNone>,
+		putPixelsSSE2<8, kHalfPelX>,
+		putPixelsSSE2<8, kHalfPelY>,
+		putPixelsSSE2<8, kHalfPelXY>
+	},
+	{
+		putPixelsSSE2<16, kHalfPelNone>,
+		putPixelsSSE2<16, kHalfPelX>,
+		putPixelsSSE2<16, kHalfPelY>,
+		putPixelsSSE2<16, kHalfPelXY>
+	},
+	mc8x8SSE2<false>,
+	mc8x8SSE2<true>,
+	mcAvg8x8SSE2<false>,
+	mcAvg8x8SSE2<true>,
+	inverseSlant8x8SSE2,
+	inverseHaar8x8SSE2,
+	clipRowSSE2
+};
+
+} // End of namespace Image
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -20,6 +20,7 @@
  */
 
 #include "image/codecs/hnm.h"
+#include "image/codecs/bufferpool.h"
 
 #include "common/stream.h"
 #include "common/textconsole.h"
@@ -1338,17 +1339,17 @@ DecoderImpl::DecoderImpl(uint16 width, uint16 height, const Graphics::PixelForma
 	if (bufferSize < HEADER_SIZE) {
 		error("Invalid buffer size");
 	}
-	_buffer = new byte[bufferSize];
-	_surface.create(_width, _height, _format);
+	_buffer = (byte *)CodecBufferPoolMan.allocate(bufferSize);
+	CodecBufferPoolMan.createSurface(_surface, _width, _height, _format);
 	if (videoMode) {
-		_surfaceOld.create(_width, _height, _format);
+		CodecBufferPoolMan.createSurface(_surfaceOld, _width, _height, _format);
 	}
 }
 
 DecoderImpl::~DecoderImpl() {
-	delete [] _buffer;
-	_surface.free();
-	_surfaceOld.free();
+	CodecBufferPoolMan.release(_buffer);
+	CodecBufferPoolMan.freeSurface(_surface);
+	CodecBufferPoolMan.freeSurface(_surfaceOld);
 }
 
 const Graphics::Surface *DecoderImpl::decodeFrame(Common::SeekableReadStream &stream) {
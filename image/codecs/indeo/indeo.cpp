@@ -23,6 +23,7 @@
  * Indeo5 decoders, derived from ffmpeg.
  */
 
+#include "image/codecs/dsp.h"
 #include "image/codecs/indeo/indeo.h"
 #include "image/codecs/indeo/indeo_dsp.h"
 #include "image/codecs/indeo/mem.h"
@@ -916,9 +917,9 @@ void IndeoDecoderBase::outputPlane(IVIPlaneDesc *_plane, uint8 *dst, int dstPitc
 	if (!src)
 		return;
 
+	const CodecDSP::Funcs &dsp = CodecDSP::getFuncs();
 	for (int y = 0; y < _plane->_height; y++) {
-		for (int x = 0; x < _plane->_width; x++)
-			dst[x] = avClipUint8(src[x] + 128);
+		dsp.clipRow(dst, src, _plane->_width);
 		src += pitch;
 		dst += dstPitch;
 	}
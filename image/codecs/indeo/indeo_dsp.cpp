@@ -25,6 +25,7 @@
  * written, produced, and directed by Alan Smithee
  */
 
+#include "image/codecs/dsp.h"
 #include "image/codecs/indeo/indeo_dsp.h"
 
 namespace Image {
@@ -72,54 +73,7 @@ namespace Indeo {
 
 void IndeoDSP::ffIviInverseHaar8x8(const int32 *in, int16 *out, uint32 pitch,
 							 const uint8 *flags) {
-	int32 tmp[64];
-	int t0, t1, t2, t3, t4, t5, t6, t7, t8;
-
-	// apply the InvHaar8 to all columns
-#define COMPENSATE(x) (x)
-	const int32 *src = in;
-	int32 *dst = tmp;
-	for (int i = 0; i < 8; i++) {
-		if (flags[i]) {
-			// pre-scaling
-			int shift = !(i & 4);
-			int sp1 = src[ 0] << shift;
-			int sp2 = src[ 8] << shift;
-			int sp3 = src[16] << shift;
-			int sp4 = src[24] << shift;
-			INV_HAAR8(    sp1,     sp2,     sp3,     sp4,
-					  src[32], src[40], src[48], src[56],
-					  dst[ 0], dst[ 8], dst[16], dst[24],
-					  dst[32], dst[40], dst[48], dst[56],
-					  t0, t1, t2, t3, t4, t5, t6, t7, t8);
-		} else {
-			dst[ 0] = dst[ 8] = dst[16] = dst[24] =
-			dst[32] = dst[40] = dst[48] = dst[56] = 0;
-		}
-
-		src++;
-		dst++;
-	}
-#undef  COMPENSATE
-
-	// apply the InvHaar8 to all rows
-#define COMPENSATE(x) (x)
-	src = tmp;
-	for (int i = 0; i < 8; i++) {
-		if (!src[0] && !src[1] && !src[2] && !src[3] &&
-				!src[4] && !src[5] && !src[6] && !src[7]) {
-			memset(out, 0, 8 * sizeof(out[0]));
-		} else {
-			INV_HAAR8(src[0], src[1], src[2], src[3],
-					  src[4], src[5], src[6], src[7],
-					  out[0], out[1], out[2], out[3],
-					  out[4], out[5], out[6], out[7],
-					  t0, t1, t2, t3, t4, t5, t6, t7, t8);
-		}
-		src += 8;
-		out += pitch;
-	}
-#undef  COMPENSATE
+	CodecDSP::getFuncs().inverseHaar8x8(in, out, pitch, flags);
 }
 
 void IndeoDSP::ffIviRowHaar8(const int32 *in, int16 *out, uint32 pitch,
@@ -321,40 +275,7 @@ void IndeoDSP::ffIviDcHaar2d(const int32 *in, int16 *out, uint32 pitch,
 	d4 = COMPENSATE(t4);}
 
 void IndeoDSP::ffIviInverseSlant8x8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
-	int32 tmp[64];
-	int t0, t1, t2, t3, t4, t5, t6, t7, t8;
-
-#define COMPENSATE(x) (x)
-	const int32 *src = in;
-	int32 *dst = tmp;
-	for (int i = 0; i < 8; i++) {
-		if (flags[i]) {
-			IVI_INV_SLANT8(src[0], src[8], src[16], src[24], src[32], src[40], src[48], src[56],
-						   dst[0], dst[8], dst[16], dst[24], dst[32], dst[40], dst[48], dst[56],
-						   t0, t1, t2, t3, t4, t5, t6, t7, t8);
-		} else {
-			dst[0] = dst[8] = dst[16] = dst[24] = dst[32] = dst[40] = dst[48] = dst[56] = 0;
-		}
-
-		src++;
-		dst++;
-	}
-#undef COMPENSATE
-
-#define COMPENSATE(x) (((x) + 1)>>1)
-	src = tmp;
-	for (int i = 0; i < 8; i++) {
-		if (!src[0] && !src[1] && !src[2] && !src[3] && !src[4] && !src[5] && !src[6] && !src[7]) {
-			memset(out, 0, 8*sizeof(out[0]));
-		} else {
-			IVI_INV_SLANT8(src[0], src[1], src[2], src[3], src[4], src[5], src[6], src[7],
-						   out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7],
-						   t0, t1, t2, t3, t4, t5, t6, t7, t8);
-		}
-		src += 8;
-		out += pitch;
-	}
-#undef COMPENSATE
+	CodecDSP::getFuncs().inverseSlant8x8(in, out, pitch, flags);
 }
 
 void IndeoDSP::ffIviInverseSlant4x4(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
@@ -594,14 +515,28 @@ void IndeoDSP::ffIviMcAvg ## size ##x## size ## suffix(int16 *buf, \
 #define OP_PUT(a, b)  (a) = (b)
 #define OP_ADD(a, b)  (a) += (b)
 
-IVI_MC_TEMPLATE(8, NoDelta, OP_PUT)
-IVI_MC_TEMPLATE(8, Delta,   OP_ADD)
 IVI_MC_TEMPLATE(4, NoDelta, OP_PUT)
 IVI_MC_TEMPLATE(4, Delta,   OP_ADD)
-IVI_MC_AVG_TEMPLATE(8, NoDelta, OP_PUT)
-IVI_MC_AVG_TEMPLATE(8, Delta,   OP_ADD)
 IVI_MC_AVG_TEMPLATE(4, NoDelta, OP_PUT)
 IVI_MC_AVG_TEMPLATE(4, Delta,   OP_ADD)
 
+void IndeoDSP::ffIviMc8x8NoDelta(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType) {
+	CodecDSP::getFuncs().mcPut8x8(buf, pitch, refBuf, pitch, mcType);
+}
+
+void IndeoDSP::ffIviMc8x8Delta(int16 *buf, const int16 *refBuf, uint32 pitch, int mcType) {
+	CodecDSP::getFuncs().mcAdd8x8(buf, pitch, refBuf, pitch, mcType);
+}
+
+void IndeoDSP::ffIviMcAvg8x8NoDelta(int16 *buf, const int16 *refBuf, const int16 *refBuf2,
+		uint32 pitch, int mcType, int mcType2) {
+	CodecDSP::getFuncs().mcAvgPut8x8(buf, refBuf, refBuf2, pitch, mcType, mcType2);
+}
+
+void IndeoDSP::ffIviMcAvg8x8Delta(int16 *buf, const int16 *refBuf, const int16 *refBuf2,
+		uint32 pitch, int mcType, int mcType2) {
+	CodecDSP::getFuncs().mcAvgAdd8x8(buf, refBuf, refBuf2, pitch, mcType, mcType2);
+}
+
 } // End of namespace Indeo
 } // End of namespace Image
@@ -22,6 +22,7 @@
  // Based off ffmpeg's msvideo.cpp
 
 #include "image/codecs/msvideo1.h"
+#include "image/codecs/bufferpool.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -35,14 +36,14 @@ namespace Image {
 
 MSVideo1Decoder::MSVideo1Decoder(uint16 width, uint16 height, byte bitsPerPixel) : Codec() {
 	_surface = new Graphics::Surface();
-	_surface->create(width, height, (bitsPerPixel == 8) ? Graphics::PixelFormat::createFormatCLUT8() :
+	CodecBufferPoolMan.createSurface(*_surface, width, height, (bitsPerPixel == 8) ? Graphics::PixelFormat::createFormatCLUT8() :
 														  Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0));
 
 	_bitsPerPixel = bitsPerPixel;
 }
 
 MSVideo1Decoder::~MSVideo1Decoder() {
-	_surface->free();
+	CodecBufferPoolMan.freeSurface(*_surface);
 	delete _surface;
 }
 
@@ -23,6 +23,7 @@
 // Based off ffmpeg's QuickTime RLE decoder (written by Mike Melanson)
 
 #include "image/codecs/qtrle.h"
+#include "image/codecs/bufferpool.h"
 #include "image/codecs/dither.h"
 
 #include "common/debug.h"
@@ -51,7 +52,7 @@ QTRLEDecoder::QTRLEDecoder(uint16 width, uint16 height, byte bitsPerPixel) : Cod
 
 QTRLEDecoder::~QTRLEDecoder() {
 	if (_surface) {
-		_surface->free();
+		CodecBufferPoolMan.freeSurface(*_surface);
 		delete _surface;
 	}
 
@@ -667,12 +668,12 @@ void QTRLEDecoder::setDither(DitherType type, const byte *palette) {
 
 void QTRLEDecoder::createSurface() {
 	if (_surface) {
-		_surface->free();
+		CodecBufferPoolMan.freeSurface(*_surface);
 		delete _surface;
 	}
 
 	_surface = new Graphics::Surface();
-	_surface->create(_paddedWidth, _height, getPixelFormat());
+	CodecBufferPoolMan.createSurface(*_surface, _paddedWidth, _height, getPixelFormat());
 	_surface->w = _width;
 }
 
@@ -22,6 +22,7 @@
  // Based off ffmpeg's RPZA decoder
 
 #include "image/codecs/rpza.h"
+#include "image/codecs/bufferpool.h"
 #include "image/codecs/dither.h"
 
 #include "common/debug.h"
@@ -44,7 +45,7 @@ RPZADecoder::RPZADecoder(uint16 width, uint16 height) : Codec(), _ditherPalette(
 
 RPZADecoder::~RPZADecoder() {
 	if (_surface) {
-		_surface->free();
+		CodecBufferPoolMan.freeSurface(*_surface);
 		delete _surface;
 	}
 
@@ -330,7 +331,7 @@ const Graphics::Surface *RPZADecoder::decodeFrame(Common::SeekableReadStream &st
 		_surface = new Graphics::Surface();
 
 		// Allocate enough space in the surface for the blocks
-		_surface->create(_blockWidth * 4, _blockHeight * 4, getPixelFormat());
+		CodecBufferPoolMan.createSurface(*_surface, _blockWidth * 4, _blockHeight * 4, getPixelFormat());
 
 		// Adjust width/height to be the right ones
 		_surface->w = _width;
@@ -22,6 +22,7 @@
 // Based off ffmpeg's SMC decoder
 
 #include "image/codecs/smc.h"
+#include "image/codecs/bufferpool.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -46,11 +47,11 @@ namespace Image {
 
 SMCDecoder::SMCDecoder(uint16 width, uint16 height) {
 	_surface = new Graphics::Surface();
-	_surface->create(width, height, Graphics::PixelFormat::createFormatCLUT8());
+	CodecBufferPoolMan.createSurface(*_surface, width, height, Graphics::PixelFormat::createFormatCLUT8());
 }
 
 SMCDecoder::~SMCDecoder() {
-	_surface->free();
+	CodecBufferPoolMan.freeSurface(*_surface);
 	delete _surface;
 }
 
@@ -83,16 +83,6 @@ private:
 			Common::Point *motion, int x, int y);
 	bool svq1DecodeDeltaBlock(Common::BitStream32BEMSB *ss, byte *current, byte *previous, int pitch,
 			Common::Point *motion, int x, int y);
-
-	void putPixels8C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels8L2(byte *dst, const byte *src1, const byte *src2, int dstStride, int srcStride1, int srcStride2, int h);
-	void putPixels8X2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels8Y2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels8XY2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16X2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16Y2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16XY2C(byte *block, const byte *pixels, int lineSize, int h);
 };
 
 } // End of namespace Image
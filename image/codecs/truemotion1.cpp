@@ -23,6 +23,7 @@
 
 #include "common/scummsys.h"
 #include "image/codecs/truemotion1.h"
+#include "image/codecs/bufferpool.h"
 
 #ifdef IMAGE_CODECS_TRUEMOTION1_H
 
@@ -98,7 +99,7 @@ TrueMotion1Decoder::TrueMotion1Decoder() {
 
 TrueMotion1Decoder::~TrueMotion1Decoder() {
 	if (_surface) {
-		_surface->free();
+		CodecBufferPoolMan.freeSurface(*_surface);
 		delete _surface;
 	}
 
@@ -160,7 +161,8 @@ void TrueMotion1Decoder::genVectorTable16(const byte *selVectorTable) {
 }
 
 void TrueMotion1Decoder::decodeHeader(Common::SeekableReadStream &stream) {
-	_buf = new byte[stream.size()];
+	// A new buffer for each frame, which the pool recycles
+	_buf = (byte *)CodecBufferPoolMan.allocate((uint32)stream.size());
 	stream.read(_buf, stream.size());
 
 	byte headerBuffer[128];  // logical maximum size of the header
@@ -195,7 +197,7 @@ void TrueMotion1Decoder::decodeHeader(Common::SeekableReadStream &stream) {
 
 	if (!_surface) {
 		_surface = new Graphics::Surface();
-		_surface->create(_header.xsize, _header.ysize, getPixelFormat());
+		CodecBufferPoolMan.createSurface(*_surface, _header.xsize, _header.ysize, getPixelFormat());
 	}
 
 	// There is 1 change bit per 4 pixels, so each change byte represents
@@ -410,18 +412,18 @@ const Graphics::Surface *TrueMotion1Decoder::decodeFrame(Common::SeekableReadStr
 	decodeHeader(stream);
 
 	if (compressionTypes[_header.compression].algorithm == ALGO_NOP) {
-		delete[] _buf;
+		CodecBufferPoolMan.release(_buf);
 		return 0;
 	}
 
 	if (compressionTypes[_header.compression].algorithm == ALGO_RGB24H) {
 		warning("Unhandled TrueMotion1 24bpp frame");
-		delete[] _buf;
+		CodecBufferPoolMan.release(_buf);
 		return 0;
 	} else
 		decode16();
 
-	delete[] _buf;
+	CodecBufferPoolMan.release(_buf);
 
 	return _surface;
 }
@@ -34,6 +34,7 @@
  */
 
 #include "image/codecs/xan.h"
+#include "image/codecs/bufferpool.h"
 
 #include "common/stream.h"
 #include "common/bitstream.h"
@@ -50,6 +51,12 @@ namespace Image {
 
 static const int SCRATCH_SPARE = 256;
 
+static uint8 *allocateBuffer(uint32 size) {
+	uint8 *buf = (uint8 *)CodecBufferPoolMan.allocate(size);
+	memset(buf, 0, size);
+	return buf;
+}
+
 XanDecoder::XanDecoder(int width, int height, int bitsPerPixel) : Codec(),
 		_width(width), _height(height), _wc4Mode(false), _surface(nullptr) {
 	assert(bitsPerPixel == 16);
@@ -57,26 +64,26 @@ XanDecoder::XanDecoder(int width, int height, int bitsPerPixel) : Codec(),
 		error("XanDecoder: BPP must be 16 not %d", bitsPerPixel);
 	if (width % 2)
 		error("XanDecoder: width must be even, not %d", width);
-	_scratchbuf = new uint8[_width * _height + SCRATCH_SPARE]();
-	_lumabuf = new uint8[_width * _height]();
-	_ybuf = new uint8[_width * _height]();
-	_ubuf = new uint8[_width * _height / 2]();
-	_vbuf = new uint8[_width * _height / 2]();
+	_scratchbuf = allocateBuffer(_width * _height + SCRATCH_SPARE);
+	_lumabuf = allocateBuffer(_width * _height);
+	_ybuf = allocateBuffer(_width * _height);
+	_ubuf = allocateBuffer(_width * _height / 2);
+	_vbuf = allocateBuffer(_width * _height / 2);
 
 	_pixelFormat = getDefaultYUVFormat();
 }
 
 XanDecoder::~XanDecoder() {
 	if (_surface) {
-		_surface->free();
+		CodecBufferPoolMan.freeSurface(*_surface);
 		delete _surface;
 		_surface = nullptr;
 	}
-	delete [] _scratchbuf;
-	delete [] _lumabuf;
-	delete [] _ybuf;
-	delete [] _ubuf;
-	delete [] _vbuf;
+	CodecBufferPoolMan.release(_scratchbuf);
+	CodecBufferPoolMan.release(_lumabuf);
+	CodecBufferPoolMan.release(_ybuf);
+	CodecBufferPoolMan.release(_ubuf);
+	CodecBufferPoolMan.release(_vbuf);
 }
 
 const Graphics::Surface *XanDecoder::decodeFrame(Common::SeekableReadStream &stream) {
@@ -492,7 +499,7 @@ void XanDecoder::convertYUVtoRGBSurface() {
 
 	if (!_surface) {
 		_surface = new Graphics::Surface;
-		_surface->create(_width, _height, _pixelFormat);
+		CodecBufferPoolMan.createSurface(*_surface, _width, _height, _pixelFormat);
 	}
 
 	YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleFull,
@@ -16,10 +16,12 @@ MODULE_OBJS := \
 	tga.o \
 	xbm.o \
 	codecs/bmp_raw.o \
+	codecs/bufferpool.o \
 	codecs/cdtoons.o \
 	codecs/cinepak.o \
 	codecs/codec.o \
 	codecs/dither.o \
+	codecs/dsp.o \
 	codecs/hlz.o \
 	codecs/jyv1.o \
 	codecs/mjpeg.o \
@@ -33,6 +35,16 @@ MODULE_OBJS := \
 	codecs/truemotion1.o \
 	codecs/xan.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	codecs/dsp_neon.o
+endif
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	codecs/dsp_sse2.o
+endif
+
 ifdef USE_GIF
 MODULE_OBJS += \
 	gif.o
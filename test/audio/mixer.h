@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/mixer_intern.h"
+
+#include "../system/null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite {
+	Audio::SeekableAudioStream *makeStream() {
+		const uint32 size = 22050;
+		byte *data = (byte *)malloc(size);
+		memset(data, 0x80, size);
+		return Audio::makeRawStream(data, size, 22050, Audio::FLAG_UNSIGNED);
+	}
+
+public:
+	void test_queued_setters() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeStream());
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		// The values read back are the last ones set, also while older
+		// changes are applied
+		int16 samples[512];
+		mixer.setChannelVolume(handle, 10);
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+		mixer.setChannelVolume(handle, 20);
+		mixer.setChannelBalance(handle, -30);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 20);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -30);
+
+		mixer.setChannelVolume(handle, 30);
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 30);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -30);
+
+		mixer.setChannelRate(handle, 11025);
+		mixer.setChannelFaderL(handle, 100);
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025U);
+		TS_ASSERT_EQUALS(mixer.getChannelFaderL(handle), 100);
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050U);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+#endif
+	}
+
+	void test_stop_channels() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		// Stopping channels in any order keeps the others playing
+		Audio::SoundHandle handles[40];
+		for (int i = 0; i < ARRAYSIZE(handles); i++)
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handles[i], makeStream(), i);
+
+		for (int i = 0; i < ARRAYSIZE(handles); i += 3)
+			mixer.stopHandle(handles[i]);
+		mixer.stopID(ARRAYSIZE(handles) - 1);
+
+		int16 samples[512];
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+		for (int i = 0; i < ARRAYSIZE(handles); i++) {
+			const bool active = (i % 3) != 0 && i != ARRAYSIZE(handles) - 1;
+			TS_ASSERT_EQUALS(mixer.isSoundHandleActive(handles[i]), active);
+			TS_ASSERT_EQUALS(mixer.isSoundIDActive(i), active);
+		}
+
+		mixer.stopAll();
+		for (int i = 0; i < ARRAYSIZE(handles); i++)
+			TS_ASSERT(!mixer.isSoundHandleActive(handles[i]));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+#endif
+	}
+
+	void test_stale_handles() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		// The handles of stopped sounds do not refer to the sounds reusing
+		// their slots
+		Audio::SoundHandle first, handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &first, makeStream());
+		mixer.stopHandle(first);
+		for (int i = 0; i < 100; i++) {
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, makeStream());
+			TS_ASSERT(!mixer.isSoundHandleActive(first));
+			mixer.setChannelVolume(first, 10);
+			TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), Audio::Mixer::kMaxChannelVolume);
+			mixer.stopHandle(first);
+			TS_ASSERT(mixer.isSoundHandleActive(handle));
+			mixer.stopHandle(handle);
+		}
+#endif
+	}
+};
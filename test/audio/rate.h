@@ -0,0 +1,265 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/audiostream.h"
+#include "common/memstream.h"
+
+#include "test/instrset_detect.h"
+#include "test/system/null_osystem.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	int16 nextSample() {
+		_seed = _seed * 1103515245 + 12345;
+		// Favour the extremes, so that clipping gets tested too
+		switch ((_seed >> 8) & 7) {
+		case 0:
+			return -32768;
+		case 1:
+			return 32767;
+		default:
+			return (int16)(_seed >> 16);
+		}
+	}
+
+	void compareFuncs(const Audio::SampleMixer::Funcs &funcs, const char *name) {
+		static const Audio::st_volume_t volumes[] = { 0, 1, 127, 128, 255, 256 };
+		static const Audio::st_size_t frameCounts[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 100 };
+
+		int16 in[200], outRef[200], outTest[200];
+
+		_seed = 1;
+		for (int layout = 0; layout < 5; layout++) {
+			const bool inStereo = (layout >= 2);
+			const bool outStereo = (layout == 1 || layout >= 3);
+			const bool reverseStereo = (layout == 4);
+			const Audio::SampleMixer::MixFunc ref = Audio::SampleMixer::funcsGeneric.get(inStereo, outStereo, reverseStereo);
+			const Audio::SampleMixer::MixFunc test = funcs.get(inStereo, outStereo, reverseStereo);
+
+			for (int l = 0; l < ARRAYSIZE(volumes); l++) {
+			for (int r = 0; r < ARRAYSIZE(volumes); r++) {
+			for (int n = 0; n < ARRAYSIZE(frameCounts); n++) {
+				for (int i = 0; i < ARRAYSIZE(in); i++) {
+					in[i] = nextSample();
+					outRef[i] = outTest[i] = nextSample();
+				}
+
+				ref(outRef, in, frameCounts[n], volumes[l], volumes[r]);
+				test(outTest, in, frameCounts[n], volumes[l], volumes[r]);
+
+				if (memcmp(outRef, outTest, sizeof(outRef)) != 0) {
+					warning("%s: layout %d, volumes %d/%d, %d frames", name, layout, volumes[l], volumes[r], frameCounts[n]);
+					TS_FAIL("SIMD mixing output differs from the generic one");
+					return;
+				}
+			}
+			}
+			}
+		}
+
+		int16 samples[Audio::SampleMixer::kFilterTaps], coeffs[Audio::SampleMixer::kFilterTaps];
+		for (int n = 0; n < 1000; n++) {
+			for (int i = 0; i < Audio::SampleMixer::kFilterTaps; i++) {
+				samples[i] = nextSample();
+				// Keep the sum within 32 bits, like the real filter banks do
+				coeffs[i] = nextSample() >> 5;
+			}
+
+			if (funcs.filter(samples, coeffs) != Audio::SampleMixer::filterGeneric(samples, coeffs)) {
+				warning("%s: filter run %d", name, n);
+				TS_FAIL("SIMD filter output differs from the generic one");
+				return;
+			}
+		}
+	}
+
+	void convertTestTemplate(const int inRate, const int outRate, const bool inStereo, const bool outStereo) {
+		convertTestTemplate(Audio::SampleMixer::funcsGeneric, inRate, outRate, inStereo, outStereo);
+#ifdef SCUMMVM_NEON
+		convertTestTemplate(Audio::SampleMixer::funcsNEON, inRate, outRate, inStereo, outStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			convertTestTemplate(Audio::SampleMixer::funcsSSE2, inRate, outRate, inStereo, outStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			convertTestTemplate(Audio::SampleMixer::funcsAVX2, inRate, outRate, inStereo, outStereo);
+#endif
+		Audio::SampleMixer::selectedFuncs = nullptr;
+	}
+
+	void convertTestTemplate(const Audio::SampleMixer::Funcs &funcs, const int inRate, const int outRate, const bool inStereo, const bool outStereo) {
+		Audio::SampleMixer::selectedFuncs = &funcs;
+
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, &sine, true, inStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, inStereo, outStereo, false);
+
+		// Convert in odd sized blocks, to test the internal block boundaries
+		const int inFrames = inRate;
+		const int step = inRate / outRate;
+		const int outFrames = (inRate == outRate) ? inFrames : inFrames / step;
+		const int outChannels = outStereo ? 2 : 1;
+		int16 *out = new int16[(outFrames + 1000) * outChannels]();
+
+		int total = 0;
+		for (;;) {
+			const int res = converter->convert(*s, out + total * outChannels, 777, 200, 100);
+			total += res;
+			if (res < 777)
+				break;
+		}
+		TS_ASSERT_EQUALS(total, outFrames);
+
+		for (int i = 0; i < outFrames; i++) {
+			// simpleConvert picks the last of each group of input frames
+			const int inPos = (inRate == outRate) ? i : 1 + i * step;
+			const int16 inL = sine[inPos * (inStereo ? 2 : 1)];
+			const int16 inR = inStereo ? sine[inPos * 2 + 1] : inL;
+			const int16 outL = (inL * 200) / Audio::Mixer::kMaxMixerVolume;
+			const int16 outR = (inR * 100) / Audio::Mixer::kMaxMixerVolume;
+
+			if (outStereo) {
+				TS_ASSERT_EQUALS(out[i * 2], outL);
+				TS_ASSERT_EQUALS(out[i * 2 + 1], outR);
+			} else {
+				TS_ASSERT_EQUALS(out[i], (outL + outR) / 2);
+			}
+		}
+
+		delete[] out;
+		delete[] sine;
+		delete converter;
+		delete s;
+	}
+
+	void polyphaseTestTemplate(const int inRate, const int outRate, const bool inStereo) {
+		polyphaseTestTemplate(Audio::SampleMixer::funcsGeneric, inRate, outRate, inStereo);
+#ifdef SCUMMVM_NEON
+		polyphaseTestTemplate(Audio::SampleMixer::funcsNEON, inRate, outRate, inStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			polyphaseTestTemplate(Audio::SampleMixer::funcsSSE2, inRate, outRate, inStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			polyphaseTestTemplate(Audio::SampleMixer::funcsAVX2, inRate, outRate, inStereo);
+#endif
+		Audio::SampleMixer::selectedFuncs = nullptr;
+	}
+
+	void polyphaseTestTemplate(const Audio::SampleMixer::Funcs &funcs, const int inRate, const int outRate, const bool inStereo) {
+		Common::install_null_g_system();
+		Audio::SampleMixer::selectedFuncs = &funcs;
+
+		// A 1 kHz sine on the left channel, and its inverse on the right one
+		const int inFrames = inRate / 4;
+		const int channels = inStereo ? 2 : 1;
+		const double freq = 1000.0;
+		const double amplitude = 16000.0;
+		int16 *in = (int16 *)malloc(inFrames * channels * sizeof(int16));
+		for (int i = 0; i < inFrames; i++) {
+			in[i * channels] = (int16)(sin(i * freq / inRate * 2 * M_PI) * amplitude);
+			if (inStereo)
+				in[i * channels + 1] = -in[i * channels];
+		}
+
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((const byte *)in, inFrames * channels * sizeof(int16), inRate,
+		                                                     Audio::FLAG_16BITS | (inStereo ? Audio::FLAG_STEREO : 0)
+#ifdef SCUMM_LITTLE_ENDIAN
+		                                                     | Audio::FLAG_LITTLE_ENDIAN
+#endif
+		                                                     );
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, inStereo, true, false, Audio::kRateQualityHigh);
+
+		// Output frame n is centered on input frame n * inRate / outRate, and
+		// needs half the filter length of input frames after it
+		int outFrames = 0;
+		while ((int64)outFrames * inRate / outRate + Audio::SampleMixer::kFilterTaps / 2 < inFrames)
+			outFrames++;
+
+		int16 *out = new int16[(outFrames + 1000) * 2]();
+
+		int total = 0;
+		for (;;) {
+			const int res = converter->convert(*s, out + total * 2, 777, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			total += res;
+			if (res < 777)
+				break;
+		}
+		TS_ASSERT_EQUALS(total, outFrames);
+
+		// Skip the start, where the filter still sees the silence before the stream
+		int maxError = 0;
+		for (int i = Audio::SampleMixer::kFilterTaps * outRate / inRate; i < total; i++) {
+			const int16 expected = (int16)(sin(i * freq / outRate * 2 * M_PI) * amplitude);
+			maxError = MAX(maxError, ABS(out[i * 2] - expected));
+			maxError = MAX(maxError, ABS(out[i * 2 + 1] - (inStereo ? -expected : expected)));
+		}
+		TS_ASSERT_LESS_THAN(maxError, amplitude / 200);
+
+		delete[] out;
+		delete converter;
+		delete s;
+	}
+
+public:
+	void test_mix_funcs() {
+#ifdef SCUMMVM_NEON
+		compareFuncs(Audio::SampleMixer::funcsNEON, "NEON");
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareFuncs(Audio::SampleMixer::funcsSSE2, "SSE2");
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareFuncs(Audio::SampleMixer::funcsAVX2, "AVX2");
+#endif
+	}
+
+	void test_copy_convert_mono() {
+		convertTestTemplate(11025, 11025, false, true);
+	}
+
+	void test_copy_convert_stereo() {
+		convertTestTemplate(22050, 22050, true, true);
+	}
+
+	void test_copy_convert_stereo_to_mono() {
+		convertTestTemplate(22050, 22050, true, false);
+	}
+
+	void test_simple_convert_mono() {
+		convertTestTemplate(44100, 22050, false, true);
+	}
+
+	void test_simple_convert_stereo() {
+		convertTestTemplate(44100, 11025, true, true);
+	}
+
+	void test_polyphase_convert_mono() {
+		polyphaseTestTemplate(11025, 48000, false);
+	}
+
+	void test_polyphase_convert_stereo() {
+		polyphaseTestTemplate(22050, 44100, true);
+	}
+
+	void test_polyphase_convert_downsample() {
+		polyphaseTestTemplate(48000, 22050, true);
+	}
+
+	void test_polyphase_convert_odd_rate() {
+		// Needs more phases than a filter bank has, the ratio gets approximated
+		polyphaseTestTemplate(11127, 48000, false);
+	}
+};
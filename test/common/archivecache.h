@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/stream.h"
+
+/**
+ * An archive whose members are named after their size, and which counts
+ * how often their contents get read.
+ */
+class CountingArchive : public Common::MemcachingCaseInsensitiveArchive {
+public:
+	mutable int reads;
+
+	CountingArchive() : Common::MemcachingCaseInsensitiveArchive(16), reads(0) {}
+
+	bool hasFile(const Common::Path &path) const override { return true; }
+	int listMembers(Common::ArchiveMemberList &list) const override { return 0; }
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override { return Common::ArchiveMemberPtr(); }
+
+	Common::SharedArchiveContents readContentsForPath(const Common::Path &translatedPath) const override {
+		reads++;
+
+		const uint32 size = atoi(translatedPath.toString().c_str());
+		if (!size)
+			return Common::SharedArchiveContents();
+
+		byte *contents = new byte[size];
+		memset(contents, size & 0xFF, size);
+		return Common::SharedArchiveContents(contents, size);
+	}
+
+	void open(const char *name) {
+		Common::SeekableReadStream *stream = createReadStreamForMember(name);
+		delete stream;
+	}
+};
+
+class ArchiveCacheTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_small_contents_kept() {
+		CountingArchive archive;
+		archive.setCacheLimit(0);
+
+		archive.open("10");
+		archive.open("10");
+		TS_ASSERT_EQUALS(archive.reads, 1);
+
+		// Missing files are remembered as well
+		archive.open("missing");
+		archive.open("missing");
+		TS_ASSERT_EQUALS(archive.reads, 2);
+	}
+
+	void test_contents_used_by_streams() {
+		CountingArchive archive;
+		archive.setCacheLimit(0);
+
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember("1000");
+		archive.open("1000");
+		TS_ASSERT_EQUALS(archive.reads, 1);
+		TS_ASSERT_EQUALS(stream->readByte(), 1000 & 0xFF);
+		delete stream;
+
+		archive.open("1000");
+		TS_ASSERT_EQUALS(archive.reads, 2);
+	}
+
+	void test_lru() {
+		const uint32 oldLimit = Common::MemcachingCaseInsensitiveArchive::getGlobalCacheLimit();
+		Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(1024 * 1024);
+
+		CountingArchive archive;
+		archive.setCacheLimit(3100);
+
+		const Common::MemcachingCaseInsensitiveArchive::CacheStats before = Common::MemcachingCaseInsensitiveArchive::getGlobalCacheStats();
+
+		archive.open("1000");
+		archive.open("1001");
+		archive.open("1002");
+		TS_ASSERT_EQUALS(archive.reads, 3);
+
+		// Make 1000 the most recently used one, then push out 1001
+		archive.open("1000");
+		archive.open("1003");
+		TS_ASSERT_EQUALS(archive.reads, 4);
+
+		archive.open("1000");
+		archive.open("1002");
+		archive.open("1003");
+		TS_ASSERT_EQUALS(archive.reads, 4);
+
+		archive.open("1001");
+		TS_ASSERT_EQUALS(archive.reads, 5);
+
+		// Contents above the limit are not kept at all
+		archive.open("5000");
+		archive.open("5000");
+		TS_ASSERT_EQUALS(archive.reads, 7);
+
+		const Common::MemcachingCaseInsensitiveArchive::CacheStats after = Common::MemcachingCaseInsensitiveArchive::getGlobalCacheStats();
+		TS_ASSERT_EQUALS(after.hits - before.hits, 4u);
+		TS_ASSERT_EQUALS(after.misses - before.misses, 7u);
+		TS_ASSERT_EQUALS(after.evictions - before.evictions, 2u);
+		TS_ASSERT_EQUALS(after.cachedBytes - before.cachedBytes, 1001u + 1002 + 1003);
+
+		// Lowering the limit drops contents right away
+		archive.setCacheLimit(1500);
+		archive.open("1001");
+		TS_ASSERT_EQUALS(archive.reads, 7);
+		archive.open("1003");
+		TS_ASSERT_EQUALS(archive.reads, 8);
+
+		Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(oldLimit);
+	}
+
+	void test_global_limit_default() {
+		// Contents are kept without the backend setting a budget
+		TS_ASSERT_EQUALS(Common::MemcachingCaseInsensitiveArchive::getGlobalCacheLimit(), (uint32)Common::MemcachingCaseInsensitiveArchive::kDefaultGlobalCacheLimit);
+		TS_ASSERT(Common::MemcachingCaseInsensitiveArchive::kDefaultGlobalCacheLimit > 0);
+
+		CountingArchive archive;
+		archive.open("1000");
+		archive.open("1000");
+		TS_ASSERT_EQUALS(archive.reads, 1);
+
+		// Backends may disable the cache
+		Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(0);
+		archive.open("1001");
+		archive.open("1001");
+		TS_ASSERT_EQUALS(archive.reads, 3);
+		Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(Common::MemcachingCaseInsensitiveArchive::kDefaultGlobalCacheLimit);
+	}
+
+	void test_global_limit() {
+		const uint32 oldLimit = Common::MemcachingCaseInsensitiveArchive::getGlobalCacheLimit();
+		Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(3100);
+
+		CountingArchive archive1, archive2;
+
+		archive1.open("1000");
+		archive2.open("1001");
+		archive1.open("1002");
+
+		// The oldest contents of all archives go first
+		archive2.open("1003");
+		archive2.open("1001");
+		archive1.open("1002");
+		TS_ASSERT_EQUALS(archive1.reads, 2);
+		TS_ASSERT_EQUALS(archive2.reads, 2);
+
+		archive1.open("1000");
+		TS_ASSERT_EQUALS(archive1.reads, 3);
+
+		Common::MemcachingCaseInsensitiveArchive::setGlobalCacheLimit(oldLimit);
+	}
+};
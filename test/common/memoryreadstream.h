@@ -104,4 +104,20 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_range_pointer() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.seek(3);
+		TS_ASSERT_EQUALS(ms.getRangePointer(0, 7), contents);
+		TS_ASSERT_EQUALS(ms.getRangePointer(2, 5), contents + 2);
+		TS_ASSERT_EQUALS(ms.getRangePointer(7, 0), contents + 7);
+		TS_ASSERT(!ms.getRangePointer(3, 5));
+		TS_ASSERT(!ms.getRangePointer(8, 0));
+		TS_ASSERT(!ms.getRangePointer(-1, 1));
+
+		// The position is left alone
+		TS_ASSERT_EQUALS(ms.pos(), 3);
+	}
 };
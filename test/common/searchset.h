@@ -0,0 +1,174 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+/**
+ * An archive holding a few one byte files, whose contents tell which
+ * archive they were read from.
+ */
+class TestArchive : public Common::Archive {
+public:
+	mutable int probes;
+
+	TestArchive(byte id, bool listComplete = true) : probes(0), _id(id), _listComplete(listComplete) {}
+
+	void addFile(const char *name) {
+		_files.push_back(Common::Path(name));
+	}
+
+	/** Add a file which is provided, but not listed by listMembers(). */
+	void addUnlistedFile(const char *name) {
+		_unlistedFiles.push_back(Common::Path(name));
+	}
+
+	bool hasFile(const Common::Path &path) const override {
+		probes++;
+		for (const auto &file : _files) {
+			if (file.equalsIgnoreCase(path))
+				return true;
+		}
+		for (const auto &file : _unlistedFiles) {
+			if (file.equalsIgnoreCase(path))
+				return true;
+		}
+		return false;
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const override {
+		for (const auto &file : _files)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(file, *this)));
+		return _files.size();
+	}
+
+	bool isMemberListComplete() const override {
+		return _listComplete;
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return nullptr;
+		return new Common::MemoryReadStream(&_id, 1);
+	}
+
+private:
+	byte _id;
+	Common::Array<Common::Path> _files;
+	Common::Array<Common::Path> _unlistedFiles;
+	bool _listComplete;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite
+{
+	int readArchiveId(Common::SearchSet &set, const char *name) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(Common::Path(name));
+		if (!stream)
+			return -1;
+
+		const int id = stream->readByte();
+		delete stream;
+		return id;
+	}
+
+	void lookupTestTemplate(bool useIndex) {
+		Common::SearchSet set;
+		set.setUseIndex(useIndex);
+
+		TestArchive *low = new TestArchive(1);
+		low->addFile("shared.dat");
+		low->addFile("low.dat");
+		low->addFile("dir/nested.dat");
+		set.add("low", low, -1);
+
+		TestArchive *high = new TestArchive(2);
+		high->addFile("SHARED.DAT");
+		high->addFile("high.dat");
+		set.add("high", high, 1);
+
+		TS_ASSERT(set.hasFile(Common::Path("shared.dat")));
+		TS_ASSERT(set.hasFile(Common::Path("Low.dat")));
+		TS_ASSERT(set.hasFile(Common::Path("dir/nested.dat")));
+		TS_ASSERT(!set.hasFile(Common::Path("missing.dat")));
+
+		TS_ASSERT_EQUALS(readArchiveId(set, "shared.dat"), 2);
+		TS_ASSERT_EQUALS(readArchiveId(set, "low.dat"), 1);
+		TS_ASSERT_EQUALS(readArchiveId(set, "high.dat"), 2);
+		TS_ASSERT_EQUALS(readArchiveId(set, "missing.dat"), -1);
+
+		Common::Archive *container = nullptr;
+		TS_ASSERT(set.getMember(Common::Path("shared.dat"), &container));
+		TS_ASSERT_EQUALS(container, high);
+
+		// Reprioritizing and removing archives must be picked up
+		set.setPriority("low", 2);
+		TS_ASSERT_EQUALS(readArchiveId(set, "shared.dat"), 1);
+
+		set.remove("low");
+		TS_ASSERT_EQUALS(readArchiveId(set, "shared.dat"), 2);
+		TS_ASSERT_EQUALS(readArchiveId(set, "low.dat"), -1);
+
+		// As must files added to an archive once the index is dropped
+		high->addFile("late.dat");
+		set.invalidateIndex();
+		TS_ASSERT_EQUALS(readArchiveId(set, "late.dat"), 2);
+
+		// Archives added later take precedence according to their priority
+		TestArchive *top = new TestArchive(3, false);
+		top->addFile("high.dat");
+		set.add("top", top, 3);
+		TestArchive *bottom = new TestArchive(4);
+		bottom->addFile("late.dat");
+		bottom->addFile("bottom.dat");
+		set.add("bottom", bottom, -3);
+		TS_ASSERT_EQUALS(readArchiveId(set, "high.dat"), 3);
+		TS_ASSERT_EQUALS(readArchiveId(set, "late.dat"), 2);
+		TS_ASSERT_EQUALS(readArchiveId(set, "bottom.dat"), 4);
+
+		// Archives which provide files they do not list win over the
+		// archives with a lower priority listing them
+		top->addUnlistedFile("shared.dat");
+		TS_ASSERT_EQUALS(readArchiveId(set, "shared.dat"), 3);
+		container = nullptr;
+		TS_ASSERT(set.getMember(Common::Path("shared.dat"), &container));
+		TS_ASSERT_EQUALS(container, top);
+	}
+
+public:
+	void test_lookup() {
+		lookupTestTemplate(false);
+	}
+
+	void test_indexed_lookup() {
+		lookupTestTemplate(true);
+	}
+
+	void test_index_counters() {
+		Common::SearchSet set;
+		set.setUseIndex(true);
+
+		TestArchive *arc = new TestArchive(1);
+		arc->addFile("file.dat");
+		set.add("arc", arc);
+
+		TestArchive *side = new TestArchive(2, false);
+		side->addUnlistedFile("side.dat");
+		set.add("side", side, -1);
+
+		TS_ASSERT(set.hasFile(Common::Path("file.dat")));
+		TS_ASSERT(set.hasFile(Common::Path("FILE.DAT")));
+		TS_ASSERT(!set.hasFile(Common::Path("other.dat")));
+		TS_ASSERT(set.hasFile(Common::Path("side.dat")));
+
+		// Only the archive whose member list is not complete gets asked,
+		// and only if no archive above it lists the file
+		TS_ASSERT_EQUALS(arc->probes, 0);
+		TS_ASSERT_EQUALS(side->probes, 2);
+
+		TS_ASSERT_EQUALS(set.getIndexHits(), 4u);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 0u);
+	}
+};
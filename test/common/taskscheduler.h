@@ -0,0 +1,166 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/taskscheduler.h"
+#include "common/system.h"
+#include "../system/null_osystem.h"
+
+class TaskSchedulerTestSuite : public CxxTest::TestSuite {
+	static void increment(void *param) {
+		(*(int *)param)++;
+	}
+
+	// keeps a worker busy until the flag is set
+	static void block(void *param) {
+		while (!((Common::Atomic<uint32> *)param)->load())
+			g_system->delayMillis(1);
+	}
+
+	struct NestedJob {
+		Common::TaskScheduler *scheduler;
+		int counts[64];
+	};
+
+	// a task splitting its own work, and waiting for it
+	static void runNested(void *param) {
+		NestedJob *job = (NestedJob *)param;
+		job->scheduler->parallelFor(64, 4, [job](uint begin, uint end) {
+			for (uint i = begin; i < end; i++)
+				job->counts[i]++;
+		}, "nested");
+	}
+
+	// checks that each item is visited exactly once, and the ranges are large enough
+	void checkParallelFor(Common::TaskScheduler &scheduler, uint count, uint grain) {
+		int *counts = new int[count]();
+		bool tooSmall = false;
+		scheduler.parallelFor(count, grain, [&](uint begin, uint end) {
+			if (end - begin < MIN(grain, count))
+				tooSmall = true;
+			for (uint i = begin; i < end; i++)
+				counts[i]++;
+		});
+
+		for (uint i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(counts[i], 1);
+		TS_ASSERT(!tooSmall);
+		delete[] counts;
+	}
+
+	void checkScheduler(Common::TaskScheduler &scheduler) {
+		checkParallelFor(scheduler, 1, 1);
+		checkParallelFor(scheduler, 3, 8);
+		checkParallelFor(scheduler, 100, 1);
+		checkParallelFor(scheduler, 1000, 7);
+		checkParallelFor(scheduler, 100000, 16);
+
+		int counts[100] = {};
+		Common::Array<Common::TaskFuture> futures;
+		for (int i = 0; i < 100; i++)
+			futures.push_back(scheduler.submit(increment, &counts[i], "increment"));
+		for (uint i = 0; i < futures.size(); i++) {
+			futures[i].wait();
+			TS_ASSERT(futures[i].isReady());
+			TS_ASSERT_EQUALS(counts[i], 1);
+		}
+
+		NestedJob nested[8];
+		futures.clear();
+		for (int i = 0; i < 8; i++) {
+			nested[i].scheduler = &scheduler;
+			memset(nested[i].counts, 0, sizeof(nested[i].counts));
+			futures.push_back(scheduler.submit(runNested, &nested[i]));
+		}
+		for (int i = 0; i < 8; i++) {
+			futures[i].wait();
+			for (int j = 0; j < 64; j++)
+				TS_ASSERT_EQUALS(nested[i].counts[j], 1);
+		}
+	}
+
+public:
+	void test_synchronous() {
+		Common::TaskScheduler scheduler(0);
+		TS_ASSERT_EQUALS(scheduler.getNumWorkers(), 0u);
+
+		int count = 0;
+		Common::TaskFuture future = scheduler.submit(increment, &count);
+		TS_ASSERT(future.isReady());
+		TS_ASSERT_EQUALS(count, 1);
+
+		checkScheduler(scheduler);
+	}
+
+	void test_threaded() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		for (int numWorkers = 1; numWorkers <= 4; numWorkers += 3) {
+			Common::TaskScheduler scheduler(numWorkers);
+			if (!scheduler.getNumWorkers())
+				return;
+			TS_ASSERT_EQUALS(scheduler.getNumWorkers(), (uint)numWorkers);
+
+			for (int pass = 0; pass < 10; pass++)
+				checkScheduler(scheduler);
+		}
+#endif
+	}
+
+	void test_wait_own_tasks() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::TaskScheduler scheduler(1);
+		if (!scheduler.getNumWorkers())
+			return;
+
+		// While the worker is busy, waiting for a parallelFor() only runs
+		// its own ranges, and not the tasks queued before them
+		Common::Atomic<uint32> released(0);
+		Common::TaskFuture blocker = scheduler.submit(block, &released);
+		int count = 0;
+		Common::TaskFuture future = scheduler.submit(increment, &count);
+
+		checkParallelFor(scheduler, 100, 1);
+		TS_ASSERT(!future.isReady());
+		TS_ASSERT_EQUALS(count, 0);
+
+		released.store(1);
+		future.wait();
+		blocker.wait();
+		TS_ASSERT_EQUALS(count, 1);
+#endif
+	}
+
+	void test_stats() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// The tasks are timed with the OSystem when run synchronously
+		Common::install_null_g_system();
+		static const char *const kName = "increment";
+
+		for (int numWorkers = 0; numWorkers <= 2; numWorkers += 2) {
+			Common::TaskScheduler scheduler(numWorkers);
+			int counts[10] = {};
+
+			// Tasks are only counted when the statistics are enabled
+			scheduler.submit(increment, &counts[0], kName).wait();
+			TS_ASSERT(scheduler.getStats().empty());
+
+			scheduler.setStatsEnabled(true);
+			for (int i = 0; i < 10; i++)
+				scheduler.submit(increment, &counts[i], kName).wait();
+
+			Common::Array<Common::TaskScheduler::TaskStats> stats = scheduler.getStats();
+			TS_ASSERT_EQUALS(stats.size(), 1u);
+			if (!stats.empty()) {
+				TS_ASSERT_EQUALS(stats[0].name, kName);
+				TS_ASSERT_EQUALS(stats[0].count, 10u);
+				TS_ASSERT(stats[0].maxMicros <= stats[0].totalMicros);
+			}
+
+			scheduler.resetStats();
+			TS_ASSERT(scheduler.getStats().empty());
+		}
+#endif
+	}
+};
@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/compression/deflate.h"
+#include "common/compression/unzip.h"
+
+class ZipTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kSmallSize = 100,
+		kLargeSize = 300000
+	};
+
+	static byte *makeData(uint32 size) {
+		// Compressible, but not trivially so
+		byte *data = new byte[size];
+		uint32 seed = 1;
+		for (uint32 i = 0; i < size; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (i % 64 < 32) ? (byte)(i / 64) : (byte)(seed >> 24);
+		}
+		return data;
+	}
+
+	static void compareRange(Common::SeekableReadStream &stream, const byte *data, uint32 pos, uint32 len) {
+		byte buf[1000];
+		assert(len <= sizeof(buf));
+
+		TS_ASSERT(stream.seek(pos));
+		TS_ASSERT_EQUALS(stream.pos(), pos);
+		TS_ASSERT_EQUALS(stream.read(buf, len), len);
+		TS_ASSERT_SAME_DATA(buf, data + pos, len);
+	}
+
+#ifdef USE_ZLIB
+	/** Compress @p data to a raw deflate stream. */
+	static byte *deflateData(const byte *data, uint32 size, uint32 &compressedSize) {
+		Common::MemoryWriteStreamDynamic *out = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(out);
+		gzip->write(data, size);
+		gzip->finalize();
+
+		// Strip the gzip header and trailer
+		byte *gzipData = out->getData();
+		compressedSize = out->size() - 10 - 8;
+		delete gzip;
+
+		byte *compressed = new byte[compressedSize];
+		memcpy(compressed, gzipData + 10, compressedSize);
+		free(gzipData);
+		return compressed;
+	}
+#endif
+
+	struct Member {
+		const char *name;
+		uint16 method;
+		const byte *data;
+		uint32 size;
+		const byte *compressed;
+		uint32 compressedSize;
+	};
+
+	static Common::SeekableReadStream *makeZip(const Member *members, int count) {
+		Common::CRC32 crc;
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		Common::Array<uint32> offsets;
+
+		for (int i = 0; i < count; i++) {
+			const Member &m = members[i];
+			offsets.push_back(zip.pos());
+			zip.writeUint32LE(0x04034b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(m.method);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(crc.crcFast(m.data, m.size));
+			zip.writeUint32LE(m.compressedSize);
+			zip.writeUint32LE(m.size);
+			zip.writeUint16LE(strlen(m.name));
+			zip.writeUint16LE(0);
+			zip.write(m.name, strlen(m.name));
+			zip.write(m.compressed, m.compressedSize);
+		}
+
+		const uint32 dirOffset = zip.pos();
+		for (int i = 0; i < count; i++) {
+			const Member &m = members[i];
+			zip.writeUint32LE(0x02014b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(m.method);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(crc.crcFast(m.data, m.size));
+			zip.writeUint32LE(m.compressedSize);
+			zip.writeUint32LE(m.size);
+			zip.writeUint16LE(strlen(m.name));
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(offsets[i]);
+			zip.write(m.name, strlen(m.name));
+		}
+		const uint32 dirSize = zip.pos() - dirOffset;
+
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(count);
+		zip.writeUint16LE(count);
+		zip.writeUint32LE(dirSize);
+		zip.writeUint32LE(dirOffset);
+		zip.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES);
+	}
+
+	void zipTestTemplate(uint16 largeMethod, uint32 streamingThreshold) {
+		byte *small = makeData(kSmallSize);
+		byte *large = makeData(kLargeSize);
+
+		Member members[2] = {
+			{ "small.bin", 0, small, kSmallSize, small, kSmallSize },
+			{ "large.bin", 0, large, kLargeSize, large, kLargeSize }
+		};
+
+#ifdef USE_ZLIB
+		byte *compressed = nullptr;
+		if (largeMethod == 8) {
+			members[1].method = 8;
+			members[1].compressed = compressed = deflateData(large, kLargeSize, members[1].compressedSize);
+		}
+#endif
+
+		Common::Archive *archive = Common::makeZipArchive(makeZip(members, 2), false, streamingThreshold);
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *smallStream = archive->createReadStreamForMember("small.bin");
+		TS_ASSERT(smallStream);
+		TS_ASSERT_EQUALS(smallStream->size(), kSmallSize);
+		compareRange(*smallStream, small, 0, kSmallSize);
+
+		// Two streams of the same member, which share the archive stream
+		Common::SeekableReadStream *largeStream1 = archive->createReadStreamForMember("large.bin");
+		Common::SeekableReadStream *largeStream2 = archive->createReadStreamForMember("large.bin");
+		TS_ASSERT(largeStream1);
+		TS_ASSERT(largeStream2);
+		TS_ASSERT_EQUALS(largeStream1->size(), kLargeSize);
+
+		// Read forward, then back and forth
+		for (uint32 pos = 0; pos + 1000 <= kLargeSize; pos += 1000) {
+			compareRange(*largeStream1, large, pos, 1000);
+		}
+
+		// The members outlive the archive
+		delete archive;
+
+		static const uint32 positions[] = { 250000, 10, 123456, 299000, 70000, 69000, 0, 200001 };
+		for (int i = 0; i < ARRAYSIZE(positions); i++) {
+			compareRange(*largeStream1, large, positions[i], 1000);
+			compareRange(*largeStream2, large, positions[ARRAYSIZE(positions) - 1 - i], 1000);
+			compareRange(*smallStream, small, i, 10);
+		}
+
+		delete largeStream1;
+		delete largeStream2;
+		delete smallStream;
+#ifdef USE_ZLIB
+		delete[] compressed;
+#endif
+		delete[] large;
+		delete[] small;
+	}
+
+public:
+	void test_stored_members() {
+		zipTestTemplate(0, Common::kZipStreamingThreshold);
+	}
+
+	void test_stored_members_streamed() {
+		zipTestTemplate(0, 1024);
+	}
+
+#ifdef USE_ZLIB
+	void test_deflated_members() {
+		zipTestTemplate(8, Common::kZipStreamingThreshold);
+	}
+
+	void test_deflated_members_streamed() {
+		zipTestTemplate(8, 1024);
+	}
+
+	void test_deflate_checkpoints() {
+		byte *data = makeData(kLargeSize);
+		uint32 compressedSize;
+		byte *compressed = deflateData(data, kLargeSize, compressedSize);
+
+		Common::SeekableReadStream *stream = Common::wrapDeflateReadStream(
+			new Common::MemoryReadStream(compressed, compressedSize), DisposeAfterUse::YES, kLargeSize, nullptr, 0, 4096);
+		TS_ASSERT(stream);
+
+		// The first seeks create checkpoints along the way, the later ones use them
+		static const uint32 positions[] = { 5000, 100000, 4096, 4095, 8192, 299000, 0, 150000, 12345, 12345 };
+		for (int i = 0; i < ARRAYSIZE(positions); i++)
+			compareRange(*stream, data, positions[i], 1000);
+
+		delete stream;
+		delete[] compressed;
+		delete[] data;
+	}
+#endif
+};
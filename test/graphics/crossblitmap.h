@@ -0,0 +1,136 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/blit.h"
+#include "graphics/blit/blit-map.h"
+
+#include "test/instrset_detect.h"
+
+// converts CLUT8 images with the row kernels and pixel by pixel, and compares the results
+
+class CrossBlitMapTestSuite : public CxxTest::TestSuite {
+	uint32 _seed = 0;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	void blit(int mode, byte *dst, const byte *src, const byte *mask, uint dstPitch, uint srcPitch, uint w, uint h, uint bpp, const uint32 *map, uint32 key) {
+		bool result;
+		if (mode == 0)
+			result = Graphics::crossBlitMap(dst, src, dstPitch, srcPitch, w, h, bpp, map);
+		else if (mode == 1)
+			result = Graphics::crossKeyBlitMap(dst, src, dstPitch, srcPitch, w, h, bpp, map, key);
+		else
+			result = Graphics::crossMaskBlitMap(dst, src, mask, dstPitch, srcPitch, srcPitch, w, h, bpp, map);
+		TS_ASSERT(result);
+	}
+
+	void compareFuncs(const Graphics::MapBlitKernels::Funcs &funcs, const char *name) {
+		const uint kHeight = 5;
+		const uint kMaxWidth = 70;
+
+		uint32 map[256];
+		for (int i = 0; i < 256; i++)
+			map[i] = 0x01020304 * i + 0x5A000000;
+
+		byte src[kMaxWidth * kHeight], mask[kMaxWidth * kHeight * 4];
+		byte expected[kMaxWidth * kHeight * 4], actual[kMaxWidth * kHeight * 4];
+
+		for (uint bpp = 2; bpp <= 4; bpp += 2) {
+			for (int mode = 0; mode < 3; mode++) {
+				for (uint w = 1; w <= kMaxWidth - 3; w++) {
+					const uint srcPitch = w + 3;
+					const uint dstPitch = w * bpp + 2;
+					const uint32 key = (w & 4) ? 0x1FF : nextRandom() & 0x0F;
+
+					for (uint i = 0; i < sizeof(src); i++)
+						src[i] = nextRandom() & (w & 1 ? 0xFF : 0x0F);
+					for (uint i = 0; i < sizeof(mask); i++)
+						mask[i] = nextRandom() & 1;
+					for (uint i = 0; i < sizeof(expected); i++)
+						expected[i] = nextRandom();
+					memcpy(actual, expected, sizeof(actual));
+
+					Graphics::MapBlitKernels::selectedFuncs = &Graphics::MapBlitKernels::funcsNone;
+					blit(mode, expected, src, mask, dstPitch, srcPitch, w, kHeight, bpp, map, key);
+					Graphics::MapBlitKernels::selectedFuncs = &funcs;
+					blit(mode, actual, src, mask, dstPitch, srcPitch, w, kHeight, bpp, map, key);
+
+					if (memcmp(expected, actual, sizeof(actual)) != 0) {
+						warning("%s: %d bpp, mode %d, width %d", name, bpp, mode, w);
+						TS_FAIL("Kernel output differs from converting pixel by pixel");
+					}
+
+					// In place, with the source pixels at the start of each row of the destination
+					for (uint y = 0; y < kHeight; y++) {
+						memcpy(expected + y * dstPitch, src + y * srcPitch, w);
+						memcpy(actual + y * dstPitch, src + y * srcPitch, w);
+					}
+
+					Graphics::MapBlitKernels::selectedFuncs = &Graphics::MapBlitKernels::funcsNone;
+					blit(mode, expected, expected, mask, dstPitch, dstPitch, w, kHeight, bpp, map, key);
+					Graphics::MapBlitKernels::selectedFuncs = &funcs;
+					blit(mode, actual, actual, mask, dstPitch, dstPitch, w, kHeight, bpp, map, key);
+
+					if (memcmp(expected, actual, sizeof(actual)) != 0) {
+						warning("%s: %d bpp, mode %d, width %d, in place", name, bpp, mode, w);
+						TS_FAIL("Kernel output differs from converting pixel by pixel");
+					}
+				}
+			}
+		}
+	}
+
+public:
+	void test_generic_rows() {
+		compareFuncs(Graphics::MapBlitKernels::funcsNone, "None");
+	}
+
+	void test_simd_rows() {
+#ifdef SCUMMVM_NEON
+		compareFuncs(Graphics::MapBlitKernels::funcsNEON, "NEON");
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareFuncs(Graphics::MapBlitKernels::funcsAVX2, "AVX2");
+#endif
+	}
+
+	void test_palette_map_cache() {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32()
+		};
+
+		byte palettes[12][256 * 3];
+		for (int p = 0; p < ARRAYSIZE(palettes); p++) {
+			for (int i = 0; i < 256 * 3; i++)
+				palettes[p][i] = nextRandom();
+		}
+
+		// More palettes than the cache holds, in different formats and sizes,
+		// and the same palettes again with one color changed
+		for (int pass = 0; pass < 4; pass++) {
+			for (int p = 0; p < ARRAYSIZE(palettes); p++) {
+				const Graphics::PixelFormat &format = formats[(p + pass) % ARRAYSIZE(formats)];
+				const uint colors = (p & 1) ? 256 : 16 + p;
+
+				if (pass == 2)
+					palettes[p][(p * 7) % (colors * 3)] ^= 0x80;
+
+				uint32 expected[256], actual[256];
+				memset(actual, 0, sizeof(actual));
+				memset(expected, 0, sizeof(expected));
+				Graphics::convertPaletteToMap(expected, palettes[p], colors, format);
+				Graphics::convertPaletteToMapCached(actual, palettes[p], colors, format);
+				TS_ASSERT_SAME_DATA(expected, actual, sizeof(actual));
+
+				// A hit, likely
+				Graphics::convertPaletteToMapCached(actual, palettes[p], colors, format);
+				TS_ASSERT_SAME_DATA(expected, actual, sizeof(actual));
+			}
+		}
+	}
+};
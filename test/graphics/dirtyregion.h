@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyregion.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+public:
+	void test_single_rect() {
+		Graphics::DirtyRegion region(16);
+		region.setBounds(Common::Rect(100, 80));
+		TS_ASSERT(region.isEmpty());
+		TS_ASSERT(region.getRects().empty());
+
+		region.addRect(Common::Rect(10, 20, 50, 70));
+		TS_ASSERT(!region.isEmpty());
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(10, 20, 50, 70));
+
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+		TS_ASSERT(region.getRects().empty());
+	}
+
+	void test_clipping() {
+		Graphics::DirtyRegion region(16);
+		region.setBounds(Common::Rect(10, 10, 110, 90));
+
+		region.addRect(Common::Rect(0, 0, 5, 5));
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(100, 0, 200, 20));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(100, 10, 110, 20));
+	}
+
+	void test_merging() {
+		Graphics::DirtyRegion region(16);
+		region.setBounds(Common::Rect(100, 80));
+
+		// Overlapping and adjacent rects become one
+		region.addRect(Common::Rect(0, 0, 20, 20));
+		region.addRect(Common::Rect(10, 10, 30, 30));
+		region.addRect(Common::Rect(30, 0, 32, 30));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 32, 30));
+
+		// Distant ones do not
+		region.addRect(Common::Rect(70, 60, 75, 65));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		TS_ASSERT_EQUALS(region.getRects()[1], Common::Rect(70, 60, 75, 65));
+	}
+
+	void test_min_rect_height() {
+		Graphics::DirtyRegion region(16);
+		region.setBounds(Common::Rect(100, 80));
+		region.setMinRectHeight(4);
+
+		// The part in the second row of tiles is a single line
+		region.addRect(Common::Rect(0, 10, 20, 16));
+		region.addRect(Common::Rect(20, 16, 30, 17));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 10, 20, 16));
+		TS_ASSERT_EQUALS(region.getRects()[1], Common::Rect(20, 16, 30, 20));
+		region.clear();
+
+		// Rects at the bottom are grown upwards
+		region.addRect(Common::Rect(0, 78, 20, 80));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 76, 20, 80));
+	}
+
+	void test_coverage() {
+		const int kWidth = 100, kHeight = 80;
+		Graphics::DirtyRegion region(16);
+		region.setBounds(Common::Rect(kWidth, kHeight));
+
+		uint32 seed = 1;
+		for (int pass = 0; pass < 20; pass++) {
+			bool dirty[kHeight][kWidth];
+			memset(dirty, 0, sizeof(dirty));
+
+			region.clear();
+			for (int i = 0; i < pass * 3; i++) {
+				seed = seed * 1103515245 + 12345;
+				const int x = (seed >> 8) % (kWidth + 20) - 10;
+				const int y = (seed >> 16) % (kHeight + 20) - 10;
+				seed = seed * 1103515245 + 12345;
+				const int w = (seed >> 8) % 30 + 1;
+				const int h = (seed >> 16) % 30 + 1;
+
+				region.addRect(Common::Rect(x, y, x + w, y + h));
+				for (int py = MAX(y, 0); py < MIN(y + h, kHeight); py++) {
+					for (int px = MAX(x, 0); px < MIN(x + w, kWidth); px++) {
+						dirty[py][px] = true;
+					}
+				}
+			}
+
+			// Each dirty pixel is covered by exactly one rect, and each rect
+			// only covers tiles containing dirty pixels
+			int covered[kHeight][kWidth];
+			memset(covered, 0, sizeof(covered));
+			for (const auto &r : region.getRects()) {
+				TS_ASSERT(!r.isEmpty());
+				TS_ASSERT(Common::Rect(kWidth, kHeight).contains(r));
+				for (int py = r.top; py < r.bottom; py++) {
+					for (int px = r.left; px < r.right; px++) {
+						covered[py][px]++;
+					}
+				}
+			}
+
+			for (int py = 0; py < kHeight; py++) {
+				for (int px = 0; px < kWidth; px++) {
+					TS_ASSERT(covered[py][px] <= 1);
+					if (dirty[py][px])
+						TS_ASSERT_EQUALS(covered[py][px], 1);
+				}
+			}
+
+			for (int ty = 0; ty < kHeight; ty += 16) {
+				for (int tx = 0; tx < kWidth; tx += 16) {
+					bool tileDirty = false, tileCovered = false;
+					for (int py = ty; py < MIN(ty + 16, kHeight); py++) {
+						for (int px = tx; px < MIN(tx + 16, kWidth); px++) {
+							tileDirty |= dirty[py][px];
+							tileCovered |= covered[py][px] != 0;
+						}
+					}
+					TS_ASSERT(tileDirty || !tileCovered);
+				}
+			}
+		}
+	}
+};
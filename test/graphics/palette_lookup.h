@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/color_quantizer.h"
+#include "graphics/palette.h"
+#include "graphics/surface.h"
+
+class PaletteLookupTestSuite : public CxxTest::TestSuite {
+	uint32 _seed = 0;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+public:
+	void test_find_best_color() {
+		static const Graphics::ColorDistanceMethod methods[] = {
+			Graphics::kColorDistanceEuclidean,
+			Graphics::kColorDistanceNaive,
+			Graphics::kColorDistanceRedmean
+		};
+
+		for (int pass = 0; pass < 8; pass++) {
+			// Random palettes of different sizes, some of them with few
+			// distinct colors to get ties between entries
+			const uint size = (pass & 1) ? 256 : 7 + pass * 20;
+			const byte colorMask = (pass & 2) ? 0xC0 : 0xFF;
+
+			byte data[256 * 3];
+			for (uint i = 0; i < size * 3; i++)
+				data[i] = nextRandom() & colorMask;
+
+			Graphics::Palette palette(256);
+			palette.set(data, 0, size);
+
+			for (int m = 0; m < ARRAYSIZE(methods); m++) {
+				// The lookup caches colors regardless of the method
+				Graphics::PaletteLookup lookup(data, size);
+
+				for (int i = 0; i < 2000; i++) {
+					byte r = nextRandom(), g = nextRandom(), b = nextRandom();
+					if (i % 10 == 0) {
+						const uint entry = nextRandom() % size;
+						r = data[entry * 3 + 0];
+						g = data[entry * 3 + 1];
+						b = data[entry * 3 + 2];
+					}
+
+					TS_ASSERT_EQUALS(lookup.findBestColor(r, g, b, methods[m]), palette.findBestColor(r, g, b, methods[m]));
+				}
+			}
+		}
+	}
+
+	void test_set_palette() {
+		byte data[16 * 3];
+		for (int i = 0; i < 16 * 3; i++)
+			data[i] = i * 5;
+
+		Graphics::PaletteLookup lookup(data, 16);
+		TS_ASSERT_EQUALS(lookup.findBestColor(60, 65, 70), 4);
+
+		data[15 * 3 + 0] = 61;
+		data[15 * 3 + 1] = 64;
+		data[15 * 3 + 2] = 70;
+		TS_ASSERT(lookup.setPalette(data, 16));
+		TS_ASSERT_EQUALS(lookup.findBestColor(61, 64, 70), 15);
+		TS_ASSERT(!lookup.setPalette(data, 16));
+	}
+
+	void test_quantizer_add_surface() {
+		const int kWidth = 40, kHeight = 30;
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+
+		byte colors[kWidth * kHeight * 3];
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				// Runs of pixels with the same color
+				if (x % 5 == 0)
+					surface.setPixel(x, y, surface.format.RGBToColor(nextRandom(), nextRandom(), nextRandom()));
+				else
+					surface.setPixel(x, y, surface.getPixel(x - 1, y));
+
+				byte *color = colors + (y * kWidth + x) * 3;
+				surface.format.colorToRGB(surface.getPixel(x, y), color[0], color[1], color[2]);
+			}
+		}
+
+		Graphics::ColorQuantizer expectedQuantizer(16);
+		for (int i = 0; i < kWidth * kHeight; i++)
+			expectedQuantizer.addColor(colors[i * 3 + 0], colors[i * 3 + 1], colors[i * 3 + 2]);
+		Graphics::Palette *expected = expectedQuantizer.getPalette();
+
+		// A reused quantizer gives the same palette
+		Graphics::ColorQuantizer quantizer(16);
+		for (int i = 0; i < 100; i++)
+			quantizer.addColor(nextRandom(), nextRandom(), nextRandom());
+		quantizer.reset();
+
+		quantizer.addSurface(surface);
+		Graphics::Palette *actual = quantizer.getPalette();
+		TS_ASSERT_SAME_DATA(expected->data(), actual->data(), 16 * 3);
+		delete actual;
+
+		quantizer.reset();
+		quantizer.addColors(colors, kWidth * kHeight);
+		actual = quantizer.getPalette();
+		TS_ASSERT_SAME_DATA(expected->data(), actual->data(), 16 * 3);
+		delete actual;
+
+		delete expected;
+		surface.free();
+	}
+};
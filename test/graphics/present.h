@@ -0,0 +1,450 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/rect.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/blit.h"
+#include "graphics/dirtyregion.h"
+#include "graphics/scalerplugin.h"
+#include "graphics/surface.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/normal.h"
+#include "graphics/scaler/scalebit.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#ifdef USE_ASPECT
+#include "graphics/scaler/aspect.h"
+#endif
+#endif
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+#ifdef USE_SCALERS
+
+// A benchmark run by the test runner. It replays screen updates through the
+// steps SurfaceSdlGraphicsManager takes to present a frame, without SDL:
+// copying rects to the game screen, collecting and coalescing the dirty
+// rects, converting them to the screen format, scaling them, correcting the
+// aspect ratio and copying them to the window. Like the backend, the aspect
+// ratio of each rect is corrected right after scaling it, since the
+// coalesced rects may overlap.
+//
+// The updates follow synthetic patterns resembling typical games, not
+// traces recorded from real ones. The time taken by each step is reported as
+//
+//   present pattern=<name> scaler=<name> factor=<n> aspect=<0|1> stage=<name> ms_per_frame=<t> mpixels_per_s=<n>
+//
+// where the pixels are those the step processed, in its own coordinates.
+
+class PresentTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kWorldWidth = 640,
+		kWorldHeight = 400,
+		kFrames = 30
+	};
+
+	enum Pattern {
+		kPatternVideo,         // The whole screen changes every frame
+		kPatternScroll,        // A scrolling play field above a status bar
+		kPatternSprites,       // Sprites moving over a static background
+		kPatternText,          // Glyphs printed one after another
+		kPatternCount
+	};
+
+	enum Stage {
+		kStageCopy,            // copyRectToScreen() and addDirtyRect()
+		kStageDirty,           // Coalescing the dirty rects
+		kStageConvert,         // Converting the rects to the screen format
+		kStageScale,           // Scaling the rects and correcting their aspect ratio
+		kStageUpdate,          // Copying the scaled rects to the window
+		kStageCount
+	};
+
+	/** The rects copied to the game screen in a frame, and where from. */
+	struct Frame {
+		Common::Array<Common::Rect> rects;
+		Common::Array<Common::Point> sources;
+	};
+
+	/** The dirty rects of a frame, as they go through the stages. */
+	struct FrameState {
+		bool forceRedraw;
+		Common::Array<Common::Rect> dirtyRects;
+		Common::Array<Common::Rect> screenRects;
+	};
+
+	struct Pipeline {
+		Scaler *scaler;
+		int factor;
+		bool aspect;
+		int padding;
+		Graphics::PixelFormat format;
+
+		Graphics::Surface world;      ///< Where the game graphics come from
+		Graphics::Surface game;       ///< The CLUT8 game screen
+		Graphics::Surface tmp;        ///< The game screen in the screen format, with padding for the scaler
+		Graphics::Surface hw;         ///< The scaled screen
+		Graphics::Surface window;
+		byte palette[256 * 3];
+		Graphics::DirtyRegion dirtyRegion;
+		uint64 pixels[kStageCount];
+
+		Pipeline(Scaler *s, int extraPixels, int f, bool a) : scaler(s), factor(f), aspect(a), padding(extraPixels), dirtyRegion(20) {
+			format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+			scaler->setFactor(factor);
+
+			int hwHeight = kHeight * factor;
+#ifdef USE_ASPECT
+			if (aspect)
+				hwHeight = real2Aspect(hwHeight - 1) + 1;
+#endif
+
+			world.create(kWorldWidth, kWorldHeight, Graphics::PixelFormat::createFormatCLUT8());
+			game.create(kWidth, kHeight, Graphics::PixelFormat::createFormatCLUT8());
+			tmp.create(kWidth + 2 * padding, kHeight + 2 * padding, format);
+			hw.create(kWidth * factor, hwHeight, format);
+			window.create(kWidth * factor, hwHeight, format);
+
+			// Blocks of a few colors, with some noise in them
+			uint32 seed = 1;
+			for (int y = 0; y < kWorldHeight; y++) {
+				byte *row = (byte *)world.getBasePtr(0, y);
+				for (int x = 0; x < kWorldWidth; x++) {
+					seed = seed * 1103515245 + 12345;
+					row[x] = ((x / 24 + y / 16) * 37 + ((seed >> 16) % 23 == 0 ? (seed >> 24) : 0)) & 0xFF;
+				}
+			}
+			for (int i = 0; i < 256 * 3; i++)
+				palette[i] = (i * 97) & 0xFF;
+
+			for (int i = 0; i < kStageCount; i++)
+				pixels[i] = 0;
+
+			dirtyRegion.setMinRectHeight(4);
+		}
+
+		~Pipeline() {
+			world.free();
+			game.free();
+			tmp.free();
+			hw.free();
+			window.free();
+			delete scaler;
+		}
+
+		/** Same as SurfaceSdlGraphicsManager::addDirtyRect(), for the game screen. */
+		void addDirtyRect(FrameState &state, Common::Rect r) {
+			if (state.forceRedraw)
+				return;
+
+			// Aspect ratio correction requires this to be at least one
+			const int adjust = MAX(padding, 1);
+			int x = r.left - adjust, y = r.top - adjust;
+			int w = r.width() + adjust * 2, h = r.height() + adjust * 2;
+
+			if (x < 0) {
+				w += x;
+				x = 0;
+			}
+			if (y < 0) {
+				h += y;
+				y = 0;
+			}
+			w = MIN<int>(w, kWidth - x);
+			h = MIN<int>(h, kHeight - y);
+
+#ifdef USE_ASPECT
+			if (aspect)
+				makeRectStretchable(x, y, w, h, true);
+#endif
+
+			if (w == kWidth && h == kHeight) {
+				state.forceRedraw = true;
+				return;
+			}
+
+			if (w > 0 && h > 0)
+				state.dirtyRects.push_back(Common::Rect(x, y, x + w, y + h));
+		}
+
+		void runStage(Stage stage, const Frame &frame, FrameState &state) {
+			switch (stage) {
+			case kStageCopy:
+				state.forceRedraw = false;
+				state.dirtyRects.clear();
+				for (uint i = 0; i < frame.rects.size(); i++) {
+					const Common::Rect &r = frame.rects[i];
+					Graphics::copyBlit((byte *)game.getBasePtr(r.left, r.top), (const byte *)world.getBasePtr(frame.sources[i].x, frame.sources[i].y),
+					                   game.pitch, world.pitch, r.width(), r.height(), 1);
+					pixels[stage] += r.width() * r.height();
+					addDirtyRect(state, r);
+				}
+				break;
+
+			case kStageDirty:
+				state.screenRects.clear();
+				if (state.forceRedraw) {
+					state.screenRects.push_back(Common::Rect(kWidth, kHeight));
+				} else if (state.dirtyRects.size() > 1) {
+					const Common::Rect bounds(kWidth, kHeight);
+					if (dirtyRegion.getBounds() != bounds)
+						dirtyRegion.setBounds(bounds);
+					for (uint i = 0; i < state.dirtyRects.size(); i++)
+						dirtyRegion.addRect(state.dirtyRects[i]);
+					state.screenRects = dirtyRegion.getRects();
+					dirtyRegion.clear();
+#ifdef USE_ASPECT
+					if (aspect) {
+						for (uint i = 0; i < state.screenRects.size(); i++) {
+							Common::Rect &r = state.screenRects[i];
+							int x = r.left, y = r.top, w = r.width(), h = r.height();
+							makeRectStretchable(x, y, w, h, true);
+							r = Common::Rect(x, y, x + w, y + h);
+						}
+					}
+#endif
+				} else {
+					state.screenRects = state.dirtyRects;
+				}
+				for (uint i = 0; i < state.dirtyRects.size(); i++)
+					pixels[stage] += state.dirtyRects[i].width() * state.dirtyRects[i].height();
+				break;
+
+			case kStageConvert: {
+				uint32 map[256];
+				Graphics::convertPaletteToMapCached(map, palette, 256, format);
+				for (uint i = 0; i < state.screenRects.size(); i++) {
+					const Common::Rect &r = state.screenRects[i];
+					Graphics::crossBlitMap((byte *)tmp.getBasePtr(r.left + padding, r.top + padding), (const byte *)game.getBasePtr(r.left, r.top),
+					                       tmp.pitch, game.pitch, r.width(), r.height(), format.bytesPerPixel, map);
+					pixels[stage] += r.width() * r.height();
+				}
+				break;
+			}
+
+			case kStageScale:
+				for (uint i = 0; i < state.screenRects.size(); i++) {
+					const Common::Rect &r = state.screenRects[i];
+					const int origY = r.top * factor;
+					int dstY = origY;
+#ifdef USE_ASPECT
+					if (aspect)
+						dstY = real2Aspect(dstY);
+#endif
+					scaler->scale((const byte *)tmp.getBasePtr(r.left + padding, r.top + padding), tmp.pitch,
+					              (byte *)hw.getBasePtr(r.left * factor, dstY), hw.pitch, r.width(), r.height(), r.left, r.top);
+					pixels[stage] += r.width() * r.height() * factor * factor;
+
+#ifdef USE_ASPECT
+					if (aspect)
+						stretch200To240((uint8 *)hw.getPixels(), hw.pitch, r.width() * factor, r.height() * factor,
+						                r.left * factor, dstY, origY, true, format);
+#endif
+				}
+				break;
+
+			case kStageUpdate:
+				for (uint i = 0; i < state.screenRects.size(); i++) {
+					const Common::Rect &r = state.screenRects[i];
+					int top = r.top * factor, bottom = r.bottom * factor;
+#ifdef USE_ASPECT
+					if (aspect) {
+						top = real2Aspect(top);
+						bottom = real2Aspect(bottom - 1) + 1;
+					}
+#endif
+					Graphics::copyBlit((byte *)window.getBasePtr(r.left * factor, top), (const byte *)hw.getBasePtr(r.left * factor, top),
+					                   window.pitch, hw.pitch, r.width() * factor, bottom - top, format.bytesPerPixel);
+					pixels[stage] += r.width() * factor * (bottom - top);
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		void runFrame(const Frame &frame, FrameState &state, bool forceRedraw) {
+			runStage(kStageCopy, frame, state);
+			state.forceRedraw |= forceRedraw;
+			for (int stage = kStageDirty; stage < kStageCount; stage++)
+				runStage((Stage)stage, frame, state);
+		}
+	};
+
+	static const char *getPatternName(int pattern) {
+		static const char *const names[] = { "video", "scroll", "sprites", "text" };
+		return names[pattern];
+	}
+
+	static const char *getStageName(int stage) {
+		static const char *const names[] = { "copy", "dirty", "convert", "scale", "update" };
+		return names[stage];
+	}
+
+	void makeFrames(Pattern pattern, Common::Array<Frame> &frames) {
+		frames.resize(kFrames);
+		uint32 seed = pattern + 1;
+
+		for (int f = 0; f < kFrames; f++) {
+			Frame &frame = frames[f];
+			frame.rects.clear();
+			frame.sources.clear();
+
+			switch (pattern) {
+			case kPatternVideo:
+				frame.rects.push_back(Common::Rect(kWidth, kHeight));
+				frame.sources.push_back(Common::Point((f * 7) % (kWorldWidth - kWidth), (f * 5) % (kWorldHeight - kHeight)));
+				break;
+
+			case kPatternScroll:
+				frame.rects.push_back(Common::Rect(0, 16, kWidth, 160));
+				frame.sources.push_back(Common::Point(f * 4, 16));
+				if (f % 10 == 0) {
+					frame.rects.push_back(Common::Rect(0, 160, kWidth, kHeight));
+					frame.sources.push_back(Common::Point(f, 200));
+				}
+				break;
+
+			case kPatternSprites:
+				for (int i = 0; i < 24; i++) {
+					const int x = (i * 53 + f * (i % 5 + 1)) % (kWidth - 16);
+					const int y = (i * 31 + f * (i % 3 + 1)) % (kHeight - 24);
+					frame.rects.push_back(Common::Rect(x, y, x + 16, y + 24));
+					frame.sources.push_back(Common::Point(x + (f & 1) * 320, y));
+				}
+				break;
+
+			case kPatternText:
+				for (int i = 0; i < 40; i++) {
+					const int glyph = f * 40 + i;
+					const int x = (glyph % 38) * 8 + 8;
+					const int y = ((glyph / 38) % 20) * 9 + 10;
+					seed = seed * 1103515245 + 12345;
+					frame.rects.push_back(Common::Rect(x, y, x + 8, y + 8));
+					frame.sources.push_back(Common::Point((seed >> 16) % (kWorldWidth - 8), (seed >> 8) % (kWorldHeight - 8)));
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	void comparePresents(Scaler *scaler, Scaler *refScaler, int extraPixels, int factor, bool aspect, const char *name) {
+		Pipeline pipeline(scaler, extraPixels, factor, aspect);
+		Pipeline reference(refScaler, extraPixels, factor, aspect);
+
+		for (int p = 0; p < kPatternCount; p++) {
+			Common::Array<Frame> frames;
+			makeFrames((Pattern)p, frames);
+
+			for (int f = 0; f < kFrames; f++) {
+				// Like the backend, the whole screen is presented first,
+				// while the reference presents it every frame
+				FrameState state, refState;
+				pipeline.runFrame(frames[f], state, f == 0);
+				reference.runFrame(frames[f], refState, true);
+
+				if (memcmp(pipeline.window.getPixels(), reference.window.getPixels(), pipeline.window.h * pipeline.window.pitch) != 0) {
+					warning("%s %dx, aspect %d, pattern %s, frame %d", name, factor, aspect, getPatternName(p), f);
+					TS_FAIL("Presenting the dirty rects differs from presenting the whole screen");
+					break;
+				}
+			}
+		}
+	}
+
+	void benchmark(Scaler *scaler, int extraPixels, int factor, bool aspect, const char *name, int iters) {
+		Pipeline pipeline(scaler, extraPixels, factor, aspect);
+
+		for (int p = 0; p < kPatternCount; p++) {
+			Common::Array<Frame> frames;
+			Common::Array<FrameState> states;
+			makeFrames((Pattern)p, frames);
+			states.resize(kFrames);
+
+			for (int stage = 0; stage < kStageCount; stage++)
+				pipeline.pixels[stage] = 0;
+
+			// Each stage is timed on its own for all frames, since the
+			// frames are too quick to time one by one
+			uint32 total = 0;
+			for (int stage = 0; stage < kStageCount; stage++) {
+				const uint32 start = g_system->getMillis();
+				for (int i = 0; i < iters; i++) {
+					for (int f = 0; f < kFrames; f++)
+						pipeline.runStage((Stage)stage, frames[f], states[f]);
+				}
+				const uint32 time = g_system->getMillis() - start;
+				total += time;
+
+				debug("present pattern=%s scaler=%s factor=%d aspect=%d stage=%s ms_per_frame=%.3f mpixels_per_s=%.2f",
+				      getPatternName(p), name, factor, aspect, getStageName(stage), (double)time / (iters * kFrames),
+				      time ? pipeline.pixels[stage] / (time * 1000.0) : 0.0);
+			}
+
+			debug("present pattern=%s scaler=%s factor=%d aspect=%d stage=total ms_per_frame=%.3f",
+			      getPatternName(p), name, factor, aspect, (double)total / (iters * kFrames));
+		}
+	}
+
+public:
+	void test_dirty_rects() {
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		comparePresents(new NormalScaler(format), new NormalScaler(format), 0, 2, false, "Normal");
+		comparePresents(new AdvMameScaler(format), new AdvMameScaler(format), 4, 2, false, "AdvMame");
+#ifdef USE_ASPECT
+		// The dirty rects are aligned for aspect ratio correction in game
+		// coordinates, so the first line of a scaled rect can be blended
+		// with the previous frame. That does not show when the scaler
+		// doubles the lines.
+		comparePresents(new NormalScaler(format), new NormalScaler(format), 0, 2, true, "Normal");
+		comparePresents(new AdvMameScaler(format), new AdvMameScaler(format), 4, 3, false, "AdvMame");
+#endif
+#ifdef USE_HQ_SCALERS
+		comparePresents(new HQScaler(format), new HQScaler(format), 1, 2, false, "HQ");
+#endif
+	}
+
+	void test_present_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 20;
+#else
+		const int iters = 1;
+#endif
+
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		benchmark(new NormalScaler(format), 0, 1, false, "Normal", iters);
+		benchmark(new NormalScaler(format), 0, 2, false, "Normal", iters);
+#ifdef USE_ASPECT
+		benchmark(new NormalScaler(format), 0, 2, true, "Normal", iters);
+#endif
+		benchmark(new AdvMameScaler(format), 4, 3, false, "AdvMame", iters);
+#ifdef USE_HQ_SCALERS
+		benchmark(new HQScaler(format), 1, 2, false, "HQ", iters);
+#endif
+#endif
+	}
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/textconsole.h"
+
+#include "graphics/scalerplugin.h"
+#include "graphics/scaler/normal.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/pm.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#endif
+
+// scales the same rects in one piece and in bands, which has to give the same output
+
+class ScalerBandsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 48,
+		kHeight = 37,
+		kPadding = 4,  // The largest extraPixels() of the scalers
+		kMaxFactor = 5
+	};
+
+	void compareBands(Scaler *scaler, const Graphics::PixelFormat &format, uint factor, const char *name) {
+		TS_ASSERT(scaler->canScaleInBands());
+		scaler->setFactor(factor);
+
+		const int bpp = format.bytesPerPixel;
+		const uint32 srcPitch = (kWidth + 2 * kPadding) * bpp;
+		const uint32 dstPitch = kWidth * kMaxFactor * bpp;
+
+		byte *src = new byte[srcPitch * (kHeight + 2 * kPadding)];
+		byte *expected = new byte[dstPitch * kHeight * kMaxFactor];
+		byte *actual = new byte[dstPitch * kHeight * kMaxFactor];
+
+		// Blocks of a few colors, so the scalers find edges to work on
+		uint32 seed = 1;
+		for (int y = 0; y < kHeight + 2 * kPadding; y++) {
+			for (uint32 i = 0; i < srcPitch; i++) {
+				seed = seed * 1103515245 + 12345;
+				src[y * srcPitch + i] = ((seed >> 16) & 3) ? src[(y ? y - 1 : 0) * srcPitch + i] : (seed >> 24) & 0xC3;
+			}
+		}
+
+		// The whole surface and a dirty rect inside of it
+		static const int rects[][4] = {
+			{ 0, 0, kWidth, kHeight },
+			{ 8, 3, 32, 29 }
+		};
+		static const int bandHeights[] = { 4, 5, 16 };
+
+		for (int r = 0; r < ARRAYSIZE(rects); r++) {
+			const int x = rects[r][0], y = rects[r][1], w = rects[r][2], h = rects[r][3];
+			const byte *srcPtr = src + (kPadding + y) * srcPitch + (kPadding + x) * bpp;
+
+			memset(expected, 0, dstPitch * kHeight * kMaxFactor);
+			scaler->setBandHeight(0);
+			scaler->scale(srcPtr, srcPitch, expected, dstPitch, w, h, x, y);
+
+			for (int b = 0; b < ARRAYSIZE(bandHeights); b++) {
+				memset(actual, 0, dstPitch * kHeight * kMaxFactor);
+				scaler->setBandHeight(bandHeights[b]);
+				scaler->scale(srcPtr, srcPitch, actual, dstPitch, w, h, x, y);
+
+				if (memcmp(actual, expected, dstPitch * kHeight * kMaxFactor) != 0) {
+					warning("%s %dx, %d bpp, rect %d, band height %d", name, factor, bpp * 8, r, bandHeights[b]);
+					TS_FAIL("Scaling in bands differs from scaling in one piece");
+				}
+			}
+		}
+
+		delete[] src;
+		delete[] expected;
+		delete[] actual;
+		delete scaler;
+	}
+
+	template<class T>
+	void compareFormats(uint factor, const char *name) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat::createFormatARGB32()
+		};
+		for (int f = 0; f < ARRAYSIZE(formats); f++)
+			compareBands(new T(formats[f]), formats[f], factor, name);
+	}
+
+public:
+	void test_normal() {
+#ifdef USE_SCALERS
+		for (uint factor = 2; factor <= 5; factor++)
+			compareFormats<NormalScaler>(factor, "Normal");
+#endif
+	}
+
+	void test_hq() {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+		compareFormats<HQScaler>(2, "HQ");
+		compareFormats<HQScaler>(3, "HQ");
+#endif
+	}
+
+	void test_advmame() {
+#ifdef USE_SCALERS
+		for (uint factor = 2; factor <= 4; factor++)
+			compareFormats<AdvMameScaler>(factor, "AdvMame");
+#endif
+	}
+
+	void test_others() {
+#ifdef USE_SCALERS
+		compareFormats<SAIScaler>(2, "SAI");
+		compareFormats<SuperSAIScaler>(2, "SuperSAI");
+		compareFormats<SuperEagleScaler>(2, "SuperEagle");
+		compareFormats<PMScaler>(2, "PM");
+		compareFormats<TVScaler>(2, "TV");
+		compareFormats<DotMatrixScaler>(2, "DotMatrix");
+#endif
+	}
+};
@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_TINYGL
+
+#include "common/rect.h"
+
+#include "graphics/tinygl/tinygl.h"
+
+// renders the same triangles with and without a scissor box, and checks
+// that clipping keeps exactly the pixels within the box
+
+class TinyGLClippingTestSuite : public CxxTest::TestSuite {
+	uint32 _seed = 0;
+
+	float nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) / (float)(1 << 24);
+	}
+
+	// draws overlapping triangles, partly outside of the screen, with and
+	// without blending
+	byte *render(int w, int h, const Common::Rect *scissor, int numTriangles) {
+		TinyGL::ContextHandle *context = TinyGL::createContext(w, h, Graphics::PixelFormat::createFormatARGB32(), 256, true, false);
+		TinyGL::setContext(context);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglViewport(0, 0, w, h);
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClearDepth(1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		if (scissor) {
+			// the scissor box starts at the bottom of the screen
+			tglScissor(scissor->left, h - scissor->bottom, scissor->width(), scissor->height());
+			tglEnable(TGL_SCISSOR_TEST);
+		}
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+		_seed = 1;
+		for (int i = 0; i < numTriangles; i++) {
+			if (i & 1)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+
+			const float x = nextRandom() * 2.4f - 1.2f;
+			const float y = nextRandom() * 2.4f - 1.2f;
+			const float size = nextRandom() * 0.8f;
+
+			tglBegin(TGL_TRIANGLES);
+			for (int j = 0; j < 3; j++) {
+				tglColor4f(nextRandom(), nextRandom(), nextRandom(), 0.5f);
+				tglVertex3f(x + (nextRandom() - 0.5f) * size, y + (nextRandom() - 0.5f) * size, nextRandom() * 2.0f - 1.0f);
+			}
+			tglEnd();
+		}
+
+		TinyGL::presentBuffer();
+
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		byte *pixels = new byte[surface.h * surface.pitch];
+		memcpy(pixels, surface.getPixels(), surface.h * surface.pitch);
+
+		TinyGL::destroyContext(context);
+		return pixels;
+	}
+
+public:
+	void testScissor() {
+		const int kWidth = 160, kHeight = 120;
+		static const Common::Rect scissors[] = {
+			Common::Rect(0, 0, kWidth, kHeight),
+			Common::Rect(0, 0, kWidth, 1),
+			Common::Rect(0, kHeight - 7, kWidth, kHeight),
+			Common::Rect(30, 20, 31, 100),
+			Common::Rect(13, 41, 97, 73),
+			Common::Rect(150, 110, 160, 120)
+		};
+
+		byte *expected = render(kWidth, kHeight, nullptr, 200);
+		byte *background = render(kWidth, kHeight, nullptr, 0);
+
+		for (int i = 0; i < ARRAYSIZE(scissors); i++) {
+			byte *actual = render(kWidth, kHeight, &scissors[i], 200);
+
+			int wrongPixels = 0;
+			for (int y = 0; y < kHeight; y++) {
+				for (int x = 0; x < kWidth; x++) {
+					const int offset = (y * kWidth + x) * 4;
+					const byte *reference = scissors[i].contains(x, y) ? expected : background;
+					if (memcmp(actual + offset, reference + offset, 4) != 0)
+						wrongPixels++;
+				}
+			}
+			TS_ASSERT_EQUALS(wrongPixels, 0);
+
+			delete[] actual;
+		}
+
+		delete[] expected;
+		delete[] background;
+	}
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_TINYGL
+
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "test/instrset_detect.h"
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+// renders the same frames pixel by pixel and with the span kernels, and compares the results
+
+class TinyGLSpansTestSuite : public CxxTest::TestSuite {
+	TGLuint _texture = 0;
+	uint32 _seed = 0;
+
+	float nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) / (float)(1 << 24);
+	}
+
+	void setupContext(int w, int h, const Graphics::PixelFormat &format) {
+		TinyGL::createContext(w, h, format, 256, true, false);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1.0, 1.0, -1.0, 1.0, 1.0, 10.0);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglViewport(0, 0, w, h);
+
+		byte pixels[32 * 32 * 4];
+		for (int y = 0; y < 32; y++) {
+			for (int x = 0; x < 32; x++) {
+				byte *pixel = pixels + (y * 32 + x) * 4;
+				pixel[0] = x * 8;
+				pixel[1] = y * 8;
+				pixel[2] = (x ^ y) * 8;
+				pixel[3] = (x + y) * 4 + 3;
+			}
+		}
+		tglGenTextures(1, &_texture);
+		tglBindTexture(TGL_TEXTURE_2D, _texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_NEAREST);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_NEAREST);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 32, 32, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, pixels);
+	}
+
+	void destroyTestContext() {
+		tglDeleteTextures(1, &_texture);
+		TinyGL::destroyContext();
+	}
+
+	// draws overlapping triangles, partly outside of the screen, switching
+	// between the states handled by the span kernels and a few which are not
+	void drawFrame(int frame, int w, int h, int numTriangles, uint32 stateMask, uint32 fixedStates) {
+		_seed = frame + 1;
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 0.4f);
+		tglClearDepth(1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglDepthFunc(TGL_LESS);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+		for (int i = 0; i < numTriangles; i++) {
+			const uint32 states = ((uint32)(nextRandom() * (1 << 16)) & stateMask) | fixedStates;
+
+			if (states & 1)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+			if (states & 2)
+				tglEnable(TGL_TEXTURE_2D);
+			else
+				tglDisable(TGL_TEXTURE_2D);
+			tglShadeModel(states & 4 ? TGL_FLAT : TGL_SMOOTH);
+			tglDepthMask(states & 8 ? TGL_FALSE : TGL_TRUE);
+
+			if (states & 0x10)
+				tglDisable(TGL_DEPTH_TEST);
+			else
+				tglEnable(TGL_DEPTH_TEST);
+			static const TGLenum depthFuncs[] = { TGL_LESS, TGL_LEQUAL, TGL_LESS, TGL_GREATER };
+			tglDepthFunc(depthFuncs[(states >> 5) & 3]);
+
+			if ((states & 0x380) == 0x380)
+				tglBlendFunc(TGL_ONE, TGL_ONE);
+			else
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+			if ((states & 0x1C00) == 0x1C00) {
+				tglEnable(TGL_SCISSOR_TEST);
+				tglScissor(w / 8, h / 4, w / 2, h / 3);
+			} else {
+				tglDisable(TGL_SCISSOR_TEST);
+			}
+
+			const float x = nextRandom() * 2.4f - 1.2f;
+			const float y = nextRandom() * 2.4f - 1.2f;
+			const float size = nextRandom();
+
+			tglBegin(TGL_TRIANGLES);
+			for (int j = 0; j < 3; j++) {
+				const float z = 1.5f + nextRandom() * 7.0f;
+				tglColor4f(nextRandom(), nextRandom(), nextRandom(), nextRandom());
+				tglTexCoord2f(nextRandom() * 2.0f, nextRandom() * 2.0f);
+				tglVertex3f((x + (nextRandom() - 0.5f) * size) * z, (y + (nextRandom() - 0.5f) * size) * z, -z);
+			}
+			tglEnd();
+		}
+
+		tglDisable(TGL_SCISSOR_TEST);
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_BLEND);
+		tglDepthMask(TGL_TRUE);
+	}
+
+	const TinyGL::SpanKernels::Funcs &getBestFuncs() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			return TinyGL::SpanKernels::funcsAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			return TinyGL::SpanKernels::funcsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+		return TinyGL::SpanKernels::funcsNEON;
+#endif
+		return TinyGL::SpanKernels::funcsGeneric;
+	}
+
+	void compareFuncs(const TinyGL::SpanKernels::Funcs &funcs, const char *name) {
+		const int kWidth = 160, kHeight = 120, kFrames = 4;
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32(),
+			Graphics::PixelFormat::createFormatBGRA32(),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)
+		};
+
+		Graphics::Surface surface;
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			for (int frame = 0; frame < kFrames; frame++) {
+				const uint32 stateMask = frame ? 0xFFFF : 0;
+
+				TinyGL::SpanKernels::selectedFuncs = &TinyGL::SpanKernels::funcsNone;
+				setupContext(kWidth, kHeight, formats[f]);
+				drawFrame(frame, kWidth, kHeight, 200, stateMask, 0);
+				TinyGL::presentBuffer();
+				TinyGL::getSurfaceRef(surface);
+				byte *expected = new byte[surface.h * surface.pitch];
+				memcpy(expected, surface.getPixels(), surface.h * surface.pitch);
+				destroyTestContext();
+
+				TinyGL::SpanKernels::selectedFuncs = &funcs;
+				setupContext(kWidth, kHeight, formats[f]);
+				drawFrame(frame, kWidth, kHeight, 200, stateMask, 0);
+				TinyGL::presentBuffer();
+				TinyGL::getSurfaceRef(surface);
+				if (memcmp(surface.getPixels(), expected, surface.h * surface.pitch) != 0) {
+					warning("%s: format %s, frame %d", name, formats[f].toString().c_str(), frame);
+					TS_FAIL("Span kernel output differs from drawing pixel by pixel");
+				}
+				destroyTestContext();
+
+				delete[] expected;
+			}
+		}
+	}
+
+public:
+	void testGenericSpans() {
+		compareFuncs(TinyGL::SpanKernels::funcsGeneric, "Generic");
+	}
+
+	void testSIMDSpans() {
+#ifdef SCUMMVM_NEON
+		compareFuncs(TinyGL::SpanKernels::funcsNEON, "NEON");
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareFuncs(TinyGL::SpanKernels::funcsSSE2, "SSE2");
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareFuncs(TinyGL::SpanKernels::funcsAVX2, "AVX2");
+#endif
+	}
+
+	void testSpansSpeed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 50;
+#else
+		const int iters = 1;
+#endif
+
+		for (int textured = 0; textured < 2; textured++) {
+			for (int pass = 0; pass < 2; pass++) {
+				TinyGL::SpanKernels::selectedFuncs = pass ? &getBestFuncs() : &TinyGL::SpanKernels::funcsNone;
+				setupContext(640, 480, Graphics::PixelFormat::createFormatARGB32());
+
+				uint32 start = g_system->getMillis();
+				for (int frame = 0; frame < iters; frame++) {
+					drawFrame(frame, 640, 480, 2000, 0, textured ? 2 : 0);
+					TinyGL::presentBuffer();
+				}
+				double time = g_system->getMillis() - start;
+				destroyTestContext();
+
+				debug("TinyGL %s frame time %s (in milliseconds): %f", textured ? "textured" : "untextured",
+				      pass ? "with span kernels" : "pixel by pixel", time / iters);
+			}
+		}
+#endif
+	}
+};
+
+#endif
@@ -0,0 +1,212 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "test/instrset_detect.h"
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+// converts the same images with the lookup tables and with the row kernels,
+// which have to produce exactly the same pixels
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	enum Layout {
+		k444,
+		k422,
+		k420,
+		k410
+	};
+
+	uint32 _seed = 0;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	void fillPlane(byte *plane, int size) {
+		for (int i = 0; i < size; i++)
+			plane[i] = nextRandom();
+	}
+
+	void convert(Layout layout, Graphics::Surface *dst, Graphics::YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+		switch (layout) {
+		case k444:
+			YUVToRGBMan.convert444(dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+			break;
+		case k422:
+			YUVToRGBMan.convert422(dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+			break;
+		}
+	}
+
+	const Graphics::YUVToRGBKernels::Funcs &getBestFuncs() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			return Graphics::YUVToRGBKernels::funcsAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			return Graphics::YUVToRGBKernels::funcsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+		return Graphics::YUVToRGBKernels::funcsNEON;
+#endif
+		return Graphics::YUVToRGBKernels::funcsGeneric;
+	}
+
+	void compareFuncs(const Graphics::YUVToRGBKernels::Funcs &funcs, const char *name) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32(),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15)
+		};
+		// Widths which leave remaining pixels for the generic kernel, and
+		// one spanning more than a single chunk of interpolated YUV410 chroma
+		static const int sizes[][2] = {
+			{ 36, 20 },
+			{ 100, 8 },
+			{ 300, 4 }
+		};
+		static const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull,
+			Graphics::YUVToRGBManager::kScaleITU
+		};
+
+		for (int s = 0; s < ARRAYSIZE(sizes); s++) {
+			const int yWidth = sizes[s][0], yHeight = sizes[s][1];
+			const int yPitch = yWidth + 5;
+			// Large enough for all layouts, YUV410 needs an extra row and column
+			const int uvPitch = yWidth + 3;
+
+			byte *yPlane = new byte[yPitch * yHeight];
+			byte *uPlane = new byte[uvPitch * yHeight];
+			byte *vPlane = new byte[uvPitch * yHeight];
+			_seed = s + 1;
+			fillPlane(yPlane, yPitch * yHeight);
+			fillPlane(uPlane, uvPitch * yHeight);
+			fillPlane(vPlane, uvPitch * yHeight);
+			// Include the extremes of each plane
+			yPlane[0] = uPlane[0] = vPlane[1] = 0;
+			yPlane[1] = uPlane[1] = vPlane[0] = 255;
+
+			for (int f = 0; f < ARRAYSIZE(formats); f++) {
+				Graphics::Surface expected, actual;
+				expected.create(yWidth, yHeight, formats[f]);
+				actual.create(yWidth, yHeight, formats[f]);
+
+				for (int sc = 0; sc < ARRAYSIZE(scales); sc++) {
+					for (int l = k444; l <= k410; l++) {
+						Graphics::YUVToRGBKernels::selectedFuncs = &Graphics::YUVToRGBKernels::funcsNone;
+						convert((Layout)l, &expected, scales[sc], yPlane, uPlane, vPlane, yWidth, yHeight, yPitch, uvPitch);
+
+						Graphics::YUVToRGBKernels::selectedFuncs = &funcs;
+						convert((Layout)l, &actual, scales[sc], yPlane, uPlane, vPlane, yWidth, yHeight, yPitch, uvPitch);
+
+						if (memcmp(actual.getPixels(), expected.getPixels(), actual.h * actual.pitch) != 0) {
+							warning("%s: format %s, size %dx%d, scale %d, layout %d", name, formats[f].toString().c_str(), yWidth, yHeight, sc, l);
+							TS_FAIL("Row kernel output differs from the lookup tables");
+						}
+					}
+				}
+
+				expected.free();
+				actual.free();
+			}
+
+			delete[] yPlane;
+			delete[] uPlane;
+			delete[] vPlane;
+		}
+	}
+
+public:
+	void test_chroma_coefficients() {
+		// Same as the chroma tables of the lookup tables
+		for (int i = 0; i < 256; i++) {
+			const int16 cr = i - 128;
+			TS_ASSERT_EQUALS(Graphics::YUVToRGBKernels::chromaTerm(i, Graphics::YUVToRGBKernels::kCrToR), (int16)((0.419 / 0.299) * cr));
+			TS_ASSERT_EQUALS(-Graphics::YUVToRGBKernels::chromaTerm(i, Graphics::YUVToRGBKernels::kCrToG), (int16)(-(0.299 / 0.419) * cr));
+			TS_ASSERT_EQUALS(-Graphics::YUVToRGBKernels::chromaTerm(i, Graphics::YUVToRGBKernels::kCbToG), (int16)(-(0.114 / 0.331) * cr));
+			TS_ASSERT_EQUALS(Graphics::YUVToRGBKernels::chromaTerm(i, Graphics::YUVToRGBKernels::kCbToB), (int16)((0.587 / 0.331) * cr));
+		}
+		for (int i = 16; i < 236; i++)
+			TS_ASSERT_EQUALS(Graphics::YUVToRGBKernels::clampComponent(i, true), (uint)((i - 16) * 255 / 219));
+	}
+
+	void test_generic_kernels() {
+		compareFuncs(Graphics::YUVToRGBKernels::funcsGeneric, "Generic");
+	}
+
+	void test_simd_kernels() {
+#ifdef SCUMMVM_NEON
+		compareFuncs(Graphics::YUVToRGBKernels::funcsNEON, "NEON");
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareFuncs(Graphics::YUVToRGBKernels::funcsSSE2, "SSE2");
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareFuncs(Graphics::YUVToRGBKernels::funcsAVX2, "AVX2");
+#endif
+	}
+
+	void test_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+
+		const int yWidth = 1920, yHeight = 1080;
+		byte *yPlane = new byte[yWidth * yHeight];
+		byte *uPlane = new byte[yWidth * yHeight / 4];
+		byte *vPlane = new byte[yWidth * yHeight / 4];
+		_seed = 1;
+		fillPlane(yPlane, yWidth * yHeight);
+		fillPlane(uPlane, yWidth * yHeight / 4);
+		fillPlane(vPlane, yWidth * yHeight / 4);
+
+		Graphics::Surface surface;
+		surface.create(yWidth, yHeight, Graphics::PixelFormat::createFormatARGB32());
+
+		for (int pass = 0; pass < 2; pass++) {
+			Graphics::YUVToRGBKernels::selectedFuncs = pass ? &getBestFuncs() : &Graphics::YUVToRGBKernels::funcsNone;
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, yPlane, uPlane, vPlane, yWidth, yHeight, yWidth, yWidth / 2);
+			double time = g_system->getMillis() - start;
+
+			debug("1080p YUV420 conversion time %s (in milliseconds): %f", pass ? "with row kernels" : "with lookup tables", time / iters);
+		}
+
+		surface.free();
+		delete[] yPlane;
+		delete[] uPlane;
+		delete[] vPlane;
+#endif
+	}
+};
@@ -1012,4 +1012,141 @@ public:
 		(void)areSurfacesEqual;
 #endif
 	}
+
+private:
+	// Sprites from a few source surfaces, overlapping each other, some of
+	// them scaled, flipped or partly outside of the destination
+	static void makeSprites(Common::Array<Graphics::BlendBlitSprite> &sprites, const Graphics::ManagedSurface *sources, int numSources,
+	                        int count, int destW, int destH, bool varyModes) {
+		uint32 seed = 1;
+		sprites.clear();
+		for (int i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			const Graphics::ManagedSurface &src = sources[(seed >> 16) % numSources];
+			const int sw = (seed >> 8) % src.w + 1, sh = (seed >> 20) % src.h + 1;
+			seed = seed * 1103515245 + 12345;
+			const int sx = (seed >> 8) % (src.w - sw + 1), sy = (seed >> 16) % (src.h - sh + 1);
+			const bool scaled = varyModes && (seed >> 24) % 4 == 0;
+			const int dw = scaled ? sw * 3 / 2 + 1 : sw, dh = scaled ? sh * 2 / 3 + 1 : sh;
+			seed = seed * 1103515245 + 12345;
+			const int dx = (seed >> 8) % (destW + dw) - dw / 2 - 4, dy = (seed >> 16) % (destH + dh) - dh / 2 - 4;
+
+			Graphics::BlendBlitSprite sprite(src, Common::Rect(sx, sy, sx + sw, sy + sh), Common::Rect(dx, dy, dx + dw, dy + dh));
+			if (varyModes) {
+				seed = seed * 1103515245 + 12345;
+				sprite.flipping = (seed >> 8) & 3;
+				sprite.blend = (Graphics::TSpriteBlendMode)((seed >> 12) % Graphics::NUM_BLEND_MODES);
+				sprite.alphaType = (Graphics::AlphaType)((seed >> 16) % (Graphics::ALPHA_FULL + 1));
+				sprite.colorMod = (seed >> 20) % 3 == 0 ? MS_ARGB((seed >> 8) & 0xFF, 255, (seed >> 16) & 0xFF, 128) : MS_ARGB(255, 255, 255, 255);
+			}
+			sprites.push_back(sprite);
+		}
+	}
+
+	static void makeSpriteSources(Graphics::ManagedSurface *sources, int numSources) {
+		for (int i = 0; i < numSources; i++) {
+			sources[i].create(24 + i * 8, 20 + i * 4, Graphics::BlendBlit::getSupportedPixelFormat());
+			for (int y = 0; y < sources[i].h; y++) {
+				for (int x = 0; x < sources[i].w; x++) {
+					const int c = x / 3 + y / 5 + i;
+					sources[i].setPixel(x, y, sources[i].format.ARGBToColor((c & 3) * 85, (c & 1) * 255, (c & 2) * 127, (c & 4) * 63));
+				}
+			}
+		}
+	}
+
+public:
+	void test_blend_batch() {
+		const int kSources = 3;
+		Graphics::ManagedSurface sources[kSources];
+		makeSpriteSources(sources, kSources);
+
+		Graphics::BlendBlit::BlitFunc funcs[] = {
+			Graphics::BlendBlit::blitGeneric,
+#ifdef SCUMMVM_NEON
+			Graphics::BlendBlit::blitNEON,
+#endif
+#ifdef SCUMMVM_SSE2
+			instrset_detect() >= 2 ? Graphics::BlendBlit::blitSSE2 : Graphics::BlendBlit::blitGeneric,
+#endif
+#ifdef SCUMMVM_AVX2
+			instrset_detect() >= 8 ? Graphics::BlendBlit::blitAVX2 : Graphics::BlendBlit::blitGeneric,
+#endif
+		};
+
+		Common::Array<Graphics::BlendBlitSprite> sprites;
+		Graphics::ManagedSurface expected, batched;
+		expected.create(96, 80, Graphics::BlendBlit::getSupportedPixelFormat());
+		batched.create(96, 80, Graphics::BlendBlit::getSupportedPixelFormat());
+
+		for (int f = 0; f < ARRAYSIZE(funcs); f++) {
+			Graphics::BlendBlit::blitFunc = funcs[f];
+
+			for (int varyModes = 0; varyModes < 2; varyModes++) {
+				makeSprites(sprites, sources, kSources, 300, expected.w, expected.h, varyModes);
+
+				expected.fillRect(Common::Rect(expected.w, expected.h), expected.format.ARGBToColor(255, 40, 80, 120));
+				for (uint i = 0; i < sprites.size(); i++) {
+					const Graphics::BlendBlitSprite &sprite = sprites[i];
+					expected.blendBlitFrom(*sprite.src, sprite.srcRect, sprite.destRect, sprite.flipping, sprite.colorMod, sprite.blend, sprite.alphaType);
+				}
+
+				batched.fillRect(Common::Rect(batched.w, batched.h), batched.format.ARGBToColor(255, 40, 80, 120));
+				batched.blendBlitBatch(sprites);
+
+				if (!areSurfacesEqual(&expected, &batched)) {
+					warning("blitFunc %d, varyModes %d", f, varyModes);
+					TS_FAIL("Drawing a batch of sprites differs from drawing them one by one");
+				}
+			}
+		}
+
+		for (int i = 0; i < kSources; i++)
+			sources[i].free();
+		expected.free();
+		batched.free();
+	}
+
+	void test_blend_batch_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+
+		const int kSources = 3;
+		Graphics::ManagedSurface sources[kSources];
+		makeSpriteSources(sources, kSources);
+
+		Common::Array<Graphics::BlendBlitSprite> sprites;
+		makeSprites(sprites, sources, kSources, 500, 640, 480, false);
+
+		Graphics::ManagedSurface dest;
+		dest.create(640, 480, Graphics::BlendBlit::getSupportedPixelFormat());
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			for (uint j = 0; j < sprites.size(); j++) {
+				const Graphics::BlendBlitSprite &sprite = sprites[j];
+				dest.blendBlitFrom(*sprite.src, sprite.srcRect, sprite.destRect, sprite.flipping, sprite.colorMod, sprite.blend, sprite.alphaType);
+			}
+		}
+		const double oneByOneTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (int i = 0; i < iters; i++)
+			dest.blendBlitBatch(sprites);
+		const double batchTime = g_system->getMillis() - start;
+
+		debug("ManagedSurface::blendBlitFrom for %d sprites avg time (in milliseconds): %f", sprites.size(), oneByOneTime / iters);
+		debug("ManagedSurface::blendBlitBatch for %d sprites avg time (in milliseconds): %f", sprites.size(), batchTime / iters);
+
+		for (int i = 0; i < kSources; i++)
+			sources[i].free();
+		dest.free();
+#endif
+	}
 };
@@ -0,0 +1,276 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/util.h"
+#include "image/codecs/dsp.h"
+
+#include "test/instrset_detect.h"
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class CodecDSPTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint nextRandom(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 16) & 0x7FFF) % max;
+	}
+
+	int16 nextSample(int range) {
+		return (int16)((int)nextRandom(2 * range) - range);
+	}
+
+	const Image::CodecDSP::Funcs &getBestFuncs() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			return Image::CodecDSP::funcsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+		return Image::CodecDSP::funcsNEON;
+#endif
+		return Image::CodecDSP::funcsGeneric;
+	}
+
+	/** Run the SVQ1 half-pel copies on random blocks, and compare with the generic kernels. */
+	void comparePixels(const Image::CodecDSP::Funcs &funcs, const char *name) {
+		const Image::CodecDSP::Funcs &generic = Image::CodecDSP::funcsGeneric;
+		// An odd pitch, so that the blocks are not aligned
+		const int pitch = 43;
+		byte src[pitch * 24], expected[pitch * 24], actual[pitch * 24];
+
+		_seed = 1;
+		for (int iter = 0; iter < 200; iter++) {
+			for (uint i = 0; i < sizeof(src); i++)
+				src[i] = nextRandom(256);
+
+			const int h = (iter & 1) ? 16 : 2 * (nextRandom(8) + 1);
+			const int srcOffset = nextRandom(pitch - 17 + 1) + pitch * nextRandom(24 - 17 + 1);
+
+			for (int kernel = 0; kernel < 8; kernel++) {
+				memset(expected, 0xAA, sizeof(expected));
+				memset(actual, 0xAA, sizeof(actual));
+
+				if (kernel < 4) {
+					generic.putPixels8[kernel](expected + 1, src + srcOffset, pitch, h);
+					funcs.putPixels8[kernel](actual + 1, src + srcOffset, pitch, h);
+				} else {
+					generic.putPixels16[kernel - 4](expected + 1, src + srcOffset, pitch, h);
+					funcs.putPixels16[kernel - 4](actual + 1, src + srcOffset, pitch, h);
+				}
+
+				if (memcmp(actual, expected, sizeof(expected)) != 0)
+					TS_FAIL(Common::String::format("%s: putPixels%d[%d] differs from the generic one for block %d", name, kernel < 4 ? 8 : 16, kernel & 3, iter).c_str());
+			}
+		}
+	}
+
+	/** Run the Indeo kernels on random blocks, and compare with the generic kernels. */
+	void compareIndeo(const Image::CodecDSP::Funcs &funcs, const char *name) {
+		const Image::CodecDSP::Funcs &generic = Image::CodecDSP::funcsGeneric;
+		const uint32 pitch = 21;
+		int16 ref1[pitch * 10], ref2[pitch * 10], start[pitch * 10];
+		int16 expected[pitch * 10], actual[pitch * 10];
+		int32 coeffs[64];
+		uint8 flags[8];
+
+		_seed = 1;
+		for (int iter = 0; iter < 500; iter++) {
+			for (uint i = 0; i < ARRAYSIZE(ref1); i++) {
+				ref1[i] = nextSample(4096);
+				ref2[i] = nextSample(4096);
+				start[i] = nextSample(4096);
+			}
+
+			// Sparse and dense coefficients, with flags not always matching
+			// the empty columns
+			const uint32 density = (iter % 3 == 0) ? 1 : ((iter % 3 == 1) ? 8 : 64);
+			for (int i = 0; i < 64; i++)
+				coeffs[i] = (nextRandom(64) < density) ? nextSample(2048) : 0;
+			for (int i = 0; i < 8; i++) {
+				flags[i] = 0;
+				for (int k = 0; k < 8; k++)
+					flags[i] |= coeffs[k * 8 + i] != 0;
+				if (iter % 5 == 0)
+					flags[i] = nextRandom(2);
+			}
+
+			const int mcType1 = nextRandom(4), mcType2 = nextRandom(4);
+
+			for (int kernel = 0; kernel < 6; kernel++) {
+				memcpy(expected, start, sizeof(start));
+				memcpy(actual, start, sizeof(start));
+
+				for (int pass = 0; pass < 2; pass++) {
+					const Image::CodecDSP::Funcs &f = pass ? funcs : generic;
+					int16 *dest = (pass ? actual : expected) + 1;
+
+					switch (kernel) {
+					case 0:
+						f.mcPut8x8(dest, pitch, ref1, pitch, mcType1);
+						break;
+					case 1:
+						f.mcAdd8x8(dest, pitch, ref1, pitch, mcType1);
+						break;
+					case 2:
+						f.mcAvgPut8x8(dest, ref1, ref2 + 1, pitch, mcType1, mcType2);
+						break;
+					case 3:
+						f.mcAvgAdd8x8(dest, ref1, ref2 + 1, pitch, mcType1, mcType2);
+						break;
+					case 4:
+						f.inverseSlant8x8(coeffs, dest, pitch, flags);
+						break;
+					default:
+						f.inverseHaar8x8(coeffs, dest, pitch, flags);
+						break;
+					}
+				}
+
+				if (memcmp(actual, expected, sizeof(expected)) != 0)
+					TS_FAIL(Common::String::format("%s: Indeo kernel %d differs from the generic one for block %d", name, kernel, iter).c_str());
+			}
+		}
+	}
+
+	/** Convert random rows of all widths, and compare with the generic kernel. */
+	void compareClip(const Image::CodecDSP::Funcs &funcs, const char *name) {
+		int16 src[67];
+		byte expected[68], actual[68];
+
+		_seed = 1;
+		for (uint32 width = 0; width <= 64; width++) {
+			for (uint i = 0; i < ARRAYSIZE(src); i++)
+				src[i] = nextSample(512);
+			memset(expected, 0xAA, sizeof(expected));
+			memset(actual, 0xAA, sizeof(actual));
+
+			Image::CodecDSP::funcsGeneric.clipRow(expected + 1, src + (width & 3), width);
+			funcs.clipRow(actual + 1, src + (width & 3), width);
+
+			if (memcmp(actual, expected, sizeof(expected)) != 0)
+				TS_FAIL(Common::String::format("%s: clipRow differs from the generic one for width %u", name, width).c_str());
+		}
+	}
+
+public:
+	void test_generic() {
+		const Image::CodecDSP::Funcs &generic = Image::CodecDSP::funcsGeneric;
+		static const byte src[] = {
+			  0, 255,  10,  11,  12,  13,  14,  15,  16,
+			255, 254,   1,   2,   3,   4,   5,   6,   7,
+			  3,   4,   5,   6,   7,   8,   9,  10,  11
+		};
+		byte dst[9 * 2];
+
+		// SVQ1 rounds the averages up
+		generic.putPixels8[Image::CodecDSP::kHalfPelX](dst, src, 9, 2);
+		TS_ASSERT_EQUALS(dst[0], 128);
+		TS_ASSERT_EQUALS(dst[1], 133);
+		TS_ASSERT_EQUALS(dst[9], 255);
+		generic.putPixels8[Image::CodecDSP::kHalfPelY](dst, src, 9, 2);
+		TS_ASSERT_EQUALS(dst[0], 128);
+		TS_ASSERT_EQUALS(dst[9], 129);
+		generic.putPixels8[Image::CodecDSP::kHalfPelXY](dst, src, 9, 2);
+		TS_ASSERT_EQUALS(dst[0], (0 + 255 + 255 + 254 + 2) >> 2);
+		TS_ASSERT_EQUALS(dst[9], (255 + 254 + 3 + 4 + 2) >> 2);
+
+		// Indeo rounds them down
+		static const int16 ref[9 * 9] = {
+			-3, 4, 0, 0, 0, 0, 0, 0, 0,
+			 6, 1, 0, 0, 0, 0, 0, 0, 0
+		};
+		int16 block[8 * 8];
+		generic.mcPut8x8(block, 8, ref, 9, Image::CodecDSP::kHalfPelX);
+		TS_ASSERT_EQUALS(block[0], 0);
+		generic.mcPut8x8(block, 8, ref, 9, Image::CodecDSP::kHalfPelY);
+		TS_ASSERT_EQUALS(block[0], 1);
+		TS_ASSERT_EQUALS(block[1], 2);
+		generic.mcPut8x8(block, 8, ref, 9, Image::CodecDSP::kHalfPelXY);
+		TS_ASSERT_EQUALS(block[0], 2);
+
+		static const int16 samples[] = { -129, -128, 0, 127, 128, 1000 };
+		byte pixels[ARRAYSIZE(samples)];
+		generic.clipRow(pixels, samples, ARRAYSIZE(samples));
+		TS_ASSERT_EQUALS(pixels[0], 0);
+		TS_ASSERT_EQUALS(pixels[1], 0);
+		TS_ASSERT_EQUALS(pixels[2], 128);
+		TS_ASSERT_EQUALS(pixels[3], 255);
+		TS_ASSERT_EQUALS(pixels[4], 255);
+		TS_ASSERT_EQUALS(pixels[5], 255);
+	}
+
+	void test_kernels() {
+#ifdef SCUMMVM_NEON
+		comparePixels(Image::CodecDSP::funcsNEON, "NEON");
+		compareIndeo(Image::CodecDSP::funcsNEON, "NEON");
+		compareClip(Image::CodecDSP::funcsNEON, "NEON");
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			comparePixels(Image::CodecDSP::funcsSSE2, "SSE2");
+			compareIndeo(Image::CodecDSP::funcsSSE2, "SSE2");
+			compareClip(Image::CodecDSP::funcsSSE2, "SSE2");
+		}
+#endif
+	}
+
+	void test_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iterations = 200000;
+#else
+		const int iterations = 2000;
+#endif
+
+		const uint32 pitch = 64;
+		byte *pixels = new byte[pitch * 20];
+		byte *out = new byte[pitch * 16];
+		int16 *samples = new int16[pitch * 9];
+		int16 *block = new int16[pitch * 8];
+		int32 coeffs[64];
+		uint8 flags[8];
+
+		_seed = 1;
+		for (uint i = 0; i < pitch * 20; i++)
+			pixels[i] = nextRandom(256);
+		for (uint i = 0; i < pitch * 9; i++)
+			samples[i] = nextSample(256);
+		for (int i = 0; i < 64; i++)
+			coeffs[i] = nextSample(256);
+		memset(flags, 1, sizeof(flags));
+
+		for (int pass = 0; pass < 2; pass++) {
+			const Image::CodecDSP::Funcs &f = pass ? getBestFuncs() : Image::CodecDSP::funcsGeneric;
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iterations; i++) {
+				for (int j = 0; j < 4; j++)
+					f.putPixels16[j](out, pixels + 1, pitch, 16);
+				for (int j = 0; j < 4; j++)
+					f.mcAdd8x8(block, pitch, samples + 1, pitch, j);
+				f.inverseSlant8x8(coeffs, block, pitch, flags);
+				f.inverseHaar8x8(coeffs, block, pitch, flags);
+				for (int y = 0; y < 8; y++)
+					f.clipRow(out + y * pitch, block + y * pitch, pitch);
+			}
+			double time = g_system->getMillis() - start;
+
+			debug("Codec DSP kernels time %s (in microseconds per iteration): %f", pass ? "with the best kernels" : "with generic kernels", time * 1000 / iterations);
+		}
+
+		delete[] pixels;
+		delete[] out;
+		delete[] samples;
+		delete[] block;
+#endif
+	}
+};
@@ -0,0 +1,145 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/taskscheduler.h"
+#include "graphics/surface.h"
+#include "image/codecs/bufferpool.h"
+#include "image/codecs/msvideo1.h"
+#include "image/codecs/smc.h"
+
+#include "../system/null_osystem.h"
+
+class CodecBufferPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void test_reuse() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Image::CodecBufferPool pool;
+
+		// Sizes of the same class share the buffers
+		void *buffer = pool.allocate(5000);
+		memset(buffer, 0xFF, 5000);
+		pool.release(buffer);
+		TS_ASSERT_EQUALS(pool.allocate(4500), buffer);
+		void *small = pool.allocate(4000);
+		TS_ASSERT_DIFFERS(small, buffer);
+		void *large = pool.allocate(100000);
+		memset(large, 0xFF, 100000);
+
+		Image::CodecBufferPool::Stats stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.requests, 4U);
+		TS_ASSERT_EQUALS(stats.heapAllocations, 3U);
+		TS_ASSERT_EQUALS(stats.buffersInUse, 3U);
+		TS_ASSERT_EQUALS(stats.buffersCached, 0U);
+
+		pool.release(large);
+		pool.release(buffer);
+		stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.buffersInUse, 1U);
+		TS_ASSERT_EQUALS(stats.buffersCached, 2U);
+		TS_ASSERT(stats.bytesCached >= 105000U);
+		TS_ASSERT(stats.bytesCached < 105000U * 5 / 4);
+
+		// Lowering the limit drops the largest buffers first
+		pool.setCacheLimit(8192);
+		stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.buffersCached, 1U);
+		TS_ASSERT_EQUALS(stats.heapFrees, 1U);
+		TS_ASSERT_EQUALS(pool.allocate(5000), buffer);
+
+		// Buffers which do not fit in the limit go back to the heap
+		pool.release(pool.allocate(20000));
+		stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.buffersCached, 0U);
+		TS_ASSERT_EQUALS(stats.heapFrees, 2U);
+
+		// Only the first one fits in the limit
+		pool.release(buffer);
+		pool.release(small);
+		stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.buffersCached, 1U);
+		TS_ASSERT_EQUALS(stats.heapFrees, 3U);
+
+		pool.resetStats();
+		stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.requests, 0U);
+		TS_ASSERT_EQUALS(stats.heapFrees, 0U);
+		TS_ASSERT_EQUALS(stats.buffersInUse, 0U);
+#endif
+	}
+
+	void test_surface() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Image::CodecBufferPool pool;
+		Graphics::Surface surface;
+
+		pool.createSurface(surface, 33, 20, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		TS_ASSERT_EQUALS(surface.w, 33);
+		TS_ASSERT_EQUALS(surface.h, 20);
+		TS_ASSERT_EQUALS(surface.pitch, 66);
+		memset(surface.getPixels(), 0xFF, surface.pitch * surface.h);
+		void *pixels = surface.getPixels();
+		pool.freeSurface(surface);
+		TS_ASSERT(!surface.getPixels());
+
+		// Recycled surfaces are cleared like new ones
+		pool.createSurface(surface, 32, 20, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		TS_ASSERT_EQUALS(surface.getPixels(), pixels);
+		const byte *data = (const byte *)surface.getPixels();
+		bool cleared = true;
+		for (int i = 0; i < surface.pitch * surface.h; i++)
+			cleared = cleared && !data[i];
+		TS_ASSERT(cleared);
+		pool.freeSurface(surface);
+#endif
+	}
+
+	void test_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Image::CodecBufferPool pool;
+		Common::TaskScheduler scheduler(3);
+
+		// The counters stay consistent when the workers share the pool
+		scheduler.parallelFor(64, 1, [&](uint begin, uint end) {
+			for (uint i = begin; i < end; i++) {
+				for (uint j = 0; j < 50; j++) {
+					void *buffer = pool.allocate(4096 + (i * 50 + j) % 7 * 1000);
+					memset(buffer, i, 4096);
+					pool.release(buffer);
+				}
+			}
+		});
+
+		const Image::CodecBufferPool::Stats stats = pool.getStats();
+		TS_ASSERT_EQUALS(stats.requests, 64U * 50U);
+		TS_ASSERT_EQUALS(stats.buffersInUse, 0U);
+		TS_ASSERT_EQUALS(stats.bytesInUse, 0U);
+		TS_ASSERT_EQUALS(stats.buffersCached, stats.heapAllocations - stats.heapFrees);
+#endif
+	}
+
+	void test_codecs() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Playing videos one after the other does not touch the heap once
+		// the buffers have been allocated
+		delete new Image::MSVideo1Decoder(320, 200, 16);
+		delete new Image::SMCDecoder(320, 200);
+		CodecBufferPoolMan.resetStats();
+
+		for (int i = 0; i < 3; i++) {
+			delete new Image::MSVideo1Decoder(320, 200, 16);
+			delete new Image::SMCDecoder(320, 200);
+		}
+
+		const Image::CodecBufferPool::Stats stats = CodecBufferPoolMan.getStats();
+		TS_ASSERT_EQUALS(stats.requests, 6U);
+		TS_ASSERT_EQUALS(stats.heapAllocations, 0U);
+		TS_ASSERT_EQUALS(stats.heapFrees, 0U);
+
+		Image::CodecBufferPool::destroy();
+#endif
+	}
+};
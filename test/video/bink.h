@@ -0,0 +1,769 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/crc.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/taskscheduler.h"
+#include "graphics/surface.h"
+#include "video/bink_decoder.h"
+#include "video/bink_decoder_intern.h"
+
+#include "test/instrset_detect.h"
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+#ifdef USE_BINK
+
+// writes synthetic Bink videos using every block type, with all the bundle
+// values of a plane given at the start of the plane
+
+class BinkTestEncoder {
+public:
+	BinkTestEncoder(uint32 id, int width, int height, bool hasAlpha) :
+			_id(id), _width(width), _height(height), _hasAlpha(hasAlpha), _seed(1) {
+	}
+
+	/** Write a video with frameCount frames, the first one being a key frame. */
+	Common::SeekableReadStream *encode(int frameCount) {
+		Common::Array<Common::Array<byte> > frames;
+		for (int i = 0; i < frameCount; i++)
+			frames.push_back(encodeFrame(i == 0));
+
+		Common::Array<byte> file;
+		const uint32 headerSize = 44 + 4 * frameCount;
+		uint32 size = headerSize, largest = 0;
+		for (uint i = 0; i < frames.size(); i++) {
+			size += frames[i].size();
+			largest = MAX<uint32>(largest, frames[i].size());
+		}
+
+		putUint32(file, MKTAG('B', 'I', 'K', _id & 0xFF), true);
+		putUint32(file, size - 8);
+		putUint32(file, frameCount);
+		putUint32(file, largest);
+		putUint32(file, 0);
+		putUint32(file, _width);
+		putUint32(file, _height);
+		putUint32(file, 15);
+		putUint32(file, 1);
+		putUint32(file, _hasAlpha ? 0x00100000 : 0);
+		putUint32(file, 0); // no audio tracks
+
+		uint32 offset = headerSize;
+		for (uint i = 0; i < frames.size(); i++) {
+			putUint32(file, offset | (i == 0 ? 1 : 0));
+			offset += frames[i].size();
+		}
+		for (uint i = 0; i < frames.size(); i++)
+			file.push_back(frames[i]);
+
+		byte *data = (byte *)malloc(file.size());
+		memcpy(data, file.begin(), file.size());
+		return new Common::MemoryReadStream(data, file.size(), DisposeAfterUse::YES);
+	}
+
+private:
+	enum {
+		kBlockSkip, kBlockScaled, kBlockMotion, kBlockRun, kBlockResidue,
+		kBlockIntra, kBlockFill, kBlockInter, kBlockPattern, kBlockRaw
+	};
+
+	enum {
+		kSourceBlockTypes, kSourceSubBlockTypes, kSourceColors, kSourcePattern,
+		kSourceXOff, kSourceYOff, kSourceIntraDC, kSourceInterDC, kSourceRun,
+		kSourceMAX
+	};
+
+	/** Writes bits starting from the least significant one, like BitStream32LELSB reads them. */
+	class BitWriter {
+	public:
+		BitWriter() : _bitPos(0) {}
+
+		void putBits(uint32 value, int count) {
+			for (int i = 0; i < count; i++)
+				putBit((value >> i) & 1);
+		}
+
+		void putBit(uint bit) {
+			if ((_bitPos & 7) == 0)
+				_data.push_back(0);
+			_data.back() |= bit << (_bitPos & 7);
+			_bitPos++;
+		}
+
+		void append(const BitWriter &other) {
+			for (uint32 i = 0; i < other._bitPos; i++)
+				putBit((other._data[i >> 3] >> (i & 7)) & 1);
+		}
+
+		void align32() {
+			while (_bitPos & 0x1F)
+				putBit(0);
+		}
+
+		const Common::Array<byte> &getData() const { return _data; }
+
+	private:
+		Common::Array<byte> _data;
+		uint32 _bitPos;
+	};
+
+	uint32 _id;
+	int _width, _height;
+	bool _hasAlpha;
+	uint32 _seed;
+
+	Common::Array<int> _bundles[kSourceMAX];
+	BitWriter _blockBits;
+
+	uint nextRandom(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 16) & 0x7FFF) % max;
+	}
+
+	static void putUint32(Common::Array<byte> &data, uint32 value, bool bigEndian = false) {
+		for (int i = 0; i < 4; i++)
+			data.push_back(value >> (bigEndian ? 24 - i * 8 : i * 8));
+	}
+
+	static int highBit(int value) {
+		return Common::intLog2(ABS(value));
+	}
+
+	Common::Array<byte> encodeFrame(bool keyFrame) {
+		BitWriter frame;
+
+		if (_hasAlpha) {
+			if ((_id & 0xFF) == 'i')
+				frame.putBits(0, 32);
+			encodePlane(frame, false, keyFrame, true);
+		}
+
+		if ((_id & 0xFF) == 'i')
+			frame.putBits(0, 32);
+
+		for (int i = 0; i < 3; i++)
+			encodePlane(frame, i != 0, keyFrame, false);
+
+		return frame.getData();
+	}
+
+	void encodePlane(BitWriter &out, bool isChroma, bool keyFrame, bool isAlpha) {
+		const int blockWidth  = isChroma ? (_width  + 15) >> 4 : (_width  + 7) >> 3;
+		const int blockHeight = isChroma ? (_height + 15) >> 4 : (_height + 7) >> 3;
+
+		for (int i = 0; i < kSourceMAX; i++)
+			_bundles[i].clear();
+		_blockBits = BitWriter();
+
+		// Scaled blocks cover the block below them
+		Common::Array<bool> covered(blockWidth * blockHeight, false);
+
+		for (int y = 0; y < blockHeight; y++) {
+			for (int x = 0; x < blockWidth; x++) {
+				if (covered[y * blockWidth + x]) {
+					_bundles[kSourceBlockTypes].push_back(kBlockScaled);
+					x++;
+					continue;
+				}
+
+				int type;
+				do {
+					type = nextRandom(10);
+				} while ((keyFrame && (type == kBlockSkip || type == kBlockMotion || type == kBlockResidue || type == kBlockInter)) ||
+				         (type == kBlockScaled && ((y & 1) || y + 1 >= blockHeight || x + 1 >= blockWidth)));
+
+				// Mostly opaque alpha
+				if (isAlpha && nextRandom(4))
+					type = kBlockFill;
+
+				_bundles[kSourceBlockTypes].push_back(type);
+				encodeBlock(type, x, y, blockWidth, blockHeight);
+
+				if (type == kBlockScaled) {
+					covered[(y + 1) * blockWidth + x] = true;
+					x++;
+				}
+			}
+		}
+
+		// Huffman codebook 0 for every bundle, which gives raw nibbles
+		for (int i = 0; i < kSourceMAX; i++) {
+			if (i == kSourceColors)
+				out.putBits(0, 16 * 4);
+			if (i != kSourceIntraDC && i != kSourceInterDC)
+				out.putBits(0, 4);
+		}
+
+		// All the values of the plane are read with the first row, with one
+		// more so the bundles are not read again for the next rows
+		const int width = MAX((isChroma ? _width >> 1 : _width), 8);
+		const int cbw = isChroma ? (_width + 15) >> 4 : (_width + 7) >> 3;
+		const int typesLength   = Common::intLog2((width >> 3) + 511) + 1;
+		const int subTypeLength = Common::intLog2(((width + 7) >> 4) + 511) + 1;
+
+		writeNibbleBundle(out, kSourceBlockTypes, typesLength);
+		writeNibbleBundle(out, kSourceSubBlockTypes, subTypeLength);
+		writeColors(out, Common::intLog2(cbw * 64 + 511) + 1);
+		writePatterns(out, Common::intLog2((cbw << 3) + 511) + 1);
+		writeMotion(out, kSourceXOff, typesLength);
+		writeMotion(out, kSourceYOff, typesLength);
+		writeDCs(out, kSourceIntraDC, typesLength, false);
+		writeDCs(out, kSourceInterDC, typesLength, true);
+		writeNibbleBundle(out, kSourceRun, Common::intLog2(cbw * 48 + 511) + 1);
+
+		out.append(_blockBits);
+		out.align32();
+	}
+
+	void writeCount(BitWriter &out, Common::Array<int> &values, int countLength) {
+		if (values.empty()) {
+			out.putBits(0, countLength);
+			return;
+		}
+		values.push_back(values.back());
+		assert(values.size() < (1u << countLength));
+		out.putBits(values.size(), countLength);
+	}
+
+	void writeNibbleBundle(BitWriter &out, int source, int countLength) {
+		Common::Array<int> &values = _bundles[source];
+		writeCount(out, values, countLength);
+		if (values.empty())
+			return;
+
+		out.putBit(0);
+		for (uint i = 0; i < values.size(); i++)
+			out.putBits(values[i], 4);
+	}
+
+	void writeColors(BitWriter &out, int countLength) {
+		Common::Array<int> &values = _bundles[kSourceColors];
+		writeCount(out, values, countLength);
+		if (values.empty())
+			return;
+
+		out.putBit(0);
+		for (uint i = 0; i < values.size(); i++) {
+			out.putBits(values[i] >> 4, 4);
+			out.putBits(values[i] & 0xF, 4);
+		}
+	}
+
+	void writePatterns(BitWriter &out, int countLength) {
+		Common::Array<int> &values = _bundles[kSourcePattern];
+		writeCount(out, values, countLength);
+		for (uint i = 0; i < values.size(); i++) {
+			out.putBits(values[i] & 0xF, 4);
+			out.putBits(values[i] >> 4, 4);
+		}
+	}
+
+	void writeMotion(BitWriter &out, int source, int countLength) {
+		Common::Array<int> &values = _bundles[source];
+		writeCount(out, values, countLength);
+		if (values.empty())
+			return;
+
+		out.putBit(0);
+		for (uint i = 0; i < values.size(); i++) {
+			out.putBits(ABS(values[i]), 4);
+			if (values[i])
+				out.putBit(values[i] < 0);
+		}
+	}
+
+	void writeDCs(BitWriter &out, int source, int countLength, bool hasSign) {
+		Common::Array<int> &values = _bundles[source];
+		writeCount(out, values, countLength);
+		if (values.empty())
+			return;
+
+		if (hasSign) {
+			out.putBits(ABS(values[0]), 10);
+			if (values[0])
+				out.putBit(values[0] < 0);
+		} else {
+			out.putBits(values[0], 11);
+		}
+
+		for (uint i = 1; i < values.size(); i += 8) {
+			const uint end = MIN<uint>(i + 8, values.size());
+			int bSize = 0;
+			for (uint j = i; j < end; j++) {
+				if (values[j] != values[j - 1])
+					bSize = MAX(bSize, highBit(values[j] - values[j - 1]) + 1);
+			}
+
+			out.putBits(bSize, 4);
+			if (!bSize)
+				continue;
+
+			for (uint j = i; j < end; j++) {
+				const int diff = values[j] - values[j - 1];
+				out.putBits(ABS(diff), bSize);
+				if (diff)
+					out.putBit(diff < 0);
+			}
+		}
+	}
+
+	void addColors(int count) {
+		for (int i = 0; i < count; i++)
+			_bundles[kSourceColors].push_back(nextRandom(256));
+	}
+
+	void encodeBlock(int type, int x, int y, int blockWidth, int blockHeight) {
+		switch (type) {
+		case kBlockScaled: {
+			static const int subTypes[] = { kBlockRun, kBlockIntra, kBlockFill, kBlockPattern, kBlockRaw };
+			const int subType = subTypes[nextRandom(ARRAYSIZE(subTypes))];
+			_bundles[kSourceSubBlockTypes].push_back(subType);
+			encodeBlock(subType, x, y, blockWidth, blockHeight);
+			break;
+		}
+		case kBlockMotion:
+			addMotion(x, y, blockWidth, blockHeight);
+			break;
+		case kBlockRun:
+			encodeRuns();
+			break;
+		case kBlockResidue:
+			addMotion(x, y, blockWidth, blockHeight);
+			_blockBits.putBits(127, 7);
+			encodeResidue();
+			break;
+		case kBlockIntra:
+			_bundles[kSourceIntraDC].push_back(nextRandom(2048));
+			encodeCoefficients();
+			break;
+		case kBlockFill:
+			addColors(1);
+			break;
+		case kBlockInter:
+			addMotion(x, y, blockWidth, blockHeight);
+			_bundles[kSourceInterDC].push_back((int)nextRandom(512) - 256);
+			encodeCoefficients();
+			break;
+		case kBlockPattern:
+			addColors(2);
+			for (int i = 0; i < 8; i++)
+				_bundles[kSourcePattern].push_back(nextRandom(256));
+			break;
+		case kBlockRaw:
+			addColors(64);
+			break;
+		default:
+			break;
+		}
+	}
+
+	/** Motion from anywhere inside the plane. */
+	void addMotion(int x, int y, int blockWidth, int blockHeight) {
+		const int xOff = CLIP<int>(x * 8 + (int)nextRandom(31) - 15, 0, blockWidth  * 8 - 8) - x * 8;
+		const int yOff = CLIP<int>(y * 8 + (int)nextRandom(31) - 15, 0, blockHeight * 8 - 8) - y * 8;
+		_bundles[kSourceXOff].push_back(xOff);
+		_bundles[kSourceYOff].push_back(yOff);
+	}
+
+	void encodeRuns() {
+		_blockBits.putBits(nextRandom(16), 4);
+
+		int i = 0;
+		do {
+			const int run = 1 + nextRandom(MIN(16, 64 - i));
+			i += run;
+			_bundles[kSourceRun].push_back(run - 1);
+
+			const bool single = nextRandom(2);
+			_blockBits.putBit(single);
+			addColors(single ? 1 : run);
+		} while (i < 63);
+
+		if (i == 63)
+			addColors(1);
+	}
+
+	/** A few random coefficients, in scan order. */
+	void randomCoefficients(int *coefs, int first, int maxValue) {
+		memset(coefs, 0, 64 * sizeof(int));
+		const int count = nextRandom(8);
+		for (int i = 0; i < count; i++) {
+			const int value = 1 + nextRandom(maxValue);
+			coefs[first + nextRandom(64 - first)] = nextRandom(2) ? value : -value;
+		}
+	}
+
+	/** The coefficient list shared by BinkVideoTrack::readDCTCoeffs() and readResidue(). */
+	struct CoefficientList {
+		int coefList[128], modeList[128];
+		int listStart, listEnd;
+
+		CoefficientList() : listStart(64), listEnd(64) {}
+
+		void add(int coef, int mode) {
+			coefList[listEnd] = coef;
+			modeList[listEnd++] = mode;
+		}
+	};
+
+	/** Whether the uncoded coefficients of an entry have their highest bit at the given level. */
+	static bool isSignificant(const int *coefs, const bool *coded, int coef, int mode, int level) {
+		const int count = mode == 0 ? 20 : mode == 1 ? 16 : mode == 2 ? 4 : 1;
+		for (int i = coef; i < coef + count; i++) {
+			if (coefs[i] && !coded[i] && highBit(coefs[i]) == level)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * The inverse of reading the coefficients in BinkVideoTrack, calling
+	 * putValue(coef, level) for each coefficient found at a level.
+	 */
+	template<class T>
+	void encodeList(CoefficientList &list, const int *coefs, bool *coded, int level, const T &putValue) {
+		int listPos = list.listStart;
+		while (listPos < list.listEnd) {
+			int ccoef = list.coefList[listPos];
+			const int mode = list.modeList[listPos];
+			if (!(ccoef | mode)) {
+				listPos++;
+				continue;
+			}
+
+			const bool significant = isSignificant(coefs, coded, ccoef, mode, level);
+			_blockBits.putBit(significant);
+			if (!significant) {
+				listPos++;
+				continue;
+			}
+
+			switch (mode) {
+			case 0:
+			case 2:
+				if (mode == 0) {
+					list.coefList[listPos] = ccoef + 4;
+					list.modeList[listPos] = 1;
+				} else {
+					list.coefList[listPos] = 0;
+					list.modeList[listPos++] = 0;
+				}
+				for (int i = 0; i < 4; i++, ccoef++) {
+					if (isSignificant(coefs, coded, ccoef, 3, level)) {
+						_blockBits.putBit(0);
+						putValue(ccoef, level);
+						coded[ccoef] = true;
+					} else {
+						_blockBits.putBit(1);
+						list.coefList[--list.listStart] = ccoef;
+						list.modeList[  list.listStart] = 3;
+					}
+				}
+				break;
+			case 1:
+				list.modeList[listPos] = 2;
+				for (int i = 0; i < 3; i++) {
+					ccoef += 4;
+					list.add(ccoef, 2);
+				}
+				break;
+			case 3:
+				putValue(ccoef, level);
+				coded[ccoef] = true;
+				list.coefList[listPos] = 0;
+				list.modeList[listPos++] = 0;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	void encodeCoefficients() {
+		int coefs[64];
+		randomCoefficients(coefs, 1, 40);
+
+		int maxLevel = -1;
+		for (int i = 1; i < 64; i++) {
+			if (coefs[i])
+				maxLevel = MAX(maxLevel, highBit(coefs[i]));
+		}
+
+		_blockBits.putBits(maxLevel + 1, 4);
+
+		CoefficientList list;
+		list.add(4, 0);
+		list.add(24, 0);
+		list.add(44, 0);
+		list.add(1, 3);
+		list.add(2, 3);
+		list.add(3, 3);
+
+		bool coded[64] = {};
+		for (int level = maxLevel; level >= 0; level--) {
+			encodeList(list, coefs, coded, level, [&](int coef, int curLevel) {
+				if (curLevel)
+					_blockBits.putBits(ABS(coefs[coef]) & ((1 << curLevel) - 1), curLevel);
+				_blockBits.putBit(coefs[coef] < 0);
+			});
+		}
+
+		// Quantizers small enough not to overflow
+		_blockBits.putBits(nextRandom(4), 4);
+	}
+
+	void encodeResidue() {
+		int coefs[64];
+		randomCoefficients(coefs, 0, 15);
+
+		int maxLevel = 0;
+		for (int i = 0; i < 64; i++) {
+			if (coefs[i])
+				maxLevel = MAX(maxLevel, highBit(coefs[i]));
+		}
+
+		_blockBits.putBits(maxLevel, 3);
+
+		CoefficientList list;
+		list.add(4, 0);
+		list.add(24, 0);
+		list.add(44, 0);
+		list.add(0, 2);
+
+		bool coded[64] = {};
+		Common::Array<int> codedOrder;
+		for (int level = maxLevel; level >= 0; level--) {
+			for (uint i = 0; i < codedOrder.size(); i++)
+				_blockBits.putBit((ABS(coefs[codedOrder[i]]) >> level) & 1);
+
+			encodeList(list, coefs, coded, level, [&](int coef, int curLevel) {
+				_blockBits.putBit(coefs[coef] < 0);
+				codedOrder.push_back(coef);
+			});
+		}
+	}
+};
+
+#endif
+
+class BinkTestSuite : public CxxTest::TestSuite {
+#ifdef USE_BINK
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	const Video::BinkKernels::Funcs &getBestFuncs() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			return Video::BinkKernels::funcsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+		return Video::BinkKernels::funcsNEON;
+#endif
+		return Video::BinkKernels::funcsGeneric;
+	}
+
+	/** Run each kernel on random blocks, and compare with the generic kernels. */
+	void compareKernels(const Video::BinkKernels::Funcs &funcs, const char *name) {
+		const Video::BinkKernels::Funcs &generic = Video::BinkKernels::funcsGeneric;
+		// An odd pitch, so that the blocks are not aligned
+		const uint32 pitch = 37;
+		byte src[pitch * 24], expected[pitch * 24], actual[pitch * 24];
+		byte pixels[64];
+		int32 coeffs[64];
+		int16 residue[64];
+
+		_seed = 1;
+		for (int iter = 0; iter < 200; iter++) {
+			for (uint i = 0; i < sizeof(src); i++)
+				src[i] = nextRandom(256);
+			for (int i = 0; i < 64; i++)
+				pixels[i] = nextRandom(256);
+			for (int i = 0; i < 64; i++)
+				residue[i] = (int16)nextRandom(1024) - 512;
+
+			// Sparse coefficients, with columns holding only a DC value, and
+			// dense ones overflowing the pixel range
+			const uint32 density = (iter % 4 == 0) ? 1 : ((iter % 4 == 1) ? 8 : 64);
+			for (int i = 0; i < 64; i++)
+				coeffs[i] = (nextRandom(64) < density) ? (int32)nextRandom(8192) - 4096 : 0;
+			coeffs[0] = nextRandom(4096) * 8;
+
+			const uint32 offset = nextRandom(pitch - 16 + 1) + pitch * nextRandom(24 - 16 + 1);
+			const byte value = nextRandom(256);
+
+			for (int kernel = 0; kernel < 8; kernel++) {
+				memcpy(expected, src, sizeof(src));
+				memcpy(actual, src, sizeof(src));
+
+				for (int pass = 0; pass < 2; pass++) {
+					const Video::BinkKernels::Funcs &f = pass ? funcs : generic;
+					byte *dest = (pass ? actual : expected) + offset;
+
+					switch (kernel) {
+					case 0:
+						f.idctPut(dest, pitch, coeffs);
+						break;
+					case 1:
+						f.idctAdd(dest, pitch, coeffs);
+						break;
+					case 2:
+						f.addResidue(dest, pitch, residue);
+						break;
+					case 3:
+						f.copyBlock(dest, src + (offset ^ 1), pitch);
+						break;
+					case 4:
+						f.putBlock(dest, pitch, pixels);
+						break;
+					case 5:
+						f.putScaledBlock(dest, pitch, pixels);
+						break;
+					case 6:
+						f.fillBlock(dest, pitch, value);
+						break;
+					default:
+						f.fillScaledBlock(dest, pitch, value);
+						break;
+					}
+				}
+
+				if (memcmp(actual, expected, sizeof(src)) != 0)
+					TS_FAIL(Common::String::format("%s: kernel %d differs from the generic one for block %d", name, kernel, iter).c_str());
+			}
+		}
+	}
+
+	/** Decode all frames, and return the checksums of the frames. */
+	Common::Array<uint32> decode(uint32 id, int width, int height, bool hasAlpha, int frameCount) {
+		BinkTestEncoder encoder(id, width, height, hasAlpha);
+		Video::BinkDecoder decoder;
+		Common::Array<uint32> checksums;
+
+		TS_ASSERT(decoder.loadStream(encoder.encode(frameCount)));
+		TS_ASSERT(decoder.setOutputPixelFormat(Graphics::PixelFormat::createFormatARGB32()));
+
+		Common::CRC32 crc;
+		while (!decoder.endOfVideo()) {
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT(frame);
+			if (!frame)
+				break;
+
+			uint32 remainder = 0xFFFFFFFF;
+			for (int y = 0; y < frame->h; y++) {
+				const byte *row = (const byte *)frame->getBasePtr(0, y);
+				for (int x = 0; x < frame->w * frame->format.bytesPerPixel; x++)
+					remainder = crc.processByte(row[x], remainder);
+			}
+			checksums.push_back(crc.finalize(remainder));
+		}
+
+		return checksums;
+	}
+
+	/** Compare with the frames of the decoder from before the planes were decoded in parallel. */
+	void checkFrames(const char *name) {
+		static const uint32 expectedYUV[] = {
+			0x0C3D6B4C, 0x24625A3B, 0x12ED9AE5, 0x8B2F8BF2, 0x44D982C4, 0x81E84B9B
+		};
+		static const uint32 expectedAlpha[] = {
+			0xB53F9CE8, 0xFC120A9A, 0xA761E7D0, 0xCEAF83CD, 0x4F746F41, 0xBCBE13FE
+		};
+
+		// Odd sizes in blocks, and swapped chroma planes with alpha
+		Common::Array<uint32> checksums = decode(MKTAG('B', 'I', 'K', 'f'), 72, 40, false, ARRAYSIZE(expectedYUV));
+		TS_ASSERT_EQUALS(checksums.size(), (uint)ARRAYSIZE(expectedYUV));
+		for (uint i = 0; i < checksums.size(); i++) {
+			if (checksums[i] != expectedYUV[i])
+				TS_FAIL(Common::String::format("%s: YUV frame %u differs", name, i).c_str());
+		}
+
+		checksums = decode(MKTAG('B', 'I', 'K', 'i'), 49, 33, true, ARRAYSIZE(expectedAlpha));
+		TS_ASSERT_EQUALS(checksums.size(), (uint)ARRAYSIZE(expectedAlpha));
+		for (uint i = 0; i < checksums.size(); i++) {
+			if (checksums[i] != expectedAlpha[i])
+				TS_FAIL(Common::String::format("%s: YUVA frame %u differs", name, i).c_str());
+		}
+	}
+#endif
+
+public:
+	void test_kernels() {
+#if defined(USE_BINK)
+#ifdef SCUMMVM_NEON
+		compareKernels(Video::BinkKernels::funcsNEON, "NEON");
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels(Video::BinkKernels::funcsSSE2, "SSE2");
+#endif
+#endif
+	}
+
+	void test_frames() {
+#if defined(USE_BINK) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		for (int threaded = 0; threaded < 2; threaded++) {
+			// Recreate TaskMan with and without worker threads
+			ConfMan.setInt("worker_threads", threaded ? 2 : 0, Common::ConfigManager::kTransientDomain);
+			Common::TaskScheduler::destroy();
+
+			Video::BinkKernels::selectedFuncs = &Video::BinkKernels::funcsGeneric;
+			checkFrames(threaded ? "Threaded, generic kernels" : "Synchronous, generic kernels");
+
+			Video::BinkKernels::selectedFuncs = &getBestFuncs();
+			checkFrames(threaded ? "Threaded, best kernels" : "Synchronous, best kernels");
+		}
+
+		Video::BinkKernels::selectedFuncs = nullptr;
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kTransientDomain);
+		Common::TaskScheduler::destroy();
+#endif
+	}
+
+	void test_speed() {
+#if defined(USE_BINK) && BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		// The encoder gives all the bundle values of a plane at once, which
+		// limits the number of blocks
+#ifdef SLOW_TESTS
+		const int frameCount = 2000;
+#else
+		const int frameCount = 20;
+#endif
+
+		for (int pass = 0; pass < 2; pass++) {
+			// The decoder from before, and with the best kernels and the default worker threads
+			if (pass == 0)
+				ConfMan.setInt("worker_threads", 0, Common::ConfigManager::kTransientDomain);
+			Common::TaskScheduler::destroy();
+			Video::BinkKernels::selectedFuncs = pass ? &getBestFuncs() : &Video::BinkKernels::funcsGeneric;
+
+			uint32 start = g_system->getMillis();
+			decode(MKTAG('B', 'I', 'K', 'i'), 72, 40, true, frameCount);
+			double time = g_system->getMillis() - start;
+
+			debug("72x40 Bink encoding and decoding time %s (in milliseconds): %f", pass ? "with SIMD kernels and worker threads" : "with generic kernels", time / frameCount);
+
+			ConfMan.removeKey("worker_threads", Common::ConfigManager::kTransientDomain);
+		}
+
+		Video::BinkKernels::selectedFuncs = nullptr;
+		Common::TaskScheduler::destroy();
+#endif
+	}
+};
@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/taskscheduler.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../system/null_osystem.h"
+
+// a video whose frames and palette depend on the frame number, decoded with
+// and without decoding frames ahead
+
+class FrameAheadTestDecoder : public Video::VideoDecoder {
+public:
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		addTrack(new TestTrack());
+		return true;
+	}
+
+private:
+	class TestTrack : public FixedRateVideoTrack {
+	public:
+		TestTrack() : _curFrame(-1), _dirtyPalette(false) {
+			_surface.create(32, 24, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+		~TestTrack() override { _surface.free(); }
+
+		bool isRewindable() const override { return true; }
+		bool rewind() override { _curFrame = -1; return true; }
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override { _curFrame = getFrameAtTime(time) - 1; return true; }
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return 40; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			for (int y = 0; y < _surface.h; y++) {
+				for (int x = 0; x < _surface.w; x++)
+					*(byte *)_surface.getBasePtr(x, y) = (x * 3 + y * 7 + _curFrame * 11) & 0xFF;
+			}
+
+			if (_curFrame % 5 == 0) {
+				for (int i = 0; i < 256 * 3; i++)
+					_palette[i] = i + _curFrame;
+				_dirtyPalette = true;
+			}
+			return &_surface;
+		}
+
+		const byte *getPalette() const override { _dirtyPalette = false; return _palette; }
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+		bool canDecodeAhead() const override { return true; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 30; }
+
+	private:
+		int _curFrame;
+		Graphics::Surface _surface;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+};
+
+class FrameAheadTestSuite : public CxxTest::TestSuite {
+	// decodes count frames with both decoders, and checks they give the same output
+	void compareFrames(FrameAheadTestDecoder &expected, FrameAheadTestDecoder &decoder, int count) {
+		for (int i = 0; i < count; i++) {
+			TS_ASSERT_EQUALS(decoder.endOfVideo(), expected.endOfVideo());
+			if (expected.endOfVideo())
+				return;
+
+			const Graphics::Surface *expectedFrame = expected.decodeNextFrame();
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT(frame);
+			if (!frame)
+				return;
+
+			TS_ASSERT_EQUALS(frame->w, expectedFrame->w);
+			TS_ASSERT_EQUALS(frame->h, expectedFrame->h);
+			for (int y = 0; y < frame->h; y++)
+				TS_ASSERT_SAME_DATA(frame->getBasePtr(0, y), expectedFrame->getBasePtr(0, y), frame->w);
+
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), expected.getCurFrame());
+			TS_ASSERT_EQUALS(decoder.hasDirtyPalette(), expected.hasDirtyPalette());
+			if (expected.hasDirtyPalette())
+				TS_ASSERT_SAME_DATA(decoder.getPalette(), expected.getPalette(), 256 * 3);
+		}
+	}
+
+public:
+	void test_frame_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Recreate TaskMan with worker threads
+		ConfMan.setInt("worker_threads", 2, Common::ConfigManager::kTransientDomain);
+		Common::TaskScheduler::destroy();
+
+		for (uint count = 1; count <= Video::VideoDecoder::kMaxFramesAhead; count *= 2) {
+			FrameAheadTestDecoder expected, decoder;
+			expected.setFrameAheadCount(0);
+			decoder.setFrameAheadCount(count);
+			decoder.setExclusiveStream(true);
+			TS_ASSERT_EQUALS(decoder.getFrameAheadCount(), count);
+			expected.loadStream(nullptr);
+			decoder.loadStream(nullptr);
+
+			compareFrames(expected, decoder, 12);
+
+			// Seeking drops the frames decoded ahead
+			TS_ASSERT(expected.seekToFrame(3));
+			TS_ASSERT(decoder.seekToFrame(3));
+			compareFrames(expected, decoder, 10);
+
+			TS_ASSERT(expected.rewind());
+			TS_ASSERT(decoder.rewind());
+			compareFrames(expected, decoder, 50);
+			TS_ASSERT(decoder.endOfVideo());
+
+			const Video::VideoDecoder::FrameAheadStats stats = decoder.getFrameAheadStats();
+			if (TaskMan.getNumWorkers()) {
+				TS_ASSERT(stats.framesDecoded >= 40u);
+				uint shown = 0, timed = 0;
+				for (uint i = 0; i < Video::VideoDecoder::kMaxFramesAhead; i++)
+					shown += stats.queueDepth[i];
+				for (uint i = 0; i < Video::VideoDecoder::FrameAheadStats::kDecodeTimeBuckets; i++)
+					timed += stats.decodeTime[i];
+				TS_ASSERT_EQUALS(timed, stats.framesDecoded);
+				TS_ASSERT(shown <= stats.framesDecoded);
+			} else {
+				TS_ASSERT_EQUALS(stats.framesDecoded, 0u);
+			}
+		}
+
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kTransientDomain);
+		Common::TaskScheduler::destroy();
+#endif
+	}
+
+	void test_shared_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		ConfMan.setInt("worker_threads", 2, Common::ConfigManager::kTransientDomain);
+		Common::TaskScheduler::destroy();
+
+		// Streams which may be shared are not read ahead
+		FrameAheadTestDecoder expected, decoder;
+		expected.setFrameAheadCount(0);
+		decoder.setFrameAheadCount(2);
+		TS_ASSERT(!decoder.isExclusiveStream());
+		expected.loadStream(nullptr);
+		decoder.loadStream(nullptr);
+
+		compareFrames(expected, decoder, 12);
+		TS_ASSERT_EQUALS(decoder.getFrameAheadStats().framesDecoded, 0u);
+
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kTransientDomain);
+		Common::TaskScheduler::destroy();
+#endif
+	}
+};
@@ -55,6 +55,9 @@ static const uint32 kBIKiID = MKTAG('B', 'I', 'K', 'i');
 
 static const uint32 kVideoFlagAlpha = 0x00100000;
 
+/** The number of pairs of block rows drawn by each task. */
+static const uint kRowPairsPerTask = 2;
+
 static const uint16 kAudioFlagDCT    = 0x1000;
 static const uint16 kAudioFlagStereo = 0x2000;
 
@@ -303,6 +306,26 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 	memset(_curPlanes[3], 255, _yBlockWidth  * 8 * _yBlockHeight  * 8);
 	memset(_oldPlanes[3], 255, _yBlockWidth  * 8 * _yBlockHeight  * 8);
 
+	for (int i = 0; i < 4; i++) {
+		const bool isChroma = (i == 1) || (i == 2);
+		const uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
+		const uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
+
+		_planes[i].funcs       = nullptr;
+		_planes[i].dest        = nullptr;
+		_planes[i].prev        = nullptr;
+		_planes[i].pitch       = blockWidth * 8;
+		_planes[i].blockHeight = blockHeight;
+		_planes[i].blockCount  = 0;
+		_planes[i].drawInOrder = false;
+
+		if ((i == 3) && !_hasAlpha)
+			continue;
+
+		_planes[i].blocks.resize(blockWidth * blockHeight);
+		_planes[i].rowStarts.resize(blockHeight + 1);
+	}
+
 	initBundles();
 	initHuffman();
 }
@@ -457,11 +480,14 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		_surface->w = _width;
 	}
 
+	// Each plane is drawn on worker threads while the next ones are read
+	Common::TaskFuture planeTasks[4];
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
 
-		decodePlane(frame, 3, false);
+		planeTasks[3] = decodePlane(frame, 3, false);
 	}
 
 	if (_id == kBIKiID)
@@ -470,12 +496,15 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	for (int i = 0; i < 3; i++) {
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
-		decodePlane(frame, planeIdx, i != 0);
+		planeTasks[planeIdx] = decodePlane(frame, planeIdx, i != 0);
 
 		if (frame.bits->pos() >= frame.bits->size())
 			break;
 	}
 
+	for (int i = 0; i < 4; i++)
+		planeTasks[i].wait();
+
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
@@ -496,30 +525,24 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	_curFrame++;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
+Common::TaskFuture BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
 	uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
-	uint32 width       = blockWidth  * 8;
-	uint32 height      = blockHeight * 8;
 
 	DecodeContext ctx;
 
-	ctx.video     = &video;
-	ctx.planeIdx  = planeIdx;
-	ctx.destStart = _curPlanes[planeIdx];
-	ctx.destEnd   = _curPlanes[planeIdx] + width * height;
-	ctx.prevStart = _oldPlanes[planeIdx];
-	ctx.prevEnd   = _oldPlanes[planeIdx] + width * height;
-	ctx.pitch     = width;
-
-	for (int i = 0; i < 64; i++) {
-		ctx.coordMap[i] = (i & 7) + (i >> 3) * ctx.pitch;
-
-		ctx.coordScaledMap1[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 0) * ctx.pitch);
-		ctx.coordScaledMap2[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 0) * ctx.pitch);
-		ctx.coordScaledMap3[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 1) * ctx.pitch);
-		ctx.coordScaledMap4[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 1) * ctx.pitch);
-	}
+	ctx.video    = &video;
+	ctx.planeIdx = planeIdx;
+	ctx.width    = blockWidth  * 8;
+	ctx.height   = blockHeight * 8;
+
+	Plane &plane = _planes[planeIdx];
+
+	plane.funcs       = &BinkKernels::getFuncs();
+	plane.dest        = _curPlanes[planeIdx];
+	plane.prev        = _oldPlanes[planeIdx];
+	plane.blockCount  = 0;
+	plane.drawInOrder = false;
 
 	for (int i = 0; i < kSourceMAX; i++) {
 		_bundles[i].countLength = _bundles[i].countLengths[isChroma ? 1 : 0];
@@ -538,62 +561,115 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 		readDCS<kDCStartBits, true> (video, _bundles[kSourceInterDC]);
 		readRuns                    (video, _bundles[kSourceRun]);
 
-		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
-		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
+		plane.rowStarts[ctx.blockY] = plane.blockCount;
 
-		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
+		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++) {
 			BlockType blockType = (BlockType) getBundleValue(kSourceBlockTypes);
 
 			// 16x16 block type on odd line means part of the already decoded block, so skip it
 			if ((ctx.blockY & 1) && (blockType == kBlockScaled)) {
 				ctx.blockX += 1;
-				ctx.dest   += 8;
-				ctx.prev   += 8;
 				continue;
 			}
 
-			switch (blockType) {
-			case kBlockSkip:
-				blockSkip(ctx);
-				break;
-			case kBlockScaled:
-				blockScaled(ctx);
-				break;
-			case kBlockMotion:
-				blockMotion(ctx);
-				break;
-			case kBlockRun:
-				blockRun(ctx);
-				break;
-			case kBlockResidue:
-				blockResidue(ctx);
-				break;
-			case kBlockIntra:
-				blockIntra(ctx);
-				break;
-			case kBlockFill:
-				blockFill(ctx);
-				break;
-			case kBlockInter:
-				blockInter(ctx);
-				break;
-			case kBlockPattern:
-				blockPattern(ctx);
-				break;
-			case kBlockRaw:
-				blockRaw(ctx);
-				break;
-			default:
-				error("Unknown block type: %d", blockType);
-			}
+			Block &block = plane.blocks[plane.blockCount++];
+			block.type   = blockType;
+			block.blockX = ctx.blockX;
+
+			readBlock(ctx, block, blockType);
+
+			if (blockType == kBlockScaled) {
+				// A 16x16 block on the last row or column writes beyond its two rows
+				if ((ctx.blockX + 1 >= blockWidth) || (ctx.blockY + 1 >= blockHeight))
+					plane.drawInOrder = true;
 
+				ctx.blockX += 1;
+			}
 		}
 
 	}
 
+	plane.rowStarts[blockHeight] = plane.blockCount;
+
 	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
 		video.bits->skip(32 - (video.bits->pos() & 0x1F));
 
+	return TaskMan.submit(drawPlane, &plane, "BinkVideoTrack::drawPlane");
+}
+
+void BinkDecoder::BinkVideoTrack::drawPlane(void *param) {
+	const Plane &plane = *(const Plane *)param;
+
+	if (plane.drawInOrder) {
+		drawRows(plane, 0, plane.blockHeight);
+		return;
+	}
+
+	// The blocks of two rows only write to them, since 16x16 blocks start on even rows
+	TaskMan.parallelFor((plane.blockHeight + 1) / 2, kRowPairsPerTask, [&plane](uint begin, uint end) {
+		drawRows(plane, begin * 2, MIN<uint32>(end * 2, plane.blockHeight));
+	}, "BinkVideoTrack::drawRows");
+}
+
+void BinkDecoder::BinkVideoTrack::drawRows(const Plane &plane, uint32 begin, uint32 end) {
+	for (uint32 blockY = begin; blockY < end; blockY++) {
+		for (uint32 i = plane.rowStarts[blockY]; i < plane.rowStarts[blockY + 1]; i++)
+			drawBlock(plane, plane.blocks[i], blockY);
+	}
+}
+
+void BinkDecoder::BinkVideoTrack::drawBlock(const Plane &plane, const Block &block, uint32 blockY) {
+	const BinkKernels::Funcs &funcs = *plane.funcs;
+	const uint32 pitch  = plane.pitch;
+	const uint32 offset = blockY * 8 * pitch + block.blockX * 8;
+
+	byte       *dest = plane.dest + offset;
+	const byte *prev = plane.prev + offset;
+	const byte *motion = prev + block.yOff * ((int32) pitch) + block.xOff;
+
+	int32 coeffs[64];
+
+	switch (block.type) {
+	case kBlockSkip:
+		funcs.copyBlock(dest, prev, pitch);
+		break;
+	case kBlockScaled:
+		if (block.subType == kBlockIntra) {
+			byte pixels[64];
+
+			dequantize(block, true, coeffs);
+			funcs.idctPut(pixels, 8, coeffs);
+			funcs.putScaledBlock(dest, pitch, pixels);
+		} else if (block.subType == kBlockFill) {
+			funcs.fillScaledBlock(dest, pitch, block.color);
+		} else {
+			funcs.putScaledBlock(dest, pitch, block.pixels);
+		}
+		break;
+	case kBlockMotion:
+		funcs.copyBlock(dest, motion, pitch);
+		break;
+	case kBlockResidue:
+		funcs.copyBlock(dest, motion, pitch);
+		funcs.addResidue(dest, pitch, block.coeffs);
+		break;
+	case kBlockIntra:
+		dequantize(block, true, coeffs);
+		funcs.idctPut(dest, pitch, coeffs);
+		break;
+	case kBlockFill:
+		funcs.fillBlock(dest, pitch, block.color);
+		break;
+	case kBlockInter:
+		funcs.copyBlock(dest, motion, pitch);
+		dequantize(block, false, coeffs);
+		funcs.idctAdd(dest, pitch, coeffs);
+		break;
+	default:
+		// Run, pattern and raw blocks
+		funcs.putBlock(dest, pitch, block.pixels);
+		break;
+	}
 }
 
 void BinkDecoder::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
@@ -753,160 +829,72 @@ uint32 BinkDecoder::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &b
 	return n;
 }
 
-void BinkDecoder::BinkVideoTrack::blockSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
-
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 8);
-}
-
-void BinkDecoder::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
-
-	for (int j = 0; j < 16; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 16);
-}
-
-void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
-	const uint8 *scan = binkPatterns[ctx.video->bits->getBits<4>()];
-
-	int i = 0;
-	do {
-		int run = getBundleValue(kSourceRun) + 1;
-
-		i += run;
-		if (i > 64)
-			error("Run went out of bounds");
-
-		if (ctx.video->bits->getBit()) {
-
-			byte v = getBundleValue(kSourceColors);
-			for (int j = 0; j < run; j++, scan++)
-				ctx.dest[ctx.coordScaledMap1[*scan]] =
-				ctx.dest[ctx.coordScaledMap2[*scan]] =
-				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = v;
-
-		} else
-			for (int j = 0; j < run; j++, scan++)
-				ctx.dest[ctx.coordScaledMap1[*scan]] =
-				ctx.dest[ctx.coordScaledMap2[*scan]] =
-				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
-
-	} while (i < 63);
-
-	if (i == 63)
-		ctx.dest[ctx.coordScaledMap1[*scan]] =
-		ctx.dest[ctx.coordScaledMap2[*scan]] =
-		ctx.dest[ctx.coordScaledMap3[*scan]] =
-		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
-}
-
-void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
-
-	block[0] = getBundleValue(kSourceIntraDC);
-
-	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCT(block);
-
-	int32 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
-
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 16; i++, dest += ctx.pitch)
-		memset(dest, v, 16);
-}
-
-void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
-	byte col[2];
-
-	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
-
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		byte v = getBundleValue(kSourcePattern);
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
-	byte row[8];
-
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		memcpy(row, _bundles[kSourceColors].curPtr, 8);
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
-
-		_bundles[kSourceColors].curPtr += 8;
+void BinkDecoder::BinkVideoTrack::readBlock(DecodeContext &ctx, Block &block, BlockType type) {
+	switch (type) {
+	case kBlockSkip:
+		break;
+	case kBlockScaled:
+		readBlockScaled(ctx, block);
+		break;
+	case kBlockMotion:
+		readBlockMotion(ctx, block);
+		break;
+	case kBlockRun:
+		readBlockRun(ctx, block);
+		break;
+	case kBlockResidue:
+		readBlockResidue(ctx, block);
+		break;
+	case kBlockIntra:
+		readBlockIntra(ctx, block);
+		break;
+	case kBlockFill:
+		block.color = getBundleValue(kSourceColors);
+		break;
+	case kBlockInter:
+		readBlockInter(ctx, block);
+		break;
+	case kBlockPattern:
+		readBlockPattern(ctx, block);
+		break;
+	case kBlockRaw:
+		readBlockRaw(ctx, block);
+		break;
+	default:
+		error("Unknown block type: %d", type);
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
+void BinkDecoder::BinkVideoTrack::readBlockScaled(DecodeContext &ctx, Block &block) {
 	BlockType blockType = (BlockType) getBundleValue(kSourceSubBlockTypes);
 
 	switch (blockType) {
 	case kBlockRun:
-		blockScaledRun(ctx);
-		break;
 	case kBlockIntra:
-		blockScaledIntra(ctx);
-		break;
 	case kBlockFill:
-		blockScaledFill(ctx);
-		break;
 	case kBlockPattern:
-		blockScaledPattern(ctx);
-		break;
 	case kBlockRaw:
-		blockScaledRaw(ctx);
+		block.subType = blockType;
+		readBlock(ctx, block, blockType);
 		break;
 	default:
 		error("Invalid 16x16 block type: %d", blockType);
 	}
-
-	ctx.blockX += 1;
-	ctx.dest   += 8;
-	ctx.prev   += 8;
 }
 
-void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
-	int8 xOff = getBundleValue(kSourceXOff);
-	int8 yOff = getBundleValue(kSourceYOff);
+void BinkDecoder::BinkVideoTrack::readBlockMotion(DecodeContext &ctx, Block &block) {
+	block.xOff = getBundleValue(kSourceXOff);
+	block.yOff = getBundleValue(kSourceYOff);
 
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
-	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd))
-		error("Copy out of bounds (%d | %d)", ctx.blockX * 8 + xOff, ctx.blockY * 8 + yOff);
+	int32 x = ctx.blockX * 8 + block.xOff;
+	int32 y = ctx.blockY * 8 + block.yOff;
 
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		memcpy(dest, prev, 8);
+	int32 offset = y * ((int32) ctx.width) + x;
+	if ((offset < 0) || (offset > (int32) (ctx.width * ctx.height)))
+		error("Copy out of bounds (%d | %d)", x, y);
 }
 
-void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
+void BinkDecoder::BinkVideoTrack::readBlockRun(DecodeContext &ctx, Block &block) {
 	const uint8 *scan = binkPatterns[ctx.video->bits->getBits<4>()];
 
 	int i = 0;
@@ -921,75 +909,54 @@ void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
 
 			byte v = getBundleValue(kSourceColors);
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = v;
+				block.pixels[*scan++] = v;
 
 		} else
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+				block.pixels[*scan++] = getBundleValue(kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+		block.pixels[*scan++] = getBundleValue(kSourceColors);
 }
 
-void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
-	blockMotion(ctx);
+void BinkDecoder::BinkVideoTrack::readBlockResidue(DecodeContext &ctx, Block &block) {
+	readBlockMotion(ctx, block);
 
 	byte v = ctx.video->bits->getBits<7>();
 
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+	memset(block.coeffs, 0, 64 * sizeof(int16));
 
-	readResidue(*ctx.video, block, v);
-
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	readResidue(*ctx.video, block.coeffs, v);
 }
 
-void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
-
-	block[0] = getBundleValue(kSourceIntraDC);
+void BinkDecoder::BinkVideoTrack::readBlockIntra(DecodeContext &ctx, Block &block) {
+	memset(block.coeffs, 0, 64 * sizeof(int16));
 
-	readDCTCoeffs(*ctx.video, block, true);
+	block.coeffs[0] = getBundleValue(kSourceIntraDC);
 
-	IDCTPut(ctx, block);
+	block.quantIdx = readDCTCoeffs(*ctx.video, block.coeffs);
 }
 
-void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+void BinkDecoder::BinkVideoTrack::readBlockInter(DecodeContext &ctx, Block &block) {
+	readBlockMotion(ctx, block);
 
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch)
-		memset(dest, v, 8);
-}
-
-void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
-	blockMotion(ctx);
-
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	memset(block.coeffs, 0, 64 * sizeof(int16));
 
-	block[0] = getBundleValue(kSourceInterDC);
+	block.coeffs[0] = getBundleValue(kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
-
-	IDCTAdd(ctx, block);
+	block.quantIdx = readDCTCoeffs(*ctx.video, block.coeffs);
 }
 
-void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
+void BinkDecoder::BinkVideoTrack::readBlockPattern(DecodeContext &ctx, Block &block) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
 		col[i] = getBundleValue(kSourceColors);
 
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
+	byte *dest = block.pixels;
+	for (int i = 0; i < 8; i++) {
 		byte v = getBundleValue(kSourcePattern);
 
 		for (int j = 0; j < 8; j++, v >>= 1)
@@ -997,11 +964,8 @@ void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::blockRaw(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *data = _bundles[kSourceColors].curPtr;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
-		memcpy(dest, data, 8);
+void BinkDecoder::BinkVideoTrack::readBlockRaw(DecodeContext &ctx, Block &block) {
+	memcpy(block.pixels, _bundles[kSourceColors].curPtr, 64);
 
 	_bundles[kSourceColors].curPtr += 64;
 }
@@ -1208,11 +1172,8 @@ void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle) {
 	bundle.curDec = (byte *) dest;
 }
 
-/** Reads 8x8 block of DCT coefficients. */
-void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block, bool isIntra) {
-	int coefCount = 0;
-	int coefIdx[64];
-
+/** Reads 8x8 block of DCT coefficients in scan order, and returns the quantizer index. */
+byte BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int16 *coeffs) {
 	int listStart = 64;
 	int listEnd   = 64;
 
@@ -1262,8 +1223,7 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 							int sign = -(int)video.bits->getBit();
 							t = (t ^ sign) - sign;
 						}
-						block[binkScan[ccoef]] = t;
-						coefIdx[coefCount++]   = ccoef;
+						coeffs[ccoef] = t;
 					}
 				}
 				break;
@@ -1287,10 +1247,9 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 					int sign = -(int)video.bits->getBit();
 					t = (t ^ sign) - sign;
 				}
-				block[binkScan[ccoef]] = t;
-				coefIdx[coefCount++]   = ccoef;
-				coefList[listPos]      = 0;
-				modeList[listPos++]    = 0;
+				coeffs[ccoef]       = t;
+				coefList[listPos]   = 0;
+				modeList[listPos++] = 0;
 				break;
 
 			default:
@@ -1299,15 +1258,14 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 		}
 	}
 
-	uint8 quantIdx = video.bits->getBits<4>();
-	const int32 *quant = isIntra ? binkIntraQuant[quantIdx] : binkInterQuant[quantIdx];
-	block[0] = (block[0] * quant[0]) >> 11;
+	return video.bits->getBits<4>();
+}
 
-	for (int i = 0; i < coefCount; i++) {
-		int idx = coefIdx[i];
-		block[binkScan[idx]] = (block[binkScan[idx]] * quant[idx]) >> 11;
-	}
+void BinkDecoder::BinkVideoTrack::dequantize(const Block &block, bool isIntra, int32 *coeffs) {
+	const int32 *quant = isIntra ? binkIntraQuant[block.quantIdx] : binkInterQuant[block.quantIdx];
 
+	for (int i = 0; i < 64; i++)
+		coeffs[binkScan[i]] = (block.coeffs[i] * quant[i]) >> 11;
 }
 
 /** Reads 8x8 block with residue after motion compensation. */
@@ -1408,10 +1366,10 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
+#define A1 BinkKernels::kA1
+#define A2 BinkKernels::kA2
+#define A3 BinkKernels::kA3
+#define A4 BinkKernels::kA4
 
 #define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
 	const int a0 = (src)[s0] + (src)[s4]; \
@@ -1459,35 +1417,91 @@ static inline void IDCTCol(int32 *dest, const int32 *src) {
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
+static void idctPutGeneric(byte *dest, uint32 pitch, const int32 *block) {
 	int32 temp[64];
 
-	for (i = 0; i < 8; i++)
+	for (int i = 0; i < 8; i++)
 		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	for (int i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
+static void idctAddGeneric(byte *dest, uint32 pitch, const int32 *block) {
+	int32 temp[64], row[8];
 
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
+	for (int i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		IDCT_ROW(row, (&temp[8*i]));
+
+		for (int j = 0; j < 8; j++)
+			dest[j] += row[j];
+	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
+static void addResidueGeneric(byte *dest, uint32 pitch, const int16 *residue) {
+	for (int i = 0; i < 8; i++, dest += pitch, residue += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += residue[j];
+}
+
+static void copyBlockGeneric(byte *dest, const byte *src, uint32 pitch) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += pitch)
+		memcpy(dest, src, 8);
+}
+
+static void putBlockGeneric(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += 8)
+		memcpy(dest, src, 8);
+}
+
+static void putScaledBlockGeneric(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 8; i++, dest += 2 * pitch, src += 8) {
+		for (int j = 0; j < 8; j++)
+			dest[2 * j] = dest[2 * j + 1] = src[j];
+
+		memcpy(dest + pitch, dest, 16);
+	}
+}
+
+static void fillBlockGeneric(byte *dest, uint32 pitch, byte value) {
+	for (int i = 0; i < 8; i++, dest += pitch)
+		memset(dest, value, 8);
+}
+
+static void fillScaledBlockGeneric(byte *dest, uint32 pitch, byte value) {
+	for (int i = 0; i < 16; i++, dest += pitch)
+		memset(dest, value, 16);
+}
+
+const BinkKernels::Funcs BinkKernels::funcsGeneric = {
+	idctPutGeneric,
+	idctAddGeneric,
+	addResidueGeneric,
+	copyBlockGeneric,
+	putBlockGeneric,
+	putScaledBlockGeneric,
+	fillBlockGeneric,
+	fillScaledBlockGeneric
+};
+
+const BinkKernels::Funcs *BinkKernels::selectedFuncs = nullptr;
+
+const BinkKernels::Funcs &BinkKernels::getFuncs() {
+	if (!selectedFuncs) {
+		selectedFuncs = &funcsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			selectedFuncs = &funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			selectedFuncs = &funcsSSE2;
+#endif
 	}
+
+	return *selectedFuncs;
 }
 
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
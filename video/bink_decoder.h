@@ -33,8 +33,10 @@
 #include "common/array.h"
 #include "common/bitstream.h"
 #include "common/rational.h"
+#include "common/taskscheduler.h"
 
 #include "video/video_decoder.h"
+#include "video/bink_decoder_intern.h"
 
 #include "graphics/surface.h"
 
@@ -183,19 +185,8 @@ private:
 			uint32 blockX;
 			uint32 blockY;
 
-			byte *dest;
-			byte *prev;
-
-			byte *destStart, *destEnd;
-			byte *prevStart, *prevEnd;
-
-			uint32 pitch;
-
-			int coordMap[64];
-			int coordScaledMap1[64];
-			int coordScaledMap2[64];
-			int coordScaledMap3[64];
-			int coordScaledMap4[64];
+			uint32 width;
+			uint32 height;
 		};
 
 		/** IDs for different data types used in Bink video codec. */
@@ -227,6 +218,47 @@ private:
 			kBlockRaw           ///< Uncoded 8x8 block.
 		};
 
+		/**
+		 * A block read from the bitstream. The blocks of a plane are drawn
+		 * once the whole plane is read, see decodePlane().
+		 */
+		struct Block {
+			byte type;       ///< The BlockType.
+			byte subType;    ///< The BlockType of the 16x16 block of a kBlockScaled block.
+			byte color;      ///< The color of fill blocks.
+			byte quantIdx;   ///< The quantizer of DCT blocks.
+			int8 xOff;       ///< The motion vector of motion compensated blocks.
+			int8 yOff;
+			uint16 blockX;
+
+			union {
+				int16 coeffs[64]; ///< The DCT coefficients in scan order, or the residue.
+				byte pixels[64];  ///< The pixels of run, pattern and raw blocks.
+			};
+		};
+
+		/** The blocks of a plane. */
+		struct Plane {
+			const BinkKernels::Funcs *funcs;
+
+			byte *dest;
+			const byte *prev;
+			uint32 pitch;
+
+			uint32 blockHeight;
+
+			Common::Array<Block> blocks;
+			uint32 blockCount;
+			/** The index of the first block of each row, and the block count. */
+			Common::Array<uint32> rowStarts;
+
+			/**
+			 * Whether a 16x16 block is cut by the plane edge, and writes to
+			 * the rows below. The blocks are then drawn in order.
+			 */
+			bool drawInOrder;
+		};
+
 		/** Data structure for decoding and tranlating Huffman'd data. */
 		struct Huffman {
 			int  index;       ///< Index of the Huffman codebook to use.
@@ -281,6 +313,8 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		Plane _planes[4]; ///< The blocks of the 4 color planes, YUVA.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -289,8 +323,18 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
-		/** Decode a plane. */
-		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		/**
+		 * Read the blocks of a plane, and start drawing them on worker threads.
+		 *
+		 * @return The task drawing the plane.
+		 */
+		Common::TaskFuture decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+
+		/** Draw the blocks of a plane, in parallel rows. */
+		static void drawPlane(void *param);
+		/** Draw the blocks of rows [begin, end) of a plane. */
+		static void drawRows(const Plane &plane, uint32 begin, uint32 end);
+		static void drawBlock(const Plane &plane, const Block &block, uint32 blockY);
 
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
@@ -308,23 +352,16 @@ private:
 		/** Read a count value out of a bundle. */
 		uint32 readBundleCount(VideoFrame &video, Bundle &bundle);
 
-		// Handle the block types
-		void blockSkip         (DecodeContext &ctx);
-		void blockScaledSkip   (DecodeContext &ctx);
-		void blockScaledRun    (DecodeContext &ctx);
-		void blockScaledIntra  (DecodeContext &ctx);
-		void blockScaledFill   (DecodeContext &ctx);
-		void blockScaledPattern(DecodeContext &ctx);
-		void blockScaledRaw    (DecodeContext &ctx);
-		void blockScaled       (DecodeContext &ctx);
-		void blockMotion       (DecodeContext &ctx);
-		void blockRun          (DecodeContext &ctx);
-		void blockResidue      (DecodeContext &ctx);
-		void blockIntra        (DecodeContext &ctx);
-		void blockFill         (DecodeContext &ctx);
-		void blockInter        (DecodeContext &ctx);
-		void blockPattern      (DecodeContext &ctx);
-		void blockRaw          (DecodeContext &ctx);
+		// Read the block types
+		void readBlock        (DecodeContext &ctx, Block &block, BlockType type);
+		void readBlockScaled  (DecodeContext &ctx, Block &block);
+		void readBlockMotion  (DecodeContext &ctx, Block &block);
+		void readBlockRun     (DecodeContext &ctx, Block &block);
+		void readBlockResidue (DecodeContext &ctx, Block &block);
+		void readBlockIntra   (DecodeContext &ctx, Block &block);
+		void readBlockInter   (DecodeContext &ctx, Block &block);
+		void readBlockPattern (DecodeContext &ctx, Block &block);
+		void readBlockRaw     (DecodeContext &ctx, Block &block);
 
 		// Read the bundles
 		void readRuns        (VideoFrame &video, Bundle &bundle);
@@ -334,13 +371,11 @@ private:
 		void readColors      (VideoFrame &video, Bundle &bundle);
 		template<int startBits, bool hasSign>
 		void readDCS         (VideoFrame &video, Bundle &bundle);
-		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
+		byte readDCTCoeffs   (VideoFrame &video, int16 *coeffs);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
+		/** Dequantize the coefficients of a DCT block. */
+		static void dequantize(const Block &block, bool isIntra, int32 *coeffs);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -0,0 +1,85 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VIDEO_BINK_DECODER_INTERN_H
+#define VIDEO_BINK_DECODER_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * The kernels drawing the 8x8 blocks of Bink video planes, with SIMD
+ * variants selected at runtime.
+ *
+ * All variants produce exactly the same pixels. Like the reference
+ * decoder, pixel values are truncated to 8 bits instead of being clamped.
+ */
+class BinkKernels {
+public:
+	/** The IDCT constants, in 4.11 fixed point. */
+	enum {
+		kA1 =  2896, ///< 1 / sqrt(2)
+		kA2 =  2217,
+		kA3 =  3784,
+		kA4 = -5352
+	};
+
+	struct Funcs {
+		/** Write the IDCT of 64 dequantized coefficients to an 8x8 block. */
+		void (*idctPut)(byte *dest, uint32 pitch, const int32 *block);
+		/** Add the IDCT of 64 dequantized coefficients to an 8x8 block. */
+		void (*idctAdd)(byte *dest, uint32 pitch, const int32 *block);
+		/** Add 64 residue values to an 8x8 block. */
+		void (*addResidue)(byte *dest, uint32 pitch, const int16 *residue);
+		/** Copy an 8x8 block between planes of the same pitch. */
+		void (*copyBlock)(byte *dest, const byte *src, uint32 pitch);
+		/** Copy 64 contiguous pixels to an 8x8 block. */
+		void (*putBlock)(byte *dest, uint32 pitch, const byte *src);
+		/** Copy 64 contiguous pixels to a 16x16 block, doubling each one. */
+		void (*putScaledBlock)(byte *dest, uint32 pitch, const byte *src);
+		/** Fill an 8x8 block. */
+		void (*fillBlock)(byte *dest, uint32 pitch, byte value);
+		/** Fill a 16x16 block. */
+		void (*fillScaledBlock)(byte *dest, uint32 pitch, byte value);
+	};
+
+	/**
+	 * Return the kernels best suited for the CPU we are running on.
+	 * The selection is done on the first call.
+	 */
+	static const Funcs &getFuncs();
+
+	/** The kernels in use, nullptr until they have been selected. */
+	static const Funcs *selectedFuncs;
+
+	static const Funcs funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs funcsSSE2;
+#endif
+};
+
+} // End of namespace Video
+
+#endif
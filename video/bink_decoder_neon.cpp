@@ -0,0 +1,230 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "video/bink_decoder_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Video {
+
+static inline int32x4_t mulShiftNEON(int32x4_t a, int32 c) {
+	return vshrq_n_s32(vmulq_n_s32(a, c), 11);
+}
+
+/**
+ * The one dimensional IDCT of four columns or rows at once. The rows are
+ * rounded, and scaled down to pixel values.
+ */
+template<bool kRow>
+static inline void idctTransformNEON(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = mulShiftNEON(vsubq_s32(s[2], s[6]), BinkKernels::kA1);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = mulShiftNEON(vaddq_s32(a5, a7), BinkKernels::kA3);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(mulShiftNEON(a5, BinkKernels::kA4), b0), b1);
+	const int32x4_t b3 = vsubq_s32(mulShiftNEON(vsubq_s32(a6, a4), BinkKernels::kA1), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(mulShiftNEON(a7, BinkKernels::kA2), b3), b1);
+
+	const int32x4_t c0 = vaddq_s32(a0, a2);
+	const int32x4_t c1 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t c2 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	const int32x4_t c3 = vsubq_s32(a0, a2);
+
+	d[0] = vaddq_s32(c0, b0);
+	d[1] = vaddq_s32(c1, b2);
+	d[2] = vaddq_s32(c2, b3);
+	d[3] = vsubq_s32(c3, b4);
+	d[4] = vaddq_s32(c3, b4);
+	d[5] = vsubq_s32(c2, b3);
+	d[6] = vsubq_s32(c1, b2);
+	d[7] = vsubq_s32(c0, b0);
+
+	if (kRow) {
+		const int32x4_t round = vdupq_n_s32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = vshrq_n_s32(vaddq_s32(d[i], round), 8);
+	}
+}
+
+static inline void transposeNEON(int32x4_t *d0, int32x4_t *d1, int32x4_t *d2, int32x4_t *d3, int32x4_t s0, int32x4_t s1, int32x4_t s2, int32x4_t s3) {
+	const int32x4x2_t t0 = vtrnq_s32(s0, s1);
+	const int32x4x2_t t1 = vtrnq_s32(s2, s3);
+	*d0 = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+	*d1 = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+	*d2 = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+	*d3 = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+/**
+ * The two dimensional IDCT of a block, as the pixel values of each row
+ * truncated to 8 bits.
+ *
+ * The vectors hold four values, rows[2 * i + h] being columns [4 * h, 4 * h + 4)
+ * of row i.
+ */
+static inline void idctNEON(uint8x8_t *pixels, const int32 *block) {
+	int32x4_t rows[16], cols[16], src[8], dst[8];
+
+	// The columns, four at a time. The generic shortcut for columns with
+	// only a DC coefficient gives the same result as the transform.
+	for (int h = 0; h < 2; h++) {
+		for (int i = 0; i < 8; i++)
+			src[i] = vld1q_s32(block + 8 * i + 4 * h);
+
+		idctTransformNEON<false>(dst, src);
+
+		for (int i = 0; i < 8; i++)
+			rows[2 * i + h] = dst[i];
+	}
+
+	// cols[2 * j + h] are rows [4 * h, 4 * h + 4) of column j
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeNEON(&cols[2 * (4 * q + 0) + h], &cols[2 * (4 * q + 1) + h], &cols[2 * (4 * q + 2) + h], &cols[2 * (4 * q + 3) + h],
+			              rows[2 * (4 * h + 0) + q], rows[2 * (4 * h + 1) + q], rows[2 * (4 * h + 2) + q], rows[2 * (4 * h + 3) + q]);
+		}
+	}
+
+	// The rows, four at a time
+	for (int h = 0; h < 2; h++) {
+		for (int j = 0; j < 8; j++)
+			src[j] = cols[2 * j + h];
+
+		idctTransformNEON<true>(dst, src);
+
+		for (int j = 0; j < 8; j++)
+			cols[2 * j + h] = dst[j];
+	}
+
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeNEON(&rows[2 * (4 * h + 0) + q], &rows[2 * (4 * h + 1) + q], &rows[2 * (4 * h + 2) + q], &rows[2 * (4 * h + 3) + q],
+			              cols[2 * (4 * q + 0) + h], cols[2 * (4 * q + 1) + h], cols[2 * (4 * q + 2) + h], cols[2 * (4 * q + 3) + h]);
+		}
+	}
+
+	// The narrowing moves keep the low bits
+	for (int i = 0; i < 8; i++) {
+		const int16x8_t row = vcombine_s16(vmovn_s32(rows[2 * i]), vmovn_s32(rows[2 * i + 1]));
+		pixels[i] = vreinterpret_u8_s8(vmovn_s16(row));
+	}
+}
+
+static void idctPutNEON(byte *dest, uint32 pitch, const int32 *block) {
+	uint8x8_t pixels[8];
+	idctNEON(pixels, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, pixels[i]);
+}
+
+static void idctAddNEON(byte *dest, uint32 pitch, const int32 *block) {
+	uint8x8_t pixels[8];
+	idctNEON(pixels, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), pixels[i]));
+}
+
+static void addResidueNEON(byte *dest, uint32 pitch, const int16 *residue) {
+	for (int i = 0; i < 8; i++, dest += pitch, residue += 8) {
+		const uint8x8_t row = vreinterpret_u8_s8(vmovn_s16(vld1q_s16(residue)));
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), row));
+	}
+}
+
+static void copyBlockNEON(byte *dest, const byte *src, uint32 pitch) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += pitch)
+		vst1_u8(dest, vld1_u8(src));
+}
+
+static void putBlockNEON(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += 8)
+		vst1_u8(dest, vld1_u8(src));
+}
+
+static void putScaledBlockNEON(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 8; i++, dest += 2 * pitch, src += 8) {
+		const uint8x8_t row = vld1_u8(src);
+		const uint8x8x2_t doubled = vzip_u8(row, row);
+		const uint8x16_t scaled = vcombine_u8(doubled.val[0], doubled.val[1]);
+		vst1q_u8(dest, scaled);
+		vst1q_u8(dest + pitch, scaled);
+	}
+}
+
+static void fillBlockNEON(byte *dest, uint32 pitch, byte value) {
+	const uint8x8_t fill = vdup_n_u8(value);
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, fill);
+}
+
+static void fillScaledBlockNEON(byte *dest, uint32 pitch, byte value) {
+	const uint8x16_t fill = vdupq_n_u8(value);
+	for (int i = 0; i < 16; i++, dest += pitch)
+		vst1q_u8(dest, fill);
+}
+
+const BinkKernels::Funcs BinkKernels::funcsNEON = {
+	idctPutNEON,
+	idctAddNEON,
+	addResidueNEON,
+	copyBlockNEON,
+	putBlockNEON,
+	putScaledBlockNEON,
+	fillBlockNEON,
+	fillScaledBlockNEON
+};
+
+} // End of namespace Video
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,252 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "video/bink_decoder_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Video {
+
+/** The low 32 bits of the products of four 32 bit values by a constant. */
+static FORCEINLINE __m128i mulSSE2(__m128i a, int32 c) {
+	const __m128i cv = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(a, cv);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), cv);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static FORCEINLINE __m128i mulShiftSSE2(__m128i a, int32 c) {
+	return _mm_srai_epi32(mulSSE2(a, c), 11);
+}
+
+/**
+ * The one dimensional IDCT of four columns or rows at once. The rows are
+ * rounded, and scaled down to pixel values.
+ */
+template<bool kRow>
+static FORCEINLINE void idctTransformSSE2(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = mulShiftSSE2(_mm_sub_epi32(s[2], s[6]), BinkKernels::kA1);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = mulShiftSSE2(_mm_add_epi32(a5, a7), BinkKernels::kA3);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(mulShiftSSE2(a5, BinkKernels::kA4), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(mulShiftSSE2(_mm_sub_epi32(a6, a4), BinkKernels::kA1), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(mulShiftSSE2(a7, BinkKernels::kA2), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_sub_epi32(a0, a2);
+
+	d[0] = _mm_add_epi32(c0, b0);
+	d[1] = _mm_add_epi32(c1, b2);
+	d[2] = _mm_add_epi32(c2, b3);
+	d[3] = _mm_sub_epi32(c3, b4);
+	d[4] = _mm_add_epi32(c3, b4);
+	d[5] = _mm_sub_epi32(c2, b3);
+	d[6] = _mm_sub_epi32(c1, b2);
+	d[7] = _mm_sub_epi32(c0, b0);
+
+	if (kRow) {
+		const __m128i round = _mm_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm_srai_epi32(_mm_add_epi32(d[i], round), 8);
+	}
+}
+
+static FORCEINLINE void transposeSSE2(__m128i *d0, __m128i *d1, __m128i *d2, __m128i *d3, __m128i s0, __m128i s1, __m128i s2, __m128i s3) {
+	const __m128i t0 = _mm_unpacklo_epi32(s0, s1);
+	const __m128i t1 = _mm_unpacklo_epi32(s2, s3);
+	const __m128i t2 = _mm_unpackhi_epi32(s0, s1);
+	const __m128i t3 = _mm_unpackhi_epi32(s2, s3);
+	*d0 = _mm_unpacklo_epi64(t0, t1);
+	*d1 = _mm_unpackhi_epi64(t0, t1);
+	*d2 = _mm_unpacklo_epi64(t2, t3);
+	*d3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/**
+ * The two dimensional IDCT of a block, as the pixel values of each row
+ * truncated to 8 bits.
+ *
+ * The vectors hold four values, rows[2 * i + h] being columns [4 * h, 4 * h + 4)
+ * of row i.
+ */
+static FORCEINLINE void idctSSE2(__m128i *pixels, const int32 *block) {
+	__m128i rows[16], cols[16], src[8], dst[8];
+
+	// The columns, four at a time. The generic shortcut for columns with
+	// only a DC coefficient gives the same result as the transform.
+	for (int h = 0; h < 2; h++) {
+		for (int i = 0; i < 8; i++)
+			src[i] = _mm_loadu_si128((const __m128i *)(block + 8 * i + 4 * h));
+
+		idctTransformSSE2<false>(dst, src);
+
+		for (int i = 0; i < 8; i++)
+			rows[2 * i + h] = dst[i];
+	}
+
+	// cols[2 * j + h] are rows [4 * h, 4 * h + 4) of column j
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeSSE2(&cols[2 * (4 * q + 0) + h], &cols[2 * (4 * q + 1) + h], &cols[2 * (4 * q + 2) + h], &cols[2 * (4 * q + 3) + h],
+			              rows[2 * (4 * h + 0) + q], rows[2 * (4 * h + 1) + q], rows[2 * (4 * h + 2) + q], rows[2 * (4 * h + 3) + q]);
+		}
+	}
+
+	// The rows, four at a time
+	for (int h = 0; h < 2; h++) {
+		for (int j = 0; j < 8; j++)
+			src[j] = cols[2 * j + h];
+
+		idctTransformSSE2<true>(dst, src);
+
+		for (int j = 0; j < 8; j++)
+			cols[2 * j + h] = dst[j];
+	}
+
+	for (int h = 0; h < 2; h++) {
+		for (int q = 0; q < 2; q++) {
+			transposeSSE2(&rows[2 * (4 * h + 0) + q], &rows[2 * (4 * h + 1) + q], &rows[2 * (4 * h + 2) + q], &rows[2 * (4 * h + 3) + q],
+			              cols[2 * (4 * q + 0) + h], cols[2 * (4 * q + 1) + h], cols[2 * (4 * q + 2) + h], cols[2 * (4 * q + 3) + h]);
+		}
+	}
+
+	// Two rows of 8 bit pixels per vector
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	for (int i = 0; i < 4; i++) {
+		const __m128i row0 = _mm_packs_epi32(_mm_and_si128(rows[4 * i + 0], mask), _mm_and_si128(rows[4 * i + 1], mask));
+		const __m128i row1 = _mm_packs_epi32(_mm_and_si128(rows[4 * i + 2], mask), _mm_and_si128(rows[4 * i + 3], mask));
+		pixels[i] = _mm_packus_epi16(row0, row1);
+	}
+}
+
+static void idctPutSSE2(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i pixels[4];
+	idctSSE2(pixels, block);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch) {
+		_mm_storel_epi64((__m128i *)dest, pixels[i]);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(pixels[i], pixels[i]));
+	}
+}
+
+static void idctAddSSE2(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i pixels[4];
+	idctSSE2(pixels, block);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch) {
+		const __m128i old = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dest), _mm_loadl_epi64((const __m128i *)(dest + pitch)));
+		const __m128i sum = _mm_add_epi8(old, pixels[i]);
+		_mm_storel_epi64((__m128i *)dest, sum);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(sum, sum));
+	}
+}
+
+static void addResidueSSE2(byte *dest, uint32 pitch, const int16 *residue) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch, residue += 16) {
+		const __m128i row0 = _mm_and_si128(_mm_loadu_si128((const __m128i *)residue), mask);
+		const __m128i row1 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(residue + 8)), mask);
+		const __m128i old = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dest), _mm_loadl_epi64((const __m128i *)(dest + pitch)));
+		const __m128i sum = _mm_add_epi8(old, _mm_packus_epi16(row0, row1));
+		_mm_storel_epi64((__m128i *)dest, sum);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(sum, sum));
+	}
+}
+
+static void copyBlockSSE2(byte *dest, const byte *src, uint32 pitch) {
+	for (int i = 0; i < 8; i++, dest += pitch, src += pitch)
+		_mm_storel_epi64((__m128i *)dest, _mm_loadl_epi64((const __m128i *)src));
+}
+
+static void putBlockSSE2(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 4; i++, dest += 2 * pitch, src += 16) {
+		const __m128i rows = _mm_loadu_si128((const __m128i *)src);
+		_mm_storel_epi64((__m128i *)dest, rows);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(rows, rows));
+	}
+}
+
+static void putScaledBlockSSE2(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 8; i++, dest += 2 * pitch, src += 8) {
+		const __m128i row = _mm_loadl_epi64((const __m128i *)src);
+		const __m128i scaled = _mm_unpacklo_epi8(row, row);
+		_mm_storeu_si128((__m128i *)dest, scaled);
+		_mm_storeu_si128((__m128i *)(dest + pitch), scaled);
+	}
+}
+
+static void fillBlockSSE2(byte *dest, uint32 pitch, byte value) {
+	const __m128i fill = _mm_set1_epi8((char)value);
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, fill);
+}
+
+static void fillScaledBlockSSE2(byte *dest, uint32 pitch, byte value) {
+	const __m128i fill = _mm_set1_epi8((char)value);
+	for (int i = 0; i < 16; i++, dest += pitch)
+		_mm_storeu_si128((__m128i *)dest, fill);
+}
+
+const BinkKernels::Funcs BinkKernels::funcsSSE2 = {
+	idctPutSSE2,
+	idctAddSSE2,
+	addResidueSSE2,
+	copyBlockSSE2,
+	putBlockSSE2,
+	putScaledBlockSSE2,
+	fillBlockSSE2,
+	fillScaledBlockSSE2
+};
+
+} // End of namespace Video
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
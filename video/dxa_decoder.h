@@ -71,6 +71,7 @@ private:
 		const Graphics::Surface *decodeNextFrame();
 		const byte *getPalette() const { _dirtyPalette = false; return _palette.data(); }
 		bool hasDirtyPalette() const { return _dirtyPalette; }
+		bool canDecodeAhead() const { return true; }
 
 		void setFrameStartPos();
 
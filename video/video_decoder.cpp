@@ -24,12 +24,264 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/config-manager.h"
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/taskscheduler.h"
+
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * Decodes the frames of another video track ahead on the worker threads of
+ * TaskMan, into a ring of surfaces.
+ *
+ * Only one frame is decoded at a time. The decoded frames are only picked up
+ * by the thread using the decoder, once it sees that the decoding task is
+ * finished, so the track itself is never used by two threads at once.
+ * Decoding starts with the first decodeNextFrame() call, so the output
+ * format can still be set before.
+ */
+class VideoDecoder::FrameAheadVideoTrack : public VideoTrack {
+public:
+	FrameAheadVideoTrack(VideoTrack *track, uint count);
+	~FrameAheadVideoTrack() override;
+
+	bool endOfTrack() const override;
+	bool isRewindable() const override { return _track->isRewindable(); }
+	bool rewind() override;
+	bool isSeekable() const override { return _track->isSeekable(); }
+	bool seek(const Audio::Timestamp &time) override;
+	Audio::Timestamp getDuration() const override { return _track->getDuration(); }
+
+	uint16 getWidth() const override { return _track->getWidth(); }
+	uint16 getHeight() const override { return _track->getHeight(); }
+	Graphics::PixelFormat getPixelFormat() const override { return _track->getPixelFormat(); }
+	bool setOutputPixelFormat(const Graphics::PixelFormat &format) override;
+	void setCodecAccuracy(Image::CodecAccuracy accuracy) override;
+	int getCurFrame() const override { return _curFrame; }
+	int getFrameCount() const override { return _track->getFrameCount(); }
+	uint32 getNextFrameStartTime() const override;
+	const Graphics::Surface *decodeNextFrame() override;
+	const byte *getPalette() const override { _dirtyPalette = false; return _palette; }
+	bool hasDirtyPalette() const override { return _dirtyPalette; }
+	Audio::Timestamp getFrameTime(uint frame) const override { return _track->getFrameTime(frame); }
+	bool setReverse(bool reverse) override;
+	bool isReversed() const override { return _track->isReversed(); }
+	bool canDither() const override { return _track->canDither(); }
+	void setDither(const byte *palette) override;
+
+	const FrameAheadStats &getStats() const { return _stats; }
+
+protected:
+	void pauseIntern(bool shouldPause) override;
+
+private:
+	struct Frame {
+		Graphics::Surface surface;
+		bool hasSurface;
+		uint32 startTime;
+		int curFrame;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	/** Decode the frame of the task, on a worker thread. */
+	static void decodeFrame(void *param);
+
+	/** Start decoding the next frame if there is room for it. */
+	void fill() const;
+	/** Wait for the frame being decoded, and queue it. */
+	void finishDecode() const;
+	/** Drop the decoded frames before changing the position of the track. */
+	void flush();
+	void updatePalette(const byte *palette);
+
+	VideoTrack *_track;
+	uint _count;
+	bool _started;
+
+	mutable Frame _frames[kMaxFramesAhead + 1];
+	mutable uint _queueStart, _queueSize;
+
+	mutable Common::TaskFuture _future;
+	mutable bool _decoding;
+	mutable uint _decodeSlot;
+	mutable uint32 _decodeMillis;
+
+	int _curFrame;
+	mutable bool _dirtyPalette;
+	byte _palette[256 * 3];
+
+	mutable FrameAheadStats _stats;
+};
+
+VideoDecoder::FrameAheadVideoTrack::FrameAheadVideoTrack(VideoTrack *track, uint count) :
+		_track(track), _count(count), _started(false), _queueStart(0), _queueSize(0),
+		_decoding(false), _decodeSlot(0), _decodeMillis(0), _curFrame(track->getCurFrame()), _dirtyPalette(false) {
+	memset(_palette, 0, sizeof(_palette));
+	memset(&_stats, 0, sizeof(_stats));
+	for (uint i = 0; i <= kMaxFramesAhead; i++)
+		_frames[i].hasSurface = false;
+}
+
+VideoDecoder::FrameAheadVideoTrack::~FrameAheadVideoTrack() {
+	finishDecode();
+	for (uint i = 0; i <= kMaxFramesAhead; i++)
+		_frames[i].surface.free();
+	delete _track;
+}
+
+void VideoDecoder::FrameAheadVideoTrack::decodeFrame(void *param) {
+	FrameAheadVideoTrack *track = (FrameAheadVideoTrack *)param;
+	Frame &frame = track->_frames[track->_decodeSlot];
+	const uint32 start = g_system->getMillis();
+
+	const Graphics::Surface *surface = track->_track->decodeNextFrame();
+	frame.hasSurface = surface != nullptr;
+	if (surface) {
+		if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format)
+			frame.surface.create(surface->w, surface->h, surface->format);
+		frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+	}
+
+	frame.curFrame = track->_track->getCurFrame();
+	frame.dirtyPalette = track->_track->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, track->_track->getPalette(), sizeof(frame.palette));
+
+	track->_decodeMillis = g_system->getMillis() - start;
+}
+
+void VideoDecoder::FrameAheadVideoTrack::finishDecode() const {
+	if (!_decoding)
+		return;
+
+	_future.wait();
+	_future = Common::TaskFuture();
+	_decoding = false;
+	_queueSize++;
+
+	_stats.framesDecoded++;
+	uint bucket = 0;
+	while (bucket < FrameAheadStats::kDecodeTimeBuckets - 1 && _decodeMillis >= (1u << bucket))
+		bucket++;
+	_stats.decodeTime[bucket]++;
+}
+
+void VideoDecoder::FrameAheadVideoTrack::fill() const {
+	if (_decoding && _future.isReady())
+		finishDecode();
+
+	// The slot before the queue holds the frame being shown
+	if (!_started || _decoding || _queueSize >= _count || _track->endOfTrack())
+		return;
+
+	_decodeSlot = (_queueStart + _queueSize) % (_count + 1);
+	_frames[_decodeSlot].startTime = _track->getNextFrameStartTime();
+	_decoding = true;
+	_future = TaskMan.submit(decodeFrame, const_cast<FrameAheadVideoTrack *>(this), "VideoDecoder::decodeNextFrame");
+}
+
+void VideoDecoder::FrameAheadVideoTrack::flush() {
+	finishDecode();
+	_queueSize = 0;
+}
+
+void VideoDecoder::FrameAheadVideoTrack::updatePalette(const byte *palette) {
+	memcpy(_palette, palette, sizeof(_palette));
+	_dirtyPalette = true;
+}
+
+bool VideoDecoder::FrameAheadVideoTrack::endOfTrack() const {
+	fill();
+	return !_queueSize && !_decoding && _track->endOfTrack();
+}
+
+uint32 VideoDecoder::FrameAheadVideoTrack::getNextFrameStartTime() const {
+	fill();
+	if (_queueSize)
+		return _frames[_queueStart].startTime;
+	if (_decoding)
+		return _frames[_decodeSlot].startTime;
+	return _track->getNextFrameStartTime();
+}
+
+const Graphics::Surface *VideoDecoder::FrameAheadVideoTrack::decodeNextFrame() {
+	_started = true;
+	fill();
+
+	if (!_queueSize && _decoding) {
+		_stats.framesLate++;
+		finishDecode();
+	}
+
+	if (!_queueSize) {
+		// Past the end of the track
+		const Graphics::Surface *surface = _track->decodeNextFrame();
+		_curFrame = _track->getCurFrame();
+		if (_track->hasDirtyPalette())
+			updatePalette(_track->getPalette());
+		return surface;
+	}
+
+	const Frame &frame = _frames[_queueStart];
+	_queueStart = (_queueStart + 1) % (_count + 1);
+	_queueSize--;
+	_stats.queueDepth[_queueSize]++;
+
+	_curFrame = frame.curFrame;
+	if (frame.dirtyPalette)
+		updatePalette(frame.palette);
+
+	// Decode the next frame into the slot of the previous one
+	fill();
+	return frame.hasSurface ? &frame.surface : nullptr;
+}
+
+bool VideoDecoder::FrameAheadVideoTrack::rewind() {
+	flush();
+	const bool result = _track->rewind();
+	_curFrame = _track->getCurFrame();
+	return result;
+}
+
+bool VideoDecoder::FrameAheadVideoTrack::seek(const Audio::Timestamp &time) {
+	flush();
+	const bool result = _track->seek(time);
+	_curFrame = _track->getCurFrame();
+	return result;
+}
+
+bool VideoDecoder::FrameAheadVideoTrack::setReverse(bool reverse) {
+	flush();
+	const bool result = _track->setReverse(reverse);
+	_curFrame = _track->getCurFrame();
+	return result;
+}
+
+bool VideoDecoder::FrameAheadVideoTrack::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	finishDecode();
+	return _track->setOutputPixelFormat(format);
+}
+
+void VideoDecoder::FrameAheadVideoTrack::setCodecAccuracy(Image::CodecAccuracy accuracy) {
+	finishDecode();
+	_track->setCodecAccuracy(accuracy);
+}
+
+void VideoDecoder::FrameAheadVideoTrack::setDither(const byte *palette) {
+	finishDecode();
+	_track->setDither(palette);
+}
+
+void VideoDecoder::FrameAheadVideoTrack::pauseIntern(bool shouldPause) {
+	finishDecode();
+	_track->pause(shouldPause);
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,6 +300,10 @@ VideoDecoder::VideoDecoder() {
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
 	_videoCodecAccuracy = Image::CodecAccuracy::Default;
+	_frameAheadCount = 0;
+	_exclusiveStream = false;
+	if (ConfMan.hasKey("video_frames_ahead"))
+		setFrameAheadCount(MAX(ConfMan.getInt("video_frames_ahead"), 0));
 }
 
 void VideoDecoder::close() {
@@ -60,6 +316,7 @@ void VideoDecoder::close() {
 	_tracks.clear();
 	_internalTracks.clear();
 	_externalTracks.clear();
+	_frameAheadTracks.clear();
 	_dirtyPalette = false;
 	_palette = 0;
 	_startTime = 0;
@@ -84,7 +341,12 @@ bool VideoDecoder::loadFile(const Common::Path &filename) {
 		return false;
 	}
 
+	// The file is only read by this decoder
+	const bool exclusiveStream = _exclusiveStream;
+	_exclusiveStream = true;
 	bool result = loadStream(file);
+	_exclusiveStream = exclusiveStream;
+
 	if (!result)
 		delete file;
 	return result;
@@ -583,6 +845,23 @@ void VideoDecoder::setVideoCodecAccuracy(Image::CodecAccuracy accuracy) {
 	}
 }
 
+VideoDecoder::FrameAheadStats VideoDecoder::getFrameAheadStats() const {
+	FrameAheadStats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	for (const FrameAheadVideoTrack *track : _frameAheadTracks) {
+		const FrameAheadStats &trackStats = track->getStats();
+		stats.framesDecoded += trackStats.framesDecoded;
+		stats.framesLate += trackStats.framesLate;
+		for (uint i = 0; i < kMaxFramesAhead; i++)
+			stats.queueDepth[i] += trackStats.queueDepth[i];
+		for (uint i = 0; i < FrameAheadStats::kDecodeTimeBuckets; i++)
+			stats.decodeTime[i] += trackStats.decodeTime[i];
+	}
+
+	return stats;
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -806,6 +1085,13 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::Path &baseNa
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	if (_frameAheadCount && _exclusiveStream && track->getTrackType() == Track::kTrackTypeVideo &&
+	    ((VideoTrack *)track)->canDecodeAhead() && TaskMan.getNumWorkers()) {
+		FrameAheadVideoTrack *frameAheadTrack = new FrameAheadVideoTrack((VideoTrack *)track, _frameAheadCount);
+		_frameAheadTracks.push_back(frameAheadTrack);
+		track = frameAheadTrack;
+	}
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -424,6 +424,72 @@ public:
 	 */
 	virtual void setVideoCodecAccuracy(Image::CodecAccuracy accuracy);
 
+	enum {
+		/** The largest number of frames decoded ahead, see setFrameAheadCount(). */
+		kMaxFramesAhead = 8
+	};
+
+	/**
+	 * Decode up to the given number of frames ahead on a worker thread, so
+	 * a slow frame does not delay showing the ones before it.
+	 *
+	 * Only the video tracks which canDecodeAhead() are decoded ahead, only
+	 * when the video is read from an exclusive stream, see
+	 * setExclusiveStream(), and only when TaskMan has worker threads. The
+	 * default is taken from the "video_frames_ahead" setting, and is 0 if it
+	 * is not set.
+	 *
+	 * This should be called before loadStream().
+	 *
+	 * @param count The number of frames, 0 to decode each frame when it is due
+	 */
+	void setFrameAheadCount(uint count) { _frameAheadCount = MIN<uint>(count, kMaxFramesAhead); }
+
+	/**
+	 * Get the number of frames decoded ahead, see setFrameAheadCount().
+	 */
+	uint getFrameAheadCount() const { return _frameAheadCount; }
+
+	/**
+	 * Declare whether the streams given to loadStream() are exclusive, that
+	 * is whether nothing else reads from them or from the streams they read
+	 * from, such as the archive file of a sub stream. Frames can only be
+	 * decoded ahead from exclusive streams, since they are read on a worker
+	 * thread. The default is false.
+	 *
+	 * The file opened by loadFile() is always considered exclusive, which
+	 * requires the archives to return streams which can be read
+	 * independently of each other, like plain files and ZIP members do.
+	 *
+	 * This should be called before loadStream().
+	 */
+	void setExclusiveStream(bool exclusive) { _exclusiveStream = exclusive; }
+	bool isExclusiveStream() const { return _exclusiveStream; }
+
+	/**
+	 * Statistics of decoding frames ahead.
+	 */
+	struct FrameAheadStats {
+		enum {
+			kDecodeTimeBuckets = 8
+		};
+
+		/** The number of frames decoded ahead */
+		uint framesDecoded;
+		/** The number of frames which were not decoded yet when they were due */
+		uint framesLate;
+		/** queueDepth[n] is the number of frames shown while n more were decoded */
+		uint queueDepth[kMaxFramesAhead];
+		/** decodeTime[n] is the number of frames decoded in less than 2^n ms, the last bucket also counts the slower ones */
+		uint decodeTime[kDecodeTimeBuckets];
+	};
+
+	/**
+	 * Get the statistics of the video tracks decoded ahead since the video
+	 * was loaded.
+	 */
+	FrameAheadStats getFrameAheadStats() const;
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -688,6 +754,18 @@ protected:
 		 * Activate dithering mode with a palette
 		 */
 		virtual void setDither(const byte *palette) {}
+
+		/**
+		 * Can the frames of the track be decoded ahead on a worker thread?
+		 *
+		 * This requires decodeNextFrame() to only use the state of the track,
+		 * and the decoder to only use the track through the VideoDecoder
+		 * functions during playback. The stream of the track is only read
+		 * ahead when it is exclusive, see VideoDecoder::setExclusiveStream().
+		 *
+		 * @see VideoDecoder::setFrameAheadCount()
+		 */
+		virtual bool canDecodeAhead() const { return false; }
 	};
 
 	/**
@@ -995,6 +1073,8 @@ protected:
 	uint getNumTracks() { return _tracks.size(); }
 
 private:
+	class FrameAheadVideoTrack;
+
 	// Tracks owned by this VideoDecoder
 	TrackList _tracks;
 	TrackList _internalTracks;
@@ -1014,6 +1094,11 @@ private:
 	bool _canSetDither;
 	bool _canSetDefaultFormat;
 
+	// Decoding frames ahead
+	uint _frameAheadCount;
+	bool _exclusiveStream;
+	Common::Array<FrameAheadVideoTrack *> _frameAheadTracks;
+
 protected:
 	// Internal helper functions
 	void stopAudio();